@@ -0,0 +1,20 @@
+#include <stdio.h>
+#include <time.h>
+
+#include "bench.h"
+
+volatile uint32_t bench_sink;
+
+uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+void bench_report(const char *name, uint64_t elapsed_ns, uint64_t num_ops)
+{
+    double ns_per_op = (num_ops > 0) ? ((double)elapsed_ns / (double)num_ops) : 0.0;
+    double ops_per_s = (elapsed_ns > 0) ? (((double)num_ops * 1e9) / (double)elapsed_ns) : 0.0;
+    printf("%-48s %12.1f ns/op %14.0f op/s\n", name, ns_per_op, ops_per_s);
+}
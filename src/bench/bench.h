@@ -0,0 +1,54 @@
+#ifndef SRC_BENCH_BENCH_H
+#define SRC_BENCH_BENCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Host benchmarks of the driver modules.
+ *
+ * Each benchmark is a function that runs its workloads and prints one line per workload with @ref bench_report.
+ * Timings are wall clock from a monotonic clock, so run on an idle machine with a release build.
+ */
+
+/**
+ * @brief Get monotonic time.
+ *
+ * @return uint64_t Time in nanoseconds.
+ */
+uint64_t bench_now_ns(void);
+
+/**
+ * @brief Print the result of a workload.
+ *
+ * @param[in] name Workload name.
+ * @param[in] elapsed_ns Time that the workload took.
+ * @param[in] num_ops Number of operations that the workload performed.
+ */
+void bench_report(const char *name, uint64_t elapsed_ns, uint64_t num_ops);
+
+/** Results of workloads are added here, so that the compiler cannot optimize the workloads away. */
+extern volatile uint32_t bench_sink;
+
+/** Fleet store column scans against an array of structs baseline. */
+void bench_fleet(void);
+
+/** Resampler push and pop throughput with 10000 sensors in mixed periodic modes. */
+void bench_resample(void);
+
+/** Fusion of hundreds of groups, in a batch and through the completion callbacks of the members. */
+void bench_fusion(void);
+
+/** Serialization of records in every format, against snprintf-based JSON formatting. */
+void bench_serialize(void);
+
+/** Sample log append, read and seek throughput, and size against raw structs. */
+void bench_sample_log(void);
+
+/** Latest readings region reads by 1 to 8 reader threads while a publisher thread keeps writing. */
+void bench_latest(void);
+
+/** Simulated time to bring up 32 sensors one by one, against a group bring-up, on a simulated bus and timers. */
+void bench_group(void);
+
+#endif /* SRC_BENCH_BENCH_H */
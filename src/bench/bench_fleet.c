@@ -0,0 +1,165 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "bench.h"
+#include "sht3x_fleet.h"
+
+#define BENCH_FLEET_NUM_SENSORS 10000
+#define BENCH_FLEET_NUM_FRAMES 64
+#define BENCH_FLEET_NUM_SAMPLES (BENCH_FLEET_NUM_SENSORS * BENCH_FLEET_NUM_FRAMES)
+/* Every frame is scanned this many times */
+#define BENCH_FLEET_NUM_PASSES 20
+#define BENCH_FLEET_THRESHOLD 0x8000
+
+/**
+ * Array of structs baseline: what storing every readout from its callback into a per-sensor history gives. Scanning
+ * one frame across all sensors is a strided access.
+ */
+typedef struct {
+    uint32_t timestamp;
+    uint16_t raw_temperature;
+    uint16_t raw_humidity;
+    uint8_t status;
+} BenchFleetAosSample;
+
+static uint16_t raw_temperature[BENCH_FLEET_NUM_SAMPLES];
+static uint16_t raw_humidity[BENCH_FLEET_NUM_SAMPLES];
+static uint8_t status[BENCH_FLEET_NUM_SAMPLES];
+static uint32_t timestamps[BENCH_FLEET_NUM_FRAMES];
+static uint8_t above[BENCH_FLEET_NUM_SENSORS];
+/* Indexed by sensor * BENCH_FLEET_NUM_FRAMES + frame */
+static BenchFleetAosSample aos[BENCH_FLEET_NUM_SAMPLES];
+
+static uint32_t lcg_next(uint32_t *state)
+{
+    *state = (*state * 1664525U) + 1013904223U;
+    return *state;
+}
+
+static void fill(SHT3XFleet *fleet)
+{
+    uint32_t rng = 1;
+    for (uint16_t frame = 0; frame < BENCH_FLEET_NUM_FRAMES; frame++) {
+        sht3x_fleet_begin_frame(fleet, frame);
+        for (uint16_t sensor = 0; sensor < BENCH_FLEET_NUM_SENSORS; sensor++) {
+            uint32_t r = lcg_next(&rng);
+            SHT3XLazyMeasurement meas = {
+                .raw_temperature = (uint16_t)(r >> 16),
+                .raw_humidity = (uint16_t)r,
+                .flags = SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM,
+            };
+            /* One in 16 readouts fails */
+            uint8_t rc = ((r & 0xF00) == 0) ? SHT3X_RESULT_CODE_IO_ERR : SHT3X_RESULT_CODE_OK;
+            sht3x_fleet_store(fleet, sensor, rc, &meas);
+
+            BenchFleetAosSample *sample = &aos[(sensor * BENCH_FLEET_NUM_FRAMES) + frame];
+            sample->timestamp = frame;
+            sample->raw_temperature = meas.raw_temperature;
+            sample->raw_humidity = meas.raw_humidity;
+            sample->status = (rc == SHT3X_RESULT_CODE_OK) ? (SHT3X_FLEET_STATUS_TEMP | SHT3X_FLEET_STATUS_HUM)
+                                                          : SHT3X_FLEET_STATUS_ERROR;
+        }
+    }
+}
+
+static void aos_scan_stats(uint16_t frame, SHT3XFleetStats *stats)
+{
+    stats->count = 0;
+    stats->min = UINT16_MAX;
+    stats->max = 0;
+    stats->sum = 0;
+    for (uint16_t sensor = 0; sensor < BENCH_FLEET_NUM_SENSORS; sensor++) {
+        const BenchFleetAosSample *sample = &aos[(sensor * BENCH_FLEET_NUM_FRAMES) + frame];
+        if (sample->status & SHT3X_FLEET_STATUS_TEMP) {
+            stats->count++;
+            stats->sum += sample->raw_temperature;
+            if (sample->raw_temperature < stats->min) {
+                stats->min = sample->raw_temperature;
+            }
+            if (sample->raw_temperature > stats->max) {
+                stats->max = sample->raw_temperature;
+            }
+        }
+    }
+    stats->mean = (stats->count > 0) ? (uint16_t)((stats->sum + (stats->count / 2)) / stats->count) : 0;
+}
+
+static uint16_t aos_scan_threshold(uint16_t frame, uint16_t threshold)
+{
+    uint16_t count = 0;
+    for (uint16_t sensor = 0; sensor < BENCH_FLEET_NUM_SENSORS; sensor++) {
+        const BenchFleetAosSample *sample = &aos[(sensor * BENCH_FLEET_NUM_FRAMES) + frame];
+        above[sensor] = (sample->status & SHT3X_FLEET_STATUS_TEMP) && (sample->raw_temperature > threshold);
+        count += above[sensor];
+    }
+    return count;
+}
+
+void bench_fleet(void)
+{
+    SHT3XFleet fleet;
+    SHT3XFleetConfig cfg = {
+        .num_sensors = BENCH_FLEET_NUM_SENSORS,
+        .num_frames = BENCH_FLEET_NUM_FRAMES,
+        .raw_temperature = raw_temperature,
+        .raw_humidity = raw_humidity,
+        .status = status,
+        .timestamps = timestamps,
+    };
+    sht3x_fleet_init(&fleet, &cfg);
+    fill(&fleet);
+    /* One op is one sensor value of one frame */
+    const uint64_t num_ops = (uint64_t)BENCH_FLEET_NUM_PASSES * BENCH_FLEET_NUM_SAMPLES;
+    uint32_t check_soa = 0;
+    uint32_t check_aos = 0;
+
+    uint64_t start = bench_now_ns();
+    for (uint16_t pass = 0; pass < BENCH_FLEET_NUM_PASSES; pass++) {
+        for (uint16_t age = 0; age < BENCH_FLEET_NUM_FRAMES; age++) {
+            SHT3XFleetFrame frame;
+            SHT3XFleetStats stats;
+            sht3x_fleet_get_frame(&fleet, age, &frame);
+            sht3x_fleet_scan_stats(&frame, SHT3X_FLEET_COLUMN_TEMPERATURE, &stats);
+            check_soa += stats.sum + stats.min + stats.max;
+        }
+    }
+    bench_report("fleet stats, 10k sensors, SoA", bench_now_ns() - start, num_ops);
+
+    start = bench_now_ns();
+    for (uint16_t pass = 0; pass < BENCH_FLEET_NUM_PASSES; pass++) {
+        for (uint16_t frame = 0; frame < BENCH_FLEET_NUM_FRAMES; frame++) {
+            SHT3XFleetStats stats;
+            aos_scan_stats(frame, &stats);
+            check_aos += stats.sum + stats.min + stats.max;
+        }
+    }
+    bench_report("fleet stats, 10k sensors, AoS baseline", bench_now_ns() - start, num_ops);
+
+    start = bench_now_ns();
+    for (uint16_t pass = 0; pass < BENCH_FLEET_NUM_PASSES; pass++) {
+        for (uint16_t age = 0; age < BENCH_FLEET_NUM_FRAMES; age++) {
+            SHT3XFleetFrame frame;
+            uint16_t count;
+            sht3x_fleet_get_frame(&fleet, age, &frame);
+            sht3x_fleet_scan_threshold(&frame, SHT3X_FLEET_COLUMN_TEMPERATURE, BENCH_FLEET_THRESHOLD, above, &count);
+            check_soa += count;
+        }
+    }
+    bench_report("fleet threshold, 10k sensors, SoA", bench_now_ns() - start, num_ops);
+
+    start = bench_now_ns();
+    for (uint16_t pass = 0; pass < BENCH_FLEET_NUM_PASSES; pass++) {
+        for (uint16_t frame = 0; frame < BENCH_FLEET_NUM_FRAMES; frame++) {
+            check_aos += aos_scan_threshold(frame, BENCH_FLEET_THRESHOLD);
+        }
+    }
+    bench_report("fleet threshold, 10k sensors, AoS baseline", bench_now_ns() - start, num_ops);
+
+    /* Both layouts hold the same samples, and frames are only visited in a different order */
+    if (check_soa != check_aos) {
+        printf("fleet: SoA and AoS results differ\n");
+    }
+    bench_sink += check_soa;
+}
@@ -0,0 +1,110 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "bench.h"
+#include "sht3x_fusion.h"
+#include "sht3x_fleet.h"
+
+#define BENCH_FUSION_NUM_GROUPS 500
+#define BENCH_FUSION_MAX_VALUES (BENCH_FUSION_NUM_GROUPS * 5)
+/* Every batch is fused this many times */
+#define BENCH_FUSION_NUM_PASSES 2000
+
+static uint16_t values[BENCH_FUSION_MAX_VALUES];
+static uint8_t status[BENCH_FUSION_MAX_VALUES];
+static uint16_t fused[BENCH_FUSION_NUM_GROUPS];
+static uint8_t fused_members[BENCH_FUSION_NUM_GROUPS];
+static SHT3XFusionGroup groups[BENCH_FUSION_NUM_GROUPS];
+static uint32_t callback_check;
+
+static uint32_t lcg_next(uint32_t *state)
+{
+    *state = (*state * 1664525U) + 1013904223U;
+    return *state;
+}
+
+/* Members of a group read close values, with an occasional outlier or failed readout */
+static void fill(uint8_t num_members)
+{
+    uint32_t rng = 1;
+    for (size_t g = 0; g < BENCH_FUSION_NUM_GROUPS; g++) {
+        uint16_t base = (uint16_t)(0x4000 + (lcg_next(&rng) >> 20));
+        for (uint8_t m = 0; m < num_members; m++) {
+            uint32_t r = lcg_next(&rng);
+            size_t idx = (g * num_members) + m;
+            values[idx] = (uint16_t)(base + ((r >> 8) & 0x1F));
+            if ((r & 0xF000) == 0) {
+                values[idx] += 0x2000;
+            }
+            status[idx] = ((r & 0xF0000) == 0) ? SHT3X_FLEET_STATUS_ERROR : SHT3X_FLEET_STATUS_TEMP;
+        }
+    }
+}
+
+static void run_batch(const SHT3XFusionConfig *cfg, uint8_t num_members, const char *name)
+{
+    fill(num_members);
+    uint32_t check = 0;
+    uint64_t start = bench_now_ns();
+    for (uint32_t pass = 0; pass < BENCH_FUSION_NUM_PASSES; pass++) {
+        sht3x_fusion_batch(cfg, num_members, values, status, SHT3X_FLEET_STATUS_TEMP, BENCH_FUSION_NUM_GROUPS, fused,
+                           fused_members);
+        check += fused[pass % BENCH_FUSION_NUM_GROUPS];
+    }
+    /* One op is one group */
+    bench_report(name, bench_now_ns() - start, (uint64_t)BENCH_FUSION_NUM_PASSES * BENCH_FUSION_NUM_GROUPS);
+    bench_sink += check;
+}
+
+static void complete_cb(uint8_t result_code, const SHT3XFusionResult *result, void *user_data)
+{
+    (void)user_data;
+    callback_check += result_code + result->raw_temperature;
+}
+
+/* Same work through the completion path of each member, one group at a time */
+static void run_callbacks(const SHT3XFusionConfig *cfg, uint8_t num_members, const char *name)
+{
+    fill(num_members);
+    SHT3XFusionMember *members[BENCH_FUSION_MAX_VALUES];
+    for (size_t g = 0; g < BENCH_FUSION_NUM_GROUPS; g++) {
+        sht3x_fusion_init(&groups[g], cfg, num_members, complete_cb, NULL);
+        for (uint8_t m = 0; m < num_members; m++) {
+            sht3x_fusion_get_member(&groups[g], m, &members[(g * num_members) + m]);
+        }
+    }
+
+    callback_check = 0;
+    SHT3XLazyMeasurement meas = {.flags = SHT3X_FLAG_READ_TEMP};
+    uint64_t start = bench_now_ns();
+    for (uint32_t pass = 0; pass < BENCH_FUSION_NUM_PASSES; pass++) {
+        for (size_t idx = 0; idx < (size_t)BENCH_FUSION_NUM_GROUPS * num_members; idx++) {
+            bool ok = (status[idx] & SHT3X_FLEET_STATUS_TEMP) != 0;
+            meas.raw_temperature = values[idx];
+            sht3x_fusion_lazy_meas_complete_cb(ok ? SHT3X_RESULT_CODE_OK : SHT3X_RESULT_CODE_IO_ERR, &meas,
+                                               members[idx]);
+        }
+    }
+    bench_report(name, bench_now_ns() - start, (uint64_t)BENCH_FUSION_NUM_PASSES * BENCH_FUSION_NUM_GROUPS);
+    bench_sink += callback_check;
+}
+
+void bench_fusion(void)
+{
+    SHT3XFusionConfig median = {
+        .method = SHT3X_FUSION_METHOD_MEDIAN,
+        .trim = 0,
+        .max_deviation = 0x100,
+        .min_members = 2,
+    };
+    SHT3XFusionConfig trimmed_mean = {
+        .method = SHT3X_FUSION_METHOD_TRIMMED_MEAN,
+        .trim = 1,
+        .max_deviation = 0x100,
+        .min_members = 2,
+    };
+    run_batch(&median, 3, "fusion batch, 500 groups of 3, median");
+    run_batch(&trimmed_mean, 5, "fusion batch, 500 groups of 5, trimmed mean");
+    run_callbacks(&median, 3, "fusion callbacks, 500 groups of 3, median");
+}
@@ -0,0 +1,232 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "sht3x.h"
+#include "sht3x_group.h"
+/* Included to know the size of SHT3X instance to return from get_instance_memory. */
+#include "sht3x_private.h"
+
+#define BENCH_GROUP_NUM_SENSORS 32
+#define BENCH_GROUP_BUS_SPEED_HZ 400000UL
+/* Bring-ups of each kind timed on the host */
+#define BENCH_GROUP_NUM_RUNS 2000
+/* Pending I2C completions and timers. The driver and the group only have one of each in flight at a time. */
+#define BENCH_GROUP_MAX_EVENTS 8
+
+/**
+ * Simulated backend: all sensors share one bus, an I2C transaction occupies it for its airtime, and timers expire
+ * exactly after their duration. Completions are queued instead of executed from within i2c_write, i2c_read and
+ * start_timer, like a real interrupt driven backend would.
+ */
+typedef struct {
+    uint64_t time_us;
+    /* Keeps events with the same time in the order they were queued */
+    uint64_t order;
+    SHT3X_I2CTransactionCompleteCb i2c_cb;
+    SHT3XTimerExpiredCb timer_cb;
+    void *cb_user_data;
+} BenchGroupEvent;
+
+static struct SHT3XStruct instance_memory[BENCH_GROUP_NUM_SENSORS];
+static SHT3X instances[BENCH_GROUP_NUM_SENSORS];
+static uint8_t results[BENCH_GROUP_NUM_SENSORS];
+static BenchGroupEvent events[BENCH_GROUP_MAX_EVENTS];
+static size_t num_events;
+static uint64_t num_queued;
+static uint64_t now_us;
+static uint64_t bus_free_us;
+static bool event_queue_full;
+
+static void queue_event(uint64_t time_us, SHT3X_I2CTransactionCompleteCb i2c_cb, SHT3XTimerExpiredCb timer_cb,
+                        void *cb_user_data)
+{
+    if (num_events == BENCH_GROUP_MAX_EVENTS) {
+        event_queue_full = true;
+        return;
+    }
+    events[num_events].time_us = time_us;
+    events[num_events].order = num_queued++;
+    events[num_events].i2c_cb = i2c_cb;
+    events[num_events].timer_cb = timer_cb;
+    events[num_events].cb_user_data = cb_user_data;
+    num_events++;
+}
+
+/* Execute queued events in time order until there are none left */
+static void run_events(void)
+{
+    while (num_events > 0) {
+        size_t next = 0;
+        for (size_t i = 1; i < num_events; i++) {
+            if ((events[i].time_us < events[next].time_us)
+                || ((events[i].time_us == events[next].time_us) && (events[i].order < events[next].order))) {
+                next = i;
+            }
+        }
+        BenchGroupEvent event = events[next];
+        events[next] = events[--num_events];
+        now_us = event.time_us;
+        if (event.i2c_cb) {
+            event.i2c_cb(SHT3X_I2C_RESULT_CODE_OK, event.cb_user_data);
+        } else {
+            event.timer_cb(event.cb_user_data);
+        }
+    }
+}
+
+/* Start and stop conditions, and the address byte and data bytes with their ACK bits */
+static void transact(size_t length, SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data)
+{
+    uint64_t num_bits = 2 + (9 * (1 + length));
+    uint64_t start_us = (bus_free_us > now_us) ? bus_free_us : now_us;
+    bus_free_us = start_us + (((num_bits * 1000000) + BENCH_GROUP_BUS_SPEED_HZ - 1) / BENCH_GROUP_BUS_SPEED_HZ);
+    queue_event(bus_free_us, cb, NULL, cb_user_data);
+}
+
+static void i2c_write(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                      SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data)
+{
+    (void)data;
+    (void)i2c_addr;
+    (void)user_data;
+    transact(length, cb, cb_user_data);
+}
+
+/* Every read is a status register readout with all flags cleared */
+static void i2c_read(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                     SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data)
+{
+    (void)i2c_addr;
+    (void)user_data;
+    static const uint8_t clean_status[] = {0x00, 0x00, 0x81};
+    for (size_t i = 0; i < length; i++) {
+        data[i] = clean_status[i % sizeof(clean_status)];
+    }
+    transact(length, cb, cb_user_data);
+}
+
+static void start_timer(uint32_t duration_ms, void *user_data, SHT3XTimerExpiredCb cb, void *cb_user_data)
+{
+    (void)user_data;
+    queue_event(now_us + ((uint64_t)duration_ms * 1000), NULL, cb, cb_user_data);
+}
+
+static void *get_instance_memory(void *user_data)
+{
+    return user_data;
+}
+
+static void reset(void)
+{
+    memset(instance_memory, 0, sizeof(instance_memory));
+    memset(results, 0xFF, sizeof(results));
+    num_events = 0;
+    now_us = 0;
+    bus_free_us = 0;
+    for (size_t i = 0; i < BENCH_GROUP_NUM_SENSORS; i++) {
+        SHT3XInitConfig init_cfg = {
+            .get_instance_memory = get_instance_memory,
+            .get_instance_memory_user_data = &instance_memory[i],
+            .i2c_write = i2c_write,
+            .i2c_write_user_data = NULL,
+            .i2c_read = i2c_read,
+            .i2c_read_user_data = NULL,
+            .start_timer = start_timer,
+            .start_timer_user_data = NULL,
+            .i2c_addr = 0x44,
+        };
+        sht3x_create(&instances[i], &init_cfg);
+    }
+}
+
+static void init_sequence_complete(uint8_t result_code, uint32_t time_to_first_sample_ms, void *user_data)
+{
+    (void)time_to_first_sample_ms;
+    *(uint8_t *)user_data = result_code;
+}
+
+static void group_init_complete(uint8_t result_code, void *user_data)
+{
+    (void)result_code;
+    (void)user_data;
+}
+
+/* One sensor after another, each with its own soft reset time and delays. Returns the simulated time in us. */
+static uint64_t bring_up_sequential(const SHT3XInitSequenceConfig *cfg)
+{
+    reset();
+    for (size_t i = 0; i < BENCH_GROUP_NUM_SENSORS; i++) {
+        if (sht3x_init_sequence(instances[i], cfg, init_sequence_complete, &results[i]) != SHT3X_RESULT_CODE_OK) {
+            break;
+        }
+        run_events();
+    }
+    return now_us;
+}
+
+/* All sensors with @ref sht3x_group_init. Returns the simulated time in us. */
+static uint64_t bring_up_group(const SHT3XInitSequenceConfig *cfg)
+{
+    reset();
+    SHT3XGroup group;
+    SHT3XGroupConfig group_cfg = {
+        .instances = instances,
+        .results = results,
+        .num_instances = BENCH_GROUP_NUM_SENSORS,
+        .init_cfg = *cfg,
+        .start_timer = start_timer,
+        .start_timer_user_data = NULL,
+    };
+    if (sht3x_group_init(&group, &group_cfg, group_init_complete, NULL) == SHT3X_RESULT_CODE_OK) {
+        run_events();
+    }
+    return now_us;
+}
+
+static size_t count_failed(void)
+{
+    size_t num_failed = 0;
+    for (size_t i = 0; i < BENCH_GROUP_NUM_SENSORS; i++) {
+        num_failed += (results[i] != SHT3X_RESULT_CODE_OK);
+    }
+    return num_failed;
+}
+
+void bench_group(void)
+{
+    SHT3XInitSequenceConfig cfg = {
+        .meas_mode = SHT3X_MEAS_MODE_PERIODIC,
+        .repeatability = SHT3X_MEAS_REPEATABILITY_HIGH,
+        .mps = SHT3X_MPS_1,
+        .verify_status = true,
+    };
+    event_queue_full = false;
+
+    uint64_t sequential_us = 0;
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < BENCH_GROUP_NUM_RUNS; i++) {
+        sequential_us = bring_up_sequential(&cfg);
+    }
+    bench_report("group bring-up host time, sequential", bench_now_ns() - start, BENCH_GROUP_NUM_RUNS);
+    size_t sequential_failed = count_failed();
+
+    uint64_t group_us = 0;
+    start = bench_now_ns();
+    for (size_t i = 0; i < BENCH_GROUP_NUM_RUNS; i++) {
+        group_us = bring_up_group(&cfg);
+    }
+    bench_report("group bring-up host time, group init", bench_now_ns() - start, BENCH_GROUP_NUM_RUNS);
+    size_t group_failed = count_failed();
+
+    printf("group bring-up of %d sensors at %lu Hz: sequential %.3f ms, group init %.3f ms, %.1fx faster\n",
+           BENCH_GROUP_NUM_SENSORS, BENCH_GROUP_BUS_SPEED_HZ, (double)sequential_us / 1000.0, (double)group_us / 1000.0,
+           (double)sequential_us / (double)group_us);
+    if ((sequential_failed > 0) || (group_failed > 0) || event_queue_full) {
+        printf("group: %zu sensors failed sequential bring-up, %zu failed group init%s\n", sequential_failed,
+               group_failed, event_queue_full ? ", event queue overflowed" : "");
+    }
+}
@@ -0,0 +1,142 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <pthread.h>
+
+#include "bench.h"
+#include "sht3x_latest.h"
+
+#define BENCH_LATEST_NUM_SLOTS 1024
+#define BENCH_LATEST_MAX_READERS 8
+/* Reads done by each reader thread */
+#define BENCH_LATEST_NUM_READS 2000000
+
+typedef struct {
+    SHT3XLatestReader reader;
+    uint32_t seed;
+    size_t num_busy;
+    size_t num_torn;
+} BenchLatestReaderState;
+
+/* uint32_t elements keep the region aligned to 4 bytes */
+static uint32_t region[SHT3X_LATEST_REGION_SIZE(BENCH_LATEST_NUM_SLOTS) / sizeof(uint32_t)];
+static SHT3XLatestPublisher publisher;
+static volatile bool stop_publisher;
+static uint64_t num_published;
+
+static uint32_t lcg_next(uint32_t *state)
+{
+    *state = (*state * 1664525U) + 1013904223U;
+    return *state;
+}
+
+/* Both raw values are derived from the timestamp, so a reading mixed from two publishes is detected */
+static void make_reading(uint32_t timestamp, SHT3XLatestReading *reading)
+{
+    reading->timestamp = timestamp;
+    reading->raw_temperature = (uint16_t)timestamp;
+    reading->raw_humidity = (uint16_t)~timestamp;
+    reading->flags = 0;
+}
+
+static void *publisher_thread(void *arg)
+{
+    (void)arg;
+    uint64_t count = 0;
+    SHT3XLatestReading reading;
+    while (!stop_publisher) {
+        make_reading((uint32_t)count, &reading);
+        sht3x_latest_publish(&publisher, (uint32_t)(count % BENCH_LATEST_NUM_SLOTS), &reading);
+        count++;
+    }
+    num_published = count;
+    return NULL;
+}
+
+static void *reader_thread(void *arg)
+{
+    BenchLatestReaderState *state = (BenchLatestReaderState *)arg;
+    SHT3XLatestReading reading;
+    for (size_t i = 0; i < BENCH_LATEST_NUM_READS; i++) {
+        uint32_t slot = lcg_next(&state->seed) % BENCH_LATEST_NUM_SLOTS;
+        uint8_t rc = sht3x_latest_read(&state->reader, slot, &reading, NULL);
+        if (rc == SHT3X_RESULT_CODE_BUSY) {
+            state->num_busy++;
+        } else if ((rc != SHT3X_RESULT_CODE_OK) || (reading.raw_temperature != (uint16_t)reading.timestamp)
+                   || (reading.raw_humidity != (uint16_t)~reading.timestamp)) {
+            state->num_torn++;
+        }
+    }
+    return NULL;
+}
+
+static void run(size_t num_readers, bool with_publisher)
+{
+    pthread_t publisher_tid;
+    pthread_t reader_tids[BENCH_LATEST_MAX_READERS];
+    BenchLatestReaderState states[BENCH_LATEST_MAX_READERS];
+    for (size_t i = 0; i < num_readers; i++) {
+        sht3x_latest_reader_init(&states[i].reader, region, sizeof(region));
+        states[i].seed = (uint32_t)i + 1;
+        states[i].num_busy = 0;
+        states[i].num_torn = 0;
+    }
+
+    stop_publisher = false;
+    SHT3X_LATEST_BARRIER();
+    if (with_publisher && (pthread_create(&publisher_tid, NULL, publisher_thread, NULL) != 0)) {
+        printf("latest: failed to start the publisher\n");
+        return;
+    }
+    uint64_t start = bench_now_ns();
+    size_t num_started = 0;
+    while ((num_started < num_readers)
+           && (pthread_create(&reader_tids[num_started], NULL, reader_thread, &states[num_started]) == 0)) {
+        num_started++;
+    }
+    for (size_t i = 0; i < num_started; i++) {
+        pthread_join(reader_tids[i], NULL);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    stop_publisher = true;
+    SHT3X_LATEST_BARRIER();
+    if (with_publisher) {
+        pthread_join(publisher_tid, NULL);
+    }
+    if (num_started < num_readers) {
+        printf("latest: started only %zu of %zu readers\n", num_started, num_readers);
+        return;
+    }
+
+    size_t num_busy = 0;
+    size_t num_torn = 0;
+    for (size_t i = 0; i < num_readers; i++) {
+        num_busy += states[i].num_busy;
+        num_torn += states[i].num_torn;
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "latest read, %zu reader(s)%s", num_readers, with_publisher ? " + publisher" : "");
+    bench_report(name, elapsed, (uint64_t)num_readers * BENCH_LATEST_NUM_READS);
+    if (with_publisher) {
+        snprintf(name, sizeof(name), "latest publish, %zu reader(s)", num_readers);
+        bench_report(name, elapsed, num_published);
+    }
+    if ((num_busy > 0) || (num_torn > 0)) {
+        printf("latest: %zu reads busy, %zu reads torn or failed\n", num_busy, num_torn);
+    }
+}
+
+void bench_latest(void)
+{
+    sht3x_latest_publisher_init(&publisher, region, sizeof(region), BENCH_LATEST_NUM_SLOTS);
+    SHT3XLatestReading reading;
+    for (uint32_t slot = 0; slot < BENCH_LATEST_NUM_SLOTS; slot++) {
+        make_reading(slot, &reading);
+        sht3x_latest_publish(&publisher, slot, &reading);
+    }
+    run(1, false);
+    for (size_t num_readers = 1; num_readers <= BENCH_LATEST_MAX_READERS; num_readers *= 2) {
+        run(num_readers, true);
+    }
+}
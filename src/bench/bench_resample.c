@@ -0,0 +1,95 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "bench.h"
+#include "sht3x_resample.h"
+
+#define BENCH_RESAMPLE_NUM_SENSORS 10000
+#define BENCH_RESAMPLE_NUM_ROWS 8
+#define BENCH_RESAMPLE_NUM_VALUES (BENCH_RESAMPLE_NUM_SENSORS * BENCH_RESAMPLE_NUM_ROWS)
+/* Simulated time in ms */
+#define BENCH_RESAMPLE_DURATION_MS 60000
+#define BENCH_RESAMPLE_CHUNK_MS 1000
+
+/* MPS 10, 4, 2, 1 and 0.5, assigned to the sensors in turn */
+static const uint32_t periods_ms[] = {100, 250, 500, 1000, 2000};
+#define BENCH_RESAMPLE_NUM_MODES (sizeof(periods_ms) / sizeof(periods_ms[0]))
+
+static SHT3XResampleSensor sensors[BENCH_RESAMPLE_NUM_SENSORS];
+static uint16_t raw_temperature[BENCH_RESAMPLE_NUM_VALUES];
+static uint16_t raw_humidity[BENCH_RESAMPLE_NUM_VALUES];
+static uint8_t status[BENCH_RESAMPLE_NUM_VALUES];
+static uint32_t next_sample_ms[BENCH_RESAMPLE_NUM_SENSORS];
+
+/**
+ * @brief Stream the samples of all sensors through a resampler, and report push and pop throughput.
+ *
+ * Samples are pushed one chunk of simulated time at a time: every sensor pushes its samples of the chunk in time
+ * order, then all complete rows are taken out.
+ */
+static void run(uint8_t method, const char *push_name, const char *pop_name)
+{
+    SHT3XResampler resampler;
+    SHT3XResampleConfig cfg = {
+        .num_sensors = BENCH_RESAMPLE_NUM_SENSORS,
+        .num_rows = BENCH_RESAMPLE_NUM_ROWS,
+        .method = method,
+        .start_time = 1000,
+        .period = 1000,
+        .max_age = 0,
+        .max_delay = 2500,
+        .sensors = sensors,
+        .raw_temperature = raw_temperature,
+        .raw_humidity = raw_humidity,
+        .status = status,
+    };
+    sht3x_resample_init(&resampler, &cfg);
+    for (uint16_t i = 0; i < BENCH_RESAMPLE_NUM_SENSORS; i++) {
+        /* Spread the sampling instants within a period */
+        next_sample_ms[i] = (i * 7U) % periods_ms[i % BENCH_RESAMPLE_NUM_MODES];
+    }
+
+    uint64_t push_ns = 0;
+    uint64_t pop_ns = 0;
+    uint64_t num_pushes = 0;
+    uint64_t num_rows = 0;
+    uint64_t num_failed = 0;
+    uint32_t check = 0;
+    SHT3XLazyMeasurement meas = {.flags = SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM};
+    for (uint32_t chunk_end = BENCH_RESAMPLE_CHUNK_MS; chunk_end <= BENCH_RESAMPLE_DURATION_MS;
+         chunk_end += BENCH_RESAMPLE_CHUNK_MS) {
+        uint64_t start = bench_now_ns();
+        for (uint16_t i = 0; i < BENCH_RESAMPLE_NUM_SENSORS; i++) {
+            for (; next_sample_ms[i] < chunk_end; next_sample_ms[i] += periods_ms[i % BENCH_RESAMPLE_NUM_MODES]) {
+                meas.raw_temperature = (uint16_t)(next_sample_ms[i] / 10);
+                meas.raw_humidity = (uint16_t)i;
+                num_failed += (sht3x_resample_push(&resampler, i, next_sample_ms[i], &meas) != SHT3X_RESULT_CODE_OK);
+                num_pushes++;
+            }
+        }
+        uint64_t mid = bench_now_ns();
+        SHT3XResampleRow row;
+        while (sht3x_resample_pop_row(&resampler, chunk_end, &row) == SHT3X_RESULT_CODE_OK) {
+            check += row.raw_temperature[row.num_sensors - 1];
+            num_rows++;
+        }
+        uint64_t end = bench_now_ns();
+        push_ns += mid - start;
+        pop_ns += end - mid;
+    }
+
+    bench_report(push_name, push_ns, num_pushes);
+    bench_report(pop_name, pop_ns, num_rows);
+    if (num_failed > 0) {
+        printf("resample: %llu pushes failed\n", (unsigned long long)num_failed);
+    }
+    bench_sink += check;
+}
+
+void bench_resample(void)
+{
+    run(SHT3X_RESAMPLE_METHOD_HOLD, "resample push, 10k sensors, hold", "resample pop row, 10k sensors, hold");
+    run(SHT3X_RESAMPLE_METHOD_LINEAR, "resample push, 10k sensors, linear", "resample pop row, 10k sensors, linear");
+}
@@ -0,0 +1,125 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "sht3x_sample_log.h"
+
+/* About 11.6 days of samples at 1 Hz */
+#define BENCH_SAMPLE_LOG_NUM_SAMPLES 1000000
+#define BENCH_SAMPLE_LOG_BLOCK_SIZE 4096
+/* Far more than the encoded samples need */
+#define BENCH_SAMPLE_LOG_SIZE (BENCH_SAMPLE_LOG_NUM_SAMPLES * sizeof(SHT3XLogSample))
+#define BENCH_SAMPLE_LOG_NUM_SEEKS 10000
+
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t length;
+} BenchSampleLogStorage;
+
+static SHT3XLogSample samples[BENCH_SAMPLE_LOG_NUM_SAMPLES];
+static SHT3XLogSample raw_copy[BENCH_SAMPLE_LOG_NUM_SAMPLES];
+static uint8_t log_buf[BENCH_SAMPLE_LOG_SIZE];
+static uint8_t block_buf[BENCH_SAMPLE_LOG_BLOCK_SIZE];
+
+static uint32_t lcg_next(uint32_t *state)
+{
+    *state = (*state * 1664525U) + 1013904223U;
+    return *state;
+}
+
+/* Slowly drifting values with a few ticks of noise, sampled every 1000 ms with some jitter */
+static void fill(void)
+{
+    uint32_t rng = 1;
+    uint32_t timestamp = 0;
+    int32_t temp = 0x6000;
+    int32_t hum = 0x7000;
+    for (size_t i = 0; i < BENCH_SAMPLE_LOG_NUM_SAMPLES; i++) {
+        uint32_t r = lcg_next(&rng);
+        timestamp += 995 + ((r >> 24) % 10);
+        temp += (int32_t)((r >> 4) % 5) - 2;
+        hum += (int32_t)((r >> 12) % 9) - 4;
+        temp = (temp < 0) ? 0 : ((temp > 0xFFFF) ? 0xFFFF : temp);
+        hum = (hum < 0) ? 0 : ((hum > 0xFFFF) ? 0xFFFF : hum);
+        samples[i].timestamp = timestamp;
+        samples[i].raw_temperature = (uint16_t)temp;
+        samples[i].raw_humidity = (uint16_t)hum;
+    }
+}
+
+static bool storage_write(const uint8_t *data, size_t length, void *user_data)
+{
+    BenchSampleLogStorage *storage = (BenchSampleLogStorage *)user_data;
+    if ((storage->size - storage->length) < length) {
+        return false;
+    }
+    memcpy(&storage->buf[storage->length], data, length);
+    storage->length += length;
+    return true;
+}
+
+void bench_sample_log(void)
+{
+    fill();
+    BenchSampleLogStorage storage = {
+        .buf = log_buf,
+        .size = sizeof(log_buf),
+        .length = 0,
+    };
+    SHT3XSampleLogWriterConfig cfg = {
+        .block_buf = block_buf,
+        .block_size = sizeof(block_buf),
+        .write = storage_write,
+        .write_user_data = &storage,
+    };
+    SHT3XSampleLogWriter writer;
+    sht3x_sample_log_writer_init(&writer, &cfg);
+
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < BENCH_SAMPLE_LOG_NUM_SAMPLES; i++) {
+        sht3x_sample_log_append(&writer, &samples[i]);
+    }
+    sht3x_sample_log_flush(&writer);
+    bench_report("sample log append", bench_now_ns() - start, BENCH_SAMPLE_LOG_NUM_SAMPLES);
+
+    /* Baseline: storing the raw structs */
+    start = bench_now_ns();
+    for (size_t i = 0; i < BENCH_SAMPLE_LOG_NUM_SAMPLES; i++) {
+        memcpy(&raw_copy[i], &samples[i], sizeof(samples[i]));
+    }
+    bench_report("sample log append, raw struct baseline", bench_now_ns() - start, BENCH_SAMPLE_LOG_NUM_SAMPLES);
+    bench_sink += raw_copy[BENCH_SAMPLE_LOG_NUM_SAMPLES - 1].raw_temperature;
+
+    SHT3XSampleLogReader reader;
+    sht3x_sample_log_reader_init(&reader, log_buf, storage.length);
+    size_t num_read = 0;
+    size_t num_mismatches = 0;
+    SHT3XLogSample sample;
+    start = bench_now_ns();
+    while (sht3x_sample_log_read(&reader, &sample) == SHT3X_RESULT_CODE_OK) {
+        num_mismatches += (num_read >= BENCH_SAMPLE_LOG_NUM_SAMPLES)
+                          || (memcmp(&sample, &samples[num_read], sizeof(sample)) != 0);
+        num_read++;
+    }
+    bench_report("sample log read", bench_now_ns() - start, num_read);
+
+    uint32_t rng = 2;
+    uint32_t last_timestamp = samples[BENCH_SAMPLE_LOG_NUM_SAMPLES - 1].timestamp;
+    start = bench_now_ns();
+    for (size_t i = 0; i < BENCH_SAMPLE_LOG_NUM_SEEKS; i++) {
+        sht3x_sample_log_seek(&reader, lcg_next(&rng) % last_timestamp);
+    }
+    bench_report("sample log seek", bench_now_ns() - start, BENCH_SAMPLE_LOG_NUM_SEEKS);
+
+    double raw_bytes = (double)BENCH_SAMPLE_LOG_NUM_SAMPLES * sizeof(SHT3XLogSample);
+    printf("sample log size: %.2f bytes/sample, raw structs %.2f bytes/sample, compression ratio %.2f\n",
+           (double)storage.length / BENCH_SAMPLE_LOG_NUM_SAMPLES, raw_bytes / BENCH_SAMPLE_LOG_NUM_SAMPLES,
+           raw_bytes / (double)storage.length);
+    if ((num_read != BENCH_SAMPLE_LOG_NUM_SAMPLES) || (num_mismatches > 0)) {
+        printf("sample log: read %zu samples, %zu differ from the appended ones\n", num_read, num_mismatches);
+    }
+}
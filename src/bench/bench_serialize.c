@@ -0,0 +1,106 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "sht3x_serialize.h"
+
+#define BENCH_SERIALIZE_NUM_RECORDS 1000
+/* Every batch is serialized this many times */
+#define BENCH_SERIALIZE_NUM_PASSES 200
+
+static SHT3XRecord records[BENCH_SERIALIZE_NUM_RECORDS];
+static uint8_t buf[BENCH_SERIALIZE_NUM_RECORDS * SHT3X_SERIALIZE_JSON_MAX_SIZE];
+
+static void fill(void)
+{
+    for (uint32_t i = 0; i < BENCH_SERIALIZE_NUM_RECORDS; i++) {
+        records[i].sensor_id = i;
+        records[i].timestamp = 1700000000U + i;
+        records[i].meas.temperature = -10.0f + ((float)i * 0.047f);
+        records[i].meas.humidity = (float)i * 0.0913f;
+    }
+}
+
+/* The formatting that the serializer replaces */
+static size_t snprintf_json(const SHT3XRecord *record, char *out, size_t size)
+{
+    int n = snprintf(out, size, "{\"id\":%lu,\"ts\":%lu,\"t\":%.2f,\"rh\":%.2f}\n", (unsigned long)record->sensor_id,
+                     (unsigned long)record->timestamp, (double)record->meas.temperature,
+                     (double)record->meas.humidity);
+    return (n > 0) ? (size_t)n : 0;
+}
+
+static void run_records(SHT3XSerializeFormat format, const char *name)
+{
+    size_t total = 0;
+    uint64_t start = bench_now_ns();
+    for (uint32_t pass = 0; pass < BENCH_SERIALIZE_NUM_PASSES; pass++) {
+        size_t pos = 0;
+        for (size_t i = 0; i < BENCH_SERIALIZE_NUM_RECORDS; i++) {
+            size_t length = 0;
+            sht3x_serialize_record(format, &records[i], &buf[pos], sizeof(buf) - pos, &length);
+            pos += length;
+        }
+        total += pos;
+    }
+    bench_report(name, bench_now_ns() - start, (uint64_t)BENCH_SERIALIZE_NUM_PASSES * BENCH_SERIALIZE_NUM_RECORDS);
+    bench_sink += (uint32_t)total;
+}
+
+static void run_batch(SHT3XSerializeFormat format, const char *name)
+{
+    size_t total = 0;
+    uint64_t start = bench_now_ns();
+    for (uint32_t pass = 0; pass < BENCH_SERIALIZE_NUM_PASSES; pass++) {
+        size_t length = 0;
+        sht3x_serialize_batch(format, records, BENCH_SERIALIZE_NUM_RECORDS, buf, sizeof(buf), &length);
+        total += length;
+    }
+    bench_report(name, bench_now_ns() - start, (uint64_t)BENCH_SERIALIZE_NUM_PASSES * BENCH_SERIALIZE_NUM_RECORDS);
+    bench_sink += (uint32_t)total;
+}
+
+static void run_snprintf(const char *name)
+{
+    size_t total = 0;
+    uint64_t start = bench_now_ns();
+    for (uint32_t pass = 0; pass < BENCH_SERIALIZE_NUM_PASSES; pass++) {
+        size_t pos = 0;
+        for (size_t i = 0; i < BENCH_SERIALIZE_NUM_RECORDS; i++) {
+            pos += snprintf_json(&records[i], (char *)&buf[pos], sizeof(buf) - pos);
+        }
+        total += pos;
+    }
+    bench_report(name, bench_now_ns() - start, (uint64_t)BENCH_SERIALIZE_NUM_PASSES * BENCH_SERIALIZE_NUM_RECORDS);
+    bench_sink += (uint32_t)total;
+}
+
+/* Both JSON forms must be byte for byte the same */
+static void check_json(void)
+{
+    char expected[SHT3X_SERIALIZE_JSON_MAX_SIZE + 1];
+    uint8_t actual[SHT3X_SERIALIZE_JSON_MAX_SIZE];
+    for (size_t i = 0; i < BENCH_SERIALIZE_NUM_RECORDS; i++) {
+        size_t expected_length = snprintf_json(&records[i], expected, sizeof(expected));
+        size_t length = 0;
+        sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_JSON_LINES, &records[i], actual, sizeof(actual), &length);
+        if ((length != expected_length) || (memcmp(actual, expected, length) != 0)) {
+            printf("serialize: JSON line of record %zu differs from snprintf\n", i);
+            return;
+        }
+    }
+}
+
+void bench_serialize(void)
+{
+    fill();
+    check_json();
+    run_records(SHT3X_SERIALIZE_FORMAT_BINARY, "serialize record, binary");
+    run_records(SHT3X_SERIALIZE_FORMAT_CBOR, "serialize record, CBOR");
+    run_records(SHT3X_SERIALIZE_FORMAT_JSON_LINES, "serialize record, JSON lines");
+    run_snprintf("serialize record, JSON lines with snprintf");
+    run_batch(SHT3X_SERIALIZE_FORMAT_CBOR, "serialize batch of 1000, CBOR");
+    run_batch(SHT3X_SERIALIZE_FORMAT_JSON_LINES, "serialize batch of 1000, JSON lines");
+}
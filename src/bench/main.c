@@ -0,0 +1,56 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+typedef struct {
+    const char *name;
+    void (*run)(void);
+} SHT3XBench;
+
+static const SHT3XBench benches[] = {
+    {"fleet", bench_fleet},
+    {"resample", bench_resample},
+    {"fusion", bench_fusion},
+    {"serialize", bench_serialize},
+    {"sample_log", bench_sample_log},
+    {"latest", bench_latest},
+    {"group", bench_group},
+};
+
+#define SHT3X_BENCH_NUM_BENCHES (sizeof(benches) / sizeof(benches[0]))
+
+/**
+ * @brief Run the benchmarks named in the arguments, or all of them if there are none.
+ */
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++) {
+        bool found = false;
+        for (size_t j = 0; j < SHT3X_BENCH_NUM_BENCHES; j++) {
+            found = found || (strcmp(argv[i], benches[j].name) == 0);
+        }
+        if (!found) {
+            fprintf(stderr, "Unknown benchmark %s. Available:", argv[i]);
+            for (size_t j = 0; j < SHT3X_BENCH_NUM_BENCHES; j++) {
+                fprintf(stderr, " %s", benches[j].name);
+            }
+            fprintf(stderr, "\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (size_t j = 0; j < SHT3X_BENCH_NUM_BENCHES; j++) {
+        bool selected = (argc == 1);
+        for (int i = 1; i < argc; i++) {
+            selected = selected || (strcmp(argv[i], benches[j].name) == 0);
+        }
+        if (selected) {
+            printf("# %s\n", benches[j].name);
+            benches[j].run();
+        }
+    }
+    return EXIT_SUCCESS;
+}
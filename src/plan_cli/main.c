@@ -0,0 +1,209 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sht3x_plan.h"
+
+/**
+ * @brief Command line front end of @ref sht3x_plan.
+ *
+ * Parses plan options from the arguments, and prints the predictions. Run with --help for the list of options.
+ */
+
+typedef struct {
+    const char *name;
+    uint8_t value;
+} SHT3XPlanCliOption;
+
+static const SHT3XPlanCliOption mode_options[] = {
+    {"single", SHT3X_MEAS_MODE_SINGLE_SHOT},
+    {"periodic", SHT3X_MEAS_MODE_PERIODIC},
+};
+
+static const SHT3XPlanCliOption repeatability_options[] = {
+    {"high", SHT3X_MEAS_REPEATABILITY_HIGH},
+    {"medium", SHT3X_MEAS_REPEATABILITY_MEDIUM},
+    {"low", SHT3X_MEAS_REPEATABILITY_LOW},
+};
+
+static const SHT3XPlanCliOption clock_stretching_options[] = {
+    {"on", SHT3X_CLOCK_STRETCHING_ENABLED},
+    {"off", SHT3X_CLOCK_STRETCHING_DISABLED},
+};
+
+static const SHT3XPlanCliOption mps_options[] = {
+    {"0.5", SHT3X_MPS_0_5}, {"1", SHT3X_MPS_1}, {"2", SHT3X_MPS_2}, {"4", SHT3X_MPS_4}, {"10", SHT3X_MPS_10},
+};
+
+static const SHT3XPlanCliOption flag_options[] = {
+    {"temp", SHT3X_FLAG_READ_TEMP},
+    {"hum", SHT3X_FLAG_READ_HUM},
+    {"crc-temp", SHT3X_FLAG_VERIFY_CRC_TEMP},
+    {"crc-hum", SHT3X_FLAG_VERIFY_CRC_HUM},
+};
+
+#define SHT3X_PLAN_CLI_NUM_OPTIONS(options) (sizeof(options) / sizeof((options)[0]))
+
+static void print_usage(const char *prog)
+{
+    printf("Usage: %s [options]\n"
+           "  --bus-speed HZ                  Bus clock speed in Hz (default 100000)\n"
+           "  --sensors N                     Number of sensors on the bus (default 1)\n"
+           "  --mode single|periodic          Measurement mode (default single)\n"
+           "  --repeatability high|medium|low Repeatability (default high)\n"
+           "  --clock-stretching on|off       Clock stretching, single shot mode only (default off)\n"
+           "  --mps 0.5|1|2|4|10              Measurements per second, periodic mode only (default 1)\n"
+           "  --flags LIST                    Comma-separated temp, hum, crc-temp, crc-hum (default temp,hum)\n"
+           "  --interval MS                   Requested sample interval in ms, 0 for fastest (default 0)\n",
+           prog);
+}
+
+/**
+ * @brief Look up the value of a named option.
+ *
+ * @param[in] options Option table.
+ * @param[in] num_options Number of entries in @p options.
+ * @param[in] name Name to look up.
+ * @param[out] value Value of the option is written here.
+ *
+ * @retval true Found.
+ * @retval false @p name is not in @p options.
+ */
+static bool parse_option(const SHT3XPlanCliOption *options, size_t num_options, const char *name, uint8_t *value)
+{
+    for (size_t i = 0; i < num_options; i++) {
+        if (strcmp(options[i].name, name) == 0) {
+            *value = options[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parse_u32(const char *str, uint32_t max, uint32_t *value)
+{
+    char *end;
+    unsigned long val = strtoul(str, &end, 10);
+    if ((*str == '\0') || (*end != '\0') || (str[0] == '-') || (val > max)) {
+        return false;
+    }
+    *value = (uint32_t)val;
+    return true;
+}
+
+static bool parse_flags(const char *str, uint8_t *flags)
+{
+    char buf[64];
+    if (strlen(str) >= sizeof(buf)) {
+        return false;
+    }
+    strcpy(buf, str);
+    *flags = 0;
+    for (char *name = strtok(buf, ","); name; name = strtok(NULL, ",")) {
+        uint8_t flag;
+        if (!parse_option(flag_options, SHT3X_PLAN_CLI_NUM_OPTIONS(flag_options), name, &flag)) {
+            return false;
+        }
+        *flags |= flag;
+    }
+    return true;
+}
+
+/**
+ * @brief Parse plan options from the command line arguments.
+ *
+ * @param[in] argc Number of arguments.
+ * @param[in] argv Arguments.
+ * @param[out] cfg Options are written here. Options that are not given keep their value.
+ *
+ * @retval true Success.
+ * @retval false An argument is unknown, has no value or has an invalid value.
+ */
+static bool parse_args(int argc, char **argv, SHT3XPlanConfig *cfg)
+{
+    for (int i = 1; i < argc; i += 2) {
+        const char *arg = argv[i];
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Missing value of %s\n", arg);
+            return false;
+        }
+        const char *val = argv[i + 1];
+        uint32_t num;
+        bool ok;
+        if (strcmp(arg, "--bus-speed") == 0) {
+            ok = parse_u32(val, UINT32_MAX, &cfg->bus_speed_hz);
+        } else if (strcmp(arg, "--sensors") == 0) {
+            ok = parse_u32(val, UINT16_MAX, &num);
+            if (ok) {
+                cfg->num_sensors = (uint16_t)num;
+            }
+        } else if (strcmp(arg, "--mode") == 0) {
+            ok = parse_option(mode_options, SHT3X_PLAN_CLI_NUM_OPTIONS(mode_options), val, &cfg->meas_mode);
+        } else if (strcmp(arg, "--repeatability") == 0) {
+            ok = parse_option(repeatability_options, SHT3X_PLAN_CLI_NUM_OPTIONS(repeatability_options), val,
+                              &cfg->repeatability);
+        } else if (strcmp(arg, "--clock-stretching") == 0) {
+            ok = parse_option(clock_stretching_options, SHT3X_PLAN_CLI_NUM_OPTIONS(clock_stretching_options), val,
+                              &cfg->clock_stretching);
+        } else if (strcmp(arg, "--mps") == 0) {
+            ok = parse_option(mps_options, SHT3X_PLAN_CLI_NUM_OPTIONS(mps_options), val, &cfg->mps);
+        } else if (strcmp(arg, "--flags") == 0) {
+            ok = parse_flags(val, &cfg->flags);
+        } else if (strcmp(arg, "--interval") == 0) {
+            ok = parse_u32(val, UINT32_MAX, &cfg->sample_interval_ms);
+        } else {
+            fprintf(stderr, "Unknown option %s\n", arg);
+            return false;
+        }
+        if (!ok) {
+            fprintf(stderr, "Invalid value of %s: %s\n", arg, val);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--help") == 0) || (strcmp(argv[i], "-h") == 0)) {
+            print_usage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+    }
+
+    SHT3XPlanConfig cfg = {
+        .bus_speed_hz = 100000,
+        .num_sensors = 1,
+        .meas_mode = SHT3X_MEAS_MODE_SINGLE_SHOT,
+        .repeatability = SHT3X_MEAS_REPEATABILITY_HIGH,
+        .clock_stretching = SHT3X_CLOCK_STRETCHING_DISABLED,
+        .mps = SHT3X_MPS_1,
+        .flags = SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM,
+        .sample_interval_ms = 0,
+    };
+    if (!parse_args(argc, argv, &cfg)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    SHT3XPlan plan;
+    uint8_t rc = sht3x_plan(&cfg, &plan);
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        fprintf(stderr, "Invalid plan options, result code %u\n", rc);
+        return EXIT_FAILURE;
+    }
+
+    printf("sample_duration_us %lu\n", (unsigned long)plan.sample_duration_us);
+    printf("bus_time_per_sample_us %lu\n", (unsigned long)plan.bus_time_per_sample_us);
+    printf("min_sample_interval_us %lu\n", (unsigned long)plan.min_sample_interval_us);
+    printf("sample_interval_us %lu\n", (unsigned long)plan.sample_interval_us);
+    printf("samples_per_s %.3f\n", (double)plan.samples_per_s);
+    printf("occupancy_permille %u\n", (unsigned)plan.occupancy_permille);
+    printf("worst_case_sample_age_us %lu\n", (unsigned long)plan.worst_case_sample_age_us);
+    printf("meets_interval %s\n", plan.meets_interval ? "yes" : "no");
+    return EXIT_SUCCESS;
+}
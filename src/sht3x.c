@@ -11,13 +11,6 @@
  * value in RH%. */
 #define SHT3X_HUMIDITY_CONVERSION_MAGIC 0.001525902189669f
 
-/* From the datasheet - there must be at least 1 ms delay between two I2C commands received by the sensor. */
-#define SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS 1
-
-/* From the datasheet - the max amount of time between soft reset command is issued and when sensor is ready to process
- * I2C commands again. Rounded up. */
-#define SHT3X_SOFT_RESET_DELAY_MS 2
-
 /* From the datasheet, rounded up */
 #define SHT3X_MAX_MEASUREMENT_DURATION_HIGH_REPEATBILITY_MS 16
 #define SHT3X_MAX_MEASUREMENT_DURATION_MEDIUM_REPEATBILITY_MS 7
@@ -87,6 +80,16 @@
 #define SHT3X_READ_STATUS_REG_CMD_MSB 0xF3
 #define SHT3X_READ_STATUS_REG_CMD_LSB 0x2D
 
+/* Read serial number command code, clock stretching disabled */
+#define SHT3X_READ_SERIAL_NUMBER_CMD_MSB 0x37
+#define SHT3X_READ_SERIAL_NUMBER_CMD_LSB 0x80
+
+/* Device responds to read serial number command with two 16-bit words, each followed by a CRC */
+#define SHT3X_SERIAL_NUMBER_NUM_BYTES 6
+
+/* Combine command code MSB and LSB into a single value to be stored in a sequence step */
+#define SHT3X_CMD(msb, lsb) ((uint16_t)(((uint16_t)(msb) << 8) | (uint16_t)(lsb)))
+
 #define SHT3X_STATUS_REG_WRITE_DATA_CHECKSUM_STATUS_MASK (1U << 0)
 #define SHT3X_STATUS_REG_COMMAND_STATUS_MASK (1U << 1)
 #define SHT3X_STATUS_REG_SYSTEM_RESET_DETECTED_MASK (1U << 4)
@@ -95,14 +98,213 @@
 #define SHT3X_STATUS_REG_HEATER_STATUS_MASK (1U << 13)
 #define SHT3X_STATUS_REG_ALERT_PENDING_STATUS_MASK (1U << 15)
 
+/* From the datasheet - flags that are cleared by the clear status register command */
+#define SHT3X_STATUS_REG_CLEARABLE_FLAGS_MASK                                                                          \
+    (SHT3X_STATUS_REG_ALERT_PENDING_STATUS_MASK | SHT3X_STATUS_REG_RH_TRACKING_ALERT_MASK |                            \
+     SHT3X_STATUS_REG_T_TRACKING_ALERT_MASK | SHT3X_STATUS_REG_SYSTEM_RESET_DETECTED_MASK)
+/* From the datasheet - status register value after a reset: alert pending and system reset detected flags are set,
+ * all other flags are cleared. */
+#define SHT3X_STATUS_REG_DEFAULT_VAL                                                                                   \
+    (SHT3X_STATUS_REG_ALERT_PENDING_STATUS_MASK | SHT3X_STATUS_REG_SYSTEM_RESET_DETECTED_MASK)
+
+/* Status register flags that must be cleared after the device was reset and its status register was cleared */
+#define SHT3X_INIT_STATUS_REG_MUST_BE_CLEARED_MASK                                                                     \
+    (SHT3X_STATUS_REG_CLEARABLE_FLAGS_MASK | SHT3X_STATUS_REG_HEATER_STATUS_MASK |                                     \
+     SHT3X_STATUS_REG_COMMAND_STATUS_MASK | SHT3X_STATUS_REG_WRITE_DATA_CHECKSUM_STATUS_MASK)
+
+/* Layout of the snapshot blob. Bumped whenever the layout changes, so that a blob saved by a different firmware is
+ * rejected. */
+#define SHT3X_SNAPSHOT_VERSION 1
+#define SHT3X_SNAPSHOT_VERSION_IDX 0
+#define SHT3X_SNAPSHOT_I2C_ADDR_IDX 1
+#define SHT3X_SNAPSHOT_HEATER_STATE_IDX 2
+#define SHT3X_SNAPSHOT_MEAS_MODE_IDX 3
+#define SHT3X_SNAPSHOT_REPEATABILITY_IDX 4
+#define SHT3X_SNAPSHOT_MPS_IDX 5
+#define SHT3X_SNAPSHOT_STATUS_REG_IDX 6
+#define SHT3X_SNAPSHOT_STATUS_REG_VALID_IDX 8
+/* CRC over all preceding bytes */
+#define SHT3X_SNAPSHOT_CRC_IDX 9
+
+/* Bits of SHT3XLazyMeasurement.converted */
+#define SHT3X_LAZY_MEAS_TEMPERATURE_CONVERTED (1U << 0)
+#define SHT3X_LAZY_MEAS_HUMIDITY_CONVERTED (1U << 1)
+
+/* Layout of the quality word of a measurement. Each field is masked before it is shifted to its position. */
+#define SHT3X_QUALITY_FLAGS_MASK 0x0FU
+#define SHT3X_QUALITY_HEATER_STATE_POS 4
+#define SHT3X_QUALITY_HEATER_STATE_MASK 0x03U
+#define SHT3X_QUALITY_MEAS_MODE_POS 6
+#define SHT3X_QUALITY_MEAS_MODE_MASK 0x03U
+#define SHT3X_QUALITY_REPEATABILITY_POS 8
+#define SHT3X_QUALITY_REPEATABILITY_MASK 0x03U
+#define SHT3X_QUALITY_RETRY_COUNT_POS 10
+#define SHT3X_QUALITY_RETRY_COUNT_MASK 0x07U
+
+/* From the datasheet - ART mode samples at 4 Hz */
+#define SHT3X_ART_MEAS_PERIOD_MS 250
+
+/** Effect that a command sent in a sequence has on the tracked device state, once it is sent successfully. */
+typedef enum {
+    SHT3X_SHADOW_UPDATE_NONE,
+    SHT3X_SHADOW_UPDATE_HEATER_ON,
+    SHT3X_SHADOW_UPDATE_HEATER_OFF,
+    /** Repeatability and MPS are written to the instance before the command is sent. */
+    SHT3X_SHADOW_UPDATE_START_PERIODIC,
+    SHT3X_SHADOW_UPDATE_START_PERIODIC_ART,
+    SHT3X_SHADOW_UPDATE_STOP_PERIODIC,
+    SHT3X_SHADOW_UPDATE_SOFT_RESET,
+    SHT3X_SHADOW_UPDATE_CLEAR_STATUS_REG,
+} SHT3xShadowUpdate;
+
+/** Operation performed by a sequence step. */
+typedef enum {
+    /** Send a two-byte command. */
+    SHT3X_STEP_OP_WRITE,
+    /** Wait for a number of ms. */
+    SHT3X_STEP_OP_DELAY,
+    /** Read a number of bytes into i2c_read_buf. */
+    SHT3X_STEP_OP_READ,
+    /** Interpret i2c_read_buf as status register value with CRC, and fail the sequence if any of the flags in the step
+     * argument are set. Completes immediately. */
+    SHT3X_STEP_OP_VERIFY_STATUS_REG,
+    /** Interpret i2c_read_buf and execute the complete callback. Always the last step of a sequence. */
+    SHT3X_STEP_OP_PARSE,
+} SHT3xStepOp;
+
+/** How the PARSE step interprets the data that was read out. Also defines the callback type of sequence_cb. */
+typedef enum {
+    /** Nothing to interpret. sequence_cb is SHT3XCompleteCb. */
+    SHT3X_PARSE_KIND_NONE,
+    /** sequence_cb is SHT3XMeasCompleteCb, SHT3XLazyMeasCompleteCb or SHT3XExtMeasCompleteCb, depending on
+     * sequence_meas_result_type. */
+    SHT3X_PARSE_KIND_MEAS,
+    /** sequence_cb is SHT3XReadStatusRegCompleteCb. */
+    SHT3X_PARSE_KIND_STATUS_REG,
+    /** sequence_cb is SHT3XReadSerialNumberCompleteCb. */
+    SHT3X_PARSE_KIND_SERIAL_NUMBER,
+    /** sequence_cb is SHT3XInitSequenceCompleteCb. sequence_timer_period holds the time to first sample. */
+    SHT3X_PARSE_KIND_INIT,
+} SHT3xParseKind;
+
+/* Step argument is taken from the sequence data of the instance: sequence_cmd and sequence_shadow_update for WRITE,
+ * sequence_timer_period for DELAY, sequence_i2c_read_len for READ. */
+#define SHT3X_STEP_ARG_FROM_SEQUENCE 0
+
+/* Address NACK during this step means that there is no data to read out, rather than an IO error */
+#define SHT3X_STEP_FLAG_NACK_IS_NO_DATA (1U << 0)
+
+typedef struct {
+    /** One of @ref SHT3xStepOp. */
+    uint8_t op;
+    uint8_t flags;
+    /** WRITE with a command code in arg: effect of the command on the tracked device state, one of @ref
+     * SHT3xShadowUpdate. */
+    uint8_t shadow_update;
+    /** WRITE: command code. DELAY: period in ms. READ: number of bytes. VERIFY_STATUS_REG: mask of flags that must be
+     * cleared. PARSE: one of @ref SHT3xParseKind. */
+    uint16_t arg;
+} SHT3xStep;
+
+/** Defines which callback type the sequence_cb of a measurement sequence is. */
 typedef enum {
-    SHT3X_SEQUENCE_TYPE_GENERIC,
-    SHT3X_SEQUENCE_TYPE_READ_MEAS,
-    SHT3X_SEQUENCE_TYPE_SINGLE_SHOT_MEAS,
-    SHT3X_SEQUENCE_TYPE_READ_PERIODIC_MEAS,
-    /** There is currently no ongoing sequence. */
-    SHT3X_SEQUENCE_TYPE_NO_SEQ,
-} SHT3xSequenceType;
+    /** sequence_cb is a SHT3XMeasCompleteCb, measurements are converted before it is executed. */
+    SHT3X_MEAS_RESULT_TYPE_CONVERTED,
+    /** sequence_cb is a SHT3XLazyMeasCompleteCb, conversion is left to the caller. */
+    SHT3X_MEAS_RESULT_TYPE_LAZY,
+    /** sequence_cb is a SHT3XExtMeasCompleteCb, measurements are converted and passed with their quality metadata. */
+    SHT3X_MEAS_RESULT_TYPE_EXTENDED,
+} SHT3xMeasResultType;
+
+// clang-format off
+static const SHT3xStep write_cmd_steps[] = {
+    {SHT3X_STEP_OP_WRITE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_STEP_ARG_FROM_SEQUENCE},
+    {SHT3X_STEP_OP_PARSE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_PARSE_KIND_NONE},
+};
+
+/* Address NACK is not considered an error as a part of read measurement or read periodic measurement sequences. It
+ * is a valid scenario if the measurements are not available. To let the caller distinguish between this scenario and
+ * a generic IO error, a different code is returned when address NACK occurs during the readout. */
+static const SHT3xStep read_meas_steps[] = {
+    {SHT3X_STEP_OP_READ, SHT3X_STEP_FLAG_NACK_IS_NO_DATA, SHT3X_SHADOW_UPDATE_NONE, SHT3X_STEP_ARG_FROM_SEQUENCE},
+    {SHT3X_STEP_OP_PARSE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_PARSE_KIND_MEAS},
+};
+
+static const SHT3xStep single_shot_meas_steps[] = {
+    {SHT3X_STEP_OP_WRITE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_STEP_ARG_FROM_SEQUENCE},
+    {SHT3X_STEP_OP_DELAY, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_STEP_ARG_FROM_SEQUENCE},
+    {SHT3X_STEP_OP_READ, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_STEP_ARG_FROM_SEQUENCE},
+    {SHT3X_STEP_OP_PARSE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_PARSE_KIND_MEAS},
+};
+
+static const SHT3xStep read_periodic_meas_steps[] = {
+    {SHT3X_STEP_OP_WRITE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_STEP_ARG_FROM_SEQUENCE},
+    {SHT3X_STEP_OP_DELAY, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_STEP_ARG_FROM_SEQUENCE},
+    {SHT3X_STEP_OP_READ, SHT3X_STEP_FLAG_NACK_IS_NO_DATA, SHT3X_SHADOW_UPDATE_NONE, SHT3X_STEP_ARG_FROM_SEQUENCE},
+    {SHT3X_STEP_OP_PARSE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_PARSE_KIND_MEAS},
+};
+
+static const SHT3xStep soft_reset_with_delay_steps[] = {
+    {SHT3X_STEP_OP_WRITE, 0, SHT3X_SHADOW_UPDATE_SOFT_RESET, SHT3X_CMD(SHT3X_SOFT_RESET_CMD_MSB, SHT3X_SOFT_RESET_CMD_LSB)},
+    /* Give sensor time to perform soft reset */
+    {SHT3X_STEP_OP_DELAY, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_SOFT_RESET_DELAY_MS},
+    {SHT3X_STEP_OP_PARSE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_PARSE_KIND_NONE},
+};
+
+static const SHT3xStep read_status_reg_steps[] = {
+    {SHT3X_STEP_OP_WRITE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_CMD(SHT3X_READ_STATUS_REG_CMD_MSB, SHT3X_READ_STATUS_REG_CMD_LSB)},
+    {SHT3X_STEP_OP_DELAY, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS},
+    /* 2 bytes, or 3 bytes if CRC is verified */
+    {SHT3X_STEP_OP_READ, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_STEP_ARG_FROM_SEQUENCE},
+    {SHT3X_STEP_OP_PARSE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_PARSE_KIND_STATUS_REG},
+};
+
+static const SHT3xStep read_serial_number_steps[] = {
+    {SHT3X_STEP_OP_WRITE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_CMD(SHT3X_READ_SERIAL_NUMBER_CMD_MSB, SHT3X_READ_SERIAL_NUMBER_CMD_LSB)},
+    {SHT3X_STEP_OP_DELAY, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS},
+    {SHT3X_STEP_OP_READ, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_SERIAL_NUMBER_NUM_BYTES},
+    {SHT3X_STEP_OP_PARSE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_PARSE_KIND_SERIAL_NUMBER},
+};
+
+/* Minimal legal spacing: soft reset time after the reset, and the mandatory delay between commands otherwise */
+static const SHT3xStep init_steps[] = {
+    {SHT3X_STEP_OP_WRITE, 0, SHT3X_SHADOW_UPDATE_SOFT_RESET, SHT3X_CMD(SHT3X_SOFT_RESET_CMD_MSB, SHT3X_SOFT_RESET_CMD_LSB)},
+    {SHT3X_STEP_OP_DELAY, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_SOFT_RESET_DELAY_MS},
+    {SHT3X_STEP_OP_WRITE, 0, SHT3X_SHADOW_UPDATE_CLEAR_STATUS_REG, SHT3X_CMD(SHT3X_CLEAR_STATUS_REGISTER_CMD_MSB, SHT3X_CLEAR_STATUS_REGISTER_CMD_LSB)},
+    {SHT3X_STEP_OP_DELAY, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS},
+    /* Start periodic measurement or ART */
+    {SHT3X_STEP_OP_WRITE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_STEP_ARG_FROM_SEQUENCE},
+    {SHT3X_STEP_OP_PARSE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_PARSE_KIND_INIT},
+};
+
+static const SHT3xStep init_verify_steps[] = {
+    {SHT3X_STEP_OP_WRITE, 0, SHT3X_SHADOW_UPDATE_SOFT_RESET, SHT3X_CMD(SHT3X_SOFT_RESET_CMD_MSB, SHT3X_SOFT_RESET_CMD_LSB)},
+    {SHT3X_STEP_OP_DELAY, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_SOFT_RESET_DELAY_MS},
+    {SHT3X_STEP_OP_WRITE, 0, SHT3X_SHADOW_UPDATE_CLEAR_STATUS_REG, SHT3X_CMD(SHT3X_CLEAR_STATUS_REGISTER_CMD_MSB, SHT3X_CLEAR_STATUS_REGISTER_CMD_LSB)},
+    {SHT3X_STEP_OP_DELAY, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS},
+    {SHT3X_STEP_OP_WRITE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_CMD(SHT3X_READ_STATUS_REG_CMD_MSB, SHT3X_READ_STATUS_REG_CMD_LSB)},
+    {SHT3X_STEP_OP_DELAY, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS},
+    /* Status register value and its CRC */
+    {SHT3X_STEP_OP_READ, 0, SHT3X_SHADOW_UPDATE_NONE, 3},
+    {SHT3X_STEP_OP_VERIFY_STATUS_REG, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_INIT_STATUS_REG_MUST_BE_CLEARED_MASK},
+    /* No delay needed, the read status register command was sent at least 1 ms ago */
+    {SHT3X_STEP_OP_WRITE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_STEP_ARG_FROM_SEQUENCE},
+    {SHT3X_STEP_OP_PARSE, 0, SHT3X_SHADOW_UPDATE_NONE, SHT3X_PARSE_KIND_INIT},
+};
+
+/* Indexed by SHT3XSequenceType. Each sequence type has a table of steps. */
+static const SHT3xStep *const sequence_steps[] = {
+    [SHT3X_SEQUENCE_TYPE_WRITE_CMD] = write_cmd_steps,
+    [SHT3X_SEQUENCE_TYPE_READ_MEAS] = read_meas_steps,
+    [SHT3X_SEQUENCE_TYPE_SINGLE_SHOT_MEAS] = single_shot_meas_steps,
+    [SHT3X_SEQUENCE_TYPE_READ_PERIODIC_MEAS] = read_periodic_meas_steps,
+    [SHT3X_SEQUENCE_TYPE_SOFT_RESET_WITH_DELAY] = soft_reset_with_delay_steps,
+    [SHT3X_SEQUENCE_TYPE_READ_STATUS_REG] = read_status_reg_steps,
+    [SHT3X_SEQUENCE_TYPE_READ_SERIAL_NUMBER] = read_serial_number_steps,
+    [SHT3X_SEQUENCE_TYPE_INIT] = init_steps,
+    [SHT3X_SEQUENCE_TYPE_INIT_VERIFY] = init_verify_steps,
+};
+// clang-format on
 
 /**
  * @brief Check whether SHT3X I2C address is valid.
@@ -230,18 +432,21 @@ static uint16_t two_big_endian_bytes_to_uint16(const uint8_t *const bytes)
 }
 
 /**
- * @brief Run SHT3X CRC algorithm on two bytes.
+ * @brief Run SHT3X CRC algorithm on a number of bytes.
+ *
+ * The device sends a CRC over every two bytes of data, so @p length is 2 for all data received from the device.
+ *
+ * @param[in] data Bytes at this address are used for CRC calculation.
+ * @param[in] length Number of bytes.
  *
- * @param[in] data Two bytes at this address are used for CRC calculation.
-
  * @return uint8_t Resulting CRC.
  */
-static uint8_t sht3x_crc8(const uint8_t *const data)
+static uint8_t sht3x_crc8(const uint8_t *const data, size_t length)
 {
     uint8_t crc = 0xFF;
     const uint8_t poly = 0x31;
 
-    for (size_t i = 0; i < 2; i++) {
+    for (size_t i = 0; i < length; i++) {
         crc ^= data[i];
         for (uint8_t bit = 0; bit < 8; bit++) {
             if (crc & 0x80) {
@@ -258,32 +463,28 @@ static uint8_t sht3x_crc8(const uint8_t *const data)
 /**
  * @brief Convert raw temperature measurement to temperature in celsius.
  *
- * @param[in] raw_temp Should point to 2 bytes that are raw temperature measurement read out from the device.
+ * @param[in] raw_temp Raw temperature measurement read out from the device, in target endianness.
  *
  * @return float Resulting temperature in Celsius.
  */
-static float convert_raw_temp_meas_to_celsius(const uint8_t *const raw_temp)
+static float convert_raw_temp_meas_to_celsius(uint16_t raw_temp)
 {
-    /* Device sends raw measurements in big endian, convert to a 16-bit value in target endianness */
-    uint16_t raw_temp_val = two_big_endian_bytes_to_uint16(raw_temp);
     /* Based on conversion formula from the SHT3X datasheet, p. 14, section 4.13. */
-    float temperature_celsius = (SHT3X_TEMPERATURE_CONVERSION_MAGIC * (float)raw_temp_val) - 45;
+    float temperature_celsius = (SHT3X_TEMPERATURE_CONVERSION_MAGIC * (float)raw_temp) - 45;
     return temperature_celsius;
 }
 
 /**
  * @brief Convert raw humidity measurement to humidity in RH%.
  *
- * @param[in] raw_humidity Should point to 2 bytes that are raw humidity measurement read out from the device.
+ * @param[in] raw_humidity Raw humidity measurement read out from the device, in target endianness.
  *
  * @return float Resulting humidity in RH%.
  */
-static float convert_raw_humidity_meas_to_rh(const uint8_t *const raw_humidity)
+static float convert_raw_humidity_meas_to_rh(uint16_t raw_humidity)
 {
-    /* Device sends raw measurements in big endian, convert to a 16-bit value in target endianness */
-    uint16_t raw_humidity_val = two_big_endian_bytes_to_uint16(raw_humidity);
     /* Based on conversion formula from the SHT3X datasheet, p. 14, section 4.13. */
-    float humidity_rh = SHT3X_HUMIDITY_CONVERSION_MAGIC * (float)raw_humidity_val;
+    float humidity_rh = SHT3X_HUMIDITY_CONVERSION_MAGIC * (float)raw_humidity;
     return humidity_rh;
 }
 
@@ -501,6 +702,35 @@ static size_t map_read_meas_flags_to_num_bytes_to_read(uint8_t flags)
     return num_bytes;
 }
 
+#ifdef SHT3X_ENABLE_TRACE
+/**
+ * @brief Execute the trace hook of the instance, if there is one.
+ *
+ * @param[in] self SHT3X instance.
+ * @param[in] type Use @ref SHT3XTraceEventType.
+ * @param[in] result_code Result of a completion event, 0 otherwise.
+ * @param[in] arg Event-specific argument.
+ */
+static void trace(SHT3X self, uint8_t type, uint8_t result_code, uint32_t arg)
+{
+    if (!self->trace_hook) {
+        return;
+    }
+    SHT3XTraceEvent event = {
+        .instance = self,
+        .type = type,
+        .sequence_type = self->sequence_type,
+        .result_code = result_code,
+        .arg = arg,
+    };
+    self->trace_hook(&event, self->trace_hook_user_data);
+}
+
+#define SHT3X_TRACE(self, type, result_code, arg) trace((self), (type), (result_code), (arg))
+#else
+#define SHT3X_TRACE(self, type, result_code, arg) ((void)0)
+#endif
+
 /**
  * @brief Resets all sequence-related data and marks that there is currently no ongoing sequence.
  *
@@ -512,260 +742,402 @@ static void reset_sequence_data(SHT3X self)
     self->sequence_cb_user_data = NULL;
     /* No ongoing sequence */
     self->sequence_type = SHT3X_SEQUENCE_TYPE_NO_SEQ;
+    self->sequence_step = 0;
+    self->sequence_cmd[0] = 0;
+    self->sequence_cmd[1] = 0;
     self->sequence_flags = 0;
     self->sequence_i2c_read_len = 0;
     self->sequence_timer_period = 0;
+    self->sequence_meas_result_type = SHT3X_MEAS_RESULT_TYPE_CONVERTED;
+    self->sequence_shadow_update = SHT3X_SHADOW_UPDATE_NONE;
 }
 
 /**
- * @brief Check whether there is currently an ongoing sequence.
- *
- * A sequence is ongoing when a public function of this driver has been called, but not all steps have been completed
- * yet. For example, "start periodic measurement" command has been sent, but I2C callback has not arrived yet. This
- * means that the I2C write is still in progress, and the driver should not attempt to start another sequence.
+ * @brief Mark the end of the current sequence, and reset all sequence-related data.
  *
  * @param[in] self SHT3X instance.
- *
- * @retval true Sequence ongoing.
- * @retval false There is no ongoing sequence.
+ * @param[in] rc Result code that the complete callback of the sequence is executed with.
  */
-static bool is_sequence_ongoing(SHT3X self)
+static void end_sequence(SHT3X self, uint8_t rc)
 {
-    return (self->sequence_type != SHT3X_SEQUENCE_TYPE_NO_SEQ);
+    SHT3X_TRACE(self, SHT3X_TRACE_EVENT_SEQUENCE_END, rc, 0);
+    /* Only used by the tracepoint, which compiles to nothing without SHT3X_ENABLE_TRACE */
+    (void)rc;
+    reset_sequence_data(self);
 }
 
 /**
- * @brief Start a generic sequence.
+ * @brief Mark all tracked device state as unknown.
  *
  * @param[in] self SHT3X instance.
- * @param[in] sequence_type Sequence type.
- * @param[in] cb Callback to execute once the sequence is complete.
- * @param[in] cb_user_data User data to pass to @p cb.
  */
-static void start_sequence(SHT3X self, uint8_t seq_type, void *cb, void *cb_user_data)
+static void invalidate_shadow_state(SHT3X self)
 {
-    self->sequence_cb = cb;
-    self->sequence_cb_user_data = cb_user_data;
-    self->sequence_type = seq_type;
+    self->heater_state = SHT3X_HEATER_STATE_UNKNOWN;
+    self->meas_mode = SHT3X_MEAS_MODE_UNKNOWN;
+    self->periodic_repeatability = 0;
+    self->periodic_mps = 0;
+    self->single_shot_repeatability = SHT3X_QUALITY_REPEATABILITY_UNKNOWN;
+    self->status_reg = 0;
+    self->status_reg_valid = false;
 }
 
 /**
- * @brief Start a measurement sequence.
+ * @brief Update tracked device state after a command was sent.
  *
- * @param[in] self SHT3X instance.
- * @param[in] cb Callback to execute once the sequence is complete.
- * @param[in] cb_user_data User data to pass to @p cb.
- * @param[in] sequence_type Sequence type.
- * @param[in] flags Read flags. Determine how many bytes are read during the measurement readout, as well as what
- * measurements (temperature/humidity) are read out, and whether temperature/humidity CRC is validated.
- * @param[in] timer_period Time to wait between sending the initial I2C write command and sending the measurement
- * readout I2C command.
- */
-static void start_meas_seq(SHT3X self, SHT3XMeasCompleteCb cb, void *cb_user_data, uint8_t sequence_type, uint8_t flags,
-                           uint32_t timer_period)
-{
-    self->sequence_cb = (void *)cb;
-    self->sequence_cb_user_data = cb_user_data;
-    self->sequence_type = sequence_type;
-    self->sequence_flags = flags;
-    self->sequence_timer_period = timer_period;
-}
-
-/**
- * @brief Thin wrapper around i2c_write for sending fetch data command.
+ * If the command failed, the device may or may not have received it, so the state that the command affects becomes
+ * unknown.
  *
  * @param[in] self SHT3X instance.
- * @param[in] cb Callback to execute once complete.
- * @param[in] user_data User data to pass to callback.
+ * @param[in] shadow_update Effect of the command on the tracked device state, use @ref SHT3xShadowUpdate.
+ * @param[in] success true if the command was sent successfully, false otherwise.
  */
-static void send_fetch_data_cmd(SHT3X self, SHT3X_I2CTransactionCompleteCb cb, void *user_data)
+static void apply_shadow_update(SHT3X self, uint8_t shadow_update, bool success)
 {
-    uint8_t cmd[2] = {SHT3X_FETCH_PERIODIC_MEAS_DATA_CMD_MSB, SHT3X_FETCH_PERIODIC_MEAS_DATA_CMD_LSB};
-    self->i2c_write(cmd, 2, self->i2c_addr, self->i2c_write_user_data, cb, user_data);
+    switch (shadow_update) {
+    case SHT3X_SHADOW_UPDATE_HEATER_ON:
+        if (success) {
+            self->heater_state = SHT3X_HEATER_STATE_ON;
+            self->status_reg |= (uint16_t)SHT3X_STATUS_REG_HEATER_STATUS_MASK;
+        } else {
+            self->heater_state = SHT3X_HEATER_STATE_UNKNOWN;
+            self->status_reg_valid = false;
+        }
+        break;
+    case SHT3X_SHADOW_UPDATE_HEATER_OFF:
+        if (success) {
+            self->heater_state = SHT3X_HEATER_STATE_OFF;
+            self->status_reg &= (uint16_t)~SHT3X_STATUS_REG_HEATER_STATUS_MASK;
+        } else {
+            self->heater_state = SHT3X_HEATER_STATE_UNKNOWN;
+            self->status_reg_valid = false;
+        }
+        break;
+    case SHT3X_SHADOW_UPDATE_START_PERIODIC:
+        self->meas_mode = success ? SHT3X_MEAS_MODE_PERIODIC : SHT3X_MEAS_MODE_UNKNOWN;
+        break;
+    case SHT3X_SHADOW_UPDATE_START_PERIODIC_ART:
+        self->meas_mode = success ? SHT3X_MEAS_MODE_PERIODIC_ART : SHT3X_MEAS_MODE_UNKNOWN;
+        break;
+    case SHT3X_SHADOW_UPDATE_STOP_PERIODIC:
+        self->meas_mode = success ? SHT3X_MEAS_MODE_SINGLE_SHOT : SHT3X_MEAS_MODE_UNKNOWN;
+        break;
+    case SHT3X_SHADOW_UPDATE_SOFT_RESET:
+        if (success) {
+            /* Device is back in its default state */
+            self->heater_state = SHT3X_HEATER_STATE_OFF;
+            self->meas_mode = SHT3X_MEAS_MODE_SINGLE_SHOT;
+            self->status_reg = SHT3X_STATUS_REG_DEFAULT_VAL;
+            self->status_reg_valid = true;
+        } else {
+            invalidate_shadow_state(self);
+        }
+        break;
+    case SHT3X_SHADOW_UPDATE_CLEAR_STATUS_REG:
+        if (success) {
+            self->status_reg &= (uint16_t)~SHT3X_STATUS_REG_CLEARABLE_FLAGS_MASK;
+        } else {
+            self->status_reg_valid = false;
+        }
+        break;
+    default:
+        break;
+    }
 }
 
 /**
- * @brief Thin wrapper around i2c_read for sending a read command.
+ * @brief Update tracked device state with a status register value that was read out from the device.
+ *
+ * If the system reset detected flag is set, and it was not known to be set before, the device went through a reset
+ * that the driver did not initiate. In that case, the tracked measurement mode is no longer known.
  *
  * @param[in] self SHT3X instance.
- * @param[in] length Number of bytes to read out from the device.
- * @param[in] cb Callback to execute once complete.
- * @param[in] user_data User data to pass to callback.
+ * @param[in] status_reg_val Status register value read out from the device.
  */
-static void send_read_cmd(SHT3X self, size_t length, SHT3X_I2CTransactionCompleteCb cb, void *user_data)
+static void update_shadow_status_reg(SHT3X self, uint16_t status_reg_val)
 {
-    self->i2c_read(self->i2c_read_buf, length, self->i2c_addr, self->i2c_read_user_data, cb, user_data);
+    bool reset_flag_known_set =
+        self->status_reg_valid && (self->status_reg & (uint16_t)SHT3X_STATUS_REG_SYSTEM_RESET_DETECTED_MASK);
+    if (sht3x_is_system_reset_detected(status_reg_val) && !reset_flag_known_set) {
+        invalidate_shadow_state(self);
+    }
+    self->status_reg = status_reg_val;
+    self->status_reg_valid = true;
+    self->heater_state = sht3x_is_heater_on(status_reg_val) ? SHT3X_HEATER_STATE_ON : SHT3X_HEATER_STATE_OFF;
 }
 
 /**
- * @brief Thin wrapper around i2c_write for sending read status register command.
+ * @brief Check whether the device is known to be performing periodic measurements.
  *
  * @param[in] self SHT3X instance.
- * @param[in] cb Callback to execute once complete.
- * @param[in] user_data User data to pass to callback.
+ *
+ * @retval true Device is known to be in periodic or ART mode. Single shot commands are not accepted by the device.
+ * @retval false Device is known to be in single shot mode, or the mode is unknown.
  */
-static void send_read_status_reg_cmd(SHT3X self, SHT3X_I2CTransactionCompleteCb cb, void *user_data)
+static bool is_periodic_mode_known(SHT3X self)
 {
-    uint8_t cmd[2] = {SHT3X_READ_STATUS_REG_CMD_MSB, SHT3X_READ_STATUS_REG_CMD_LSB};
-    self->i2c_write(cmd, 2, self->i2c_addr, self->i2c_write_user_data, cb, user_data);
+    return (self->meas_mode == SHT3X_MEAS_MODE_PERIODIC) || (self->meas_mode == SHT3X_MEAS_MODE_PERIODIC_ART);
 }
 
 /**
- * @brief Thin wrapper around i2c_write for sending soft reset command.
+ * @brief Check whether the device is known to be in single shot mode.
  *
  * @param[in] self SHT3X instance.
- * @param[in] cb Callback to execute once complete.
- * @param[in] user_data User data to pass to callback.
+ *
+ * @retval true Device is known to be in single shot mode. There is no periodic measurement data to fetch.
+ * @retval false Device is known to be in periodic or ART mode, or the mode is unknown.
  */
-static void send_soft_reset_cmd(SHT3X self, SHT3X_I2CTransactionCompleteCb cb, void *user_data)
+static bool is_single_shot_mode_known(SHT3X self)
 {
-    uint8_t cmd[2] = {SHT3X_SOFT_RESET_CMD_MSB, SHT3X_SOFT_RESET_CMD_LSB};
-    self->i2c_write(cmd, 2, self->i2c_addr, self->i2c_write_user_data, cb, user_data);
+    return self->meas_mode == SHT3X_MEAS_MODE_SINGLE_SHOT;
 }
 
 /**
- * @brief Send single shot measurement command.
+ * @brief Complete a sequence without performing any I2C transactions.
  *
- * @param[in] self SHT3X instance.
- * @param[in] repeatability Repeatability option. Use @ref SHT3XMeasRepeatability.
- * @param[in] clock_stretching Clock stretching option. Use @ref SHT3XClockStretching.
- * @param[in] cb Callback to execute once complete.
- * @param[in] user_data User data to pass to callback.
+ * Used when the tracked device state shows that sending the command would not change anything on the device.
  *
- * @retval SHT3X_RESULT_CODE_OK Successfully sent command.
- * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self is NULL, @p repeatability option is invalid, or @p clock_stretching
- * option is invalid.
+ * @param[in] cb Callback to execute. Can be NULL.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @return uint8_t Always SHT3X_RESULT_CODE_OK.
  */
-static uint8_t send_single_shot_meas_cmd(SHT3X self, uint8_t repeatability, uint8_t clock_stretching,
-                                         SHT3X_I2CTransactionCompleteCb cb, void *user_data)
+static uint8_t complete_locally(SHT3XCompleteCb cb, void *user_data)
 {
-    if (!self) {
-        return SHT3X_RESULT_CODE_INVALID_ARG;
-    }
-
-    uint8_t cmd[2];
-    uint8_t rc = get_single_shot_meas_command_code(repeatability, clock_stretching, cmd);
-    if (rc != SHT3X_RESULT_CODE_OK) {
-        /* Invalid repeatability or clock stretching option. */
-        return SHT3X_RESULT_CODE_INVALID_ARG;
+    if (cb) {
+        cb(SHT3X_RESULT_CODE_OK, user_data);
     }
-    self->i2c_write(cmd, 2, self->i2c_addr, self->i2c_write_user_data, cb, user_data);
     return SHT3X_RESULT_CODE_OK;
 }
 
 /**
- * @brief Send start periodic measurement command.
+ * @brief Check whether there is currently an ongoing sequence.
+ *
+ * A sequence is ongoing when a public function of this driver has been called, but not all steps have been completed
+ * yet. For example, "start periodic measurement" command has been sent, but I2C callback has not arrived yet. This
+ * means that the I2C write is still in progress, and the driver should not attempt to start another sequence.
  *
  * @param[in] self SHT3X instance.
- * @param[in] repeatability Repeatability option. Use @ref SHT3XMeasRepeatability.
- * @param[in] mps MPS option. Use @ref SHT3XMps.
- * @param[in] cb Callback to execute once complete.
- * @param[in] user_data User data to pass to callback.
  *
- * @retval SHT3X_RESULT_CODE_OK Successfully sent command.
- * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self is NULL, @p repeatability option is invalid, or @p mps option is
- * invalid.
+ * @retval true Sequence ongoing.
+ * @retval false There is no ongoing sequence.
  */
-static uint8_t send_start_periodic_meas_cmd(SHT3X self, uint8_t repeatability, uint8_t mps,
-                                            SHT3X_I2CTransactionCompleteCb cb, void *user_data)
+static bool is_sequence_ongoing(SHT3X self)
 {
-    if (!self) {
-        return SHT3X_RESULT_CODE_INVALID_ARG;
-    }
-
-    uint8_t cmd[2];
-    uint8_t rc = get_start_periodic_meas_cmd(repeatability, mps, cmd);
-    if (rc != SHT3X_RESULT_CODE_OK) {
-        /* Invalid repeatability or MPS option. */
-        return SHT3X_RESULT_CODE_INVALID_ARG;
-    }
-    self->i2c_write(cmd, 2, self->i2c_addr, self->i2c_write_user_data, cb, user_data);
-    return SHT3X_RESULT_CODE_OK;
+    return (self->sequence_type != SHT3X_SEQUENCE_TYPE_NO_SEQ);
 }
 
 /**
- * @brief Thin wrapper around i2c_write for sending start periodic measurement ART command.
+ * @brief Start a generic sequence.
  *
  * @param[in] self SHT3X instance.
- * @param[in] cb Callback to execute once complete.
- * @param[in] user_data User data to pass to callback.
+ * @param[in] sequence_type Sequence type.
+ * @param[in] cb Callback to execute once the sequence is complete.
+ * @param[in] cb_user_data User data to pass to @p cb.
  */
-static void send_start_periodic_meas_art_cmd(SHT3X self, SHT3X_I2CTransactionCompleteCb cb, void *user_data)
+static void start_sequence(SHT3X self, uint8_t seq_type, void *cb, void *cb_user_data)
 {
-    uint8_t cmd[2] = {SHT3X_ART_CMD_MSB, SHT3X_ART_CMD_LSB};
-    self->i2c_write(cmd, 2, self->i2c_addr, self->i2c_write_user_data, cb, user_data);
+    self->sequence_cb = cb;
+    self->sequence_cb_user_data = cb_user_data;
+    self->sequence_type = seq_type;
+    self->sequence_step = 0;
+    SHT3X_TRACE(self, SHT3X_TRACE_EVENT_SEQUENCE_START, 0, 0);
 }
 
 /**
- * @brief Thin wrapper around i2c_write for sending stop periodic measurement command.
+ * @brief Start a measurement sequence.
  *
  * @param[in] self SHT3X instance.
- * @param[in] cb Callback to execute once complete.
- * @param[in] user_data User data to pass to callback.
+ * @param[in] cb Callback to execute once the sequence is complete. Its type is defined by @p result_type.
+ * @param[in] cb_user_data User data to pass to @p cb.
+ * @param[in] result_type Use @ref SHT3xMeasResultType. Defines whether @p cb is a SHT3XMeasCompleteCb or a
+ * SHT3XLazyMeasCompleteCb.
+ * @param[in] sequence_type Sequence type.
+ * @param[in] flags Read flags. Determine how many bytes are read during the measurement readout, as well as what
+ * measurements (temperature/humidity) are read out, and whether temperature/humidity CRC is validated.
+ * @param[in] timer_period Time to wait between sending the initial I2C write command and sending the measurement
+ * readout I2C command.
  */
-static void send_stop_periodic_meas_cmd(SHT3X self, SHT3X_I2CTransactionCompleteCb cb, void *user_data)
+static void start_meas_seq(SHT3X self, void *cb, void *cb_user_data, uint8_t result_type, uint8_t sequence_type,
+                           uint8_t flags, uint32_t timer_period)
 {
-    uint8_t cmd[2] = {SHT3X_STOP_PERIODIC_MEAS_CMD_MSB, SHT3X_STOP_PERIODIC_MEAS_CMD_LSB};
-    self->i2c_write(cmd, 2, self->i2c_addr, self->i2c_write_user_data, cb, user_data);
+    self->sequence_cb = cb;
+    self->sequence_cb_user_data = cb_user_data;
+    self->sequence_meas_result_type = result_type;
+    self->sequence_type = sequence_type;
+    self->sequence_step = 0;
+    self->sequence_flags = flags;
+    self->sequence_timer_period = timer_period;
+    SHT3X_TRACE(self, SHT3X_TRACE_EVENT_SEQUENCE_START, 0, 0);
 }
 
 /**
- * @brief Thin wrapper around i2c_write for sending enable heater command.
+ * @brief Reset all health monitor counters.
  *
  * @param[in] self SHT3X instance.
- * @param[in] cb Callback to execute once complete.
- * @param[in] user_data User data to pass to callback.
  */
-static void send_enable_heater_cmd(SHT3X self, SHT3X_I2CTransactionCompleteCb cb, void *user_data)
+static void reset_health_counters(SHT3X self)
 {
-    uint8_t cmd[2] = {SHT3X_ENABLE_HEATER_CMD_MSB, SHT3X_ENABLE_HEATER_CMD_LSB};
-    self->i2c_write(cmd, 2, self->i2c_addr, self->i2c_write_user_data, cb, user_data);
+    self->health_last_raw_temperature = 0;
+    self->health_last_raw_humidity = 0;
+    self->health_last_flags = 0;
+    self->health_identical_count = 0;
+    self->health_crc_history = 0;
+    self->health_window_crc_errors = 0;
+    self->health_no_data_count = 0;
 }
 
 /**
- * @brief Thin wrapper around i2c_write for sending disable heater command.
+ * @brief Increment a health monitor counter, and check whether it just reached its threshold.
  *
- * @param[in] self SHT3X instance.
- * @param[in] cb Callback to execute once complete.
- * @param[in] user_data User data to pass to callback.
+ * @param[in,out] counter Counter to increment. Saturates at UINT16_MAX.
+ * @param[in] threshold Threshold. 0 means that the event is disabled.
+ *
+ * @retval true Counter just reached @p threshold.
+ * @retval false Otherwise.
  */
-static void send_disable_heater_cmd(SHT3X self, SHT3X_I2CTransactionCompleteCb cb, void *user_data)
+static bool health_counter_increment(uint16_t *counter, uint16_t threshold)
 {
-    uint8_t cmd[2] = {SHT3X_DISABLE_HEATER_CMD_MSB, SHT3X_DISABLE_HEATER_CMD_LSB};
-    self->i2c_write(cmd, 2, self->i2c_addr, self->i2c_write_user_data, cb, user_data);
+    if (*counter < UINT16_MAX) {
+        (*counter)++;
+    }
+    return (threshold != 0) && (*counter == threshold);
 }
 
 /**
- * @brief Thin wrapper around i2c_write for sending clear status register command.
+ * @brief Update health monitor with the outcome of a measurement readout.
  *
  * @param[in] self SHT3X instance.
- * @param[in] cb Callback to execute once complete.
- * @param[in] user_data User data to pass to callback.
+ * @param[in] rc Result code of the readout.
+ * @param[in] lazy_meas Measurement that was read out. NULL if @p rc is not SHT3X_RESULT_CODE_OK.
+ * @param[out] event Raised event is written here, if true is returned.
+ *
+ * @retval true An event was raised.
+ * @retval false No event was raised, or the health monitor is disabled.
  */
-static void send_clear_status_reg_cmd(SHT3X self, SHT3X_I2CTransactionCompleteCb cb, void *user_data)
+static bool update_health(SHT3X self, uint8_t rc, const SHT3XLazyMeasurement *lazy_meas, uint8_t *event)
 {
-    uint8_t cmd[2] = {SHT3X_CLEAR_STATUS_REGISTER_CMD_MSB, SHT3X_CLEAR_STATUS_REGISTER_CMD_LSB};
-    self->i2c_write(cmd, 2, self->i2c_addr, self->i2c_write_user_data, cb, user_data);
+    if (!self->health_cb) {
+        return false;
+    }
+    bool raised = false;
+
+    if (rc == SHT3X_RESULT_CODE_NO_DATA) {
+        if (health_counter_increment(&(self->health_no_data_count), self->health_no_data_threshold)) {
+            *event = SHT3X_HEALTH_EVENT_NO_DATA;
+            raised = true;
+        }
+    } else {
+        self->health_no_data_count = 0;
+    }
+
+    if (self->health_crc_window > 0) {
+        /* Slide the window by one readout: the oldest outcome leaves it, and this one enters it */
+        bool crc_mismatch = (rc == SHT3X_RESULT_CODE_CRC_MISMATCH);
+        bool oldest_crc_mismatch = ((self->health_crc_history >> (self->health_crc_window - 1)) & 1U) != 0;
+        uint32_t window_mask = (self->health_crc_window < 32) ? ((1UL << self->health_crc_window) - 1) : UINT32_MAX;
+        self->health_crc_history = ((self->health_crc_history << 1) | (crc_mismatch ? 1U : 0U)) & window_mask;
+        if (oldest_crc_mismatch) {
+            self->health_window_crc_errors--;
+        }
+        if (crc_mismatch) {
+            if (health_counter_increment(&(self->health_window_crc_errors), self->health_crc_error_threshold) &&
+                !oldest_crc_mismatch) {
+                /* Only fire when the count rises to the threshold, not when an error replaces an evicted one */
+                *event = SHT3X_HEALTH_EVENT_CRC_ERROR_RATE;
+                raised = true;
+            }
+        }
+    }
+
+    if ((rc == SHT3X_RESULT_CODE_OK) && lazy_meas) {
+        bool identical = (self->health_identical_count > 0) && (lazy_meas->flags == self->health_last_flags) &&
+                         (lazy_meas->raw_temperature == self->health_last_raw_temperature) &&
+                         (lazy_meas->raw_humidity == self->health_last_raw_humidity);
+        if (!identical) {
+            /* This readout starts a new run of identical values */
+            self->health_identical_count = 0;
+            self->health_last_flags = lazy_meas->flags;
+            self->health_last_raw_temperature = lazy_meas->raw_temperature;
+            self->health_last_raw_humidity = lazy_meas->raw_humidity;
+        }
+        if (health_counter_increment(&(self->health_identical_count), self->health_stuck_threshold)) {
+            *event = SHT3X_HEALTH_EVENT_STUCK_VALUE;
+            raised = true;
+        }
+    }
+
+    return raised;
 }
 
 /**
- * @brief Interpret self->sequence_cb as MeasCompleteCb and execute it, if available.
+ * @brief Interpret self->sequence_cb as MeasCompleteCb, LazyMeasCompleteCb or ExtMeasCompleteCb and execute it, if
+ * available.
+ *
+ * If the sequence was started with @ref SHT3X_MEAS_RESULT_TYPE_CONVERTED or @ref SHT3X_MEAS_RESULT_TYPE_EXTENDED, the
+ * requested values of @p lazy_meas are converted here, right before the callback is executed. Otherwise, @p lazy_meas
+ * is passed to the callback as is.
  *
  * @param[in] self SHT3X instance.
- * @param[in] rc Return code to pass to MeasCompleteCb, use @ref SHT3XResultCode.
- * @param[in] meas Measurement pointer to pass to MeasCompleteCb. Can be NULL.
+ * @param[in] rc Return code to pass to the callback, use @ref SHT3XResultCode.
+ * @param[in] lazy_meas Measurement that was read out. Can be NULL.
  */
-static void execute_meas_complete_cb(SHT3X self, uint8_t rc, SHT3XMeasurement *meas)
+static void execute_meas_complete_cb(SHT3X self, uint8_t rc, SHT3XLazyMeasurement *lazy_meas)
 {
     if (!self) {
         return;
     }
-    SHT3XMeasCompleteCb cb = (SHT3XMeasCompleteCb)self->sequence_cb;
+    void *cb = self->sequence_cb;
     void *user_data = self->sequence_cb_user_data;
+    uint8_t result_type = self->sequence_meas_result_type;
+    uint8_t health_event;
+    bool health_event_raised = update_health(self, rc, lazy_meas, &health_event);
+    /* Reported as retry count in the quality word of the next measurement */
+    if (rc == SHT3X_RESULT_CODE_OK) {
+        self->meas_failure_count = 0;
+    } else if (self->meas_failure_count < SHT3X_QUALITY_MAX_RETRY_COUNT) {
+        self->meas_failure_count++;
+    }
+    /* Captured before the complete callback is executed, because the instance could be destroyed from it */
+    SHT3XHealthEventCb health_cb = self->health_cb;
+    void *health_cb_user_data = self->health_cb_user_data;
     /* Public functions can now be called again - sequence complete */
-    reset_sequence_data(self);
-    if (cb) {
-        cb(rc, meas, user_data);
+    end_sequence(self, rc);
+
+    if (!cb) {
+        /* Nothing to execute */
+    } else if (result_type == SHT3X_MEAS_RESULT_TYPE_LAZY) {
+        ((SHT3XLazyMeasCompleteCb)cb)(rc, lazy_meas, user_data);
+    } else if (result_type == SHT3X_MEAS_RESULT_TYPE_EXTENDED) {
+        if (!lazy_meas) {
+            ((SHT3XExtMeasCompleteCb)cb)(rc, NULL, user_data);
+        } else {
+            SHT3XExtMeasurement ext_meas = {
+                .temperature = 0,
+                .humidity = 0,
+                .quality = lazy_meas->quality,
+                .sample_age_ms = lazy_meas->sample_age_ms,
+            };
+            /* Values that were not read out are left at 0 */
+            sht3x_lazy_meas_get_temperature(lazy_meas, &ext_meas.temperature);
+            sht3x_lazy_meas_get_humidity(lazy_meas, &ext_meas.humidity);
+            ((SHT3XExtMeasCompleteCb)cb)(rc, &ext_meas, user_data);
+        }
+    } else if (!lazy_meas) {
+        ((SHT3XMeasCompleteCb)cb)(rc, NULL, user_data);
+    } else {
+        SHT3XMeasurement meas = {
+            .temperature = 0,
+            .humidity = 0,
+        };
+        /* Values that were not read out are left at 0 */
+        sht3x_lazy_meas_get_temperature(lazy_meas, &meas.temperature);
+        sht3x_lazy_meas_get_humidity(lazy_meas, &meas.humidity);
+        ((SHT3XMeasCompleteCb)cb)(rc, &meas, user_data);
+    }
+
+    if (health_event_raised) {
+        health_cb(health_event, health_cb_user_data);
     }
 }
 
@@ -783,7 +1155,7 @@ static void execute_complete_cb(SHT3X self, uint8_t rc)
     SHT3XCompleteCb cb = (SHT3XCompleteCb)self->sequence_cb;
     void *user_data = self->sequence_cb_user_data;
     /* Public functions can now be called again - sequence complete */
-    reset_sequence_data(self);
+    end_sequence(self, rc);
     if (cb) {
         cb(rc, user_data);
     }
@@ -804,52 +1176,182 @@ static void execute_read_status_reg_complete_cb(SHT3X self, uint8_t rc, uint16_t
     SHT3XReadStatusRegCompleteCb cb = (SHT3XReadStatusRegCompleteCb)self->sequence_cb;
     void *user_data = self->sequence_cb_user_data;
     /* Public functions can now be called again - sequence complete */
-    reset_sequence_data(self);
+    end_sequence(self, rc);
     if (cb) {
         cb(rc, status_reg_val, user_data);
     }
 }
 
-static void generic_i2c_complete_cb(uint8_t result_code, void *user_data)
+/**
+ * @brief Interpret self->sequence_cb as ReadSerialNumberCompleteCb and execute it, if available.
+ *
+ * @param[in] self SHT3X instance.
+ * @param[in] rc Return code to pass to ReadSerialNumberCompleteCb, use @ref SHT3XResultCode.
+ * @param[in] serial_number Serial number to pass to ReadSerialNumberCompleteCb.
+ */
+static void execute_read_serial_number_complete_cb(SHT3X self, uint8_t rc, uint32_t serial_number)
 {
-    SHT3X self = (SHT3X)user_data;
     if (!self) {
         return;
     }
-
-    uint8_t rc = (result_code == SHT3X_I2C_RESULT_CODE_OK) ? SHT3X_RESULT_CODE_OK : SHT3X_RESULT_CODE_IO_ERR;
-    execute_complete_cb(self, rc);
+    SHT3XReadSerialNumberCompleteCb cb = (SHT3XReadSerialNumberCompleteCb)self->sequence_cb;
+    void *user_data = self->sequence_cb_user_data;
+    /* Public functions can now be called again - sequence complete */
+    end_sequence(self, rc);
+    if (cb) {
+        cb(rc, serial_number, user_data);
+    }
 }
 
-static void meas_i2c_complete_cb(uint8_t result_code, void *user_data)
+/**
+ * @brief Interpret self->sequence_cb as InitSequenceCompleteCb and execute it, if available.
+ *
+ * @param[in] self SHT3X instance.
+ * @param[in] rc Return code to pass to InitSequenceCompleteCb, use @ref SHT3XResultCode.
+ * @param[in] time_to_first_sample_ms Time to first sample to pass to InitSequenceCompleteCb.
+ */
+static void execute_init_sequence_complete_cb(SHT3X self, uint8_t rc, uint32_t time_to_first_sample_ms)
 {
-    SHT3X self = (SHT3X)user_data;
     if (!self) {
         return;
     }
+    SHT3XInitSequenceCompleteCb cb = (SHT3XInitSequenceCompleteCb)self->sequence_cb;
+    void *user_data = self->sequence_cb_user_data;
+    /* Public functions can now be called again - sequence complete */
+    end_sequence(self, rc);
+    if (cb) {
+        cb(rc, time_to_first_sample_ms, user_data);
+    }
+}
 
-    /* Address NACK is not considered an error as a part of read measurement or read periodic measurement sequences. It
-     * is a valid scenario if the measurements are not available. To let the caller distinguish between this scenario
-     * and a generic IO error, return a different code when address NACK occurred as a part of read measurement
-     * sequence.
-     *
-     * All other sequences are implemented in a way that address NACK should never happen, so for all other sequences it
-     * is considered an IO error. */
-    bool return_no_data_if_address_nack = ((self->sequence_type == SHT3X_SEQUENCE_TYPE_READ_MEAS) ||
-                                           (self->sequence_type == SHT3X_SEQUENCE_TYPE_READ_PERIODIC_MEAS));
-    if (result_code == SHT3X_I2C_RESULT_CODE_ADDRESS_NACK && return_no_data_if_address_nack) {
-        execute_meas_complete_cb(self, SHT3X_RESULT_CODE_NO_DATA, NULL);
-        return;
-    } else if (result_code != SHT3X_I2C_RESULT_CODE_OK) {
-        execute_meas_complete_cb(self, SHT3X_RESULT_CODE_IO_ERR, NULL);
-        return;
+/**
+ * @brief Get the step of the current sequence that is currently being executed.
+ *
+ * @param[in] self SHT3X instance. Must have an ongoing sequence.
+ *
+ * @return const SHT3xStep* Current step.
+ */
+static const SHT3xStep *get_current_step(SHT3X self)
+{
+    return &(sequence_steps[self->sequence_type][self->sequence_step]);
+}
+
+/**
+ * @brief Terminate the current sequence early, and execute its complete callback with a failure.
+ *
+ * The callback type is defined by the PARSE step of the sequence.
+ *
+ * @param[in] self SHT3X instance.
+ * @param[in] rc Return code to pass to the callback, use @ref SHT3XResultCode.
+ */
+static void fail_sequence(SHT3X self, uint8_t rc)
+{
+    const SHT3xStep *step = get_current_step(self);
+    while (step->op != SHT3X_STEP_OP_PARSE) {
+        step++;
+    }
+
+    switch (step->arg) {
+    case SHT3X_PARSE_KIND_MEAS:
+        execute_meas_complete_cb(self, rc, NULL);
+        break;
+    case SHT3X_PARSE_KIND_STATUS_REG:
+        execute_read_status_reg_complete_cb(self, rc, 0);
+        break;
+    case SHT3X_PARSE_KIND_SERIAL_NUMBER:
+        execute_read_serial_number_complete_cb(self, rc, 0);
+        break;
+    case SHT3X_PARSE_KIND_INIT:
+        execute_init_sequence_complete_cb(self, rc, 0);
+        break;
+    default:
+        execute_complete_cb(self, rc);
+        break;
+    }
+}
+
+/**
+ * @brief Get the period of periodic measurements.
+ *
+ * @param[in] mps MPS option. Use @ref SHT3XMps.
+ *
+ * @return uint32_t Period in ms, 0 if @p mps is invalid.
+ */
+static uint32_t get_periodic_meas_period_ms(uint8_t mps)
+{
+    switch (mps) {
+    case SHT3X_MPS_0_5:
+        return 2000;
+    case SHT3X_MPS_1:
+        return 1000;
+    case SHT3X_MPS_2:
+        return 500;
+    case SHT3X_MPS_4:
+        return 250;
+    case SHT3X_MPS_10:
+        return 100;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Derive the quality word and the sample age of a measurement read out in the current sequence.
+ *
+ * Everything is derived from the sequence data and the tracked device state, so this must be called before the
+ * sequence ends.
+ *
+ * @param[in] self SHT3X instance.
+ * @param[in,out] meas Measurement with flags already set. Its quality and sample_age_ms are written here.
+ */
+static void fill_meas_quality(SHT3X self, SHT3XLazyMeasurement *meas)
+{
+    uint8_t meas_mode = self->meas_mode;
+    uint8_t repeatability = SHT3X_QUALITY_REPEATABILITY_UNKNOWN;
+    uint32_t sample_age_ms = SHT3X_SAMPLE_AGE_UNKNOWN;
+    bool fetched = (self->sequence_type == SHT3X_SEQUENCE_TYPE_READ_PERIODIC_MEAS);
+
+    if (self->sequence_type == SHT3X_SEQUENCE_TYPE_SINGLE_SHOT_MEAS) {
+        /* The device took the measurement in response to the single shot command of this sequence */
+        meas_mode = SHT3X_MEAS_MODE_SINGLE_SHOT;
+        repeatability = self->single_shot_repeatability;
+        /* The measurement was complete at the latest when the delay before the readout elapsed */
+        sample_age_ms = self->sequence_timer_period;
+    } else if (meas_mode == SHT3X_MEAS_MODE_SINGLE_SHOT) {
+        repeatability = self->single_shot_repeatability;
+    } else if (meas_mode == SHT3X_MEAS_MODE_PERIODIC) {
+        repeatability = self->periodic_repeatability;
+        uint32_t period = get_periodic_meas_period_ms(self->periodic_mps);
+        if (fetched && (period > 0)) {
+            /* The fetched measurement is at most one period old, plus the delay between the fetch and the readout */
+            sample_age_ms = period + self->sequence_timer_period;
+        }
+    } else if ((meas_mode == SHT3X_MEAS_MODE_PERIODIC_ART) && fetched) {
+        sample_age_ms = SHT3X_ART_MEAS_PERIOD_MS + self->sequence_timer_period;
     }
 
-    /* I2C transaction successful. Interpret the received bytes according to the flags. */
+    // clang-format off
+    meas->quality = (uint16_t)(
+        ((uint16_t)meas->flags & SHT3X_QUALITY_FLAGS_MASK)
+        | (((uint16_t)self->heater_state & SHT3X_QUALITY_HEATER_STATE_MASK) << SHT3X_QUALITY_HEATER_STATE_POS)
+        | (((uint16_t)meas_mode & SHT3X_QUALITY_MEAS_MODE_MASK) << SHT3X_QUALITY_MEAS_MODE_POS)
+        | (((uint16_t)repeatability & SHT3X_QUALITY_REPEATABILITY_MASK) << SHT3X_QUALITY_REPEATABILITY_POS)
+        | (((uint16_t)self->meas_failure_count & SHT3X_QUALITY_RETRY_COUNT_MASK) << SHT3X_QUALITY_RETRY_COUNT_POS)
+    );
+    // clang-format on
+    meas->sample_age_ms = sample_age_ms;
+}
 
+/**
+ * @brief Interpret i2c_read_buf as a measurement according to sequence flags, and execute meas complete callback.
+ *
+ * @param[in] self SHT3X instance.
+ */
+static void parse_meas(SHT3X self)
+{
     /* Verify CRCs if the corresponding flags are set */
     if (self->sequence_flags & SHT3X_FLAG_VERIFY_CRC_HUM) {
-        uint8_t expected_hum_crc = sht3x_crc8(&(self->i2c_read_buf[3]));
+        uint8_t expected_hum_crc = sht3x_crc8(&(self->i2c_read_buf[3]), 2);
         uint8_t actual_hum_crc = self->i2c_read_buf[5];
         if (expected_hum_crc != actual_hum_crc) {
             execute_meas_complete_cb(self, SHT3X_RESULT_CODE_CRC_MISMATCH, NULL);
@@ -857,7 +1359,7 @@ static void meas_i2c_complete_cb(uint8_t result_code, void *user_data)
         }
     }
     if (self->sequence_flags & SHT3X_FLAG_VERIFY_CRC_TEMP) {
-        uint8_t expected_temp_crc = sht3x_crc8(&(self->i2c_read_buf[0]));
+        uint8_t expected_temp_crc = sht3x_crc8(&(self->i2c_read_buf[0]), 2);
         uint8_t actual_temp_crc = self->i2c_read_buf[2];
         if (expected_temp_crc != actual_temp_crc) {
             execute_meas_complete_cb(self, SHT3X_RESULT_CODE_CRC_MISMATCH, NULL);
@@ -865,136 +1367,319 @@ static void meas_i2c_complete_cb(uint8_t result_code, void *user_data)
         }
     }
 
-    /* i2c_read_buf now contains the raw measurements. Need to convert them to temperature in Celsius and
-     * humidity in RH%. */
-    SHT3XMeasurement meas = {
+    /* i2c_read_buf now contains the raw measurements. Only store the raw ticks here, conversion to temperature in
+     * Celsius and humidity in RH% happens when (and if) the values are requested. */
+    SHT3XLazyMeasurement lazy_meas = {
+        .raw_temperature = 0,
+        .raw_humidity = 0,
+        .flags = self->sequence_flags,
+        .quality = 0,
+        .sample_age_ms = SHT3X_SAMPLE_AGE_UNKNOWN,
+        .converted = 0,
         .temperature = 0,
         .humidity = 0,
     };
+    /* Device sends raw measurements in big endian, convert to 16-bit values in target endianness */
     if (self->sequence_flags & SHT3X_FLAG_READ_TEMP) {
         /* Temperature is the first two bytes in the received data. */
-        meas.temperature = convert_raw_temp_meas_to_celsius(&(self->i2c_read_buf[0]));
+        lazy_meas.raw_temperature = two_big_endian_bytes_to_uint16(&(self->i2c_read_buf[0]));
     }
     if (self->sequence_flags & SHT3X_FLAG_READ_HUM) {
         /* Bytes 3 and 4 in the received data form the raw humidity measurement. */
-        meas.humidity = convert_raw_humidity_meas_to_rh(&(self->i2c_read_buf[3]));
+        lazy_meas.raw_humidity = two_big_endian_bytes_to_uint16(&(self->i2c_read_buf[3]));
     }
+    fill_meas_quality(self, &lazy_meas);
 
-    execute_meas_complete_cb(self, SHT3X_RESULT_CODE_OK, &meas);
+    execute_meas_complete_cb(self, SHT3X_RESULT_CODE_OK, &lazy_meas);
 }
 
-static void read_meas_seq_part_3(void *user_data)
+/**
+ * @brief Interpret i2c_read_buf as status register value, and execute read status reg complete callback.
+ *
+ * @param[in] self SHT3X instance.
+ */
+static void parse_status_reg(SHT3X self)
 {
-    SHT3X self = (SHT3X)user_data;
-    if (!self) {
-        return;
+    uint8_t rc = SHT3X_RESULT_CODE_OK;
+    uint16_t reg_val = two_big_endian_bytes_to_uint16(&(self->i2c_read_buf[0]));
+    if (self->sequence_i2c_read_len == 3) {
+        /* If we read 3 bytes, need to verify the CRC, otherwise we would not have read the third byte */
+        uint8_t expected_crc = sht3x_crc8(&(self->i2c_read_buf[0]), 2);
+        uint8_t actual_crc = self->i2c_read_buf[2];
+        rc = (expected_crc == actual_crc) ? SHT3X_RESULT_CODE_OK : SHT3X_RESULT_CODE_CRC_MISMATCH;
     }
 
-    size_t length = map_read_meas_flags_to_num_bytes_to_read(self->sequence_flags);
-    if (length == 0) {
-        /* Flags are invalid, this should never happen */
-        execute_meas_complete_cb(self, SHT3X_RESULT_CODE_DRIVER_ERR, NULL);
+    if (rc == SHT3X_RESULT_CODE_OK) {
+        update_shadow_status_reg(self, reg_val);
     }
-
-    send_read_cmd(self, length, meas_i2c_complete_cb, (void *)self);
+    execute_read_status_reg_complete_cb(self, rc, reg_val);
 }
 
-static void read_meas_seq_part_2(uint8_t result_code, void *user_data)
+/**
+ * @brief Interpret i2c_read_buf as serial number, and execute read serial number complete callback.
+ *
+ * @param[in] self SHT3X instance.
+ */
+static void parse_serial_number(SHT3X self)
 {
-    SHT3X self = (SHT3X)user_data;
-    if (!self) {
-        return;
-    }
-
-    if (result_code != SHT3X_I2C_RESULT_CODE_OK) {
-        /* Previous I2C write failed, execute meas complete cb to indicate failure */
-        execute_meas_complete_cb(self, SHT3X_RESULT_CODE_IO_ERR, NULL);
+    uint8_t *buf = self->i2c_read_buf;
+    if ((sht3x_crc8(&(buf[0]), 2) != buf[2]) || (sht3x_crc8(&(buf[3]), 2) != buf[5])) {
+        execute_read_serial_number_complete_cb(self, SHT3X_RESULT_CODE_CRC_MISMATCH, 0);
         return;
     }
 
-    self->start_timer(self->sequence_timer_period, self->start_timer_user_data, read_meas_seq_part_3, (void *)self);
+    /* Most significant word is sent first */
+    uint32_t serial_number = (((uint32_t)two_big_endian_bytes_to_uint16(&(buf[0]))) << 16) |
+                             ((uint32_t)two_big_endian_bytes_to_uint16(&(buf[3])));
+    execute_read_serial_number_complete_cb(self, SHT3X_RESULT_CODE_OK, serial_number);
 }
 
-static void soft_reset_with_delay_part_3(void *user_data)
+/**
+ * @brief Interpret i2c_read_buf as status register value with CRC, and check that none of @p must_be_cleared flags
+ * are set.
+ *
+ * @param[in] self SHT3X instance.
+ * @param[in] must_be_cleared Mask of status register flags that must be cleared.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Status register value is as expected.
+ * @retval SHT3X_RESULT_CODE_CRC_MISMATCH CRC verification failed.
+ * @retval SHT3X_RESULT_CODE_UNEXPECTED_STATUS At least one of @p must_be_cleared flags is set.
+ */
+static uint8_t verify_status_reg(SHT3X self, uint16_t must_be_cleared)
 {
-    SHT3X self = (SHT3X)user_data;
-    if (!self) {
-        return;
+    uint16_t reg_val = two_big_endian_bytes_to_uint16(&(self->i2c_read_buf[0]));
+    if (sht3x_crc8(&(self->i2c_read_buf[0]), 2) != self->i2c_read_buf[2]) {
+        return SHT3X_RESULT_CODE_CRC_MISMATCH;
     }
-    execute_complete_cb(self, SHT3X_RESULT_CODE_OK);
+
+    update_shadow_status_reg(self, reg_val);
+    return (reg_val & must_be_cleared) ? SHT3X_RESULT_CODE_UNEXPECTED_STATUS : SHT3X_RESULT_CODE_OK;
 }
 
-static void soft_reset_with_delay_part_2(uint8_t result_code, void *user_data)
-{
-    SHT3X self = (SHT3X)user_data;
-    if (!self) {
-        return;
-    }
+static void sequence_i2c_complete_cb(uint8_t result_code, void *user_data);
+static void sequence_timer_expired_cb(void *user_data);
 
-    if (result_code != SHT3X_I2C_RESULT_CODE_OK) {
-        /* Previous I2C write failed, execute meas complete cb to indicate failure */
-        execute_complete_cb(self, SHT3X_RESULT_CODE_IO_ERR);
-        return;
-    }
+/**
+ * @brief Execute the current step of the current sequence.
+ *
+ * WRITE, DELAY and READ steps complete asynchronously, and the next step is executed from the I2C complete or timer
+ * expired callback. VERIFY_STATUS_REG step completes immediately. PARSE step completes the sequence.
+ *
+ * @param[in] self SHT3X instance.
+ */
+static void run_current_step(SHT3X self)
+{
+    const SHT3xStep *step = get_current_step(self);
 
-    /* Give sensor time to perform soft reset */
-    self->start_timer(SHT3X_SOFT_RESET_DELAY_MS, self->start_timer_user_data, soft_reset_with_delay_part_3,
-                      (void *)self);
+    switch (step->op) {
+    case SHT3X_STEP_OP_WRITE: {
+        uint8_t cmd[2];
+        if (step->arg == SHT3X_STEP_ARG_FROM_SEQUENCE) {
+            cmd[0] = self->sequence_cmd[0];
+            cmd[1] = self->sequence_cmd[1];
+        } else {
+            cmd[0] = (uint8_t)(step->arg >> 8);
+            cmd[1] = (uint8_t)(step->arg & 0xFF);
+        }
+        SHT3X_TRACE(self, SHT3X_TRACE_EVENT_I2C_WRITE_ISSUE, 0, ((uint32_t)cmd[0] << 8) | cmd[1]);
+        self->i2c_write(cmd, 2, self->i2c_addr, self->i2c_write_user_data, sequence_i2c_complete_cb, (void *)self);
+        break;
+    }
+    case SHT3X_STEP_OP_DELAY: {
+        uint32_t period = (step->arg == SHT3X_STEP_ARG_FROM_SEQUENCE) ? self->sequence_timer_period : step->arg;
+        SHT3X_TRACE(self, SHT3X_TRACE_EVENT_TIMER_ARM, 0, period);
+        self->start_timer(period, self->start_timer_user_data, sequence_timer_expired_cb, (void *)self);
+        break;
+    }
+    case SHT3X_STEP_OP_READ: {
+        size_t length = (step->arg == SHT3X_STEP_ARG_FROM_SEQUENCE) ? self->sequence_i2c_read_len : step->arg;
+        if ((length == 0) || (length > SHT3X_I2C_READ_BUF_SIZE)) {
+            /* Read length is resolved from validated options, this should never happen */
+            fail_sequence(self, SHT3X_RESULT_CODE_DRIVER_ERR);
+            break;
+        }
+        SHT3X_TRACE(self, SHT3X_TRACE_EVENT_I2C_READ_ISSUE, 0, length);
+        self->i2c_read(self->i2c_read_buf, length, self->i2c_addr, self->i2c_read_user_data, sequence_i2c_complete_cb,
+                       (void *)self);
+        break;
+    }
+    case SHT3X_STEP_OP_VERIFY_STATUS_REG: {
+        uint8_t rc = verify_status_reg(self, step->arg);
+        if (rc != SHT3X_RESULT_CODE_OK) {
+            fail_sequence(self, rc);
+            break;
+        }
+        self->sequence_step++;
+        run_current_step(self);
+        break;
+    }
+    case SHT3X_STEP_OP_PARSE:
+        if (step->arg == SHT3X_PARSE_KIND_MEAS) {
+            parse_meas(self);
+        } else if (step->arg == SHT3X_PARSE_KIND_STATUS_REG) {
+            parse_status_reg(self);
+        } else if (step->arg == SHT3X_PARSE_KIND_SERIAL_NUMBER) {
+            parse_serial_number(self);
+        } else if (step->arg == SHT3X_PARSE_KIND_INIT) {
+            execute_init_sequence_complete_cb(self, SHT3X_RESULT_CODE_OK, self->sequence_timer_period);
+        } else {
+            execute_complete_cb(self, SHT3X_RESULT_CODE_OK);
+        }
+        break;
+    default:
+        /* Invalid step table, this should never happen */
+        fail_sequence(self, SHT3X_RESULT_CODE_DRIVER_ERR);
+        break;
+    }
 }
 
-static void read_status_reg_part_4(uint8_t result_code, void *user_data)
+static void sequence_i2c_complete_cb(uint8_t result_code, void *user_data)
 {
     SHT3X self = (SHT3X)user_data;
-    if (!self) {
+    if (!self || !is_sequence_ongoing(self)) {
         return;
     }
 
-    uint8_t rc;
-    uint16_t reg_val;
-    if (result_code == SHT3X_I2C_RESULT_CODE_OK) {
-        reg_val = two_big_endian_bytes_to_uint16(&(self->i2c_read_buf[0]));
-        if (self->sequence_i2c_read_len == 3) {
-            /* If we read 3 bytes, need to verify the CRC, otherwise we would not have read the third byte */
-            uint8_t expected_crc = sht3x_crc8(&(self->i2c_read_buf[0]));
-            uint8_t actual_crc = self->i2c_read_buf[2];
-            rc = (expected_crc == actual_crc) ? SHT3X_RESULT_CODE_OK : SHT3X_RESULT_CODE_CRC_MISMATCH;
-        } else {
-            rc = SHT3X_RESULT_CODE_OK;
-        }
-    } else {
-        rc = SHT3X_RESULT_CODE_IO_ERR;
-        reg_val = 0;
+    const SHT3xStep *step = get_current_step(self);
+    SHT3X_TRACE(self,
+                (step->op == SHT3X_STEP_OP_WRITE) ? SHT3X_TRACE_EVENT_I2C_WRITE_COMPLETE
+                                                  : SHT3X_TRACE_EVENT_I2C_READ_COMPLETE,
+                result_code, 0);
+    bool success = (result_code == SHT3X_I2C_RESULT_CODE_OK);
+    if (step->op == SHT3X_STEP_OP_WRITE) {
+        /* Tracked device state is updated as soon as the command is sent, even if there are more steps */
+        uint8_t shadow_update =
+            (step->arg == SHT3X_STEP_ARG_FROM_SEQUENCE) ? self->sequence_shadow_update : step->shadow_update;
+        apply_shadow_update(self, shadow_update, success);
     }
 
-    execute_read_status_reg_complete_cb(self, rc, reg_val);
+    if (!success) {
+        bool no_data = (result_code == SHT3X_I2C_RESULT_CODE_ADDRESS_NACK) &&
+                       (step->flags & SHT3X_STEP_FLAG_NACK_IS_NO_DATA);
+        fail_sequence(self, no_data ? SHT3X_RESULT_CODE_NO_DATA : SHT3X_RESULT_CODE_IO_ERR);
+        return;
+    }
+
+    self->sequence_step++;
+    run_current_step(self);
 }
 
-static void read_status_reg_part_3(void *user_data)
+static void sequence_timer_expired_cb(void *user_data)
 {
     SHT3X self = (SHT3X)user_data;
-    if (!self) {
+    if (!self || !is_sequence_ongoing(self)) {
         return;
     }
+    SHT3X_TRACE(self, SHT3X_TRACE_EVENT_TIMER_EXPIRE, 0, 0);
 
-    send_read_cmd(self, self->sequence_i2c_read_len, read_status_reg_part_4, (void *)self);
+    self->sequence_step++;
+    run_current_step(self);
 }
 
-static void read_status_reg_part_2(uint8_t result_code, void *user_data)
+/**
+ * @brief Start a sequence that sends a single command, and send the command.
+ *
+ * @param[in] self SHT3X instance.
+ * @param[in] cmd_msb Command code MSB.
+ * @param[in] cmd_lsb Command code LSB.
+ * @param[in] shadow_update Effect of the command on the tracked device state, use @ref SHT3xShadowUpdate.
+ * @param[in] cb Callback of type SHT3XCompleteCb to execute once the sequence is complete.
+ * @param[in] cb_user_data User data to pass to @p cb.
+ */
+static void write_cmd(SHT3X self, uint8_t cmd_msb, uint8_t cmd_lsb, uint8_t shadow_update, SHT3XCompleteCb cb,
+                      void *cb_user_data)
 {
-    SHT3X self = (SHT3X)user_data;
-    if (!self) {
-        return;
+    start_sequence(self, SHT3X_SEQUENCE_TYPE_WRITE_CMD, (void *)cb, cb_user_data);
+    self->sequence_cmd[0] = cmd_msb;
+    self->sequence_cmd[1] = cmd_lsb;
+    self->sequence_shadow_update = shadow_update;
+    run_current_step(self);
+}
+
+/**
+ * @brief Implementation of @ref sht3x_read_measurement, @ref sht3x_read_measurement_lazy and @ref
+ * sht3x_read_measurement_ext.
+ *
+ * @param[in] self SHT3X instance.
+ * @param[in] flags Read measurement options.
+ * @param[in] cb Callback to execute once complete. Its type is defined by @p result_type.
+ * @param[in] user_data User data to pass to @p cb.
+ * @param[in] result_type Use @ref SHT3xMeasResultType.
+ *
+ * @return uint8_t Return value of the public function, see @ref sht3x_read_measurement.
+ */
+static uint8_t read_measurement(SHT3X self, uint8_t flags, void *cb, void *user_data, uint8_t result_type)
+{
+    if (!self || !read_flags_valid(flags)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (is_sequence_ongoing(self)) {
+        return SHT3X_RESULT_CODE_BUSY;
     }
 
-    if (result_code != SHT3X_I2C_RESULT_CODE_OK) {
-        /* Previous I2C write failed, execute read status reg complete cb to indicate failure */
-        execute_read_status_reg_complete_cb(self, SHT3X_RESULT_CODE_IO_ERR, 0);
-        return;
+    size_t length = map_read_meas_flags_to_num_bytes_to_read(flags);
+    if (length == 0) {
+        /* We should never end up here, because we validate flags above. */
+        return SHT3X_RESULT_CODE_DRIVER_ERR;
+    }
+
+    start_sequence(self, SHT3X_SEQUENCE_TYPE_READ_MEAS, cb, user_data);
+    self->sequence_flags = flags;
+    self->sequence_meas_result_type = result_type;
+    self->sequence_i2c_read_len = (uint8_t)length;
+
+    run_current_step(self);
+    return SHT3X_RESULT_CODE_OK;
+}
+
+/**
+ * @brief Implementation of @ref sht3x_issue, @ref sht3x_issue_lazy and @ref sht3x_issue_ext.
+ *
+ * All options are resolved in @p prepared, so only the instance state is checked here.
+ *
+ * @param[in] self SHT3X instance.
+ * @param[in] prepared Measurement prepared by @ref sht3x_prepare_single_shot_measurement or @ref
+ * sht3x_prepare_periodic_measurement.
+ * @param[in] cb Callback to execute once complete. Its type is defined by @p result_type.
+ * @param[in] user_data User data to pass to @p cb.
+ * @param[in] result_type Use @ref SHT3xMeasResultType.
+ *
+ * @return uint8_t Return value of the public function, see @ref sht3x_issue.
+ */
+static uint8_t issue(SHT3X self, const SHT3XPreparedMeas *const prepared, void *cb, void *user_data,
+                     uint8_t result_type)
+{
+    if (!self || !prepared) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (is_sequence_ongoing(self)) {
+        return SHT3X_RESULT_CODE_BUSY;
+    }
+
+    if (prepared->sequence_type == SHT3X_SEQUENCE_TYPE_SINGLE_SHOT_MEAS) {
+        if (is_periodic_mode_known(self)) {
+            return SHT3X_RESULT_CODE_WRONG_MODE;
+        }
+    } else if (prepared->sequence_type == SHT3X_SEQUENCE_TYPE_READ_PERIODIC_MEAS) {
+        if (is_single_shot_mode_known(self)) {
+            return SHT3X_RESULT_CODE_WRONG_MODE;
+        }
+    } else {
+        /* Not prepared by one of the prepare functions */
+        return SHT3X_RESULT_CODE_INVALID_ARG;
     }
 
-    /* Mandatory 1 ms delay between two I2C commands */
-    self->start_timer(SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS, self->start_timer_user_data, read_status_reg_part_3,
-                      (void *)self);
+    start_meas_seq(self, cb, user_data, result_type, prepared->sequence_type, prepared->flags,
+                   prepared->timer_period);
+    if (prepared->sequence_type == SHT3X_SEQUENCE_TYPE_SINGLE_SHOT_MEAS) {
+        self->single_shot_repeatability = prepared->repeatability;
+    }
+    self->sequence_i2c_read_len = prepared->read_len;
+    self->sequence_cmd[0] = prepared->cmd[0];
+    self->sequence_cmd[1] = prepared->cmd[1];
+
+    run_current_step(self);
+    return SHT3X_RESULT_CODE_OK;
 }
 
 uint8_t sht3x_create(SHT3X *const instance, const SHT3XInitConfig *const cfg)
@@ -1016,7 +1701,15 @@ uint8_t sht3x_create(SHT3X *const instance, const SHT3XInitConfig *const cfg)
     (*instance)->start_timer = cfg->start_timer;
     (*instance)->start_timer_user_data = cfg->start_timer_user_data;
     (*instance)->i2c_addr = cfg->i2c_addr;
+    (*instance)->trace_hook = cfg->trace_hook;
+    (*instance)->trace_hook_user_data = cfg->trace_hook_user_data;
     reset_sequence_data(*instance);
+    /* Nothing is known about the device until the first commands are sent to it */
+    invalidate_shadow_state(*instance);
+    (*instance)->health_cb = NULL;
+    (*instance)->health_cb_user_data = NULL;
+    reset_health_counters(*instance);
+    (*instance)->meas_failure_count = 0;
 
     return SHT3X_RESULT_CODE_OK;
 }
@@ -1030,41 +1723,35 @@ uint8_t sht3x_send_single_shot_measurement_cmd(SHT3X self, uint8_t repeatability
     if (is_sequence_ongoing(self)) {
         return SHT3X_RESULT_CODE_BUSY;
     }
+    if (is_periodic_mode_known(self)) {
+        return SHT3X_RESULT_CODE_WRONG_MODE;
+    }
 
-    start_sequence(self, SHT3X_SEQUENCE_TYPE_GENERIC, (void *)cb, user_data);
-
-    uint8_t rc =
-        send_single_shot_meas_cmd(self, repeatability, clock_stretching, generic_i2c_complete_cb, (void *)self);
+    uint8_t cmd[2];
+    uint8_t rc = get_single_shot_meas_command_code(repeatability, clock_stretching, cmd);
     if (rc != SHT3X_RESULT_CODE_OK) {
-        /* This should always succeed, because we pass a valid self pointer, and we validate repeatability and clock
-         * stretching options. */
-        reset_sequence_data(self);
+        /* This should always succeed, because we validate repeatability and clock stretching options. */
         return SHT3X_RESULT_CODE_DRIVER_ERR;
     }
 
+    self->single_shot_repeatability = repeatability;
+    write_cmd(self, cmd[0], cmd[1], SHT3X_SHADOW_UPDATE_NONE, cb, user_data);
     return SHT3X_RESULT_CODE_OK;
 }
 
 uint8_t sht3x_read_measurement(SHT3X self, uint8_t flags, SHT3XMeasCompleteCb cb, void *user_data)
 {
-    if (!self || !read_flags_valid(flags)) {
-        return SHT3X_RESULT_CODE_INVALID_ARG;
-    }
-    if (is_sequence_ongoing(self)) {
-        return SHT3X_RESULT_CODE_BUSY;
-    }
-
-    size_t length = map_read_meas_flags_to_num_bytes_to_read(flags);
-    if (length == 0) {
-        /* We should never end up here, because we validate flags above. */
-        return SHT3X_RESULT_CODE_DRIVER_ERR;
-    }
+    return read_measurement(self, flags, (void *)cb, user_data, SHT3X_MEAS_RESULT_TYPE_CONVERTED);
+}
 
-    start_sequence(self, SHT3X_SEQUENCE_TYPE_READ_MEAS, cb, user_data);
-    self->sequence_flags = flags;
+uint8_t sht3x_read_measurement_lazy(SHT3X self, uint8_t flags, SHT3XLazyMeasCompleteCb cb, void *user_data)
+{
+    return read_measurement(self, flags, (void *)cb, user_data, SHT3X_MEAS_RESULT_TYPE_LAZY);
+}
 
-    send_read_cmd(self, length, meas_i2c_complete_cb, (void *)self);
-    return SHT3X_RESULT_CODE_OK;
+uint8_t sht3x_read_measurement_ext(SHT3X self, uint8_t flags, SHT3XExtMeasCompleteCb cb, void *user_data)
+{
+    return read_measurement(self, flags, (void *)cb, user_data, SHT3X_MEAS_RESULT_TYPE_EXTENDED);
 }
 
 uint8_t sht3x_start_periodic_measurement(SHT3X self, uint8_t repeatability, uint8_t mps, SHT3XCompleteCb cb,
@@ -1077,16 +1764,22 @@ uint8_t sht3x_start_periodic_measurement(SHT3X self, uint8_t repeatability, uint
         return SHT3X_RESULT_CODE_BUSY;
     }
 
-    start_sequence(self, SHT3X_SEQUENCE_TYPE_GENERIC, (void *)cb, user_data);
+    if ((self->meas_mode == SHT3X_MEAS_MODE_PERIODIC) && (self->periodic_repeatability == repeatability) &&
+        (self->periodic_mps == mps)) {
+        /* Periodic measurement with the same options is already running */
+        return complete_locally(cb, user_data);
+    }
 
-    uint8_t rc = send_start_periodic_meas_cmd(self, repeatability, mps, generic_i2c_complete_cb, (void *)self);
+    uint8_t cmd[2];
+    uint8_t rc = get_start_periodic_meas_cmd(repeatability, mps, cmd);
     if (rc != SHT3X_RESULT_CODE_OK) {
-        /* This should always succeed, because we pass a valid self pointer, and we validate repeatability and mps
-         * options. */
-        reset_sequence_data(self);
+        /* This should always succeed, because we validate repeatability and mps options. */
         return SHT3X_RESULT_CODE_DRIVER_ERR;
     }
 
+    self->periodic_repeatability = repeatability;
+    self->periodic_mps = mps;
+    write_cmd(self, cmd[0], cmd[1], SHT3X_SHADOW_UPDATE_START_PERIODIC, cb, user_data);
     return SHT3X_RESULT_CODE_OK;
 }
 
@@ -1099,8 +1792,12 @@ uint8_t sht3x_start_periodic_measurement_art(SHT3X self, SHT3XCompleteCb cb, voi
         return SHT3X_RESULT_CODE_BUSY;
     }
 
-    start_sequence(self, SHT3X_SEQUENCE_TYPE_GENERIC, (void *)cb, user_data);
-    send_start_periodic_meas_art_cmd(self, generic_i2c_complete_cb, (void *)self);
+    if (self->meas_mode == SHT3X_MEAS_MODE_PERIODIC_ART) {
+        /* ART is already running */
+        return complete_locally(cb, user_data);
+    }
+
+    write_cmd(self, SHT3X_ART_CMD_MSB, SHT3X_ART_CMD_LSB, SHT3X_SHADOW_UPDATE_START_PERIODIC_ART, cb, user_data);
     return SHT3X_RESULT_CODE_OK;
 }
 
@@ -1112,9 +1809,12 @@ uint8_t sht3x_fetch_periodic_measurement_data(SHT3X self, SHT3XCompleteCb cb, vo
     if (is_sequence_ongoing(self)) {
         return SHT3X_RESULT_CODE_BUSY;
     }
+    if (is_single_shot_mode_known(self)) {
+        return SHT3X_RESULT_CODE_WRONG_MODE;
+    }
 
-    start_sequence(self, SHT3X_SEQUENCE_TYPE_GENERIC, (void *)cb, user_data);
-    send_fetch_data_cmd(self, generic_i2c_complete_cb, (void *)self);
+    write_cmd(self, SHT3X_FETCH_PERIODIC_MEAS_DATA_CMD_MSB, SHT3X_FETCH_PERIODIC_MEAS_DATA_CMD_LSB,
+              SHT3X_SHADOW_UPDATE_NONE, cb, user_data);
     return SHT3X_RESULT_CODE_OK;
 }
 
@@ -1127,8 +1827,13 @@ uint8_t sht3x_stop_periodic_measurement(SHT3X self, SHT3XCompleteCb cb, void *us
         return SHT3X_RESULT_CODE_BUSY;
     }
 
-    start_sequence(self, SHT3X_SEQUENCE_TYPE_GENERIC, (void *)cb, user_data);
-    send_stop_periodic_meas_cmd(self, generic_i2c_complete_cb, (void *)self);
+    if (self->meas_mode == SHT3X_MEAS_MODE_SINGLE_SHOT) {
+        /* Periodic measurement is not running, nothing to stop */
+        return complete_locally(cb, user_data);
+    }
+
+    write_cmd(self, SHT3X_STOP_PERIODIC_MEAS_CMD_MSB, SHT3X_STOP_PERIODIC_MEAS_CMD_LSB,
+              SHT3X_SHADOW_UPDATE_STOP_PERIODIC, cb, user_data);
     return SHT3X_RESULT_CODE_OK;
 }
 
@@ -1141,8 +1846,7 @@ uint8_t sht3x_soft_reset(SHT3X self, SHT3XCompleteCb cb, void *user_data)
         return SHT3X_RESULT_CODE_BUSY;
     }
 
-    start_sequence(self, SHT3X_SEQUENCE_TYPE_GENERIC, (void *)cb, user_data);
-    send_soft_reset_cmd(self, generic_i2c_complete_cb, (void *)self);
+    write_cmd(self, SHT3X_SOFT_RESET_CMD_MSB, SHT3X_SOFT_RESET_CMD_LSB, SHT3X_SHADOW_UPDATE_SOFT_RESET, cb, user_data);
     return SHT3X_RESULT_CODE_OK;
 }
 
@@ -1155,8 +1859,12 @@ uint8_t sht3x_enable_heater(SHT3X self, SHT3XCompleteCb cb, void *user_data)
         return SHT3X_RESULT_CODE_BUSY;
     }
 
-    start_sequence(self, SHT3X_SEQUENCE_TYPE_GENERIC, (void *)cb, user_data);
-    send_enable_heater_cmd(self, generic_i2c_complete_cb, (void *)self);
+    if (self->heater_state == SHT3X_HEATER_STATE_ON) {
+        return complete_locally(cb, user_data);
+    }
+
+    write_cmd(self, SHT3X_ENABLE_HEATER_CMD_MSB, SHT3X_ENABLE_HEATER_CMD_LSB, SHT3X_SHADOW_UPDATE_HEATER_ON, cb,
+              user_data);
     return SHT3X_RESULT_CODE_OK;
 }
 
@@ -1169,8 +1877,12 @@ uint8_t sht3x_disable_heater(SHT3X self, SHT3XCompleteCb cb, void *user_data)
         return SHT3X_RESULT_CODE_BUSY;
     }
 
-    start_sequence(self, SHT3X_SEQUENCE_TYPE_GENERIC, (void *)cb, user_data);
-    send_disable_heater_cmd(self, generic_i2c_complete_cb, (void *)self);
+    if (self->heater_state == SHT3X_HEATER_STATE_OFF) {
+        return complete_locally(cb, user_data);
+    }
+
+    write_cmd(self, SHT3X_DISABLE_HEATER_CMD_MSB, SHT3X_DISABLE_HEATER_CMD_LSB, SHT3X_SHADOW_UPDATE_HEATER_OFF, cb,
+              user_data);
     return SHT3X_RESULT_CODE_OK;
 }
 
@@ -1183,8 +1895,8 @@ uint8_t sht3x_send_read_status_register_cmd(SHT3X self, SHT3XCompleteCb cb, void
         return SHT3X_RESULT_CODE_BUSY;
     }
 
-    start_sequence(self, SHT3X_SEQUENCE_TYPE_GENERIC, (void *)cb, user_data);
-    send_read_status_reg_cmd(self, generic_i2c_complete_cb, (void *)self);
+    write_cmd(self, SHT3X_READ_STATUS_REG_CMD_MSB, SHT3X_READ_STATUS_REG_CMD_LSB, SHT3X_SHADOW_UPDATE_NONE, cb,
+              user_data);
     return SHT3X_RESULT_CODE_OK;
 }
 
@@ -1197,60 +1909,135 @@ uint8_t sht3x_clear_status_register(SHT3X self, SHT3XCompleteCb cb, void *user_d
         return SHT3X_RESULT_CODE_BUSY;
     }
 
-    start_sequence(self, SHT3X_SEQUENCE_TYPE_GENERIC, (void *)cb, user_data);
-    send_clear_status_reg_cmd(self, generic_i2c_complete_cb, (void *)self);
+    write_cmd(self, SHT3X_CLEAR_STATUS_REGISTER_CMD_MSB, SHT3X_CLEAR_STATUS_REGISTER_CMD_LSB,
+              SHT3X_SHADOW_UPDATE_CLEAR_STATUS_REG, cb, user_data);
     return SHT3X_RESULT_CODE_OK;
 }
 
 uint8_t sht3x_read_single_shot_measurement(SHT3X self, uint8_t repeatability, uint8_t clock_stretching, uint8_t flags,
                                            SHT3XMeasCompleteCb cb, void *user_data)
 {
-    if (!self || !is_valid_repeatability(repeatability) || !is_valid_clock_stretching(clock_stretching) ||
+    SHT3XPreparedMeas prepared;
+    uint8_t rc = sht3x_prepare_single_shot_measurement(repeatability, clock_stretching, flags, &prepared);
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        return rc;
+    }
+    return issue(self, &prepared, (void *)cb, user_data, SHT3X_MEAS_RESULT_TYPE_CONVERTED);
+}
+
+uint8_t sht3x_read_single_shot_measurement_lazy(SHT3X self, uint8_t repeatability, uint8_t clock_stretching,
+                                                uint8_t flags, SHT3XLazyMeasCompleteCb cb, void *user_data)
+{
+    SHT3XPreparedMeas prepared;
+    uint8_t rc = sht3x_prepare_single_shot_measurement(repeatability, clock_stretching, flags, &prepared);
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        return rc;
+    }
+    return issue(self, &prepared, (void *)cb, user_data, SHT3X_MEAS_RESULT_TYPE_LAZY);
+}
+
+uint8_t sht3x_read_single_shot_measurement_ext(SHT3X self, uint8_t repeatability, uint8_t clock_stretching,
+                                               uint8_t flags, SHT3XExtMeasCompleteCb cb, void *user_data)
+{
+    SHT3XPreparedMeas prepared;
+    uint8_t rc = sht3x_prepare_single_shot_measurement(repeatability, clock_stretching, flags, &prepared);
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        return rc;
+    }
+    return issue(self, &prepared, (void *)cb, user_data, SHT3X_MEAS_RESULT_TYPE_EXTENDED);
+}
+
+uint8_t sht3x_read_periodic_measurement(SHT3X self, uint8_t flags, SHT3XMeasCompleteCb cb, void *user_data)
+{
+    SHT3XPreparedMeas prepared;
+    uint8_t rc = sht3x_prepare_periodic_measurement(flags, &prepared);
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        return rc;
+    }
+    return issue(self, &prepared, (void *)cb, user_data, SHT3X_MEAS_RESULT_TYPE_CONVERTED);
+}
+
+uint8_t sht3x_read_periodic_measurement_lazy(SHT3X self, uint8_t flags, SHT3XLazyMeasCompleteCb cb, void *user_data)
+{
+    SHT3XPreparedMeas prepared;
+    uint8_t rc = sht3x_prepare_periodic_measurement(flags, &prepared);
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        return rc;
+    }
+    return issue(self, &prepared, (void *)cb, user_data, SHT3X_MEAS_RESULT_TYPE_LAZY);
+}
+
+uint8_t sht3x_read_periodic_measurement_ext(SHT3X self, uint8_t flags, SHT3XExtMeasCompleteCb cb, void *user_data)
+{
+    SHT3XPreparedMeas prepared;
+    uint8_t rc = sht3x_prepare_periodic_measurement(flags, &prepared);
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        return rc;
+    }
+    return issue(self, &prepared, (void *)cb, user_data, SHT3X_MEAS_RESULT_TYPE_EXTENDED);
+}
+
+uint8_t sht3x_prepare_single_shot_measurement(uint8_t repeatability, uint8_t clock_stretching, uint8_t flags,
+                                              SHT3XPreparedMeas *const prepared)
+{
+    if (!prepared || !is_valid_repeatability(repeatability) || !is_valid_clock_stretching(clock_stretching) ||
         !read_flags_valid(flags)) {
         return SHT3X_RESULT_CODE_INVALID_ARG;
     }
-    if (is_sequence_ongoing(self)) {
-        return SHT3X_RESULT_CODE_BUSY;
-    }
-    uint8_t rc;
 
-    uint32_t timer_period;
-    rc = get_single_shot_meas_timer_period(repeatability, clock_stretching, &timer_period);
+    uint8_t rc = get_single_shot_meas_command_code(repeatability, clock_stretching, prepared->cmd);
     if (rc != SHT3X_RESULT_CODE_OK) {
         /* We should never end up here, because we verify repeatability and clock stretching options above. */
         return SHT3X_RESULT_CODE_DRIVER_ERR;
     }
-
-    start_meas_seq(self, cb, user_data, SHT3X_SEQUENCE_TYPE_SINGLE_SHOT_MEAS, flags, timer_period);
-
-    rc = send_single_shot_meas_cmd(self, repeatability, clock_stretching, read_meas_seq_part_2, (void *)self);
+    rc = get_single_shot_meas_timer_period(repeatability, clock_stretching, &(prepared->timer_period));
     if (rc != SHT3X_RESULT_CODE_OK) {
-        /* Should always succeed, because we validate self pointer, and repeatability and clock stretching options. */
-        reset_sequence_data(self);
+        /* We should never end up here, because we verify repeatability and clock stretching options above. */
         return SHT3X_RESULT_CODE_DRIVER_ERR;
     }
-
+    prepared->read_len = (uint8_t)map_read_meas_flags_to_num_bytes_to_read(flags);
+    prepared->flags = flags;
+    prepared->sequence_type = SHT3X_SEQUENCE_TYPE_SINGLE_SHOT_MEAS;
+    prepared->repeatability = repeatability;
     return SHT3X_RESULT_CODE_OK;
 }
 
-uint8_t sht3x_read_periodic_measurement(SHT3X self, uint8_t flags, SHT3XMeasCompleteCb cb, void *user_data)
+uint8_t sht3x_prepare_periodic_measurement(uint8_t flags, SHT3XPreparedMeas *const prepared)
 {
-    if (!self || !read_flags_valid(flags)) {
+    if (!prepared || !read_flags_valid(flags)) {
         return SHT3X_RESULT_CODE_INVALID_ARG;
     }
-    if (is_sequence_ongoing(self)) {
-        return SHT3X_RESULT_CODE_BUSY;
-    }
 
+    prepared->cmd[0] = SHT3X_FETCH_PERIODIC_MEAS_DATA_CMD_MSB;
+    prepared->cmd[1] = SHT3X_FETCH_PERIODIC_MEAS_DATA_CMD_LSB;
     /* No need to wait between sending fetch data cmd and meas readout command other than the mandatory delay between
      * two I2C commands. */
-    start_meas_seq(self, cb, user_data, SHT3X_SEQUENCE_TYPE_READ_PERIODIC_MEAS, flags,
-                   SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS);
-
-    send_fetch_data_cmd(self, read_meas_seq_part_2, (void *)self);
+    prepared->timer_period = SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS;
+    prepared->read_len = (uint8_t)map_read_meas_flags_to_num_bytes_to_read(flags);
+    prepared->flags = flags;
+    prepared->sequence_type = SHT3X_SEQUENCE_TYPE_READ_PERIODIC_MEAS;
+    /* Taken from the tracked periodic measurement options when the measurement is read out */
+    prepared->repeatability = SHT3X_QUALITY_REPEATABILITY_UNKNOWN;
     return SHT3X_RESULT_CODE_OK;
 }
 
+uint8_t sht3x_issue(SHT3X self, const SHT3XPreparedMeas *const prepared, SHT3XMeasCompleteCb cb, void *user_data)
+{
+    return issue(self, prepared, (void *)cb, user_data, SHT3X_MEAS_RESULT_TYPE_CONVERTED);
+}
+
+uint8_t sht3x_issue_lazy(SHT3X self, const SHT3XPreparedMeas *const prepared, SHT3XLazyMeasCompleteCb cb,
+                         void *user_data)
+{
+    return issue(self, prepared, (void *)cb, user_data, SHT3X_MEAS_RESULT_TYPE_LAZY);
+}
+
+uint8_t sht3x_issue_ext(SHT3X self, const SHT3XPreparedMeas *const prepared, SHT3XExtMeasCompleteCb cb,
+                        void *user_data)
+{
+    return issue(self, prepared, (void *)cb, user_data, SHT3X_MEAS_RESULT_TYPE_EXTENDED);
+}
+
 uint8_t sht3x_soft_reset_with_delay(SHT3X self, SHT3XCompleteCb cb, void *user_data)
 {
     if (!self) {
@@ -1260,8 +2047,8 @@ uint8_t sht3x_soft_reset_with_delay(SHT3X self, SHT3XCompleteCb cb, void *user_d
         return SHT3X_RESULT_CODE_BUSY;
     }
 
-    start_sequence(self, SHT3X_SEQUENCE_TYPE_GENERIC, (void *)cb, user_data);
-    send_soft_reset_cmd(self, soft_reset_with_delay_part_2, (void *)self);
+    start_sequence(self, SHT3X_SEQUENCE_TYPE_SOFT_RESET_WITH_DELAY, (void *)cb, user_data);
+    run_current_step(self);
     return SHT3X_RESULT_CODE_OK;
 }
 
@@ -1274,9 +2061,204 @@ uint8_t sht3x_read_status_register(SHT3X self, bool verify_crc, SHT3XReadStatusR
         return SHT3X_RESULT_CODE_BUSY;
     }
 
-    start_sequence(self, SHT3X_SEQUENCE_TYPE_GENERIC, (void *)cb, user_data);
+    start_sequence(self, SHT3X_SEQUENCE_TYPE_READ_STATUS_REG, (void *)cb, user_data);
     self->sequence_i2c_read_len = verify_crc ? 3 : 2;
-    send_read_status_reg_cmd(self, read_status_reg_part_2, (void *)self);
+    run_current_step(self);
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_read_serial_number(SHT3X self, SHT3XReadSerialNumberCompleteCb cb, void *user_data)
+{
+    if (!self) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (is_sequence_ongoing(self)) {
+        return SHT3X_RESULT_CODE_BUSY;
+    }
+
+    start_sequence(self, SHT3X_SEQUENCE_TYPE_READ_SERIAL_NUMBER, (void *)cb, user_data);
+    run_current_step(self);
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_init_sequence(SHT3X self, const SHT3XInitSequenceConfig *const cfg, SHT3XInitSequenceCompleteCb cb,
+                            void *user_data)
+{
+    if (!self || !cfg || !sht3x_is_valid_periodic_cfg(cfg->meas_mode, cfg->repeatability, cfg->mps)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (is_sequence_ongoing(self)) {
+        return SHT3X_RESULT_CODE_BUSY;
+    }
+
+    uint8_t cmd[2] = {SHT3X_ART_CMD_MSB, SHT3X_ART_CMD_LSB};
+    uint8_t shadow_update = SHT3X_SHADOW_UPDATE_START_PERIODIC_ART;
+    /* The datasheet does not specify the repeatability of ART, assume the longest measurement duration */
+    uint8_t repeatability = SHT3X_MEAS_REPEATABILITY_HIGH;
+    if (cfg->meas_mode == SHT3X_MEAS_MODE_PERIODIC) {
+        if (get_start_periodic_meas_cmd(cfg->repeatability, cfg->mps, cmd) != SHT3X_RESULT_CODE_OK) {
+            /* This should always succeed, because we validate repeatability and mps options. */
+            return SHT3X_RESULT_CODE_DRIVER_ERR;
+        }
+        shadow_update = SHT3X_SHADOW_UPDATE_START_PERIODIC;
+        repeatability = cfg->repeatability;
+    }
+
+    /* The first sample is available once the first measurement after the start command completes */
+    uint32_t time_to_first_sample_ms;
+    if (get_single_shot_meas_timer_period(repeatability, SHT3X_CLOCK_STRETCHING_DISABLED, &time_to_first_sample_ms) !=
+        SHT3X_RESULT_CODE_OK) {
+        /* This should always succeed, because repeatability is valid. */
+        return SHT3X_RESULT_CODE_DRIVER_ERR;
+    }
+
+    uint8_t seq_type = cfg->verify_status ? SHT3X_SEQUENCE_TYPE_INIT_VERIFY : SHT3X_SEQUENCE_TYPE_INIT;
+    start_sequence(self, seq_type, (void *)cb, user_data);
+    self->sequence_cmd[0] = cmd[0];
+    self->sequence_cmd[1] = cmd[1];
+    self->sequence_shadow_update = shadow_update;
+    self->sequence_timer_period = time_to_first_sample_ms;
+    if (cfg->meas_mode == SHT3X_MEAS_MODE_PERIODIC) {
+        self->periodic_repeatability = cfg->repeatability;
+        self->periodic_mps = cfg->mps;
+    }
+    run_current_step(self);
+    return SHT3X_RESULT_CODE_OK;
+}
+
+bool sht3x_is_valid_periodic_cfg(uint8_t meas_mode, uint8_t repeatability, uint8_t mps)
+{
+    // clang-format off
+    return (
+        ((meas_mode == SHT3X_MEAS_MODE_PERIODIC) && is_valid_repeatability(repeatability) && is_valid_mps(mps))
+        || (meas_mode == SHT3X_MEAS_MODE_PERIODIC_ART)
+    );
+    // clang-format on
+}
+
+uint8_t sht3x_get_shadow_state(SHT3X self, SHT3XShadowState *const state)
+{
+    if (!self || !state) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    state->heater_state = self->heater_state;
+    state->meas_mode = self->meas_mode;
+    state->repeatability = self->periodic_repeatability;
+    state->mps = self->periodic_mps;
+    state->status_reg = self->status_reg;
+    state->status_reg_valid = self->status_reg_valid;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_invalidate_shadow_state(SHT3X self)
+{
+    if (!self) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (is_sequence_ongoing(self)) {
+        return SHT3X_RESULT_CODE_BUSY;
+    }
+
+    invalidate_shadow_state(self);
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_enable_health_monitor(SHT3X self, const SHT3XHealthConfig *const cfg)
+{
+    // clang-format off
+    bool cfg_valid = (
+        (cfg)
+        && (cfg->cb)
+        /* A single readout is always identical to itself */
+        && (cfg->stuck_threshold != 1)
+        && (cfg->crc_window >= cfg->crc_error_threshold)
+        && (cfg->crc_window <= SHT3X_HEALTH_MAX_CRC_WINDOW)
+    );
+    // clang-format on
+    if (!self || !cfg_valid) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    self->health_cb = cfg->cb;
+    self->health_cb_user_data = cfg->user_data;
+    self->health_stuck_threshold = cfg->stuck_threshold;
+    self->health_crc_error_threshold = cfg->crc_error_threshold;
+    self->health_crc_window = cfg->crc_window;
+    self->health_no_data_threshold = cfg->no_data_threshold;
+    reset_health_counters(self);
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_disable_health_monitor(SHT3X self)
+{
+    if (!self) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    self->health_cb = NULL;
+    self->health_cb_user_data = NULL;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_snapshot(SHT3X self, uint8_t *const buf, size_t length)
+{
+    if (!self || !buf || (length < SHT3X_SNAPSHOT_SIZE)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    /* Tracked state is not final until the ongoing sequence completes */
+    if (is_sequence_ongoing(self)) {
+        return SHT3X_RESULT_CODE_BUSY;
+    }
+
+    buf[SHT3X_SNAPSHOT_VERSION_IDX] = SHT3X_SNAPSHOT_VERSION;
+    buf[SHT3X_SNAPSHOT_I2C_ADDR_IDX] = self->i2c_addr;
+    buf[SHT3X_SNAPSHOT_HEATER_STATE_IDX] = self->heater_state;
+    buf[SHT3X_SNAPSHOT_MEAS_MODE_IDX] = self->meas_mode;
+    buf[SHT3X_SNAPSHOT_REPEATABILITY_IDX] = self->periodic_repeatability;
+    buf[SHT3X_SNAPSHOT_MPS_IDX] = self->periodic_mps;
+    buf[SHT3X_SNAPSHOT_STATUS_REG_IDX] = (uint8_t)(self->status_reg >> 8);
+    buf[SHT3X_SNAPSHOT_STATUS_REG_IDX + 1] = (uint8_t)(self->status_reg & 0xFF);
+    buf[SHT3X_SNAPSHOT_STATUS_REG_VALID_IDX] = self->status_reg_valid ? 1 : 0;
+    buf[SHT3X_SNAPSHOT_CRC_IDX] = sht3x_crc8(buf, SHT3X_SNAPSHOT_CRC_IDX);
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_restore(SHT3X self, const uint8_t *const buf, size_t length)
+{
+    if (!self || !buf || (length < SHT3X_SNAPSHOT_SIZE)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (sht3x_crc8(buf, SHT3X_SNAPSHOT_CRC_IDX) != buf[SHT3X_SNAPSHOT_CRC_IDX]) {
+        return SHT3X_RESULT_CODE_CRC_MISMATCH;
+    }
+
+    uint8_t heater_state = buf[SHT3X_SNAPSHOT_HEATER_STATE_IDX];
+    uint8_t meas_mode = buf[SHT3X_SNAPSHOT_MEAS_MODE_IDX];
+    uint8_t repeatability = buf[SHT3X_SNAPSHOT_REPEATABILITY_IDX];
+    uint8_t mps = buf[SHT3X_SNAPSHOT_MPS_IDX];
+    // clang-format off
+    bool blob_valid = (
+        (buf[SHT3X_SNAPSHOT_VERSION_IDX] == SHT3X_SNAPSHOT_VERSION)
+        /* Blob must describe the device this instance talks to */
+        && (buf[SHT3X_SNAPSHOT_I2C_ADDR_IDX] == self->i2c_addr)
+        && (heater_state <= SHT3X_HEATER_STATE_ON)
+        && (meas_mode <= SHT3X_MEAS_MODE_PERIODIC_ART)
+        && ((meas_mode != SHT3X_MEAS_MODE_PERIODIC) || (is_valid_repeatability(repeatability) && is_valid_mps(mps)))
+    );
+    // clang-format on
+    if (!blob_valid) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (is_sequence_ongoing(self)) {
+        return SHT3X_RESULT_CODE_BUSY;
+    }
+
+    self->heater_state = heater_state;
+    self->meas_mode = meas_mode;
+    self->periodic_repeatability = repeatability;
+    self->periodic_mps = mps;
+    self->status_reg = two_big_endian_bytes_to_uint16(&(buf[SHT3X_SNAPSHOT_STATUS_REG_IDX]));
+    self->status_reg_valid = (buf[SHT3X_SNAPSHOT_STATUS_REG_VALID_IDX] != 0);
     return SHT3X_RESULT_CODE_OK;
 }
 
@@ -1297,6 +2279,57 @@ uint8_t sht3x_destroy(SHT3X self, SHT3XFreeInstanceMemory free_instance_memory,
     return SHT3X_RESULT_CODE_OK;
 }
 
+uint8_t sht3x_lazy_meas_get_temperature(SHT3XLazyMeasurement *const meas, float *const temperature)
+{
+    if (!meas || !temperature || !(meas->flags & SHT3X_FLAG_READ_TEMP)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (!(meas->converted & SHT3X_LAZY_MEAS_TEMPERATURE_CONVERTED)) {
+        meas->temperature = convert_raw_temp_meas_to_celsius(meas->raw_temperature);
+        meas->converted |= SHT3X_LAZY_MEAS_TEMPERATURE_CONVERTED;
+    }
+    *temperature = meas->temperature;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_lazy_meas_get_humidity(SHT3XLazyMeasurement *const meas, float *const humidity)
+{
+    if (!meas || !humidity || !(meas->flags & SHT3X_FLAG_READ_HUM)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (!(meas->converted & SHT3X_LAZY_MEAS_HUMIDITY_CONVERTED)) {
+        meas->humidity = convert_raw_humidity_meas_to_rh(meas->raw_humidity);
+        meas->converted |= SHT3X_LAZY_MEAS_HUMIDITY_CONVERTED;
+    }
+    *humidity = meas->humidity;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_quality_get_flags(uint16_t quality)
+{
+    return (uint8_t)(quality & SHT3X_QUALITY_FLAGS_MASK);
+}
+
+uint8_t sht3x_quality_get_heater_state(uint16_t quality)
+{
+    return (uint8_t)((quality >> SHT3X_QUALITY_HEATER_STATE_POS) & SHT3X_QUALITY_HEATER_STATE_MASK);
+}
+
+uint8_t sht3x_quality_get_meas_mode(uint16_t quality)
+{
+    return (uint8_t)((quality >> SHT3X_QUALITY_MEAS_MODE_POS) & SHT3X_QUALITY_MEAS_MODE_MASK);
+}
+
+uint8_t sht3x_quality_get_repeatability(uint16_t quality)
+{
+    return (uint8_t)((quality >> SHT3X_QUALITY_REPEATABILITY_POS) & SHT3X_QUALITY_REPEATABILITY_MASK);
+}
+
+uint8_t sht3x_quality_get_retry_count(uint16_t quality)
+{
+    return (uint8_t)((quality >> SHT3X_QUALITY_RETRY_COUNT_POS) & SHT3X_QUALITY_RETRY_COUNT_MASK);
+}
+
 bool sht3x_is_crc_of_last_write_transfer_correct(uint16_t status_reg_val)
 {
     return !((status_reg_val) & (uint16_t)SHT3X_STATUS_REG_WRITE_DATA_CHECKSUM_STATUS_MASK);
@@ -40,6 +40,12 @@ typedef struct SHT3XStruct *SHT3X;
  * On the contrary, if soft reset is performed by calling @ref sht3x_soft_reset, it is the caller's responsibility to
  * wait until the device becomes responsive after the reset.
  *
+ * # Fast startup
+ * @ref sht3x_init_sequence brings the device from an unknown state to periodic measurement or ART in one call: soft
+ * reset, clear status register, optionally verify the status register, and start measurements. Only the minimal delays
+ * required by the datasheet are inserted between the commands. The complete callback reports how long the caller
+ * should wait before the first measurement can be read out.
+ *
  * # Mandatory delay between commands
  * The SHT3X device has a mandatory delay of at least 1 ms between I2C commands that it receives.
  *
@@ -49,8 +55,96 @@ typedef struct SHT3XStruct *SHT3X;
  * However, this driver does not guarantee this delay when two different driver functions are invoked after each other.
  * It is the caller's responsibility to ensure that there is a delay of at least 1 ms between calls to functions of this
  * driver.
+ *
+ * # Tracked device state
+ * The driver keeps track of the heater state, the measurement mode, and the last known status register value, based
+ * on the commands it sent and the status register values it read out. Everything is unknown after @ref sht3x_create.
+ * The tracked state can be queried with @ref sht3x_get_shadow_state.
+ *
+ * Commands that would not change anything on the device according to the tracked state are not sent:
+ * - @ref sht3x_enable_heater if the heater is known to be on.
+ * - @ref sht3x_disable_heater if the heater is known to be off.
+ * - @ref sht3x_start_periodic_measurement if periodic measurement with the same options is known to be running.
+ * - @ref sht3x_start_periodic_measurement_art if ART is known to be running.
+ * - @ref sht3x_stop_periodic_measurement if the device is known to be in single shot mode.
+ *
+ * In that case, the complete callback is executed with @ref SHT3X_RESULT_CODE_OK from within the function call, before
+ * the function returns.
+ *
+ * Commands that the device does not accept in its tracked measurement mode are rejected with @ref
+ * SHT3X_RESULT_CODE_WRONG_MODE without being sent:
+ * - Single shot measurement commands while periodic measurement or ART is running. Call @ref
+ * sht3x_stop_periodic_measurement first.
+ * - Fetch periodic measurement data commands while the device is in single shot mode.
+ *
+ * If the measurement mode is unknown, these commands are sent.
+ *
+ * If a command fails, the state that it affects becomes unknown. If a status register readout shows a reset that the
+ * driver did not initiate, the measurement mode becomes unknown. If the device state could have changed without the
+ * driver knowing, e.g. the device lost power, call @ref sht3x_invalidate_shadow_state.
+ *
+ * # Measurement quality
+ * Every measurement carries a quality word and a sample age estimate, both derived from the read flags and the
+ * tracked device state, so no extra status register readouts are needed. Lazy measurements hold them in @ref
+ * SHT3XLazyMeasurement, and the *_ext functions, e.g. @ref sht3x_read_periodic_measurement_ext, pass them along with
+ * the converted values in @ref SHT3XExtMeasurement. The quality word is decoded with:
+ * - @ref sht3x_quality_get_flags - which values were read out and which CRCs were verified.
+ * - @ref sht3x_quality_get_heater_state - tracked heater state.
+ * - @ref sht3x_quality_get_meas_mode - measurement mode, tells whether ART was running.
+ * - @ref sht3x_quality_get_repeatability - repeatability of the measurement.
+ * - @ref sht3x_quality_get_retry_count - number of failed readouts on the instance right before this one.
+ *
+ * The sample age is an upper bound on how old the measurement was when it was read out: the delay before the readout
+ * for single shot measurements, and the measurement period plus the fetch delay for periodic measurements read out
+ * with @ref sht3x_read_periodic_measurement or its variants. It is @ref SHT3X_SAMPLE_AGE_UNKNOWN if the measurement
+ * mode is unknown, or if the measurement was read out with @ref sht3x_read_measurement, because the driver does not
+ * know when the measurement was started or fetched.
+ *
+ * # Health monitor
+ * An optional health monitor can be enabled per instance with @ref sht3x_enable_health_monitor. It watches the
+ * outcome of every measurement readout, and executes a callback when it detects one of @ref SHT3XHealthEvent: frozen
+ * raw values, a high CRC mismatch rate, or repeated readouts with no data. The callback is executed after the
+ * measurement complete callback, so it can start a recovery, e.g. @ref sht3x_soft_reset_with_delay.
+ *
+ * # Warm start
+ * If the device keeps running while the host sleeps, the tracked state can be saved with @ref sht3x_snapshot into a
+ * buffer of @ref SHT3X_SNAPSHOT_SIZE bytes that survives the sleep, e.g. in retention RAM. After wakeup, create a new
+ * instance with the same config and apply the saved state with @ref sht3x_restore. Periodic measurement data can then
+ * be read out right away, without sending any configuration commands.
+ *
+ * # Tracing
+ * If the driver is built with SHT3X_ENABLE_TRACE defined, the trace_hook from the init config is executed at every
+ * sequence start and end, I2C write and read issue and completion, and timer start and expiry. Each @ref
+ * SHT3XTraceEvent carries the instance, the sequence type and the result. The hook can timestamp the events, and @ref
+ * sht3x_trace_format_chrome_event from sht3x_trace.h turns them into Chrome trace JSON for timeline analysis. @ref
+ * sht3x_flight_recorder_hook from sht3x_flight_recorder.h keeps the most recent events in a ring buffer for postmortem
+ * analysis. @ref sht3x_latency_hook from sht3x_latency.h builds latency histograms with percentile queries. @ref
+ * sht3x_trace_fanout_hook from sht3x_trace.h passes events on to several of these hooks at once. Without
+ * SHT3X_ENABLE_TRACE, all tracepoints compile to nothing, and trace_hook is ignored.
  */
 
+/** From the datasheet - there must be at least 1 ms delay between two I2C commands received by the sensor. */
+#define SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS 1
+
+/** From the datasheet - the max amount of time between soft reset command is issued and when sensor is ready to
+ * process I2C commands again. Rounded up. */
+#define SHT3X_SOFT_RESET_DELAY_MS 2
+
+/** Size in bytes of the buffer written by @ref sht3x_snapshot. */
+#define SHT3X_SNAPSHOT_SIZE 10
+
+/** sample_age_ms of a measurement whose age cannot be estimated from the tracked device state. */
+#define SHT3X_SAMPLE_AGE_UNKNOWN UINT32_MAX
+
+/** Repeatability in the quality word of a measurement whose repeatability is not known, e.g. in ART mode. */
+#define SHT3X_QUALITY_REPEATABILITY_UNKNOWN 3
+
+/** Largest retry count in the quality word. Larger counts are reported as this value. */
+#define SHT3X_QUALITY_MAX_RETRY_COUNT 7
+
+/** Largest crc_window of @ref SHT3XHealthConfig. The outcomes of the readouts in the window are kept as a bitmask. */
+#define SHT3X_HEALTH_MAX_CRC_WINDOW 32
+
 /**
  * @brief Gets called in @ref sht3x_create to get memory for a SHT3X instance.
  *
@@ -125,6 +219,76 @@ typedef struct {
  */
 typedef void (*SHT3XMeasCompleteCb)(uint8_t result_code, SHT3XMeasurement *meas, void *user_data);
 
+/**
+ * @brief Measurement that has been read out, but not converted to physical units yet.
+ *
+ * Holds the raw ticks received from the device. Temperature and humidity are only converted when they are requested via
+ * @ref sht3x_lazy_meas_get_temperature and @ref sht3x_lazy_meas_get_humidity. The converted values are memoized in
+ * this struct, so requesting the same value again does not convert it again. This way, the conversion cost is only paid
+ * for measurements that are actually consumed.
+ *
+ * The struct does not reference any driver memory, so it can be copied and kept for as long as needed.
+ */
+typedef struct {
+    /** Raw temperature ticks. Only valid if flags contains @ref SHT3X_FLAG_READ_TEMP. */
+    uint16_t raw_temperature;
+    /** Raw humidity ticks. Only valid if flags contains @ref SHT3X_FLAG_READ_HUM. */
+    uint16_t raw_humidity;
+    /** Read flags that the measurement was read out with. Tells which values were read out and which CRCs were
+     * verified. */
+    uint8_t flags;
+    /** Quality word of the measurement. Decode it with the sht3x_quality_get_* functions. */
+    uint16_t quality;
+    /** Upper bound on the age of the measurement in ms when it was read out, or @ref SHT3X_SAMPLE_AGE_UNKNOWN. */
+    uint32_t sample_age_ms;
+    /** Private. Tracks which of the values below have already been converted. */
+    uint8_t converted;
+    /** Private. Use @ref sht3x_lazy_meas_get_temperature. */
+    float temperature;
+    /** Private. Use @ref sht3x_lazy_meas_get_humidity. */
+    float humidity;
+} SHT3XLazyMeasurement;
+
+/**
+ * @brief Callback type to execute when the driver finishes reading out a measurement without converting it.
+ *
+ * @param result_code Indicates success or the reason for failure.
+ * @param meas Measurement that was read out. Undefined value if @p result_code is not SHT3X_RESULT_CODE_OK. Do not
+ * dereference the pointer in that case, it may be NULL.
+ * @param user_data User data.
+ *
+ * @note The @p meas pointer only points to valid memory during the execution of this callback. Copy the struct it
+ * points to if the measurement needs to be kept after this callback finished executing.
+ */
+typedef void (*SHT3XLazyMeasCompleteCb)(uint8_t result_code, SHT3XLazyMeasurement *meas, void *user_data);
+
+/**
+ * @brief Measurement converted to physical units, together with its quality metadata.
+ *
+ * Lets downstream filters weigh or reject a measurement without reading out the status register.
+ */
+typedef struct {
+    float temperature; /**< Temperature in degress celsius. */
+    float humidity;    /**< Humidity in RH%. */
+    /** Quality word of the measurement. Decode it with the sht3x_quality_get_* functions. */
+    uint16_t quality;
+    /** Upper bound on the age of the measurement in ms when it was read out, or @ref SHT3X_SAMPLE_AGE_UNKNOWN. */
+    uint32_t sample_age_ms;
+} SHT3XExtMeasurement;
+
+/**
+ * @brief Callback type to execute when the driver finishes reading out a measurement with its quality metadata.
+ *
+ * @param result_code Indicates success or the reason for failure.
+ * @param meas Measurement that was read out. Undefined value if @p result_code is not SHT3X_RESULT_CODE_OK. Do not
+ * dereference the pointer in that case, it may be NULL.
+ * @param user_data User data.
+ *
+ * @note The @p meas pointer only points to valid memory during the execution of this callback. Copy the struct it
+ * points to if the measurement needs to be kept after this callback finished executing.
+ */
+typedef void (*SHT3XExtMeasCompleteCb)(uint8_t result_code, SHT3XExtMeasurement *meas, void *user_data);
+
 /**
  * @brief Callback type to execute when the driver finishes a sequence.
  *
@@ -143,6 +307,25 @@ typedef void (*SHT3XCompleteCb)(uint8_t result_code, void *user_data);
  */
 typedef void (*SHT3XReadStatusRegCompleteCb)(uint8_t result_code, uint16_t reg_val, void *user_data);
 
+/**
+ * @brief Callback type to execute when the driver finishes reading out the serial number.
+ *
+ * @param result_code Indicates success or the reason for failure.
+ * @param serial_number Serial number of the device. Only valid if @p result_code is @ref SHT3X_RESULT_CODE_OK.
+ * @param user_data User data.
+ */
+typedef void (*SHT3XReadSerialNumberCompleteCb)(uint8_t result_code, uint32_t serial_number, void *user_data);
+
+/**
+ * @brief Gets called when init sequence is complete.
+ *
+ * @param result_code Indicates success or the reason for failure.
+ * @param time_to_first_sample_ms Time in ms from the moment this callback is executed until the first measurement is
+ * available for readout. Only valid if @p result_code is @ref SHT3X_RESULT_CODE_OK.
+ * @param user_data User data.
+ */
+typedef void (*SHT3XInitSequenceCompleteCb)(uint8_t result_code, uint32_t time_to_first_sample_ms, void *user_data);
+
 /** @brief Flag indicating that temperature measurement will be read. */
 #define SHT3X_FLAG_READ_TEMP (1U << 0)
 /** @brief Flag indicating that humidity measurement will be read. */
@@ -166,6 +349,10 @@ typedef enum {
     SHT3X_RESULT_CODE_CRC_MISMATCH,
     /** Previous operation is still ongoing, cannot start a new one. */
     SHT3X_RESULT_CODE_BUSY,
+    /** Command is not accepted by the device in its current measurement mode, see @ref SHT3XMeasMode. */
+    SHT3X_RESULT_CODE_WRONG_MODE,
+    /** Status register value read out during a sequence is not the expected one. */
+    SHT3X_RESULT_CODE_UNEXPECTED_STATUS,
 } SHT3XResultCode;
 
 typedef enum {
@@ -188,6 +375,126 @@ typedef enum {
     SHT3X_MPS_10,
 } SHT3XMps;
 
+/** @brief Tracked heater state. */
+typedef enum {
+    SHT3X_HEATER_STATE_UNKNOWN,
+    SHT3X_HEATER_STATE_OFF,
+    SHT3X_HEATER_STATE_ON,
+} SHT3XHeaterState;
+
+/** @brief Tracked measurement mode. */
+typedef enum {
+    SHT3X_MEAS_MODE_UNKNOWN,
+    /** Periodic measurement is not running, single shot measurements can be performed. */
+    SHT3X_MEAS_MODE_SINGLE_SHOT,
+    SHT3X_MEAS_MODE_PERIODIC,
+    SHT3X_MEAS_MODE_PERIODIC_ART,
+} SHT3XMeasMode;
+
+/** @brief Problems detected by the health monitor. */
+typedef enum {
+    /** Raw values were identical in stuck_threshold consecutive readouts. */
+    SHT3X_HEALTH_EVENT_STUCK_VALUE,
+    /** crc_error_threshold readouts out of the last crc_window readouts failed with @ref
+     * SHT3X_RESULT_CODE_CRC_MISMATCH. */
+    SHT3X_HEALTH_EVENT_CRC_ERROR_RATE,
+    /** no_data_threshold consecutive readouts failed with @ref SHT3X_RESULT_CODE_NO_DATA. */
+    SHT3X_HEALTH_EVENT_NO_DATA,
+} SHT3XHealthEvent;
+
+/** Sequence types, reported in @ref SHT3XTraceEvent. A sequence is everything that a public function does with the
+ * device between being called and executing its callback. */
+typedef enum {
+    /** Send a single command resolved when the sequence is started. */
+    SHT3X_SEQUENCE_TYPE_WRITE_CMD,
+    SHT3X_SEQUENCE_TYPE_READ_MEAS,
+    SHT3X_SEQUENCE_TYPE_SINGLE_SHOT_MEAS,
+    SHT3X_SEQUENCE_TYPE_READ_PERIODIC_MEAS,
+    SHT3X_SEQUENCE_TYPE_SOFT_RESET_WITH_DELAY,
+    SHT3X_SEQUENCE_TYPE_READ_STATUS_REG,
+    SHT3X_SEQUENCE_TYPE_READ_SERIAL_NUMBER,
+    SHT3X_SEQUENCE_TYPE_INIT,
+    /** Same as SHT3X_SEQUENCE_TYPE_INIT, but the status register is verified before measurements are started. */
+    SHT3X_SEQUENCE_TYPE_INIT_VERIFY,
+    /** There is currently no ongoing sequence. */
+    SHT3X_SEQUENCE_TYPE_NO_SEQ,
+} SHT3XSequenceType;
+
+/**
+ * @brief Health monitor options.
+ *
+ * Every event fires once when its threshold is reached. It can fire again once the condition clears and builds up
+ * again. Setting a threshold to 0 disables the event.
+ */
+typedef struct {
+    /** Number of consecutive readouts with identical raw values that raise @ref SHT3X_HEALTH_EVENT_STUCK_VALUE. Must
+     * be at least 2. */
+    uint16_t stuck_threshold;
+    /** Number of CRC mismatches within the last crc_window readouts that raise @ref
+     * SHT3X_HEALTH_EVENT_CRC_ERROR_RATE. */
+    uint16_t crc_error_threshold;
+    /** Number of most recent readouts that CRC mismatches are counted in. The window slides by one readout with every
+     * readout. Must be at least crc_error_threshold, and at most @ref SHT3X_HEALTH_MAX_CRC_WINDOW. */
+    uint16_t crc_window;
+    /** Number of consecutive readouts with no data that raise @ref SHT3X_HEALTH_EVENT_NO_DATA. */
+    uint16_t no_data_threshold;
+    /** Executed when an event is raised. Must not be NULL. */
+    SHT3XHealthEventCb cb;
+    /** User data to pass to cb. */
+    void *user_data;
+} SHT3XHealthConfig;
+
+/** @brief Device state tracked by the driver. */
+typedef struct {
+    /** One of @ref SHT3XHeaterState. */
+    uint8_t heater_state;
+    /** One of @ref SHT3XMeasMode. */
+    uint8_t meas_mode;
+    /** Repeatability of the running periodic measurement. Only meaningful if meas_mode is @ref
+     * SHT3X_MEAS_MODE_PERIODIC. */
+    uint8_t repeatability;
+    /** MPS of the running periodic measurement. Only meaningful if meas_mode is @ref SHT3X_MEAS_MODE_PERIODIC. */
+    uint8_t mps;
+    /** Last known status register value. Only meaningful if status_reg_valid is true. */
+    uint16_t status_reg;
+    bool status_reg_valid;
+} SHT3XShadowState;
+
+/**
+ * @brief Measurement request with all options resolved ahead of time.
+ *
+ * Filled in by @ref sht3x_prepare_single_shot_measurement or @ref sht3x_prepare_periodic_measurement, and passed to
+ * @ref sht3x_issue or @ref sht3x_issue_lazy. The fields are private and should not be modified by the caller.
+ */
+typedef struct {
+    /** Command that starts the sequence. */
+    uint8_t cmd[2];
+    /** Number of bytes to read out from the device. */
+    uint8_t read_len;
+    /** Read measurement options. */
+    uint8_t flags;
+    /** Sequence type of the driver. */
+    uint8_t sequence_type;
+    /** Delay in ms between the command and the readout. */
+    uint32_t timer_period;
+    /** Repeatability of a single shot measurement, reported in the quality word. */
+    uint8_t repeatability;
+} SHT3XPreparedMeas;
+
+/** @brief Options of @ref sht3x_init_sequence. */
+typedef struct {
+    /** Measurement mode to start. Only @ref SHT3X_MEAS_MODE_PERIODIC and @ref SHT3X_MEAS_MODE_PERIODIC_ART are
+     * allowed. */
+    uint8_t meas_mode;
+    /** Use @ref SHT3XMeasRepeatability. Only used if meas_mode is @ref SHT3X_MEAS_MODE_PERIODIC. */
+    uint8_t repeatability;
+    /** Use @ref SHT3XMps. Only used if meas_mode is @ref SHT3X_MEAS_MODE_PERIODIC. */
+    uint8_t mps;
+    /** Read out the status register with CRC before measurements are started, and check that the reset, alert,
+     * heater, command status and checksum flags are all cleared. */
+    bool verify_status;
+} SHT3XInitSequenceConfig;
+
 typedef struct {
     SHT3XGetInstanceMemory get_instance_memory;
     /** User data to pass to get_instance_memory function. */
@@ -203,6 +510,11 @@ typedef struct {
     void *start_timer_user_data;
     /** Can be only 0x44 or 0x45 according to the datasheet. */
     uint8_t i2c_addr;
+    /** Executed at every tracepoint. Can be NULL if not needed. Ignored unless the driver is built with
+     * SHT3X_ENABLE_TRACE defined. */
+    SHT3XTraceHook trace_hook;
+    /** User data to pass to trace_hook function. */
+    void *trace_hook_user_data;
 } SHT3XInitConfig;
 
 /**
@@ -238,6 +550,7 @@ uint8_t sht3x_create(SHT3X *const instance, const SHT3XInitConfig *const cfg);
  * SHT3X_I2C_RESULT_CODE_OK.
  * @retval SHT3X_RESULT_CODE_DRIVER_ERR Something went wrong in this driver code.
  * @retval SHT3X_RESULT_CODE_BUSY Failed, there is currently another sequence in progress.
+ * @retval SHT3X_RESULT_CODE_WRONG_MODE Failed, periodic measurement is known to be running.
  */
 uint8_t sht3x_send_single_shot_measurement_cmd(SHT3X self, uint8_t repeatability, uint8_t clock_stretching,
                                                SHT3XCompleteCb cb, void *user_data);
@@ -325,6 +638,35 @@ uint8_t sht3x_send_single_shot_measurement_cmd(SHT3X self, uint8_t repeatability
  */
 uint8_t sht3x_read_measurement(SHT3X self, uint8_t flags, SHT3XMeasCompleteCb cb, void *user_data);
 
+/**
+ * @brief Same as @ref sht3x_read_measurement, but the measurement is not converted to physical units.
+ *
+ * The measurement passed to @p cb holds raw ticks. Use @ref sht3x_lazy_meas_get_temperature and @ref
+ * sht3x_lazy_meas_get_humidity to convert them when the values are actually needed.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[in] flags Read measurement options.
+ * @param[in] cb Callback to execute once complete. Can be NULL if not required.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @return uint8_t Same return values as @ref sht3x_read_measurement.
+ */
+uint8_t sht3x_read_measurement_lazy(SHT3X self, uint8_t flags, SHT3XLazyMeasCompleteCb cb, void *user_data);
+
+/**
+ * @brief Same as @ref sht3x_read_measurement, but the measurement is passed to @p cb with its quality metadata.
+ *
+ * See "Measurement quality" in @ref SHT3X.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[in] flags Read measurement options.
+ * @param[in] cb Callback to execute once complete. Can be NULL if not needed.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @return uint8_t Same return values as @ref sht3x_read_measurement.
+ */
+uint8_t sht3x_read_measurement_ext(SHT3X self, uint8_t flags, SHT3XExtMeasCompleteCb cb, void *user_data);
+
 /**
  * @brief Send start periodic measurement command.
  *
@@ -332,6 +674,9 @@ uint8_t sht3x_read_measurement(SHT3X self, uint8_t flags, SHT3XMeasCompleteCb cb
  * - @ref SHT3X_RESULT_CODE_OK Successfully sent the command.
  * - @ref SHT3X_RESULT_CODE_IO_ERR I2C transaction failed, failed to send the command.
  *
+ * The command is not sent if periodic measurement with the same options is known to be running. See "Tracked device
+ * state" in @ref SHT3X.
+ *
  * @param[in] self Instance created by @ref sht3x_create.
  * @param[in] repeatability Repeatability option. Use @ref SHT3XMeasRepeatability.
  * @param[in] mps Measurement per second (MPS) option. Use @ref SHT3XMps.
@@ -355,6 +700,8 @@ uint8_t sht3x_start_periodic_measurement(SHT3X self, uint8_t repeatability, uint
  * - @ref SHT3X_RESULT_CODE_OK Successfully sent the command.
  * - @ref SHT3X_RESULT_CODE_IO_ERR I2C transaction failed, failed to send the command.
  *
+ * The command is not sent if ART is known to be running. See "Tracked device state" in @ref SHT3X.
+ *
  * @param[in] self Instance created by @ref sht3x_create.
  * @param[in] cb Callback to execute once complete. result_code parameter of this callback indicates success or reason
  * for failure.
@@ -381,6 +728,7 @@ uint8_t sht3x_start_periodic_measurement_art(SHT3X self, SHT3XCompleteCb cb, voi
  * @retval SHT3X_RESULT_CODE_OK Successfully initiated sending the command.
  * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self is NULL.
  * @retval SHT3X_RESULT_CODE_BUSY Failed, there is currently another sequence in progress.
+ * @retval SHT3X_RESULT_CODE_WRONG_MODE Failed, the device is known to be in single shot mode.
  */
 uint8_t sht3x_fetch_periodic_measurement_data(SHT3X self, SHT3XCompleteCb cb, void *user_data);
 
@@ -391,6 +739,8 @@ uint8_t sht3x_fetch_periodic_measurement_data(SHT3X self, SHT3XCompleteCb cb, vo
  * - @ref SHT3X_RESULT_CODE_OK Successfully sent the command.
  * - @ref SHT3X_RESULT_CODE_IO_ERR I2C transaction failed, failed to send the command.
  *
+ * The command is not sent if the device is known to be in single shot mode. See "Tracked device state" in @ref SHT3X.
+ *
  * @param[in] self Instance created by @ref sht3x_create.
  * @param[in] cb Callback to execute once complete. result_code parameter of this callback indicates success or reason
  * for failure.
@@ -427,6 +777,8 @@ uint8_t sht3x_soft_reset(SHT3X self, SHT3XCompleteCb cb, void *user_data);
  * - @ref SHT3X_RESULT_CODE_OK Successfully sent the command.
  * - @ref SHT3X_RESULT_CODE_IO_ERR I2C transaction failed, failed to send the command.
  *
+ * The command is not sent if the heater is known to be on. See "Tracked device state" in @ref SHT3X.
+ *
  * @param[in] self Instance created by @ref sht3x_create.
  * @param[in] cb Callback to execute once complete. result_code parameter of this callback indicates success or reason
  * for failure.
@@ -445,6 +797,8 @@ uint8_t sht3x_enable_heater(SHT3X self, SHT3XCompleteCb cb, void *user_data);
  * - @ref SHT3X_RESULT_CODE_OK Successfully sent the command.
  * - @ref SHT3X_RESULT_CODE_IO_ERR I2C transaction failed, failed to send the command.
  *
+ * The command is not sent if the heater is known to be off. See "Tracked device state" in @ref SHT3X.
+ *
  * @param[in] self Instance created by @ref sht3x_create.
  * @param[in] cb Callback to execute once complete. result_code parameter of this callback indicates success or reason
  * for failure.
@@ -542,11 +896,48 @@ uint8_t sht3x_clear_status_register(SHT3X self, SHT3XCompleteCb cb, void *user_d
  * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self is NULL, @p repeatability option is invalid, @p clock_stretching option
  * is invalid, or combination of @p flags is invalid.
  * @retval SHT3X_RESULT_CODE_BUSY Failed, there is currently another sequence in progress.
+ * @retval SHT3X_RESULT_CODE_WRONG_MODE Failed, periodic measurement is known to be running.
  * @retval SHT3X_RESULT_CODE_DRIVER_ERR Something went wrong in this driver code.
  */
 uint8_t sht3x_read_single_shot_measurement(SHT3X self, uint8_t repeatability, uint8_t clock_stretching, uint8_t flags,
                                            SHT3XMeasCompleteCb cb, void *user_data);
 
+/**
+ * @brief Same as @ref sht3x_read_single_shot_measurement, but the measurement is not converted to physical units.
+ *
+ * The measurement passed to @p cb holds raw ticks. Use @ref sht3x_lazy_meas_get_temperature and @ref
+ * sht3x_lazy_meas_get_humidity to convert them when the values are actually needed.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[in] repeatability Repeatability option, use @ref SHT3XMeasRepeatability.
+ * @param[in] clock_stretching Clock stretching option, use @ref SHT3XClockStretching.
+ * @param[in] flags Read measurement options.
+ * @param[in] cb Callback to execute once the command is complete. Can be NULL if not needed.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @return uint8_t Same return values as @ref sht3x_read_single_shot_measurement.
+ */
+uint8_t sht3x_read_single_shot_measurement_lazy(SHT3X self, uint8_t repeatability, uint8_t clock_stretching,
+                                                uint8_t flags, SHT3XLazyMeasCompleteCb cb, void *user_data);
+
+/**
+ * @brief Same as @ref sht3x_read_single_shot_measurement, but the measurement is passed to @p cb with its quality
+ * metadata.
+ *
+ * See "Measurement quality" in @ref SHT3X.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[in] repeatability Repeatability option, use @ref SHT3XMeasRepeatability.
+ * @param[in] clock_stretching Clock stretching option, use @ref SHT3XClockStretching.
+ * @param[in] flags Read measurement options.
+ * @param[in] cb Callback to execute once complete. Can be NULL if not needed.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @return uint8_t Same return values as @ref sht3x_read_single_shot_measurement.
+ */
+uint8_t sht3x_read_single_shot_measurement_ext(SHT3X self, uint8_t repeatability, uint8_t clock_stretching,
+                                               uint8_t flags, SHT3XExtMeasCompleteCb cb, void *user_data);
+
 /**
  * @brief Read out a periodic measurements.
  *
@@ -583,9 +974,120 @@ uint8_t sht3x_read_single_shot_measurement(SHT3X self, uint8_t repeatability, ui
  * measurement readout was successful - this is indicated by the result_code parameter of @p cb.
  * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self is NULL, or combination of @p flags is invalid.
  * @retval SHT3X_RESULT_CODE_BUSY Failed, there is currently another sequence in progress.
+ * @retval SHT3X_RESULT_CODE_WRONG_MODE Failed, the device is known to be in single shot mode.
  */
 uint8_t sht3x_read_periodic_measurement(SHT3X self, uint8_t flags, SHT3XMeasCompleteCb cb, void *user_data);
 
+/**
+ * @brief Same as @ref sht3x_read_periodic_measurement, but the measurement is not converted to physical units.
+ *
+ * The measurement passed to @p cb holds raw ticks. Use @ref sht3x_lazy_meas_get_temperature and @ref
+ * sht3x_lazy_meas_get_humidity to convert them when the values are actually needed.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[in] flags Read measurement options.
+ * @param[in] cb Callback to execute once the command is complete. Can be NULL if not needed.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @return uint8_t Same return values as @ref sht3x_read_periodic_measurement.
+ */
+uint8_t sht3x_read_periodic_measurement_lazy(SHT3X self, uint8_t flags, SHT3XLazyMeasCompleteCb cb, void *user_data);
+
+/**
+ * @brief Same as @ref sht3x_read_periodic_measurement, but the measurement is passed to @p cb with its quality
+ * metadata.
+ *
+ * See "Measurement quality" in @ref SHT3X.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[in] flags Read measurement options.
+ * @param[in] cb Callback to execute once complete. Can be NULL if not needed.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @return uint8_t Same return values as @ref sht3x_read_periodic_measurement.
+ */
+uint8_t sht3x_read_periodic_measurement_ext(SHT3X self, uint8_t flags, SHT3XExtMeasCompleteCb cb, void *user_data);
+
+/**
+ * @brief Prepare a single shot measurement to be issued with @ref sht3x_issue.
+ *
+ * Validates the options and resolves the command, the delay before readout and the readout length once. The prepared
+ * measurement can then be issued any number of times, on any instance, without repeating this work.
+ *
+ * @param[in] repeatability Repeatability option, use @ref SHT3XMeasRepeatability.
+ * @param[in] clock_stretching Clock stretching option, use @ref SHT3XClockStretching.
+ * @param[in] flags Read measurement options, same as in @ref sht3x_read_single_shot_measurement.
+ * @param[out] prepared Prepared measurement is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p prepared is NULL, or one of the options is invalid.
+ * @retval SHT3X_RESULT_CODE_DRIVER_ERR Something went wrong in this driver code.
+ */
+uint8_t sht3x_prepare_single_shot_measurement(uint8_t repeatability, uint8_t clock_stretching, uint8_t flags,
+                                              SHT3XPreparedMeas *const prepared);
+
+/**
+ * @brief Prepare a periodic measurement readout to be issued with @ref sht3x_issue.
+ *
+ * @param[in] flags Read measurement options, same as in @ref sht3x_read_periodic_measurement.
+ * @param[out] prepared Prepared measurement is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p prepared is NULL, or @p flags is invalid.
+ */
+uint8_t sht3x_prepare_periodic_measurement(uint8_t flags, SHT3XPreparedMeas *const prepared);
+
+/**
+ * @brief Issue a prepared measurement.
+ *
+ * Behaves the same as @ref sht3x_read_single_shot_measurement or @ref sht3x_read_periodic_measurement with the options
+ * that @p prepared was prepared with, but the options are not validated and resolved again.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[in] prepared Measurement prepared by @ref sht3x_prepare_single_shot_measurement or @ref
+ * sht3x_prepare_periodic_measurement. Does not need to stay valid after this function returns.
+ * @param[in] cb Callback to execute once complete. Can be NULL if not needed.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Successfully initiated the sequence.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self or @p prepared is NULL, or @p prepared was not prepared by one of the
+ * prepare functions.
+ * @retval SHT3X_RESULT_CODE_BUSY Failed, there is currently another sequence in progress.
+ * @retval SHT3X_RESULT_CODE_WRONG_MODE Failed, the device is known to be in a measurement mode that does not accept
+ * the prepared measurement.
+ */
+uint8_t sht3x_issue(SHT3X self, const SHT3XPreparedMeas *const prepared, SHT3XMeasCompleteCb cb, void *user_data);
+
+/**
+ * @brief Same as @ref sht3x_issue, but the measurement is not converted to physical units.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[in] prepared Measurement prepared by @ref sht3x_prepare_single_shot_measurement or @ref
+ * sht3x_prepare_periodic_measurement.
+ * @param[in] cb Callback to execute once complete. Can be NULL if not needed.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @return uint8_t Same return values as @ref sht3x_issue.
+ */
+uint8_t sht3x_issue_lazy(SHT3X self, const SHT3XPreparedMeas *const prepared, SHT3XLazyMeasCompleteCb cb,
+                         void *user_data);
+
+/**
+ * @brief Same as @ref sht3x_issue, but the measurement is passed to @p cb with its quality metadata.
+ *
+ * See "Measurement quality" in @ref SHT3X.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[in] prepared Measurement prepared by @ref sht3x_prepare_single_shot_measurement or @ref
+ * sht3x_prepare_periodic_measurement.
+ * @param[in] cb Callback to execute once complete. Can be NULL if not needed.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @return uint8_t Same return values as @ref sht3x_issue.
+ */
+uint8_t sht3x_issue_ext(SHT3X self, const SHT3XPreparedMeas *const prepared, SHT3XExtMeasCompleteCb cb,
+                        void *user_data);
+
 /**
  * @brief Perform soft reset and wait for 2 ms afterwards.
  *
@@ -639,6 +1141,173 @@ uint8_t sht3x_soft_reset_with_delay(SHT3X self, SHT3XCompleteCb cb, void *user_d
  */
 uint8_t sht3x_read_status_register(SHT3X self, bool verify_crc, SHT3XReadStatusRegCompleteCb cb, void *user_data);
 
+/**
+ * @brief Read out the serial number of the device.
+ *
+ * Sends the read serial number command, waits for 1 ms, and reads out the serial number. CRC of both serial number
+ * words is always verified.
+ *
+ * Potential values of result_code parameter of @p cb:
+ * - @ref SHT3X_RESULT_CODE_OK Successfully read out the serial number.
+ * - @ref SHT3X_RESULT_CODE_IO_ERR One of the I2C transactions failed.
+ * - @ref SHT3X_RESULT_CODE_CRC_MISMATCH CRC of one of the serial number words is wrong.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[in] cb Callback to execute once complete. Can be NULL if not needed.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Successfully initiated the sequence.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self is NULL.
+ * @retval SHT3X_RESULT_CODE_BUSY Failed, there is currently another sequence in progress.
+ */
+uint8_t sht3x_read_serial_number(SHT3X self, SHT3XReadSerialNumberCompleteCb cb, void *user_data);
+
+/**
+ * @brief Bring the device up and start periodic measurement or ART.
+ *
+ * Steps:
+ * 1. Send soft reset command.
+ * 2. Wait for 2 ms - soft reset time.
+ * 3. Send clear status register command.
+ * 4. Wait for 1 ms - mandatory delay between subsequent I2C commands.
+ * 5. If cfg->verify_status is true:
+ *   1. Send read status register command.
+ *   2. Wait for 1 ms - mandatory delay between subsequent I2C commands.
+ *   3. Read out the status register value and its CRC, and verify them.
+ * 6. Send start periodic measurement command or ART command, depending on cfg->meas_mode.
+ * 7. Call @p cb with the time to first sample.
+ *
+ * The time to first sample is the maximum measurement duration for the configured repeatability. ART is assumed to
+ * use high repeatability.
+ *
+ * Tracked device state is updated after every command, so if the sequence fails half way, @ref sht3x_get_shadow_state
+ * shows how far the device got.
+ *
+ * Possible values of result_code parameter in @p cb and their meaning:
+ * - @ref SHT3X_RESULT_CODE_OK Measurements are started.
+ * - @ref SHT3X_RESULT_CODE_IO_ERR One of the I2C transactions failed. The remaining steps were not performed.
+ * - @ref SHT3X_RESULT_CODE_CRC_MISMATCH Status register CRC verification failed. Measurements were not started.
+ * - @ref SHT3X_RESULT_CODE_UNEXPECTED_STATUS At least one of the verified status register flags is set. Measurements
+ * were not started.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[in] cfg Init sequence options.
+ * @param[in] cb Callback to execute once complete. Can be NULL if not needed.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Successfully initiated init sequence.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self is NULL, @p cfg is NULL, or one of the options in @p cfg is invalid.
+ * @retval SHT3X_RESULT_CODE_BUSY Failed to initiate sequence, there is currently another sequence in progress.
+ */
+uint8_t sht3x_init_sequence(SHT3X self, const SHT3XInitSequenceConfig *const cfg, SHT3XInitSequenceCompleteCb cb,
+                            void *user_data);
+
+/**
+ * @brief Check whether periodic measurement options are valid.
+ *
+ * These are the options of @ref SHT3XInitSequenceConfig. Modules that start periodic measurement on behalf of the
+ * caller use this function to validate their configs the same way the driver does.
+ *
+ * @param[in] meas_mode @ref SHT3X_MEAS_MODE_PERIODIC or @ref SHT3X_MEAS_MODE_PERIODIC_ART.
+ * @param[in] repeatability Use @ref SHT3XMeasRepeatability. Only checked if @p meas_mode is @ref
+ * SHT3X_MEAS_MODE_PERIODIC.
+ * @param[in] mps Use @ref SHT3XMps. Only checked if @p meas_mode is @ref SHT3X_MEAS_MODE_PERIODIC.
+ *
+ * @retval true Options are valid.
+ * @retval false At least one of the options is invalid.
+ */
+bool sht3x_is_valid_periodic_cfg(uint8_t meas_mode, uint8_t repeatability, uint8_t mps);
+
+/**
+ * @brief Get device state tracked by the driver.
+ *
+ * Does not perform any I2C transactions. Can be called while a sequence is in progress, in which case the state does
+ * not reflect the effect of that sequence yet.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[out] state Tracked device state is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self or @p state is NULL.
+ */
+uint8_t sht3x_get_shadow_state(SHT3X self, SHT3XShadowState *const state);
+
+/**
+ * @brief Mark all device state tracked by the driver as unknown.
+ *
+ * Should be called if the device state could have changed without the driver knowing, e.g. the device lost power.
+ * The next command of every kind is then sent to the device regardless of its previous state.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self is NULL.
+ * @retval SHT3X_RESULT_CODE_BUSY Failed, there is currently another sequence in progress.
+ */
+uint8_t sht3x_invalidate_shadow_state(SHT3X self);
+
+/**
+ * @brief Enable the health monitor.
+ *
+ * The outcome of every measurement readout is then checked in constant time as a part of the complete path, and
+ * cfg->cb is executed after the measurement complete callback if an event is raised. Enabling the monitor again
+ * restarts it with the new config.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[in] cfg Health monitor options. Copied into the instance.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self or @p cfg is NULL, cfg->cb is NULL, cfg->stuck_threshold is 1,
+ * cfg->crc_window is less than cfg->crc_error_threshold, or cfg->crc_window is greater than @ref
+ * SHT3X_HEALTH_MAX_CRC_WINDOW.
+ */
+uint8_t sht3x_enable_health_monitor(SHT3X self, const SHT3XHealthConfig *const cfg);
+
+/**
+ * @brief Disable the health monitor.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self is NULL.
+ */
+uint8_t sht3x_disable_health_monitor(SHT3X self);
+
+/**
+ * @brief Save the tracked device state into a buffer.
+ *
+ * The buffer contains the I2C address and the tracked device state, protected by a CRC. Callbacks from the init config
+ * are not saved, they are provided again to @ref sht3x_create after wakeup.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[out] buf Snapshot is written here.
+ * @param[in] length Size of @p buf in bytes. Must be at least @ref SHT3X_SNAPSHOT_SIZE.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success. The first @ref SHT3X_SNAPSHOT_SIZE bytes of @p buf contain the snapshot.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self or @p buf is NULL, or @p length is too small.
+ * @retval SHT3X_RESULT_CODE_BUSY Failed, there is currently another sequence in progress.
+ */
+uint8_t sht3x_snapshot(SHT3X self, uint8_t *const buf, size_t length);
+
+/**
+ * @brief Apply tracked device state saved by @ref sht3x_snapshot.
+ *
+ * Typically called right after @ref sht3x_create. Does not perform any I2C transactions. The device is assumed to have
+ * kept running since the snapshot was taken. If it could have lost power in between, call @ref
+ * sht3x_invalidate_shadow_state or read out the status register to detect the reset.
+ *
+ * @param[in] self Instance created by @ref sht3x_create.
+ * @param[in] buf Snapshot written by @ref sht3x_snapshot.
+ * @param[in] length Size of @p buf in bytes. Must be at least @ref SHT3X_SNAPSHOT_SIZE.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p self or @p buf is NULL, @p length is too small, the snapshot was written by
+ * a different version of this driver, for a device with a different I2C address, or contains invalid values.
+ * @retval SHT3X_RESULT_CODE_CRC_MISMATCH Snapshot is corrupted.
+ * @retval SHT3X_RESULT_CODE_BUSY Failed, there is currently another sequence in progress.
+ */
+uint8_t sht3x_restore(SHT3X self, const uint8_t *const buf, size_t length);
+
 /**
  * @brief Destroy a SHT3X instance.
  *
@@ -653,6 +1322,81 @@ uint8_t sht3x_read_status_register(SHT3X self, bool verify_crc, SHT3XReadStatusR
  */
 uint8_t sht3x_destroy(SHT3X self, SHT3XFreeInstanceMemory free_instance_memory, void *user_data);
 
+/**
+ * @brief Get temperature of a lazy measurement in degrees Celsius.
+ *
+ * Converts the raw temperature ticks on the first call, and returns the memoized value on subsequent calls.
+ *
+ * @param[in,out] meas Measurement passed to @ref SHT3XLazyMeasCompleteCb, or a copy of it.
+ * @param[out] temperature Temperature in degrees Celsius is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p meas or @p temperature is NULL, or temperature was not read out.
+ */
+uint8_t sht3x_lazy_meas_get_temperature(SHT3XLazyMeasurement *const meas, float *const temperature);
+
+/**
+ * @brief Get humidity of a lazy measurement in RH%.
+ *
+ * Converts the raw humidity ticks on the first call, and returns the memoized value on subsequent calls.
+ *
+ * @param[in,out] meas Measurement passed to @ref SHT3XLazyMeasCompleteCb, or a copy of it.
+ * @param[out] humidity Humidity in RH% is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p meas or @p humidity is NULL, or humidity was not read out.
+ */
+uint8_t sht3x_lazy_meas_get_humidity(SHT3XLazyMeasurement *const meas, float *const humidity);
+
+/**
+ * @brief Get the read flags from the quality word of a measurement.
+ *
+ * @param quality Quality word of a measurement.
+ *
+ * @return uint8_t Read flags that the measurement was read out with, a combination of SHT3X_FLAG_* values. Tells which
+ * values were read out, and which of them had their CRC verified.
+ */
+uint8_t sht3x_quality_get_flags(uint16_t quality);
+
+/**
+ * @brief Get the heater state from the quality word of a measurement.
+ *
+ * @param quality Quality word of a measurement.
+ *
+ * @return uint8_t Tracked heater state when the measurement was read out, one of @ref SHT3XHeaterState.
+ */
+uint8_t sht3x_quality_get_heater_state(uint16_t quality);
+
+/**
+ * @brief Get the measurement mode from the quality word of a measurement.
+ *
+ * @param quality Quality word of a measurement.
+ *
+ * @return uint8_t Measurement mode the measurement was taken in, one of @ref SHT3XMeasMode. @ref
+ * SHT3X_MEAS_MODE_PERIODIC_ART if it was taken in ART mode.
+ */
+uint8_t sht3x_quality_get_meas_mode(uint16_t quality);
+
+/**
+ * @brief Get the repeatability from the quality word of a measurement.
+ *
+ * @param quality Quality word of a measurement.
+ *
+ * @return uint8_t Repeatability the measurement was taken with, one of @ref SHT3XMeasRepeatability, or @ref
+ * SHT3X_QUALITY_REPEATABILITY_UNKNOWN.
+ */
+uint8_t sht3x_quality_get_repeatability(uint16_t quality);
+
+/**
+ * @brief Get the retry count from the quality word of a measurement.
+ *
+ * @param quality Quality word of a measurement.
+ *
+ * @return uint8_t Number of consecutive failed measurement readouts on the instance right before this measurement,
+ * up to @ref SHT3X_QUALITY_MAX_RETRY_COUNT.
+ */
+uint8_t sht3x_quality_get_retry_count(uint16_t quality);
+
 /**
  * @brief Check whether CRC of last write transfer was correct.
  *
@@ -0,0 +1,231 @@
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_adaptive.h"
+
+/**
+ * @brief Check whether adaptive controller level is valid.
+ *
+ * @param[in] level Level.
+ *
+ * @retval true Level is valid.
+ * @retval false Level is invalid.
+ */
+static bool is_valid_level(const SHT3XAdaptiveLevel *const level)
+{
+    return sht3x_is_valid_periodic_cfg(level->meas_mode, level->repeatability, level->mps);
+}
+
+/**
+ * @brief Check whether adaptive controller config is valid.
+ *
+ * @param[in] cfg Adaptive controller config.
+ *
+ * @retval true Config is valid.
+ * @retval false Config is invalid.
+ */
+static bool is_valid_cfg(const SHT3XAdaptiveConfig *const cfg)
+{
+    // clang-format off
+    bool valid = (
+        (cfg)
+        && (cfg->instance)
+        && (cfg->levels)
+        && (cfg->num_levels >= 2)
+        && (cfg->initial_level < cfg->num_levels)
+        && (cfg->temp_slow_threshold >= 0.0f)
+        && (cfg->temp_slow_threshold < cfg->temp_fast_threshold)
+        && (cfg->hum_slow_threshold >= 0.0f)
+        && (cfg->hum_slow_threshold < cfg->hum_fast_threshold)
+        && (cfg->settle_count >= 1)
+        && (cfg->start_timer)
+    );
+    // clang-format on
+    if (!valid) {
+        return false;
+    }
+    for (uint8_t i = 0; i < cfg->num_levels; i++) {
+        if (!is_valid_level(&(cfg->levels[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Get absolute rate of change per second.
+ *
+ * @param[in] prev Previous value.
+ * @param[in] cur Current value.
+ * @param[in] elapsed_ms Time between the two values in ms. Must not be 0.
+ *
+ * @return float Absolute rate of change per second.
+ */
+static float get_rate(float prev, float cur, uint32_t elapsed_ms)
+{
+    float delta = (cur > prev) ? (cur - prev) : (prev - cur);
+    return (delta * 1000.0f) / (float)elapsed_ms;
+}
+
+/**
+ * @brief Complete the transition in progress and execute the transition callback.
+ *
+ * @param[in] adaptive Adaptive controller.
+ * @param[in] rc Result of the transition, use @ref SHT3XResultCode.
+ */
+static void complete_transition(SHT3XAdaptive *adaptive, uint8_t rc)
+{
+    if (rc == SHT3X_RESULT_CODE_OK) {
+        if (adaptive->transition.to_level > adaptive->transition.from_level) {
+            adaptive->num_up++;
+        } else {
+            adaptive->num_down++;
+        }
+        adaptive->level = adaptive->transition.to_level;
+    }
+    adaptive->in_transition = false;
+    if (adaptive->cfg.transition_cb) {
+        adaptive->cfg.transition_cb(rc, &(adaptive->transition), adaptive->cfg.transition_cb_user_data);
+    }
+}
+
+static void start_complete_cb(uint8_t result_code, void *user_data)
+{
+    SHT3XAdaptive *adaptive = (SHT3XAdaptive *)user_data;
+    if (!adaptive) {
+        return;
+    }
+    complete_transition(adaptive, result_code);
+}
+
+static void timer_expired_cb(void *user_data)
+{
+    SHT3XAdaptive *adaptive = (SHT3XAdaptive *)user_data;
+    if (!adaptive) {
+        return;
+    }
+    const SHT3XAdaptiveLevel *level = &(adaptive->cfg.levels[adaptive->transition.to_level]);
+    uint8_t rc;
+    if (level->meas_mode == SHT3X_MEAS_MODE_PERIODIC_ART) {
+        rc = sht3x_start_periodic_measurement_art(adaptive->cfg.instance, start_complete_cb, (void *)adaptive);
+    } else {
+        rc = sht3x_start_periodic_measurement(adaptive->cfg.instance, level->repeatability, level->mps,
+                                              start_complete_cb, (void *)adaptive);
+    }
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        complete_transition(adaptive, rc);
+    }
+}
+
+static void stop_complete_cb(uint8_t result_code, void *user_data)
+{
+    SHT3XAdaptive *adaptive = (SHT3XAdaptive *)user_data;
+    if (!adaptive) {
+        return;
+    }
+    if (result_code != SHT3X_RESULT_CODE_OK) {
+        complete_transition(adaptive, result_code);
+        return;
+    }
+    adaptive->cfg.start_timer(SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS, adaptive->cfg.start_timer_user_data,
+                              timer_expired_cb, (void *)adaptive);
+}
+
+/**
+ * @brief Start transition to another level.
+ *
+ * @param[in] adaptive Adaptive controller.
+ * @param[in] to_level Index of the level to move to.
+ * @param[in] temp_rate Temperature rate that caused the transition.
+ * @param[in] hum_rate Humidity rate that caused the transition.
+ */
+static void start_transition(SHT3XAdaptive *adaptive, uint8_t to_level, float temp_rate, float hum_rate)
+{
+    adaptive->settled = 0;
+    adaptive->in_transition = true;
+    adaptive->transition.from_level = adaptive->level;
+    adaptive->transition.to_level = to_level;
+    adaptive->transition.temp_rate = temp_rate;
+    adaptive->transition.hum_rate = hum_rate;
+
+    uint8_t rc = sht3x_stop_periodic_measurement(adaptive->cfg.instance, stop_complete_cb, (void *)adaptive);
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        complete_transition(adaptive, rc);
+    }
+}
+
+uint8_t sht3x_adaptive_init(SHT3XAdaptive *const adaptive, const SHT3XAdaptiveConfig *const cfg)
+{
+    if (!adaptive || !is_valid_cfg(cfg)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    adaptive->cfg = *cfg;
+    adaptive->level = cfg->initial_level;
+    adaptive->in_transition = false;
+    adaptive->has_prev_meas = false;
+    adaptive->settled = 0;
+    adaptive->num_up = 0;
+    adaptive->num_down = 0;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_adaptive_update(SHT3XAdaptive *const adaptive, const SHT3XMeasurement *const meas, uint32_t elapsed_ms)
+{
+    if (!adaptive || !meas) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (adaptive->in_transition) {
+        return SHT3X_RESULT_CODE_BUSY;
+    }
+
+    bool has_prev_meas = adaptive->has_prev_meas;
+    SHT3XMeasurement prev_meas = adaptive->prev_meas;
+    adaptive->prev_meas = *meas;
+    adaptive->has_prev_meas = true;
+    if (!has_prev_meas || (elapsed_ms == 0)) {
+        return SHT3X_RESULT_CODE_OK;
+    }
+
+    const SHT3XAdaptiveConfig *cfg = &(adaptive->cfg);
+    float temp_rate = get_rate(prev_meas.temperature, meas->temperature, elapsed_ms);
+    float hum_rate = get_rate(prev_meas.humidity, meas->humidity, elapsed_ms);
+
+    if ((temp_rate >= cfg->temp_fast_threshold) || (hum_rate >= cfg->hum_fast_threshold)) {
+        adaptive->settled = 0;
+        if (adaptive->level < (cfg->num_levels - 1)) {
+            start_transition(adaptive, adaptive->level + 1, temp_rate, hum_rate);
+        }
+    } else if ((temp_rate <= cfg->temp_slow_threshold) && (hum_rate <= cfg->hum_slow_threshold)) {
+        if (adaptive->settled < cfg->settle_count) {
+            adaptive->settled++;
+        }
+        if ((adaptive->settled == cfg->settle_count) && (adaptive->level > 0)) {
+            start_transition(adaptive, adaptive->level - 1, temp_rate, hum_rate);
+        }
+    } else {
+        /* Within hysteresis band */
+        adaptive->settled = 0;
+    }
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_adaptive_get_level(const SHT3XAdaptive *const adaptive, uint8_t *const level)
+{
+    if (!adaptive || !level) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    *level = adaptive->level;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_adaptive_get_transition_counts(const SHT3XAdaptive *const adaptive, uint32_t *const num_up,
+                                             uint32_t *const num_down)
+{
+    if (!adaptive || !num_up || !num_down) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    *num_up = adaptive->num_up;
+    *num_down = adaptive->num_down;
+    return SHT3X_RESULT_CODE_OK;
+}
@@ -0,0 +1,184 @@
+#ifndef SRC_SHT3X_ADAPTIVE_H
+#define SRC_SHT3X_ADAPTIVE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Adaptive sampling controller.
+ *
+ * The controller switches a device that performs periodic measurements between a number of levels, depending on how
+ * fast the measured values change. Levels are provided by the caller, ordered from the slowest and cheapest one, e.g.
+ * @ref SHT3X_MPS_0_5 with low repeatability, to the fastest one, e.g. @ref SHT3X_MPS_10 with high repeatability or ART.
+ *
+ * Every measurement is passed to @ref sht3x_adaptive_update, together with the time elapsed since the previous one.
+ * The controller computes the rate of change of temperature and humidity:
+ * - If either rate is at or above its fast threshold, the controller moves one level up right away.
+ * - If both rates are at or below their slow thresholds for settle_count measurements in a row, the controller moves
+ * one level down.
+ * - Rates between the slow and fast thresholds keep the current level. The gap between the thresholds, together with
+ * settle_count, is the hysteresis that prevents the controller from switching back and forth.
+ *
+ * Moving to another level stops periodic measurement, waits for @ref SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS, and
+ * starts periodic measurement or ART with the options of the new level. No readouts must be started until the
+ * transition callback is executed. Calling @ref sht3x_adaptive_update from the measurement complete callback is safe.
+ *
+ * Every transition is reported to the transition callback together with the rates that caused it, so that the
+ * thresholds can be tuned.
+ */
+
+/** One level of the adaptive controller. */
+typedef struct {
+    /** @ref SHT3X_MEAS_MODE_PERIODIC or @ref SHT3X_MEAS_MODE_PERIODIC_ART. */
+    uint8_t meas_mode;
+    /** Use @ref SHT3XMeasRepeatability. Only used if meas_mode is @ref SHT3X_MEAS_MODE_PERIODIC. */
+    uint8_t repeatability;
+    /** Use @ref SHT3XMps. Only used if meas_mode is @ref SHT3X_MEAS_MODE_PERIODIC. */
+    uint8_t mps;
+} SHT3XAdaptiveLevel;
+
+/** Level transition, reported to @ref SHT3XAdaptiveTransitionCb. */
+typedef struct {
+    /** Index of the level before the transition. */
+    uint8_t from_level;
+    /** Index of the level after the transition, if it succeeded. */
+    uint8_t to_level;
+    /** Absolute rate of change of temperature in degrees celsius per second that caused the transition. */
+    float temp_rate;
+    /** Absolute rate of change of humidity in RH% per second that caused the transition. */
+    float hum_rate;
+} SHT3XAdaptiveTransition;
+
+/**
+ * @brief Gets called when a level transition is complete.
+ *
+ * @param result_code @ref SHT3X_RESULT_CODE_OK if the device now runs the new level. Otherwise, the result code of the
+ * stop or start command that failed, e.g. @ref SHT3X_RESULT_CODE_BUSY if a sequence of the instance was in progress.
+ * The controller then stays at the previous level, but the device might not be running it.
+ * @param transition Transition that was performed. Only valid during the callback.
+ * @param user_data User data.
+ */
+typedef void (*SHT3XAdaptiveTransitionCb)(uint8_t result_code, const SHT3XAdaptiveTransition *transition,
+                                          void *user_data);
+
+typedef struct {
+    /** Instance created by @ref sht3x_create, running the options of initial_level. */
+    SHT3X instance;
+    /** Levels, from the slowest to the fastest one. Must stay valid as long as the controller is used. */
+    const SHT3XAdaptiveLevel *levels;
+    /** Number of elements in levels. At least 2. */
+    uint8_t num_levels;
+    /** Index of the level that the device is running when the controller is initialized. */
+    uint8_t initial_level;
+    /** Move one level up if temperature changes at least this fast, in degrees celsius per second. */
+    float temp_fast_threshold;
+    /** Temperature is considered settled if it changes at most this fast. Must be below temp_fast_threshold. */
+    float temp_slow_threshold;
+    /** Move one level up if humidity changes at least this fast, in RH% per second. */
+    float hum_fast_threshold;
+    /** Humidity is considered settled if it changes at most this fast. Must be below hum_fast_threshold. */
+    float hum_slow_threshold;
+    /** Number of settled measurements in a row needed to move one level down. At least 1. */
+    uint8_t settle_count;
+    /** Executed after every transition. Can be NULL if not needed. */
+    SHT3XAdaptiveTransitionCb transition_cb;
+    /** User data to pass to transition_cb. */
+    void *transition_cb_user_data;
+    /** Used for the mandatory delay between the stop and start commands. */
+    SHT3XStartTimer start_timer;
+    /** User data to pass to start_timer function. */
+    void *start_timer_user_data;
+} SHT3XAdaptiveConfig;
+
+/**
+ * @brief Adaptive controller state.
+ *
+ * Provided by the caller, and must stay valid as long as the controller is used. The fields are private and should
+ * not be modified by the caller.
+ */
+typedef struct {
+    SHT3XAdaptiveConfig cfg;
+    /** Index of the level that the device is running. */
+    uint8_t level;
+    /** Transition in progress, valid if in_transition is true. */
+    SHT3XAdaptiveTransition transition;
+    bool in_transition;
+    /** prev_meas holds a measurement. */
+    bool has_prev_meas;
+    SHT3XMeasurement prev_meas;
+    /** Number of settled measurements in a row. */
+    uint8_t settled;
+    /** Number of completed transitions up. */
+    uint32_t num_up;
+    /** Number of completed transitions down. */
+    uint32_t num_down;
+} SHT3XAdaptive;
+
+/**
+ * @brief Initialize an adaptive controller.
+ *
+ * Does not perform any I2C transactions. The device must already be running the options of initial_level.
+ *
+ * @param[out] adaptive Caller-provided memory for the controller state.
+ * @param[in] cfg Controller options. Copied into @p adaptive.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p adaptive or @p cfg is NULL, instance, levels or start_timer is NULL, fewer
+ * than 2 levels, one of the levels is invalid, or one of the options is out of range.
+ */
+uint8_t sht3x_adaptive_init(SHT3XAdaptive *const adaptive, const SHT3XAdaptiveConfig *const cfg);
+
+/**
+ * @brief Pass a new measurement to the adaptive controller.
+ *
+ * Both temperature and humidity of @p meas must have been read out. If the measurement requires a transition, it is
+ * started before this function returns.
+ *
+ * @param[in] adaptive Controller initialized by @ref sht3x_adaptive_init.
+ * @param[in] meas Measurement. Does not need to stay valid after this function returns.
+ * @param[in] elapsed_ms Time since the previous measurement passed to this function, in ms. Ignored for the first
+ * measurement. If 0, the measurement only replaces the previous one, and no rates are computed.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Measurement is processed. A transition may have been started.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p adaptive or @p meas is NULL.
+ * @retval SHT3X_RESULT_CODE_BUSY A transition is in progress, the measurement is ignored.
+ */
+uint8_t sht3x_adaptive_update(SHT3XAdaptive *const adaptive, const SHT3XMeasurement *const meas, uint32_t elapsed_ms);
+
+/**
+ * @brief Get the index of the level that the device is running.
+ *
+ * @param[in] adaptive Controller initialized by @ref sht3x_adaptive_init.
+ * @param[out] level Level index is written here. During a transition, this is the level before the transition.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p adaptive or @p level is NULL.
+ */
+uint8_t sht3x_adaptive_get_level(const SHT3XAdaptive *const adaptive, uint8_t *const level);
+
+/**
+ * @brief Get the number of completed transitions in each direction since initialization.
+ *
+ * @param[in] adaptive Controller initialized by @ref sht3x_adaptive_init.
+ * @param[out] num_up Number of transitions to a faster level is written here.
+ * @param[out] num_down Number of transitions to a slower level is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p adaptive, @p num_up or @p num_down is NULL.
+ */
+uint8_t sht3x_adaptive_get_transition_counts(const SHT3XAdaptive *const adaptive, uint32_t *const num_up,
+                                             uint32_t *const num_down);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_ADAPTIVE_H */
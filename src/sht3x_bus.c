@@ -0,0 +1,231 @@
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_bus.h"
+
+/* Bits on the bus per byte, including the ACK bit */
+#define SHT3X_BUS_BITS_PER_BYTE 9
+/* Start and stop conditions take about one bit period each */
+#define SHT3X_BUS_START_STOP_BITS 2
+
+static uint32_t saturating_add_u32(uint32_t a, uint32_t b)
+{
+    return ((UINT32_MAX - a) < b) ? UINT32_MAX : (a + b);
+}
+
+static uint64_t saturating_add_u64(uint64_t a, uint64_t b)
+{
+    return ((UINT64_MAX - a) < b) ? UINT64_MAX : (a + b);
+}
+
+static void reset_counters(SHT3XBusCounters *counters)
+{
+    counters->transactions = 0;
+    counters->failed_transactions = 0;
+    counters->bytes_written = 0;
+    counters->bytes_read = 0;
+    counters->transaction_time_us = 0;
+    counters->airtime_us = 0;
+}
+
+/**
+ * @brief Estimate how long a transaction occupies the bus.
+ *
+ * @param[in] length Number of data bytes, not including the address byte.
+ * @param[in] bus_speed_hz Bus clock speed in Hz.
+ *
+ * @return uint64_t Estimated airtime in microseconds, rounded up.
+ */
+static uint64_t estimate_airtime_us(size_t length, uint32_t bus_speed_hz)
+{
+    uint64_t bits = (((uint64_t)length + 1) * SHT3X_BUS_BITS_PER_BYTE) + SHT3X_BUS_START_STOP_BITS;
+    return ((bits * 1000000) + bus_speed_hz - 1) / bus_speed_hz;
+}
+
+static void add_transaction(SHT3XBusCounters *counters, bool is_read, size_t length, bool failed,
+                            uint32_t transaction_time_us, uint64_t airtime_us)
+{
+    uint32_t len = (length > UINT32_MAX) ? UINT32_MAX : (uint32_t)length;
+    counters->transactions = saturating_add_u32(counters->transactions, 1);
+    if (failed) {
+        counters->failed_transactions = saturating_add_u32(counters->failed_transactions, 1);
+    }
+    if (is_read) {
+        counters->bytes_read = saturating_add_u32(counters->bytes_read, len);
+    } else {
+        counters->bytes_written = saturating_add_u32(counters->bytes_written, len);
+    }
+    counters->transaction_time_us = saturating_add_u64(counters->transaction_time_us, transaction_time_us);
+    counters->airtime_us = saturating_add_u64(counters->airtime_us, airtime_us);
+}
+
+static bool is_valid_member_cfg(const SHT3XBusMemberConfig *const cfg)
+{
+    // clang-format off
+    return (
+        (cfg)
+        && (cfg->bus)
+        && (cfg->i2c_write)
+        && (cfg->i2c_read)
+    );
+    // clang-format on
+}
+
+/**
+ * @brief Account a completed transaction, then pass the result to the driver.
+ *
+ * @param[in] result_code I2C result code.
+ * @param[in] user_data Bus member.
+ */
+static void transaction_complete_cb(uint8_t result_code, void *user_data)
+{
+    SHT3XBusMember *member = (SHT3XBusMember *)user_data;
+    if (!member) {
+        return;
+    }
+
+    SHT3XBus *bus = member->cfg.bus;
+    uint32_t transaction_time_us = bus->get_time_us(bus->get_time_us_user_data) - member->start_us;
+    uint64_t airtime_us = estimate_airtime_us(member->length, bus->bus_speed_hz);
+    bool failed = (result_code != SHT3X_I2C_RESULT_CODE_OK);
+    add_transaction(&(member->counters), member->is_read, member->length, failed, transaction_time_us, airtime_us);
+    add_transaction(&(bus->counters), member->is_read, member->length, failed, transaction_time_us, airtime_us);
+
+    SHT3X_I2CTransactionCompleteCb cb = member->cb;
+    void *cb_user_data = member->cb_user_data;
+    member->cb = NULL;
+    member->cb_user_data = NULL;
+    if (cb) {
+        cb(result_code, cb_user_data);
+    }
+}
+
+/**
+ * @brief Remember a transaction that is about to be issued.
+ *
+ * @param[in] member Bus member.
+ * @param[in] is_read true for a read, false for a write.
+ * @param[in] length Number of data bytes.
+ * @param[in] cb Driver callback to execute once the transaction is complete.
+ * @param[in] cb_user_data User data to pass to @p cb.
+ */
+static void begin_transaction(SHT3XBusMember *member, bool is_read, size_t length, SHT3X_I2CTransactionCompleteCb cb,
+                              void *cb_user_data)
+{
+    SHT3XBus *bus = member->cfg.bus;
+    member->cb = cb;
+    member->cb_user_data = cb_user_data;
+    member->is_read = is_read;
+    member->length = length;
+    member->start_us = bus->get_time_us(bus->get_time_us_user_data);
+}
+
+uint8_t sht3x_bus_init(SHT3XBus *const bus, uint32_t bus_speed_hz, SHT3XBusGetTimeUs get_time_us,
+                       void *get_time_us_user_data)
+{
+    if (!bus || !get_time_us || (bus_speed_hz == 0)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    bus->bus_speed_hz = bus_speed_hz;
+    bus->get_time_us = get_time_us;
+    bus->get_time_us_user_data = get_time_us_user_data;
+    reset_counters(&(bus->counters));
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_bus_member_init(SHT3XBusMember *const member, const SHT3XBusMemberConfig *const cfg)
+{
+    if (!member || !is_valid_member_cfg(cfg)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    member->cfg = *cfg;
+    reset_counters(&(member->counters));
+    member->cb = NULL;
+    member->cb_user_data = NULL;
+    member->start_us = 0;
+    member->length = 0;
+    member->is_read = false;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+void sht3x_bus_i2c_write(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                         SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data)
+{
+    SHT3XBusMember *member = (SHT3XBusMember *)user_data;
+    if (!member) {
+        return;
+    }
+
+    begin_transaction(member, false, length, cb, cb_user_data);
+    member->cfg.i2c_write(data, length, i2c_addr, member->cfg.i2c_write_user_data, transaction_complete_cb, member);
+}
+
+void sht3x_bus_i2c_read(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                        SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data)
+{
+    SHT3XBusMember *member = (SHT3XBusMember *)user_data;
+    if (!member) {
+        return;
+    }
+
+    begin_transaction(member, true, length, cb, cb_user_data);
+    member->cfg.i2c_read(data, length, i2c_addr, member->cfg.i2c_read_user_data, transaction_complete_cb, member);
+}
+
+uint8_t sht3x_bus_get_counters(const SHT3XBus *const bus, SHT3XBusCounters *const counters)
+{
+    if (!bus || !counters) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    *counters = bus->counters;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_bus_member_get_counters(const SHT3XBusMember *const member, SHT3XBusCounters *const counters)
+{
+    if (!member || !counters) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    *counters = member->counters;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_bus_reset_counters(SHT3XBus *const bus)
+{
+    if (!bus) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    reset_counters(&(bus->counters));
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_bus_get_occupancy(const SHT3XBus *const bus, uint64_t elapsed_us, uint16_t *const permille)
+{
+    if (!bus || !permille || (elapsed_us == 0)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    uint64_t airtime_us = bus->counters.airtime_us;
+    if (airtime_us >= elapsed_us) {
+        *permille = 1000;
+        return SHT3X_RESULT_CODE_OK;
+    }
+    /* Scale elapsed_us down instead of airtime_us up if the multiplication would overflow */
+    if (airtime_us > (UINT64_MAX / 1000)) {
+        *permille = (uint16_t)(airtime_us / (elapsed_us / 1000));
+    } else {
+        *permille = (uint16_t)((airtime_us * 1000) / elapsed_us);
+    }
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_bus_estimate_airtime(size_t length, uint32_t bus_speed_hz, uint64_t *const airtime_us)
+{
+    if (!airtime_us || (bus_speed_hz == 0)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    *airtime_us = estimate_airtime_us(length, bus_speed_hz);
+    return SHT3X_RESULT_CODE_OK;
+}
@@ -0,0 +1,200 @@
+#ifndef SRC_SHT3X_BUS_H
+#define SRC_SHT3X_BUS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Bus utilization and per-instance airtime accounting.
+ *
+ * A bus member wraps the i2c_write and i2c_read functions of one instance, and counts its transactions, failed
+ * transactions, bytes written and read, and transaction time. A bus sums the counters of all members on one I2C bus.
+ *
+ * To account an instance, initialize a bus member with the i2c_write and i2c_read functions of the instance, then pass
+ * @ref sht3x_bus_i2c_write as i2c_write, @ref sht3x_bus_i2c_read as i2c_read, and the bus member as
+ * i2c_write_user_data and i2c_read_user_data in the init config.
+ *
+ * Transaction time is measured with the get_time_us function of the bus, from issuing a transaction to its completion.
+ * It includes the time that the transaction waited for other bus traffic. Airtime is estimated from the bus speed: a
+ * start condition, the address byte and the data bytes with their ACK bits, and a stop condition. @ref
+ * sht3x_bus_get_occupancy divides the airtime by the elapsed time, to tell how close the bus is to saturation.
+ */
+
+/**
+ * @brief Get current time in microseconds.
+ *
+ * The time can wrap around, as long as transactions are shorter than the wraparound period.
+ *
+ * @param user_data User data passed to @ref sht3x_bus_init.
+ *
+ * @return uint32_t Current time in microseconds.
+ */
+typedef uint32_t (*SHT3XBusGetTimeUs)(void *user_data);
+
+/** Accounting counters. All counters saturate. */
+typedef struct {
+    /** Number of completed transactions. */
+    uint32_t transactions;
+    /** Number of transactions completed with a result code other than SHT3X_I2C_RESULT_CODE_OK. */
+    uint32_t failed_transactions;
+    uint32_t bytes_written;
+    uint32_t bytes_read;
+    /** Sum of measured transaction times. */
+    uint64_t transaction_time_us;
+    /** Sum of airtimes estimated from the bus speed. */
+    uint64_t airtime_us;
+} SHT3XBusCounters;
+
+/**
+ * @brief Bus state.
+ *
+ * Provided by the caller, and must stay valid as long as its members are used. The fields are private and should not
+ * be modified by the caller.
+ */
+typedef struct {
+    uint32_t bus_speed_hz;
+    SHT3XBusGetTimeUs get_time_us;
+    void *get_time_us_user_data;
+    SHT3XBusCounters counters;
+} SHT3XBus;
+
+/** Bus member config. */
+typedef struct {
+    /** Bus that the instance is on. */
+    SHT3XBus *bus;
+    /** Function that performs the I2C write, usually the one that would otherwise be in the init config. */
+    SHT3X_I2CWrite i2c_write;
+    void *i2c_write_user_data;
+    /** Function that performs the I2C read, usually the one that would otherwise be in the init config. */
+    SHT3X_I2CRead i2c_read;
+    void *i2c_read_user_data;
+} SHT3XBusMemberConfig;
+
+/**
+ * @brief Bus member state.
+ *
+ * Provided by the caller, and must stay valid as long as the instance that uses it. The fields are private and should
+ * not be modified by the caller.
+ */
+typedef struct {
+    SHT3XBusMemberConfig cfg;
+    SHT3XBusCounters counters;
+    /** Transaction in progress. The driver has at most one I2C transaction in progress per instance. */
+    SHT3X_I2CTransactionCompleteCb cb;
+    void *cb_user_data;
+    uint32_t start_us;
+    size_t length;
+    bool is_read;
+} SHT3XBusMember;
+
+/**
+ * @brief Initialize a bus with all counters zero.
+ *
+ * @param[out] bus Caller-provided memory for the bus state.
+ * @param[in] bus_speed_hz Bus clock speed in Hz, e.g. 100000 or 400000.
+ * @param[in] get_time_us Time source.
+ * @param[in] get_time_us_user_data User data to pass to @p get_time_us.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p bus or @p get_time_us is NULL, or @p bus_speed_hz is 0.
+ */
+uint8_t sht3x_bus_init(SHT3XBus *const bus, uint32_t bus_speed_hz, SHT3XBusGetTimeUs get_time_us,
+                       void *get_time_us_user_data);
+
+/**
+ * @brief Initialize a bus member with all counters zero.
+ *
+ * @param[out] member Caller-provided memory for the bus member state.
+ * @param[in] cfg Bus member config. Copied into @p member.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p member or @p cfg is NULL, or @p cfg is invalid.
+ */
+uint8_t sht3x_bus_member_init(SHT3XBusMember *const member, const SHT3XBusMemberConfig *const cfg);
+
+/**
+ * @brief I2C write that is accounted to a bus member. Meant to be used as i2c_write in @ref SHT3XInitConfig.
+ *
+ * @p user_data must be the bus member. See @ref SHT3X_I2CWrite for the other parameters.
+ */
+void sht3x_bus_i2c_write(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                         SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data);
+
+/**
+ * @brief I2C read that is accounted to a bus member. Meant to be used as i2c_read in @ref SHT3XInitConfig.
+ *
+ * @p user_data must be the bus member. See @ref SHT3X_I2CRead for the other parameters.
+ */
+void sht3x_bus_i2c_read(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                        SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data);
+
+/**
+ * @brief Get the counters of a bus, summed over all its members.
+ *
+ * @param[in] bus Bus.
+ * @param[out] counters Counters are written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p bus or @p counters is NULL.
+ */
+uint8_t sht3x_bus_get_counters(const SHT3XBus *const bus, SHT3XBusCounters *const counters);
+
+/**
+ * @brief Get the counters of one bus member.
+ *
+ * @param[in] member Bus member.
+ * @param[out] counters Counters are written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p member or @p counters is NULL.
+ */
+uint8_t sht3x_bus_member_get_counters(const SHT3XBusMember *const member, SHT3XBusCounters *const counters);
+
+/**
+ * @brief Set all counters of a bus to zero. Counters of the members are not affected.
+ *
+ * @param[in] bus Bus.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p bus is NULL.
+ */
+uint8_t sht3x_bus_reset_counters(SHT3XBus *const bus);
+
+/**
+ * @brief Estimate bus occupancy over a period.
+ *
+ * @param[in] bus Bus.
+ * @param[in] elapsed_us Length of the period in microseconds, usually the time since @ref sht3x_bus_init or @ref
+ * sht3x_bus_reset_counters.
+ * @param[out] permille Estimated airtime of the period in permille of @p elapsed_us is written here. Capped at 1000.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p bus or @p permille is NULL, or @p elapsed_us is 0.
+ */
+uint8_t sht3x_bus_get_occupancy(const SHT3XBus *const bus, uint64_t elapsed_us, uint16_t *const permille);
+
+/**
+ * @brief Estimate how long a transaction occupies the bus, the same way as the bus counters do.
+ *
+ * @param[in] length Number of data bytes, not including the address byte.
+ * @param[in] bus_speed_hz Bus clock speed in Hz.
+ * @param[out] airtime_us Estimated airtime in microseconds, rounded up, is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p airtime_us is NULL, or @p bus_speed_hz is 0.
+ */
+uint8_t sht3x_bus_estimate_airtime(size_t length, uint32_t bus_speed_hz, uint64_t *const airtime_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_BUS_H */
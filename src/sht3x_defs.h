@@ -99,6 +99,58 @@ typedef void (*SHT3X_I2CRead)(uint8_t *data, size_t length, uint8_t i2c_addr, vo
  */
 typedef void (*SHT3XStartTimer)(uint32_t duration_ms, void *user_data, SHT3XTimerExpiredCb cb, void *cb_user_data);
 
+/**
+ * @brief Gets called when the health monitor detects a problem with the device.
+ *
+ * @param event One of @ref SHT3XHealthEvent.
+ * @param user_data User data from the health monitor config.
+ */
+typedef void (*SHT3XHealthEventCb)(uint8_t event, void *user_data);
+
+/** Tracepoints of the driver. */
+typedef enum {
+    /** A public function started a sequence. */
+    SHT3X_TRACE_EVENT_SEQUENCE_START,
+    /** Sequence is complete, its callback is about to be executed. result_code is the one passed to the callback. */
+    SHT3X_TRACE_EVENT_SEQUENCE_END,
+    /** I2C write of a command is about to be issued. arg is the two-byte command code, MSB first. */
+    SHT3X_TRACE_EVENT_I2C_WRITE_ISSUE,
+    /** I2C write is complete. result_code is one of @ref SHT3X_I2CResultCode. */
+    SHT3X_TRACE_EVENT_I2C_WRITE_COMPLETE,
+    /** I2C read is about to be issued. arg is the number of bytes. */
+    SHT3X_TRACE_EVENT_I2C_READ_ISSUE,
+    /** I2C read is complete. result_code is one of @ref SHT3X_I2CResultCode. */
+    SHT3X_TRACE_EVENT_I2C_READ_COMPLETE,
+    /** Timer is about to be started. arg is the duration in ms. */
+    SHT3X_TRACE_EVENT_TIMER_ARM,
+    /** Timer expired. */
+    SHT3X_TRACE_EVENT_TIMER_EXPIRE,
+} SHT3XTraceEventType;
+
+/** Event passed to @ref SHT3XTraceHook. */
+typedef struct {
+    /** Instance that the event belongs to. */
+    struct SHT3XStruct *instance;
+    /** One of @ref SHT3XTraceEventType. */
+    uint8_t type;
+    /** Type of the sequence that the event belongs to, one of SHT3XSequenceType. */
+    uint8_t sequence_type;
+    /** Result of completion events, 0 otherwise. */
+    uint8_t result_code;
+    /** Event-specific argument, see @ref SHT3XTraceEventType. 0 if not used. */
+    uint32_t arg;
+} SHT3XTraceEvent;
+
+/**
+ * @brief Gets called at every tracepoint of the driver.
+ *
+ * Called synchronously from the driver, so it should only record the event, e.g. together with a timestamp.
+ *
+ * @param event Event. Only valid during the call.
+ * @param user_data User data from the init config.
+ */
+typedef void (*SHT3XTraceHook)(const SHT3XTraceEvent *event, void *user_data);
+
 #ifdef __cplusplus
 }
 #endif
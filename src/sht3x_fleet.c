@@ -0,0 +1,214 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_fleet.h"
+
+static bool is_valid_cfg(const SHT3XFleetConfig *const cfg)
+{
+    // clang-format off
+    return (
+        (cfg)
+        && (cfg->num_sensors > 0)
+        && (cfg->num_frames > 0)
+        && (cfg->raw_temperature)
+        && (cfg->raw_humidity)
+        && (cfg->status)
+        && (cfg->timestamps)
+    );
+    // clang-format on
+}
+
+/** Offset of the first sample of a frame in the sample columns. */
+static size_t get_frame_offset(const SHT3XFleet *fleet, uint16_t frame_idx)
+{
+    return (size_t)frame_idx * fleet->cfg.num_sensors;
+}
+
+static uint8_t map_result_code_to_status(uint8_t result_code, const SHT3XLazyMeasurement *meas)
+{
+    switch (result_code) {
+    case SHT3X_RESULT_CODE_OK: {
+        uint8_t status = 0;
+        if (meas->flags & SHT3X_FLAG_READ_TEMP) {
+            status |= SHT3X_FLEET_STATUS_TEMP;
+        }
+        if (meas->flags & SHT3X_FLAG_READ_HUM) {
+            status |= SHT3X_FLEET_STATUS_HUM;
+        }
+        return status;
+    }
+    case SHT3X_RESULT_CODE_CRC_MISMATCH:
+        return SHT3X_FLEET_STATUS_CRC_MISMATCH;
+    case SHT3X_RESULT_CODE_NO_DATA:
+        return SHT3X_FLEET_STATUS_NO_DATA;
+    default:
+        return SHT3X_FLEET_STATUS_ERROR;
+    }
+}
+
+/**
+ * @brief Get the values of a column and the status bit that marks them valid.
+ *
+ * @param[in] frame Frame.
+ * @param[in] column Column.
+ * @param[out] values Values of the column are written here.
+ * @param[out] valid_bit Status bit is written here.
+ *
+ * @retval true Success.
+ * @retval false @p column is invalid.
+ */
+static bool get_column(const SHT3XFleetFrame *frame, uint8_t column, const uint16_t **values, uint8_t *valid_bit)
+{
+    if (column == SHT3X_FLEET_COLUMN_TEMPERATURE) {
+        *values = frame->raw_temperature;
+        *valid_bit = SHT3X_FLEET_STATUS_TEMP;
+    } else if (column == SHT3X_FLEET_COLUMN_HUMIDITY) {
+        *values = frame->raw_humidity;
+        *valid_bit = SHT3X_FLEET_STATUS_HUM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+uint8_t sht3x_fleet_init(SHT3XFleet *const fleet, const SHT3XFleetConfig *const cfg)
+{
+    if (!fleet || !is_valid_cfg(cfg)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    fleet->cfg = *cfg;
+    /* The first frame goes to index 0 */
+    fleet->newest = cfg->num_frames - 1;
+    fleet->num_used = 0;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_fleet_begin_frame(SHT3XFleet *const fleet, uint32_t timestamp)
+{
+    if (!fleet) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    fleet->newest = (uint16_t)((fleet->newest + 1) % fleet->cfg.num_frames);
+    if (fleet->num_used < fleet->cfg.num_frames) {
+        fleet->num_used++;
+    }
+    fleet->cfg.timestamps[fleet->newest] = timestamp;
+    size_t offset = get_frame_offset(fleet, fleet->newest);
+    for (uint16_t i = 0; i < fleet->cfg.num_sensors; i++) {
+        fleet->cfg.status[offset + i] = 0;
+    }
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_fleet_store(SHT3XFleet *const fleet, uint16_t sensor, uint8_t result_code,
+                          const SHT3XLazyMeasurement *const meas)
+{
+    if (!fleet || (sensor >= fleet->cfg.num_sensors) || ((result_code == SHT3X_RESULT_CODE_OK) && !meas)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (fleet->num_used == 0) {
+        return SHT3X_RESULT_CODE_NO_DATA;
+    }
+
+    size_t idx = get_frame_offset(fleet, fleet->newest) + sensor;
+    uint8_t status = map_result_code_to_status(result_code, meas);
+    fleet->cfg.raw_temperature[idx] = (status & SHT3X_FLEET_STATUS_TEMP) ? meas->raw_temperature : 0;
+    fleet->cfg.raw_humidity[idx] = (status & SHT3X_FLEET_STATUS_HUM) ? meas->raw_humidity : 0;
+    fleet->cfg.status[idx] = status;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_fleet_slot_init(SHT3XFleetSlot *const slot, SHT3XFleet *const fleet, uint16_t sensor)
+{
+    if (!slot || !fleet || (sensor >= fleet->cfg.num_sensors)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    slot->fleet = fleet;
+    slot->sensor = sensor;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+void sht3x_fleet_lazy_meas_complete_cb(uint8_t result_code, SHT3XLazyMeasurement *meas, void *user_data)
+{
+    SHT3XFleetSlot *slot = (SHT3XFleetSlot *)user_data;
+    if (!slot) {
+        return;
+    }
+    sht3x_fleet_store(slot->fleet, slot->sensor, result_code, meas);
+}
+
+uint8_t sht3x_fleet_get_frame(const SHT3XFleet *const fleet, uint16_t age, SHT3XFleetFrame *const frame)
+{
+    if (!fleet || !frame) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (age >= fleet->num_used) {
+        return SHT3X_RESULT_CODE_NO_DATA;
+    }
+
+    uint16_t frame_idx = (uint16_t)((fleet->newest + fleet->cfg.num_frames - age) % fleet->cfg.num_frames);
+    size_t offset = get_frame_offset(fleet, frame_idx);
+    frame->timestamp = fleet->cfg.timestamps[frame_idx];
+    frame->num_sensors = fleet->cfg.num_sensors;
+    frame->raw_temperature = &fleet->cfg.raw_temperature[offset];
+    frame->raw_humidity = &fleet->cfg.raw_humidity[offset];
+    frame->status = &fleet->cfg.status[offset];
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_fleet_scan_stats(const SHT3XFleetFrame *const frame, uint8_t column, SHT3XFleetStats *const stats)
+{
+    const uint16_t *values;
+    uint8_t valid_bit;
+    if (!frame || !stats || !get_column(frame, column, &values, &valid_bit)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    uint16_t count = 0;
+    uint16_t min = UINT16_MAX;
+    uint16_t max = 0;
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < frame->num_sensors; i++) {
+        /* All ones for a valid value, all zeros otherwise. Invalid values then count as UINT16_MAX for min, and as 0
+         * for max and sum. */
+        uint16_t mask = (uint16_t)(0 - (uint16_t)((frame->status[i] & valid_bit) != 0));
+        uint16_t val = values[i];
+        uint16_t min_candidate = val | (uint16_t)~mask;
+        uint16_t max_candidate = val & mask;
+        min = (min_candidate < min) ? min_candidate : min;
+        max = (max_candidate > max) ? max_candidate : max;
+        sum += max_candidate;
+        count += (uint16_t)(mask & 1);
+    }
+
+    stats->count = count;
+    stats->min = min;
+    stats->max = max;
+    stats->sum = sum;
+    stats->mean = (count > 0) ? (uint16_t)((sum + (count / 2)) / count) : 0;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_fleet_scan_threshold(const SHT3XFleetFrame *const frame, uint8_t column, uint16_t threshold,
+                                   uint8_t *const above, uint16_t *const count)
+{
+    const uint16_t *values;
+    uint8_t valid_bit;
+    if (!frame || !count || !get_column(frame, column, &values, &valid_bit)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    uint16_t num_above = 0;
+    for (uint16_t i = 0; i < frame->num_sensors; i++) {
+        uint8_t is_above = (uint8_t)(((frame->status[i] & valid_bit) != 0) & (values[i] > threshold));
+        if (above) {
+            above[i] = is_above;
+        }
+        num_above += is_above;
+    }
+    *count = num_above;
+    return SHT3X_RESULT_CODE_OK;
+}
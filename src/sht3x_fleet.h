@@ -0,0 +1,207 @@
+#ifndef SRC_SHT3X_FLEET_H
+#define SRC_SHT3X_FLEET_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Measurement store of many sensors, laid out for scans over all sensors at one time.
+ *
+ * A fleet store keeps raw temperature and humidity ticks and status bits of a fixed number of sensors over a fixed
+ * number of frames. A frame holds one sample slot per sensor and a timestamp. Frames form a ring: starting a new frame
+ * overwrites the oldest one once all frames are used.
+ *
+ * Values are stored as a structure of arrays in caller-provided columns: all temperatures of one frame are next to each
+ * other, and so are all humidities and all status bytes. Scanning "temperature of every sensor at time t" reads one
+ * contiguous array, and the scan loops are branch-free so that compilers can vectorize them.
+ *
+ * To write readouts into the store directly from the completion path, initialize a @ref SHT3XFleetSlot per sensor, and
+ * pass @ref sht3x_fleet_lazy_meas_complete_cb as the callback and the slot as user data to the lazy readout functions,
+ * e.g. @ref sht3x_read_measurement_lazy. Readouts are written into the newest frame.
+ *
+ * Scans work on raw ticks. The conversions to degrees and RH% are monotonic, so thresholds can be converted to raw
+ * ticks once instead of converting every value.
+ */
+
+/** Temperature of the sample is valid. */
+#define SHT3X_FLEET_STATUS_TEMP (1U << 0)
+/** Humidity of the sample is valid. */
+#define SHT3X_FLEET_STATUS_HUM (1U << 1)
+/** Readout failed with @ref SHT3X_RESULT_CODE_CRC_MISMATCH. */
+#define SHT3X_FLEET_STATUS_CRC_MISMATCH (1U << 2)
+/** Readout failed with @ref SHT3X_RESULT_CODE_NO_DATA. */
+#define SHT3X_FLEET_STATUS_NO_DATA (1U << 3)
+/** Readout failed with another result code. */
+#define SHT3X_FLEET_STATUS_ERROR (1U << 4)
+
+/** Columns of a fleet store. */
+typedef enum {
+    SHT3X_FLEET_COLUMN_TEMPERATURE,
+    SHT3X_FLEET_COLUMN_HUMIDITY,
+} SHT3XFleetColumn;
+
+/** Fleet store config. All arrays are provided by the caller, and must stay valid as long as the store is used. */
+typedef struct {
+    uint16_t num_sensors;
+    uint16_t num_frames;
+    /** num_sensors * num_frames raw temperature ticks. */
+    uint16_t *raw_temperature;
+    /** num_sensors * num_frames raw humidity ticks. */
+    uint16_t *raw_humidity;
+    /** num_sensors * num_frames status bytes. */
+    uint8_t *status;
+    /** num_frames timestamps. */
+    uint32_t *timestamps;
+} SHT3XFleetConfig;
+
+/**
+ * @brief Fleet store state.
+ *
+ * Provided by the caller. The fields are private and should not be modified by the caller.
+ */
+typedef struct {
+    SHT3XFleetConfig cfg;
+    /** Index of the newest frame. */
+    uint16_t newest;
+    /** Number of frames that were started, up to num_frames. */
+    uint16_t num_used;
+} SHT3XFleet;
+
+/** Sensor of a fleet store, used as user data of @ref sht3x_fleet_lazy_meas_complete_cb. */
+typedef struct {
+    SHT3XFleet *fleet;
+    uint16_t sensor;
+} SHT3XFleetSlot;
+
+/** One frame of a fleet store. The arrays point into the store and have num_sensors entries each. */
+typedef struct {
+    uint32_t timestamp;
+    uint16_t num_sensors;
+    const uint16_t *raw_temperature;
+    const uint16_t *raw_humidity;
+    const uint8_t *status;
+} SHT3XFleetFrame;
+
+/** Result of @ref sht3x_fleet_scan_stats. min, max and mean are only meaningful if count is not 0. */
+typedef struct {
+    /** Number of valid values. */
+    uint16_t count;
+    uint16_t min;
+    uint16_t max;
+    /** Mean of the valid values, rounded to the nearest tick. */
+    uint16_t mean;
+    uint32_t sum;
+} SHT3XFleetStats;
+
+/**
+ * @brief Initialize a fleet store without any frames.
+ *
+ * @param[out] fleet Caller-provided memory for the store state.
+ * @param[in] cfg Store config. Copied into @p fleet.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p fleet or @p cfg is NULL, one of the arrays is NULL, or num_sensors or
+ * num_frames is 0.
+ */
+uint8_t sht3x_fleet_init(SHT3XFleet *const fleet, const SHT3XFleetConfig *const cfg);
+
+/**
+ * @brief Start a new frame with no valid samples. Overwrites the oldest frame once all frames are used.
+ *
+ * @param[in] fleet Fleet store.
+ * @param[in] timestamp Timestamp of the frame, in any unit chosen by the caller.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p fleet is NULL.
+ */
+uint8_t sht3x_fleet_begin_frame(SHT3XFleet *const fleet, uint32_t timestamp);
+
+/**
+ * @brief Store the outcome of a readout in the newest frame.
+ *
+ * @param[in] fleet Fleet store.
+ * @param[in] sensor Sensor index.
+ * @param[in] result_code Result code of the readout.
+ * @param[in] meas Measurement that was read out. Only used if @p result_code is @ref SHT3X_RESULT_CODE_OK.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p fleet is NULL, @p sensor is out of range, or @p result_code is @ref
+ * SHT3X_RESULT_CODE_OK and @p meas is NULL.
+ * @retval SHT3X_RESULT_CODE_NO_DATA No frame was started yet.
+ */
+uint8_t sht3x_fleet_store(SHT3XFleet *const fleet, uint16_t sensor, uint8_t result_code,
+                          const SHT3XLazyMeasurement *const meas);
+
+/**
+ * @brief Initialize the slot of a sensor.
+ *
+ * @param[out] slot Caller-provided memory for the slot. Must stay valid as long as readouts are pending.
+ * @param[in] fleet Fleet store.
+ * @param[in] sensor Sensor index.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p slot or @p fleet is NULL, or @p sensor is out of range.
+ */
+uint8_t sht3x_fleet_slot_init(SHT3XFleetSlot *const slot, SHT3XFleet *const fleet, uint16_t sensor);
+
+/**
+ * @brief Lazy measurement complete callback that stores the readout in the newest frame.
+ *
+ * @p user_data must be a @ref SHT3XFleetSlot. See @ref SHT3XLazyMeasCompleteCb for the other parameters.
+ */
+void sht3x_fleet_lazy_meas_complete_cb(uint8_t result_code, SHT3XLazyMeasurement *meas, void *user_data);
+
+/**
+ * @brief Get a frame.
+ *
+ * @param[in] fleet Fleet store.
+ * @param[in] age 0 for the newest frame, 1 for the one before, and so on.
+ * @param[out] frame Frame is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p fleet or @p frame is NULL.
+ * @retval SHT3X_RESULT_CODE_NO_DATA There are not more than @p age frames.
+ */
+uint8_t sht3x_fleet_get_frame(const SHT3XFleet *const fleet, uint16_t age, SHT3XFleetFrame *const frame);
+
+/**
+ * @brief Get count, min, max, sum and mean of the valid values of a column in a frame.
+ *
+ * @param[in] frame Frame from @ref sht3x_fleet_get_frame.
+ * @param[in] column Column to scan.
+ * @param[out] stats Result is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p frame or @p stats is NULL, or @p column is invalid.
+ */
+uint8_t sht3x_fleet_scan_stats(const SHT3XFleetFrame *const frame, uint8_t column, SHT3XFleetStats *const stats);
+
+/**
+ * @brief Find the sensors whose valid value in a column of a frame is above a threshold.
+ *
+ * @param[in] frame Frame from @ref sht3x_fleet_get_frame.
+ * @param[in] column Column to scan.
+ * @param[in] threshold Threshold in raw ticks.
+ * @param[out] above Optional, can be NULL. Array of num_sensors entries. 1 is written for each sensor whose value is
+ * valid and greater than @p threshold, 0 for the others.
+ * @param[out] count Number of sensors whose value is above @p threshold is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p frame or @p count is NULL, or @p column is invalid.
+ */
+uint8_t sht3x_fleet_scan_threshold(const SHT3XFleetFrame *const frame, uint8_t column, uint16_t threshold,
+                                   uint8_t *const above, uint16_t *const count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_FLEET_H */
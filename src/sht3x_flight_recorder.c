@@ -0,0 +1,156 @@
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_flight_recorder.h"
+
+/* Version of the dump format, stored in the first byte of the dump */
+#define SHT3X_FLIGHT_RECORDER_DUMP_VERSION 1
+
+/* Event layout: type in the upper and sequence type in the lower nibble, result code, argument MSB first */
+#define SHT3X_FLIGHT_RECORDER_TYPE_SHIFT 4
+#define SHT3X_FLIGHT_RECORDER_NIBBLE_MASK 0x0F
+
+/**
+ * @brief Encode a trace event into its recorded form.
+ *
+ * @param[in] event Trace event.
+ * @param[out] out @ref SHT3X_FLIGHT_RECORDER_EVENT_SIZE bytes are written here.
+ */
+static void encode_event(const SHT3XTraceEvent *event, uint8_t *out)
+{
+    uint16_t arg = (event->arg > UINT16_MAX) ? UINT16_MAX : (uint16_t)event->arg;
+    out[0] = (uint8_t)(((event->type & SHT3X_FLIGHT_RECORDER_NIBBLE_MASK) << SHT3X_FLIGHT_RECORDER_TYPE_SHIFT) |
+                       (event->sequence_type & SHT3X_FLIGHT_RECORDER_NIBBLE_MASK));
+    out[1] = event->result_code;
+    out[2] = (uint8_t)(arg >> 8);
+    out[3] = (uint8_t)(arg & 0xFF);
+}
+
+uint8_t sht3x_flight_recorder_init(SHT3XFlightRecorder *const recorder, uint8_t *const buf, size_t size)
+{
+    // clang-format off
+    bool valid = (
+        (recorder)
+        && (buf)
+        && (size >= SHT3X_FLIGHT_RECORDER_EVENT_SIZE)
+        && ((size % SHT3X_FLIGHT_RECORDER_EVENT_SIZE) == 0)
+        && ((size / SHT3X_FLIGHT_RECORDER_EVENT_SIZE) <= SHT3X_FLIGHT_RECORDER_MAX_EVENTS)
+    );
+    // clang-format on
+    if (!valid) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    recorder->buf = buf;
+    recorder->capacity = size / SHT3X_FLIGHT_RECORDER_EVENT_SIZE;
+    return sht3x_flight_recorder_clear(recorder);
+}
+
+void sht3x_flight_recorder_hook(const SHT3XTraceEvent *event, void *user_data)
+{
+    SHT3XFlightRecorder *recorder = (SHT3XFlightRecorder *)user_data;
+    if (!recorder || !event) {
+        return;
+    }
+
+    encode_event(event, &(recorder->buf[recorder->head * SHT3X_FLIGHT_RECORDER_EVENT_SIZE]));
+    recorder->head++;
+    if (recorder->head == recorder->capacity) {
+        recorder->head = 0;
+    }
+    if (recorder->num_events < recorder->capacity) {
+        recorder->num_events++;
+    }
+    if (recorder->total < UINT32_MAX) {
+        recorder->total++;
+    }
+}
+
+uint8_t sht3x_flight_recorder_clear(SHT3XFlightRecorder *const recorder)
+{
+    if (!recorder) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    recorder->head = 0;
+    recorder->num_events = 0;
+    recorder->total = 0;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_flight_recorder_dump(const SHT3XFlightRecorder *const recorder, uint8_t *const buf, size_t size,
+                                   size_t *const length)
+{
+    if (!recorder || !buf || !length) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    size_t events_size = recorder->num_events * SHT3X_FLIGHT_RECORDER_EVENT_SIZE;
+    if (size < (SHT3X_FLIGHT_RECORDER_DUMP_HEADER_SIZE + events_size)) {
+        return SHT3X_RESULT_CODE_OUT_OF_MEMORY;
+    }
+
+    buf[0] = SHT3X_FLIGHT_RECORDER_DUMP_VERSION;
+    buf[1] = 0;
+    buf[2] = (uint8_t)(recorder->num_events >> 8);
+    buf[3] = (uint8_t)(recorder->num_events & 0xFF);
+    buf[4] = (uint8_t)(recorder->total >> 24);
+    buf[5] = (uint8_t)((recorder->total >> 16) & 0xFF);
+    buf[6] = (uint8_t)((recorder->total >> 8) & 0xFF);
+    buf[7] = (uint8_t)(recorder->total & 0xFF);
+
+    /* Oldest event is at head once the ring has wrapped, and at index 0 before that */
+    size_t src_idx = (recorder->num_events == recorder->capacity) ? recorder->head : 0;
+    uint8_t *dst = &buf[SHT3X_FLIGHT_RECORDER_DUMP_HEADER_SIZE];
+    for (size_t i = 0; i < recorder->num_events; i++) {
+        const uint8_t *src = &(recorder->buf[src_idx * SHT3X_FLIGHT_RECORDER_EVENT_SIZE]);
+        for (size_t j = 0; j < SHT3X_FLIGHT_RECORDER_EVENT_SIZE; j++) {
+            *dst++ = src[j];
+        }
+        src_idx++;
+        if (src_idx == recorder->capacity) {
+            src_idx = 0;
+        }
+    }
+
+    *length = SHT3X_FLIGHT_RECORDER_DUMP_HEADER_SIZE + events_size;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_flight_recorder_decode_header(const uint8_t *const dump, size_t length, size_t *const num_events,
+                                            uint32_t *const total)
+{
+    if (!dump || !num_events || !total || (length < SHT3X_FLIGHT_RECORDER_DUMP_HEADER_SIZE)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (dump[0] != SHT3X_FLIGHT_RECORDER_DUMP_VERSION) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    size_t n = ((size_t)dump[2] << 8) | dump[3];
+    if (length < (SHT3X_FLIGHT_RECORDER_DUMP_HEADER_SIZE + (n * SHT3X_FLIGHT_RECORDER_EVENT_SIZE))) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    *num_events = n;
+    *total = ((uint32_t)dump[4] << 24) | ((uint32_t)dump[5] << 16) | ((uint32_t)dump[6] << 8) | dump[7];
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_flight_recorder_decode_event(const uint8_t *const dump, size_t length, size_t idx,
+                                           SHT3XTraceEvent *const event)
+{
+    size_t num_events;
+    uint32_t total;
+    if (!event || (sht3x_flight_recorder_decode_header(dump, length, &num_events, &total) != SHT3X_RESULT_CODE_OK)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (idx >= num_events) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    const uint8_t *src = &dump[SHT3X_FLIGHT_RECORDER_DUMP_HEADER_SIZE + (idx * SHT3X_FLIGHT_RECORDER_EVENT_SIZE)];
+    event->instance = NULL;
+    event->type = src[0] >> SHT3X_FLIGHT_RECORDER_TYPE_SHIFT;
+    event->sequence_type = src[0] & SHT3X_FLIGHT_RECORDER_NIBBLE_MASK;
+    event->result_code = src[1];
+    event->arg = ((uint32_t)src[2] << 8) | src[3];
+    return SHT3X_RESULT_CODE_OK;
+}
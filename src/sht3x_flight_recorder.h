@@ -0,0 +1,146 @@
+#ifndef SRC_SHT3X_FLIGHT_RECORDER_H
+#define SRC_SHT3X_FLIGHT_RECORDER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Flight recorder of recent driver events.
+ *
+ * Keeps the most recent trace events of an instance in a caller-provided ring buffer, @ref
+ * SHT3X_FLIGHT_RECORDER_EVENT_SIZE bytes per event: sequence starts and outcomes, command codes sent, I2C result codes
+ * and timer periods. When the ring is full, the oldest event is overwritten.
+ *
+ * To record the events of an instance, pass @ref sht3x_flight_recorder_hook as trace_hook and the recorder as
+ * trace_hook_user_data in the init config. The driver must be built with SHT3X_ENABLE_TRACE defined. Recording an
+ * event is a few byte stores, so the recorder can be left enabled in production.
+ *
+ * After a failure, @ref sht3x_flight_recorder_dump writes the recorded events, oldest first, into a self-describing
+ * binary dump that can be stored or sent off the device. @ref sht3x_flight_recorder_decode_header and @ref
+ * sht3x_flight_recorder_decode_event turn the dump back into trace events, e.g. on the host. The decoded events can
+ * then be formatted with @ref sht3x_trace_format_chrome_event.
+ *
+ * Timer periods and command codes are recorded as 16-bit values. Timer periods above 65535 ms are recorded as 65535.
+ */
+
+/** Size in bytes of one recorded event. */
+#define SHT3X_FLIGHT_RECORDER_EVENT_SIZE 4
+
+/** Size in bytes of the header at the start of a dump. */
+#define SHT3X_FLIGHT_RECORDER_DUMP_HEADER_SIZE 8
+
+/** Maximum number of events that a recorder can hold. */
+#define SHT3X_FLIGHT_RECORDER_MAX_EVENTS 0xFFFF
+
+/**
+ * @brief Flight recorder state.
+ *
+ * Provided by the caller, and must stay valid as long as the instance that it records is used. The fields are private
+ * and should not be modified by the caller.
+ */
+typedef struct {
+    uint8_t *buf;
+    /** Number of events that fit into buf. */
+    size_t capacity;
+    /** Index of the slot that the next event is written to. */
+    size_t head;
+    /** Number of events in buf. */
+    size_t num_events;
+    /** Number of events recorded since the last clear, including the overwritten ones. Saturates. */
+    uint32_t total;
+} SHT3XFlightRecorder;
+
+/**
+ * @brief Initialize a flight recorder.
+ *
+ * @param[out] recorder Caller-provided memory for the recorder state.
+ * @param[in] buf Ring buffer. Must stay valid as long as the recorder is used.
+ * @param[in] size Size of @p buf in bytes. Must be a multiple of @ref SHT3X_FLIGHT_RECORDER_EVENT_SIZE, and hold from
+ * 1 to @ref SHT3X_FLIGHT_RECORDER_MAX_EVENTS events.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p recorder or @p buf is NULL, or @p size is invalid.
+ */
+uint8_t sht3x_flight_recorder_init(SHT3XFlightRecorder *const recorder, uint8_t *const buf, size_t size);
+
+/**
+ * @brief Record a trace event. Meant to be used as trace_hook in @ref SHT3XInitConfig.
+ *
+ * @param[in] event Trace event.
+ * @param[in] user_data Flight recorder initialized by @ref sht3x_flight_recorder_init.
+ */
+void sht3x_flight_recorder_hook(const SHT3XTraceEvent *event, void *user_data);
+
+/**
+ * @brief Remove all recorded events.
+ *
+ * @param[in] recorder Flight recorder.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p recorder is NULL.
+ */
+uint8_t sht3x_flight_recorder_clear(SHT3XFlightRecorder *const recorder);
+
+/**
+ * @brief Write the recorded events, oldest first, into a dump.
+ *
+ * The dump is @ref SHT3X_FLIGHT_RECORDER_DUMP_HEADER_SIZE bytes of header, followed by @ref
+ * SHT3X_FLIGHT_RECORDER_EVENT_SIZE bytes per recorded event.
+ *
+ * @param[in] recorder Flight recorder.
+ * @param[out] buf Dump is written here.
+ * @param[in] size Size of @p buf in bytes.
+ * @param[out] length Number of bytes written to @p buf is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p recorder, @p buf or @p length is NULL.
+ * @retval SHT3X_RESULT_CODE_OUT_OF_MEMORY @p buf is too small for all recorded events.
+ */
+uint8_t sht3x_flight_recorder_dump(const SHT3XFlightRecorder *const recorder, uint8_t *const buf, size_t size,
+                                   size_t *const length);
+
+/**
+ * @brief Read the header of a dump.
+ *
+ * @param[in] dump Dump written by @ref sht3x_flight_recorder_dump.
+ * @param[in] length Length of @p dump in bytes.
+ * @param[out] num_events Number of events in the dump is written here.
+ * @param[out] total Number of events recorded before the dump, including the ones that were overwritten, is written
+ * here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG One of the pointers is NULL, the dump has an unknown version, or is shorter
+ * than its header says.
+ */
+uint8_t sht3x_flight_recorder_decode_header(const uint8_t *const dump, size_t length, size_t *const num_events,
+                                            uint32_t *const total);
+
+/**
+ * @brief Decode one event of a dump.
+ *
+ * instance of the decoded event is NULL, because the dump does not identify the instance.
+ *
+ * @param[in] dump Dump written by @ref sht3x_flight_recorder_dump.
+ * @param[in] length Length of @p dump in bytes.
+ * @param[in] idx Index of the event, 0 is the oldest one.
+ * @param[out] event Decoded event is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p dump or @p event is NULL, the dump header is invalid, or @p idx is out of
+ * range.
+ */
+uint8_t sht3x_flight_recorder_decode_event(const uint8_t *const dump, size_t length, size_t idx,
+                                           SHT3XTraceEvent *const event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_FLIGHT_RECORDER_H */
@@ -0,0 +1,241 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_fusion.h"
+
+static bool is_valid_cfg(const SHT3XFusionConfig *const cfg, uint8_t num_members)
+{
+    // clang-format off
+    return (
+        (cfg)
+        && ((cfg->method == SHT3X_FUSION_METHOD_MEDIAN) || (cfg->method == SHT3X_FUSION_METHOD_TRIMMED_MEAN))
+        && (num_members > 0)
+        && (num_members <= SHT3X_FUSION_MAX_MEMBERS)
+        && (cfg->min_members > 0)
+        && (cfg->min_members <= num_members)
+    );
+    // clang-format on
+}
+
+static uint32_t saturating_add(uint32_t a, uint32_t b)
+{
+    return ((UINT32_MAX - a) < b) ? UINT32_MAX : (a + b);
+}
+
+/** Median of sorted values, the rounded mean of the two middle ones for an even count. */
+static uint16_t get_median(const uint16_t *sorted, uint8_t count)
+{
+    uint8_t mid = count / 2;
+    if (count & 1) {
+        return sorted[mid];
+    }
+    return (uint16_t)(((uint32_t)sorted[mid - 1] + sorted[mid] + 1) / 2);
+}
+
+/**
+ * @brief Fuse the values of one group.
+ *
+ * @param[in] cfg Fusion options.
+ * @param[in] values Values of the members.
+ * @param[in] valid Whether each value is valid.
+ * @param[in] num_members Number of members.
+ * @param[out] fused Fused value is written here, 0 if there is none.
+ * @param[out] outlier Optional, can be NULL. Whether each value was rejected as an outlier is written here.
+ *
+ * @return Number of members that the fused value was computed from, 0 if there is no fused value.
+ */
+static uint8_t fuse_values(const SHT3XFusionConfig *cfg, const uint16_t *values, const bool *valid,
+                           uint8_t num_members, uint16_t *fused, bool *outlier)
+{
+    uint16_t sorted[SHT3X_FUSION_MAX_MEMBERS];
+    uint8_t count = 0;
+    /* Insertion sort, fastest for the few members of a group */
+    for (uint8_t i = 0; i < num_members; i++) {
+        if (!valid[i]) {
+            continue;
+        }
+        uint8_t j = count++;
+        while ((j > 0) && (sorted[j - 1] > values[i])) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = values[i];
+    }
+
+    if ((cfg->max_deviation > 0) && (count > 0)) {
+        uint16_t median = get_median(sorted, count);
+        uint8_t kept = 0;
+        /* Filtering keeps the remaining values sorted */
+        for (uint8_t i = 0; i < count; i++) {
+            uint16_t deviation = (sorted[i] > median) ? (sorted[i] - median) : (median - sorted[i]);
+            if (deviation <= cfg->max_deviation) {
+                sorted[kept++] = sorted[i];
+            }
+        }
+        if (outlier) {
+            for (uint8_t i = 0; i < num_members; i++) {
+                uint16_t deviation = (values[i] > median) ? (values[i] - median) : (median - values[i]);
+                outlier[i] = valid[i] && (deviation > cfg->max_deviation);
+            }
+        }
+        count = kept;
+    } else if (outlier) {
+        for (uint8_t i = 0; i < num_members; i++) {
+            outlier[i] = false;
+        }
+    }
+
+    if ((count == 0) || (count < cfg->min_members)) {
+        *fused = 0;
+        return 0;
+    }
+
+    if (cfg->method == SHT3X_FUSION_METHOD_MEDIAN) {
+        *fused = get_median(sorted, count);
+        return count;
+    }
+
+    uint8_t trim = cfg->trim;
+    if (trim > ((count - 1) / 2)) {
+        trim = (uint8_t)((count - 1) / 2);
+    }
+    uint8_t num_kept = (uint8_t)(count - (2 * trim));
+    uint32_t sum = 0;
+    for (uint8_t i = trim; i < (count - trim); i++) {
+        sum += sorted[i];
+    }
+    *fused = (uint16_t)((sum + (num_kept / 2)) / num_kept);
+    return count;
+}
+
+/**
+ * @brief Fuse the readouts of the current round, update the outlier counters and start a new round.
+ *
+ * @param[in] group Fusion group.
+ * @param[out] result Fused values are written here.
+ */
+static void fuse_round(SHT3XFusionGroup *group, SHT3XFusionResult *result)
+{
+    uint16_t values[SHT3X_FUSION_MAX_MEMBERS];
+    bool valid[SHT3X_FUSION_MAX_MEMBERS];
+    bool temp_outlier[SHT3X_FUSION_MAX_MEMBERS];
+    bool hum_outlier[SHT3X_FUSION_MAX_MEMBERS];
+
+    for (uint8_t i = 0; i < group->num_members; i++) {
+        values[i] = group->members[i].raw_temperature;
+        valid[i] = (group->members[i].flags & SHT3X_FLAG_READ_TEMP) != 0;
+    }
+    result->temperature_members = fuse_values(&group->cfg, values, valid, group->num_members,
+                                              &result->raw_temperature, temp_outlier);
+
+    for (uint8_t i = 0; i < group->num_members; i++) {
+        values[i] = group->members[i].raw_humidity;
+        valid[i] = (group->members[i].flags & SHT3X_FLAG_READ_HUM) != 0;
+    }
+    result->humidity_members = fuse_values(&group->cfg, values, valid, group->num_members, &result->raw_humidity,
+                                           hum_outlier);
+
+    for (uint8_t i = 0; i < group->num_members; i++) {
+        SHT3XFusionMember *member = &group->members[i];
+        member->counters.outliers =
+            saturating_add(member->counters.outliers, (uint32_t)temp_outlier[i] + (uint32_t)hum_outlier[i]);
+        member->reported = false;
+    }
+    group->num_reported = 0;
+}
+
+uint8_t sht3x_fusion_init(SHT3XFusionGroup *const group, const SHT3XFusionConfig *const cfg, uint8_t num_members,
+                          SHT3XFusionCompleteCb cb, void *user_data)
+{
+    if (!group || !is_valid_cfg(cfg, num_members) || !cb) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    group->cfg = *cfg;
+    group->num_members = num_members;
+    group->num_reported = 0;
+    for (uint8_t i = 0; i < SHT3X_FUSION_MAX_MEMBERS; i++) {
+        SHT3XFusionMember *member = &group->members[i];
+        member->group = group;
+        member->counters.readouts = 0;
+        member->counters.failures = 0;
+        member->counters.outliers = 0;
+        member->reported = false;
+        member->flags = 0;
+        member->raw_temperature = 0;
+        member->raw_humidity = 0;
+    }
+    group->cb = cb;
+    group->cb_user_data = user_data;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_fusion_get_member(SHT3XFusionGroup *const group, uint8_t index, SHT3XFusionMember **const member)
+{
+    if (!group || !member || (index >= group->num_members)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    *member = &group->members[index];
+    return SHT3X_RESULT_CODE_OK;
+}
+
+void sht3x_fusion_lazy_meas_complete_cb(uint8_t result_code, SHT3XLazyMeasurement *meas, void *user_data)
+{
+    SHT3XFusionMember *member = (SHT3XFusionMember *)user_data;
+    if (!member) {
+        return;
+    }
+    SHT3XFusionGroup *group = member->group;
+
+    member->counters.readouts = saturating_add(member->counters.readouts, 1);
+    if ((result_code == SHT3X_RESULT_CODE_OK) && meas) {
+        member->flags = meas->flags;
+        member->raw_temperature = meas->raw_temperature;
+        member->raw_humidity = meas->raw_humidity;
+    } else {
+        member->counters.failures = saturating_add(member->counters.failures, 1);
+        member->flags = 0;
+    }
+    if (!member->reported) {
+        member->reported = true;
+        group->num_reported++;
+    }
+    if (group->num_reported < group->num_members) {
+        return;
+    }
+
+    SHT3XFusionResult result;
+    fuse_round(group, &result);
+    bool fused = (result.temperature_members > 0) || (result.humidity_members > 0);
+    group->cb(fused ? SHT3X_RESULT_CODE_OK : SHT3X_RESULT_CODE_NO_DATA, &result, group->cb_user_data);
+}
+
+uint8_t sht3x_fusion_get_member_counters(const SHT3XFusionGroup *const group, uint8_t index,
+                                         SHT3XFusionMemberCounters *const counters)
+{
+    if (!group || !counters || (index >= group->num_members)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    *counters = group->members[index].counters;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_fusion_batch(const SHT3XFusionConfig *const cfg, uint8_t num_members, const uint16_t *const values,
+                           const uint8_t *const status, uint8_t valid_mask, size_t num_groups, uint16_t *const fused,
+                           uint8_t *const fused_members)
+{
+    if (!is_valid_cfg(cfg, num_members) || !values || !status || !fused || !fused_members) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    bool valid[SHT3X_FUSION_MAX_MEMBERS];
+    for (size_t g = 0; g < num_groups; g++) {
+        size_t offset = g * num_members;
+        for (uint8_t i = 0; i < num_members; i++) {
+            valid[i] = (status[offset + i] & valid_mask) != 0;
+        }
+        fused_members[g] = fuse_values(cfg, &values[offset], valid, num_members, &fused[g], NULL);
+    }
+    return SHT3X_RESULT_CODE_OK;
+}
@@ -0,0 +1,199 @@
+#ifndef SRC_SHT3X_FUSION_H
+#define SRC_SHT3X_FUSION_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Fusion of redundant sensors that measure the same point.
+ *
+ * A fusion group combines the readouts of up to @ref SHT3X_FUSION_MAX_MEMBERS instances into one temperature and one
+ * humidity value per round. Each instance is a member of the group. Pass @ref sht3x_fusion_lazy_meas_complete_cb as the
+ * callback and the member from @ref sht3x_fusion_get_member as user data to the lazy readout functions, e.g. @ref
+ * sht3x_read_measurement_lazy. Once every member has reported in a round, the values are fused and the complete
+ * callback of the group is executed.
+ *
+ * Fusion works on raw ticks, separately for temperature and humidity:
+ * 1. Values of failed readouts, and values that were not read out, are left out.
+ * 2. If max_deviation is not 0, values that differ from the median by more than max_deviation are rejected as outliers.
+ * 3. The remaining values are combined by median, or by mean after dropping the trim lowest and trim highest values.
+ *    The median of an even number of values is the mean of the two middle ones. Means are rounded to the nearest tick.
+ * 4. If fewer than min_members values remain, there is no fused value.
+ *
+ * Every member counts its readouts, failed readouts and rejected outliers, to find sensors that drift or fail.
+ *
+ * @ref sht3x_fusion_batch fuses many groups at once from arrays of values, e.g. a frame of a fleet store from
+ * sht3x_fleet.h with the members of each group in consecutive slots.
+ */
+
+/** Largest number of members in a group. */
+#define SHT3X_FUSION_MAX_MEMBERS 8
+
+/** How values are combined. */
+typedef enum {
+    SHT3X_FUSION_METHOD_MEDIAN,
+    SHT3X_FUSION_METHOD_TRIMMED_MEAN,
+} SHT3XFusionMethod;
+
+/** Fusion options. */
+typedef struct {
+    /** One of @ref SHT3XFusionMethod. */
+    uint8_t method;
+    /** Number of lowest and of highest values that are dropped by @ref SHT3X_FUSION_METHOD_TRIMMED_MEAN. Reduced if
+     * fewer values remain, so that at least one value is left. */
+    uint8_t trim;
+    /** Largest difference from the median in raw ticks that is not an outlier. 0 to disable outlier rejection. */
+    uint16_t max_deviation;
+    /** Smallest number of values that a fused value is computed from. At least 1. */
+    uint8_t min_members;
+} SHT3XFusionConfig;
+
+/** Error accounting of a member. All counters saturate. */
+typedef struct {
+    /** Number of readouts that the member reported. */
+    uint32_t readouts;
+    /** Number of readouts that failed. */
+    uint32_t failures;
+    /** Number of values that were rejected as outliers. Temperature and humidity are counted separately. */
+    uint32_t outliers;
+} SHT3XFusionMemberCounters;
+
+/** Fused values of a round. */
+typedef struct {
+    uint16_t raw_temperature;
+    uint16_t raw_humidity;
+    /** Number of members that raw_temperature was fused from. 0 if there is no fused temperature. */
+    uint8_t temperature_members;
+    /** Number of members that raw_humidity was fused from. 0 if there is no fused humidity. */
+    uint8_t humidity_members;
+} SHT3XFusionResult;
+
+/**
+ * @brief Callback type to execute when a round is fused.
+ *
+ * @param result_code @ref SHT3X_RESULT_CODE_OK if at least one of temperature and humidity was fused, @ref
+ * SHT3X_RESULT_CODE_NO_DATA otherwise.
+ * @param result Fused values. Only valid during the execution of this callback.
+ * @param user_data User data.
+ */
+typedef void (*SHT3XFusionCompleteCb)(uint8_t result_code, const SHT3XFusionResult *result, void *user_data);
+
+struct SHT3XFusionGroupStruct;
+
+/**
+ * @brief Member of a fusion group.
+ *
+ * Part of the group state. The fields are private and should not be modified by the caller.
+ */
+typedef struct {
+    struct SHT3XFusionGroupStruct *group;
+    SHT3XFusionMemberCounters counters;
+    /** Readout of the current round. */
+    bool reported;
+    uint8_t flags;
+    uint16_t raw_temperature;
+    uint16_t raw_humidity;
+} SHT3XFusionMember;
+
+/**
+ * @brief Fusion group state.
+ *
+ * Provided by the caller, and must stay valid as long as readouts of its members are pending. The fields are private
+ * and should not be modified by the caller.
+ */
+typedef struct SHT3XFusionGroupStruct {
+    SHT3XFusionConfig cfg;
+    uint8_t num_members;
+    /** Number of members that reported in the current round. */
+    uint8_t num_reported;
+    SHT3XFusionMember members[SHT3X_FUSION_MAX_MEMBERS];
+    SHT3XFusionCompleteCb cb;
+    void *cb_user_data;
+} SHT3XFusionGroup;
+
+/**
+ * @brief Initialize a fusion group with all member counters zero.
+ *
+ * @param[out] group Caller-provided memory for the group state.
+ * @param[in] cfg Fusion options. Copied into @p group.
+ * @param[in] num_members Number of members, from 1 to @ref SHT3X_FUSION_MAX_MEMBERS.
+ * @param[in] cb Executed when a round is fused. Must not be NULL.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p group, @p cfg or @p cb is NULL, @p num_members is out of range, or @p cfg
+ * is invalid for @p num_members.
+ */
+uint8_t sht3x_fusion_init(SHT3XFusionGroup *const group, const SHT3XFusionConfig *const cfg, uint8_t num_members,
+                          SHT3XFusionCompleteCb cb, void *user_data);
+
+/**
+ * @brief Get a member, to pass as user data to @ref sht3x_fusion_lazy_meas_complete_cb.
+ *
+ * @param[in] group Fusion group.
+ * @param[in] index Member index.
+ * @param[out] member Member is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p group or @p member is NULL, or @p index is out of range.
+ */
+uint8_t sht3x_fusion_get_member(SHT3XFusionGroup *const group, uint8_t index, SHT3XFusionMember **const member);
+
+/**
+ * @brief Lazy measurement complete callback that reports the readout of a member.
+ *
+ * If the member already reported in the current round, its readout is replaced. @p user_data must be a member from
+ * @ref sht3x_fusion_get_member. See @ref SHT3XLazyMeasCompleteCb for the other parameters.
+ */
+void sht3x_fusion_lazy_meas_complete_cb(uint8_t result_code, SHT3XLazyMeasurement *meas, void *user_data);
+
+/**
+ * @brief Get the error accounting of a member.
+ *
+ * @param[in] group Fusion group.
+ * @param[in] index Member index.
+ * @param[out] counters Counters are written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p group or @p counters is NULL, or @p index is out of range.
+ */
+uint8_t sht3x_fusion_get_member_counters(const SHT3XFusionGroup *const group, uint8_t index,
+                                         SHT3XFusionMemberCounters *const counters);
+
+/**
+ * @brief Fuse many groups at once.
+ *
+ * Group g consists of the values at indices g * num_members to g * num_members + num_members - 1. A value is valid if
+ * its status has one of the bits in @p valid_mask set, e.g. SHT3X_FLEET_STATUS_TEMP for the temperature column of a
+ * fleet frame.
+ *
+ * @param[in] cfg Fusion options.
+ * @param[in] num_members Number of members per group, from 1 to @ref SHT3X_FUSION_MAX_MEMBERS.
+ * @param[in] values num_groups * num_members values in raw ticks.
+ * @param[in] status num_groups * num_members status bytes.
+ * @param[in] valid_mask Status bits that mark a value valid.
+ * @param[in] num_groups Number of groups.
+ * @param[out] fused num_groups fused values are written here. 0 for groups without a fused value.
+ * @param[out] fused_members num_groups member counts, as in @ref SHT3XFusionResult, are written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG One of the pointers is NULL, @p num_members is out of range, or @p cfg is
+ * invalid for @p num_members.
+ */
+uint8_t sht3x_fusion_batch(const SHT3XFusionConfig *const cfg, uint8_t num_members, const uint16_t *const values,
+                           const uint8_t *const status, uint8_t valid_mask, size_t num_groups, uint16_t *const fused,
+                           uint8_t *const fused_members);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_FUSION_H */
@@ -0,0 +1,235 @@
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_group.h"
+
+/** Steps of a group bring-up, in the order they are performed. */
+typedef enum {
+    SHT3X_GROUP_STEP_SOFT_RESET,
+    SHT3X_GROUP_STEP_CLEAR_STATUS_REG,
+    SHT3X_GROUP_STEP_VERIFY_STATUS_REG,
+    SHT3X_GROUP_STEP_START,
+    SHT3X_GROUP_STEP_DONE,
+} SHT3xGroupStep;
+
+static void run_step(SHT3XGroup *group);
+
+/**
+ * @brief Check whether group config is valid.
+ *
+ * @param[in] cfg Group config.
+ *
+ * @retval true Config is valid.
+ * @retval false Config is invalid.
+ */
+static bool is_valid_cfg(const SHT3XGroupConfig *const cfg)
+{
+    // clang-format off
+    return (
+        (cfg)
+        && (cfg->instances)
+        && (cfg->results)
+        && (cfg->num_instances > 0)
+        && (cfg->start_timer)
+        && sht3x_is_valid_periodic_cfg(cfg->init_cfg.meas_mode, cfg->init_cfg.repeatability, cfg->init_cfg.mps)
+    );
+    // clang-format on
+}
+
+/**
+ * @brief Check whether status register value is the expected one after soft reset and clear status register.
+ *
+ * @param[in] status_reg_val Status register value.
+ *
+ * @retval true Reset, alert, heater, command status and checksum flags are all cleared.
+ * @retval false At least one of these flags is set.
+ */
+static bool is_status_reg_clean(uint16_t status_reg_val)
+{
+    // clang-format off
+    return (
+        !sht3x_is_at_least_one_alert_pending(status_reg_val)
+        && !sht3x_is_heater_on(status_reg_val)
+        && !sht3x_is_humidity_alert_raised(status_reg_val)
+        && !sht3x_is_temperature_alert_raised(status_reg_val)
+        && !sht3x_is_system_reset_detected(status_reg_val)
+        && sht3x_is_last_command_executed_successfully(status_reg_val)
+        && sht3x_is_crc_of_last_write_transfer_correct(status_reg_val)
+    );
+    // clang-format on
+}
+
+/**
+ * @brief Record the result of the current step for the instance at the cursor, and move on to the next instance.
+ *
+ * @param[in] group Group bring-up state.
+ * @param[in] rc Result of the current step, use @ref SHT3XResultCode.
+ */
+static void instance_step_complete(SHT3XGroup *group, uint8_t rc)
+{
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        /* This instance is skipped in all subsequent steps */
+        group->cfg.results[group->cursor] = rc;
+    }
+    group->cursor++;
+    run_step(group);
+}
+
+static void complete_cb(uint8_t result_code, void *user_data)
+{
+    SHT3XGroup *group = (SHT3XGroup *)user_data;
+    if (!group) {
+        return;
+    }
+    instance_step_complete(group, result_code);
+}
+
+static void read_status_reg_complete_cb(uint8_t result_code, uint16_t reg_val, void *user_data)
+{
+    SHT3XGroup *group = (SHT3XGroup *)user_data;
+    if (!group) {
+        return;
+    }
+    if ((result_code == SHT3X_RESULT_CODE_OK) && !is_status_reg_clean(reg_val)) {
+        result_code = SHT3X_RESULT_CODE_UNEXPECTED_STATUS;
+    }
+    instance_step_complete(group, result_code);
+}
+
+static void timer_expired_cb(void *user_data)
+{
+    SHT3XGroup *group = (SHT3XGroup *)user_data;
+    if (!group) {
+        return;
+    }
+    run_step(group);
+}
+
+/**
+ * @brief Send the command of the current step to an instance.
+ *
+ * @param[in] group Group bring-up state.
+ * @param[in] instance Instance to send the command to.
+ *
+ * @return uint8_t Return value of the driver function that sends the command.
+ */
+static uint8_t send_step_cmd(SHT3XGroup *group, SHT3X instance)
+{
+    const SHT3XInitSequenceConfig *init_cfg = &(group->cfg.init_cfg);
+    switch (group->step) {
+    case SHT3X_GROUP_STEP_SOFT_RESET:
+        return sht3x_soft_reset(instance, complete_cb, (void *)group);
+    case SHT3X_GROUP_STEP_CLEAR_STATUS_REG:
+        return sht3x_clear_status_register(instance, complete_cb, (void *)group);
+    case SHT3X_GROUP_STEP_VERIFY_STATUS_REG:
+        return sht3x_read_status_register(instance, SHT3X_VERIFY_CRC_YES, read_status_reg_complete_cb, (void *)group);
+    case SHT3X_GROUP_STEP_START:
+        if (init_cfg->meas_mode == SHT3X_MEAS_MODE_PERIODIC_ART) {
+            return sht3x_start_periodic_measurement_art(instance, complete_cb, (void *)group);
+        }
+        return sht3x_start_periodic_measurement(instance, init_cfg->repeatability, init_cfg->mps, complete_cb,
+                                                (void *)group);
+    default:
+        /* Invalid step, this should never happen */
+        return SHT3X_RESULT_CODE_DRIVER_ERR;
+    }
+}
+
+/**
+ * @brief Move on to the next step, after the current step was performed on all instances.
+ *
+ * Starts the shared delay that the next step requires, if any. The next step is then run from the timer expired
+ * callback.
+ *
+ * @param[in] group Group bring-up state.
+ */
+static void finish_step(SHT3XGroup *group)
+{
+    uint8_t finished_step = group->step;
+    group->cursor = 0;
+    group->step++;
+    if ((group->step == SHT3X_GROUP_STEP_VERIFY_STATUS_REG) && !group->cfg.init_cfg.verify_status) {
+        group->step++;
+    }
+
+    if (finished_step == SHT3X_GROUP_STEP_SOFT_RESET) {
+        /* One soft reset time for all devices */
+        group->cfg.start_timer(SHT3X_SOFT_RESET_DELAY_MS, group->cfg.start_timer_user_data, timer_expired_cb,
+                               (void *)group);
+    } else if (finished_step == SHT3X_GROUP_STEP_CLEAR_STATUS_REG) {
+        /* One mandatory delay for all devices. Read status register sequence keeps the mandatory delay before the
+         * start command on its own. */
+        group->cfg.start_timer(SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS, group->cfg.start_timer_user_data,
+                               timer_expired_cb, (void *)group);
+    } else {
+        run_step(group);
+    }
+}
+
+/**
+ * @brief Execute the complete callback of the group bring-up.
+ *
+ * @param[in] group Group bring-up state.
+ */
+static void complete_group(SHT3XGroup *group)
+{
+    uint8_t rc = SHT3X_RESULT_CODE_OK;
+    for (size_t i = 0; i < group->cfg.num_instances; i++) {
+        if (group->cfg.results[i] != SHT3X_RESULT_CODE_OK) {
+            rc = group->cfg.results[i];
+            break;
+        }
+    }
+    if (group->cb) {
+        group->cb(rc, group->cb_user_data);
+    }
+}
+
+/**
+ * @brief Send the command of the current step to the next instance that has not failed yet.
+ *
+ * If the command is sent, the rest of the step continues from the complete callback of the instance.
+ *
+ * @param[in] group Group bring-up state.
+ */
+static void run_step(SHT3XGroup *group)
+{
+    if (group->step == SHT3X_GROUP_STEP_DONE) {
+        complete_group(group);
+        return;
+    }
+
+    while (group->cursor < group->cfg.num_instances) {
+        if (group->cfg.results[group->cursor] == SHT3X_RESULT_CODE_OK) {
+            uint8_t rc = send_step_cmd(group, group->cfg.instances[group->cursor]);
+            if (rc == SHT3X_RESULT_CODE_OK) {
+                /* Wait for the complete callback of this instance */
+                return;
+            }
+            group->cfg.results[group->cursor] = rc;
+        }
+        group->cursor++;
+    }
+
+    finish_step(group);
+}
+
+uint8_t sht3x_group_init(SHT3XGroup *const group, const SHT3XGroupConfig *const cfg, SHT3XGroupInitCompleteCb cb,
+                         void *user_data)
+{
+    if (!group || !is_valid_cfg(cfg)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    group->cfg = *cfg;
+    group->cb = cb;
+    group->cb_user_data = user_data;
+    group->step = SHT3X_GROUP_STEP_SOFT_RESET;
+    group->cursor = 0;
+    for (size_t i = 0; i < cfg->num_instances; i++) {
+        group->cfg.results[i] = SHT3X_RESULT_CODE_OK;
+    }
+
+    run_step(group);
+    return SHT3X_RESULT_CODE_OK;
+}
@@ -0,0 +1,105 @@
+#ifndef SRC_SHT3X_GROUP_H
+#define SRC_SHT3X_GROUP_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Bring-up of several SHT3X devices at once.
+ *
+ * Bringing up devices one by one with @ref sht3x_init_sequence costs the soft reset time and the mandatory delays
+ * between commands once per device. @ref sht3x_group_init performs every step on all devices before moving on to the
+ * next step, so that the delays are shared:
+ * 1. Send soft reset command to every device.
+ * 2. Wait for @ref SHT3X_SOFT_RESET_DELAY_MS once.
+ * 3. Send clear status register command to every device.
+ * 4. Wait for @ref SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS once.
+ * 5. If verify_status is true, read out the status register of every device with CRC, and check that the reset,
+ * alert, heater, command status and checksum flags are all cleared.
+ * 6. Send start periodic measurement command or ART command to every device.
+ *
+ * Within a step, the commands are sent one after another: the next command is sent once the previous one completes.
+ * Devices on the same bus therefore never compete for it, and devices behind different buses are still handled
+ * correctly.
+ *
+ * A device that fails a step is skipped in all subsequent steps, while the other devices continue. The result of every
+ * device is written to the results array.
+ */
+
+/**
+ * @brief Gets called when group bring-up is complete.
+ *
+ * @param result_code @ref SHT3X_RESULT_CODE_OK if all devices were brought up. Otherwise, the result code of the first
+ * device in the instances array that failed. Result codes of every device are in the results array.
+ * @param user_data User data.
+ */
+typedef void (*SHT3XGroupInitCompleteCb)(uint8_t result_code, void *user_data);
+
+typedef struct {
+    /** Instances created by @ref sht3x_create, one per device. Must stay valid until the bring-up is complete. */
+    SHT3X *instances;
+    /** Result code of every device is written here, one per instance. Must stay valid until the bring-up is
+     * complete. */
+    uint8_t *results;
+    /** Number of elements in instances and results. */
+    size_t num_instances;
+    /** Measurement mode to start, options of the measurement and whether the status register is verified. Same as
+     * for @ref sht3x_init_sequence. */
+    SHT3XInitSequenceConfig init_cfg;
+    /** Used for the shared delays. */
+    SHT3XStartTimer start_timer;
+    /** User data to pass to start_timer function. */
+    void *start_timer_user_data;
+} SHT3XGroupConfig;
+
+/**
+ * @brief State of a group bring-up.
+ *
+ * Provided by the caller, and must stay valid until the bring-up is complete. The fields are private and should not be
+ * modified by the caller.
+ */
+typedef struct {
+    SHT3XGroupConfig cfg;
+    SHT3XGroupInitCompleteCb cb;
+    void *cb_user_data;
+    /** Current step of the bring-up. */
+    uint8_t step;
+    /** Index of the instance that the command of the current step is sent to. */
+    size_t cursor;
+} SHT3XGroup;
+
+/**
+ * @brief Bring up several devices at once and start periodic measurement or ART on all of them.
+ *
+ * Possible values of results array elements, as well as of the result_code parameter in @p cb:
+ * - @ref SHT3X_RESULT_CODE_OK Measurements are started.
+ * - @ref SHT3X_RESULT_CODE_IO_ERR One of the I2C transactions failed.
+ * - @ref SHT3X_RESULT_CODE_CRC_MISMATCH Status register CRC verification failed.
+ * - @ref SHT3X_RESULT_CODE_UNEXPECTED_STATUS At least one of the verified status register flags is set.
+ * - @ref SHT3X_RESULT_CODE_BUSY The instance had a sequence in progress, so it was skipped.
+ *
+ * @param[out] group Caller-provided memory for the bring-up state.
+ * @param[in] cfg Group bring-up options. Copied into @p group.
+ * @param[in] cb Callback to execute once complete. Can be NULL if not needed.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Successfully initiated group bring-up.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p group or @p cfg is NULL, instances or results array is NULL, num_instances
+ * is 0, start_timer is NULL, or one of the options in init_cfg is invalid.
+ */
+uint8_t sht3x_group_init(SHT3XGroup *const group, const SHT3XGroupConfig *const cfg, SHT3XGroupInitCompleteCb cb,
+                         void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_GROUP_H */
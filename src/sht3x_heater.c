@@ -0,0 +1,355 @@
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_heater.h"
+
+/** Heater phases. */
+typedef enum {
+    /** Heater is off, and the next measurement decides whether to start a pulse. */
+    SHT3X_HEATER_PHASE_IDLE,
+    /** Heater is on. */
+    SHT3X_HEATER_PHASE_HEATING,
+    /** Heater is off, and stays off to keep the duty cycle. */
+    SHT3X_HEATER_PHASE_COOLING,
+    /** Heater off retries are exhausted, heater state is unknown. No more pulses are started. */
+    SHT3X_HEATER_PHASE_FAULT,
+} SHT3xHeaterPhase;
+
+typedef enum {
+    SHT3X_HEATER_CMD_NONE,
+    SHT3X_HEATER_CMD_ON,
+    SHT3X_HEATER_CMD_OFF,
+} SHT3xHeaterCmd;
+
+typedef enum {
+    SHT3X_HEATER_TIMER_NONE,
+    /** Mandatory delay after a heater command, before the next command can be sent to the device. */
+    SHT3X_HEATER_TIMER_GAP,
+    /** End of the heating or cooling phase. */
+    SHT3X_HEATER_TIMER_PHASE,
+} SHT3xHeaterTimerPurpose;
+
+static void send_pending_cmd(SHT3XHeaterCtrl *ctrl);
+
+/**
+ * @brief Check whether heater controller config is valid.
+ *
+ * @param[in] cfg Heater controller config.
+ *
+ * @retval true Config is valid.
+ * @retval false Config is invalid.
+ */
+static bool is_valid_cfg(const SHT3XHeaterCtrlConfig *const cfg)
+{
+    // clang-format off
+    return (
+        (cfg)
+        && (cfg->instance)
+        && (cfg->start_timer)
+        && (cfg->rh_threshold >= 0.0f)
+        && (cfg->rh_threshold <= 100.0f)
+        /* Pulse must be longer than the mandatory delay after the heater on command */
+        && (cfg->pulse_ms > SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS)
+        && (cfg->max_duty_cycle_percent >= 1)
+        && (cfg->max_duty_cycle_percent <= 100)
+    );
+    // clang-format on
+}
+
+/**
+ * @brief Get the minimum time that the heater has to stay off after a pulse, to keep the duty cycle.
+ *
+ * @param[in] ctrl Heater controller.
+ *
+ * @return uint32_t Time in ms.
+ */
+static uint32_t get_cooling_ms(const SHT3XHeaterCtrl *ctrl)
+{
+    uint32_t duty = ctrl->cfg.max_duty_cycle_percent;
+    uint64_t off_ms = ((uint64_t)ctrl->cfg.pulse_ms * (100 - duty) + (duty - 1)) / duty;
+    return (off_ms > UINT32_MAX) ? UINT32_MAX : (uint32_t)off_ms;
+}
+
+static void start_timer(SHT3XHeaterCtrl *ctrl, uint8_t purpose, uint32_t duration_ms);
+
+static void read_complete_cb(uint8_t result_code, SHT3XMeasurement *meas, void *user_data)
+{
+    SHT3XHeaterCtrl *ctrl = (SHT3XHeaterCtrl *)user_data;
+    if (!ctrl) {
+        return;
+    }
+    ctrl->read_in_flight = false;
+    bool heater_affected = ctrl->heater_seen;
+    ctrl->heater_seen = (ctrl->phase != SHT3X_HEATER_PHASE_IDLE);
+
+    // clang-format off
+    bool start_pulse = (
+        (result_code == SHT3X_RESULT_CODE_OK)
+        && (meas)
+        && (ctrl->read_flags & SHT3X_FLAG_READ_HUM)
+        && (ctrl->phase == SHT3X_HEATER_PHASE_IDLE)
+        && (ctrl->pending_cmd == SHT3X_HEATER_CMD_NONE)
+        && (meas->humidity >= ctrl->cfg.rh_threshold)
+    );
+    // clang-format on
+    if (start_pulse) {
+        ctrl->pending_cmd = SHT3X_HEATER_CMD_ON;
+    }
+
+    SHT3XHeaterCtrlMeasCompleteCb cb = ctrl->read_cb;
+    void *cb_user_data = ctrl->read_cb_user_data;
+    ctrl->read_cb = NULL;
+    ctrl->read_cb_user_data = NULL;
+    /* Heater command goes first, so that a readout started from cb is queued behind it */
+    send_pending_cmd(ctrl);
+
+    if (!cb) {
+        return;
+    }
+    if (heater_affected && ctrl->cfg.suppress_heater_affected && (result_code == SHT3X_RESULT_CODE_OK)) {
+        cb(SHT3X_RESULT_CODE_NO_DATA, NULL, heater_affected, cb_user_data);
+    } else {
+        cb(result_code, meas, heater_affected, cb_user_data);
+    }
+}
+
+/**
+ * @brief Start the readout that was requested through @ref sht3x_heater_ctrl_read_periodic_measurement.
+ *
+ * @param[in] ctrl Heater controller.
+ *
+ * @return uint8_t Return value of @ref sht3x_issue.
+ */
+static uint8_t issue_read(SHT3XHeaterCtrl *ctrl)
+{
+    ctrl->read_queued = false;
+    ctrl->read_in_flight = true;
+    uint8_t rc = sht3x_issue(ctrl->cfg.instance, &(ctrl->read_prepared), read_complete_cb, (void *)ctrl);
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        ctrl->read_in_flight = false;
+    }
+    return rc;
+}
+
+/**
+ * @brief Start the readout that was queued while a heater command was in progress.
+ *
+ * If the readout cannot be started, its callback is executed with the failure.
+ *
+ * @param[in] ctrl Heater controller.
+ */
+static void issue_queued_read(SHT3XHeaterCtrl *ctrl)
+{
+    if (!ctrl->read_queued) {
+        return;
+    }
+    uint8_t rc = issue_read(ctrl);
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        SHT3XHeaterCtrlMeasCompleteCb cb = ctrl->read_cb;
+        ctrl->read_cb = NULL;
+        if (cb) {
+            cb(rc, NULL, ctrl->heater_seen, ctrl->read_cb_user_data);
+        }
+    }
+}
+
+/**
+ * @brief Give up on turning the heater off, and report the failure.
+ *
+ * A readout that is queued behind the heater commands is completed with @p result_code.
+ *
+ * @param[in] ctrl Heater controller.
+ * @param[in] result_code Result code of the last failed heater off command.
+ */
+static void enter_fault(SHT3XHeaterCtrl *ctrl, uint8_t result_code)
+{
+    ctrl->phase = SHT3X_HEATER_PHASE_FAULT;
+    ctrl->pending_cmd = SHT3X_HEATER_CMD_NONE;
+    /* Readouts requested from the callbacks below are queued behind the mandatory delay */
+    start_timer(ctrl, SHT3X_HEATER_TIMER_GAP, SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS);
+
+    SHT3XHeaterCtrlMeasCompleteCb read_cb = NULL;
+    void *read_cb_user_data = NULL;
+    if (ctrl->read_queued) {
+        read_cb = ctrl->read_cb;
+        read_cb_user_data = ctrl->read_cb_user_data;
+        ctrl->read_queued = false;
+        ctrl->read_cb = NULL;
+        ctrl->read_cb_user_data = NULL;
+    }
+    if (ctrl->cfg.error_cb) {
+        ctrl->cfg.error_cb(result_code, ctrl->cfg.error_cb_user_data);
+    }
+    if (read_cb) {
+        read_cb(result_code, NULL, true, read_cb_user_data);
+    }
+}
+
+static void heater_cmd_complete_cb(uint8_t result_code, void *user_data)
+{
+    SHT3XHeaterCtrl *ctrl = (SHT3XHeaterCtrl *)user_data;
+    if (!ctrl) {
+        return;
+    }
+    uint8_t cmd = ctrl->cmd_in_flight;
+    ctrl->cmd_in_flight = SHT3X_HEATER_CMD_NONE;
+
+    if (result_code != SHT3X_RESULT_CODE_OK) {
+        if (ctrl->off_retry_count >= SHT3X_HEATER_CTRL_MAX_OFF_RETRIES) {
+            enter_fault(ctrl, result_code);
+            return;
+        }
+        /* Heater could be on either way. Make sure it ends up off: retry the heater off command after the mandatory
+         * delay. */
+        ctrl->off_retry_count++;
+        ctrl->phase = SHT3X_HEATER_PHASE_HEATING;
+        ctrl->pending_cmd = SHT3X_HEATER_CMD_OFF;
+    } else {
+        ctrl->off_retry_count = 0;
+        if (cmd == SHT3X_HEATER_CMD_OFF) {
+            ctrl->phase = SHT3X_HEATER_PHASE_COOLING;
+        }
+    }
+    start_timer(ctrl, SHT3X_HEATER_TIMER_GAP, SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS);
+}
+
+/**
+ * @brief Send the pending heater command, unless the device is busy with a readout or another heater command.
+ *
+ * If the command is not sent now, it stays pending, and is sent once the device is free.
+ *
+ * @param[in] ctrl Heater controller.
+ */
+static void send_pending_cmd(SHT3XHeaterCtrl *ctrl)
+{
+    // clang-format off
+    bool can_send = (
+        (ctrl->pending_cmd != SHT3X_HEATER_CMD_NONE)
+        && (ctrl->cmd_in_flight == SHT3X_HEATER_CMD_NONE)
+        && !ctrl->read_in_flight
+        && (ctrl->timer_purpose != SHT3X_HEATER_TIMER_GAP)
+    );
+    // clang-format on
+    if (!can_send) {
+        return;
+    }
+
+    uint8_t cmd = ctrl->pending_cmd;
+    ctrl->pending_cmd = SHT3X_HEATER_CMD_NONE;
+    ctrl->cmd_in_flight = cmd;
+    ctrl->heater_seen = true;
+    uint8_t rc;
+    if (cmd == SHT3X_HEATER_CMD_ON) {
+        ctrl->phase = SHT3X_HEATER_PHASE_HEATING;
+        rc = sht3x_enable_heater(ctrl->cfg.instance, heater_cmd_complete_cb, (void *)ctrl);
+    } else {
+        rc = sht3x_disable_heater(ctrl->cfg.instance, heater_cmd_complete_cb, (void *)ctrl);
+    }
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        heater_cmd_complete_cb(rc, (void *)ctrl);
+    }
+}
+
+static void timer_expired_cb(void *user_data)
+{
+    SHT3XHeaterCtrl *ctrl = (SHT3XHeaterCtrl *)user_data;
+    if (!ctrl) {
+        return;
+    }
+    uint8_t purpose = ctrl->timer_purpose;
+    ctrl->timer_purpose = SHT3X_HEATER_TIMER_NONE;
+
+    if (purpose == SHT3X_HEATER_TIMER_GAP) {
+        if (ctrl->pending_cmd != SHT3X_HEATER_CMD_NONE) {
+            send_pending_cmd(ctrl);
+            return;
+        }
+        /* The gap counts towards the phase duration */
+        if (ctrl->phase == SHT3X_HEATER_PHASE_HEATING) {
+            start_timer(ctrl, SHT3X_HEATER_TIMER_PHASE,
+                        ctrl->cfg.pulse_ms - SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS);
+        } else if (ctrl->phase == SHT3X_HEATER_PHASE_COOLING) {
+            uint32_t cooling_ms = get_cooling_ms(ctrl);
+            if (cooling_ms > SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS) {
+                start_timer(ctrl, SHT3X_HEATER_TIMER_PHASE, cooling_ms - SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS);
+            } else {
+                ctrl->phase = SHT3X_HEATER_PHASE_IDLE;
+            }
+        }
+        issue_queued_read(ctrl);
+    } else if (purpose == SHT3X_HEATER_TIMER_PHASE) {
+        if (ctrl->phase == SHT3X_HEATER_PHASE_HEATING) {
+            ctrl->pending_cmd = SHT3X_HEATER_CMD_OFF;
+            send_pending_cmd(ctrl);
+        } else {
+            ctrl->phase = SHT3X_HEATER_PHASE_IDLE;
+        }
+    }
+}
+
+/**
+ * @brief Start the timer of the controller.
+ *
+ * @param[in] ctrl Heater controller.
+ * @param[in] purpose Use @ref SHT3xHeaterTimerPurpose.
+ * @param[in] duration_ms Timer duration in ms.
+ */
+static void start_timer(SHT3XHeaterCtrl *ctrl, uint8_t purpose, uint32_t duration_ms)
+{
+    ctrl->timer_purpose = purpose;
+    ctrl->cfg.start_timer(duration_ms, ctrl->cfg.start_timer_user_data, timer_expired_cb, (void *)ctrl);
+}
+
+uint8_t sht3x_heater_ctrl_init(SHT3XHeaterCtrl *const ctrl, const SHT3XHeaterCtrlConfig *const cfg)
+{
+    if (!ctrl || !is_valid_cfg(cfg)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    ctrl->cfg = *cfg;
+    ctrl->phase = SHT3X_HEATER_PHASE_IDLE;
+    ctrl->pending_cmd = SHT3X_HEATER_CMD_NONE;
+    ctrl->cmd_in_flight = SHT3X_HEATER_CMD_NONE;
+    ctrl->timer_purpose = SHT3X_HEATER_TIMER_NONE;
+    ctrl->off_retry_count = 0;
+    ctrl->heater_seen = false;
+    ctrl->read_in_flight = false;
+    ctrl->read_queued = false;
+    ctrl->read_flags = 0;
+    ctrl->read_cb = NULL;
+    ctrl->read_cb_user_data = NULL;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_heater_ctrl_read_periodic_measurement(SHT3XHeaterCtrl *const ctrl, uint8_t flags,
+                                                    SHT3XHeaterCtrlMeasCompleteCb cb, void *user_data)
+{
+    if (!ctrl) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    SHT3XPreparedMeas prepared;
+    uint8_t rc = sht3x_prepare_periodic_measurement(flags, &prepared);
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        return rc;
+    }
+    if (ctrl->read_in_flight || ctrl->read_queued) {
+        return SHT3X_RESULT_CODE_BUSY;
+    }
+
+    ctrl->read_prepared = prepared;
+    ctrl->read_flags = flags;
+    ctrl->read_cb = cb;
+    ctrl->read_cb_user_data = user_data;
+    if ((ctrl->cmd_in_flight != SHT3X_HEATER_CMD_NONE) || (ctrl->timer_purpose == SHT3X_HEATER_TIMER_GAP)) {
+        /* Sent once the heater command completes and the mandatory delay elapses */
+        ctrl->read_queued = true;
+        return SHT3X_RESULT_CODE_OK;
+    }
+
+    rc = issue_read(ctrl);
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        ctrl->read_cb = NULL;
+        ctrl->read_cb_user_data = NULL;
+    }
+    return rc;
+}
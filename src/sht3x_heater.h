@@ -0,0 +1,157 @@
+#ifndef SRC_SHT3X_HEATER_H
+#define SRC_SHT3X_HEATER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Heater duty cycle controller for condensation recovery.
+ *
+ * The controller pulses the heater of a device that performs periodic measurements, whenever the measured humidity
+ * reaches a threshold:
+ * 1. A measurement read out through @ref sht3x_heater_ctrl_read_periodic_measurement shows humidity at or above
+ * rh_threshold.
+ * 2. Heater is enabled for pulse_ms.
+ * 3. Heater is disabled, and stays disabled for at least as long as needed to keep the heater duty cycle at or below
+ * max_duty_cycle_percent.
+ * 4. The next measurement decides whether another pulse is needed.
+ *
+ * All periodic measurement readouts of the device must go through @ref sht3x_heater_ctrl_read_periodic_measurement.
+ * This lets the controller interleave heater commands with the readouts: a heater command that is due while a readout
+ * is in progress is sent right after the readout, and a readout requested while a heater command is in progress is
+ * sent once the command completes and the mandatory delay between commands elapses. Neither of them fails with @ref
+ * SHT3X_RESULT_CODE_BUSY because of the other.
+ *
+ * Measurements that may have been affected by the heater, i.e. read out while the heater was on or cooling down, are
+ * tagged, or optionally suppressed.
+ *
+ * If a heater command fails, the heater could be on, so the controller sends heater off command after the mandatory
+ * delay. It retries heater off at most @ref SHT3X_HEATER_CTRL_MAX_OFF_RETRIES times. If all of them fail, the
+ * controller gives up: error_cb from its config is executed, a queued readout completes with the error, and no more
+ * heater pulses are started. All later measurements are tagged as heater affected, because the heater state is
+ * unknown. Once the fault is resolved, e.g. with @ref sht3x_soft_reset_with_delay, which turns the heater off,
+ * initialize the controller again.
+ *
+ * The controller uses its own timer via start_timer from its config. At most one timer of the controller runs at a
+ * time, but it can run at the same time as a timer of the driver instance.
+ */
+
+/**
+ * @brief Gets called when a measurement readout through the heater controller is complete.
+ *
+ * @param result_code Same as in @ref SHT3XMeasCompleteCb. @ref SHT3X_RESULT_CODE_NO_DATA if the measurement was
+ * suppressed, because it was affected by the heater.
+ * @param meas Same as in @ref SHT3XMeasCompleteCb.
+ * @param heater_affected true if the heater was on or cooling down at some point since the previous readout.
+ * @param user_data User data.
+ */
+typedef void (*SHT3XHeaterCtrlMeasCompleteCb)(uint8_t result_code, SHT3XMeasurement *meas, bool heater_affected,
+                                              void *user_data);
+
+/**
+ * @brief Gets called when the heater controller gives up on turning the heater off.
+ *
+ * @param result_code Result code of the last failed heater off command, use @ref SHT3XResultCode.
+ * @param user_data User data.
+ */
+typedef void (*SHT3XHeaterCtrlErrorCb)(uint8_t result_code, void *user_data);
+
+/** Number of times heater off command is retried after a failed heater command, before the controller gives up. */
+#define SHT3X_HEATER_CTRL_MAX_OFF_RETRIES 3
+
+typedef struct {
+    /** Instance created by @ref sht3x_create, with periodic measurement or ART running. */
+    SHT3X instance;
+    /** Heater pulse is started when measured humidity in RH% is at or above this value. */
+    float rh_threshold;
+    /** Duration of a heater pulse in ms. Must be at least 2. */
+    uint32_t pulse_ms;
+    /** Maximum share of time in % that the heater is on. From 1 to 100. */
+    uint8_t max_duty_cycle_percent;
+    /** Report measurements affected by the heater with @ref SHT3X_RESULT_CODE_NO_DATA instead of the values. */
+    bool suppress_heater_affected;
+    /** Used for heater timing. */
+    SHT3XStartTimer start_timer;
+    /** User data to pass to start_timer function. */
+    void *start_timer_user_data;
+    /** Executed when the controller gives up on turning the heater off. Can be NULL. */
+    SHT3XHeaterCtrlErrorCb error_cb;
+    /** User data to pass to error_cb. */
+    void *error_cb_user_data;
+} SHT3XHeaterCtrlConfig;
+
+/**
+ * @brief Heater controller state.
+ *
+ * Provided by the caller, and must stay valid as long as the controller is used. The fields are private and should
+ * not be modified by the caller.
+ */
+typedef struct {
+    SHT3XHeaterCtrlConfig cfg;
+    /** Heater phase. */
+    uint8_t phase;
+    /** Heater command that is due, but not sent yet. */
+    uint8_t pending_cmd;
+    /** Heater command that is currently being sent. */
+    uint8_t cmd_in_flight;
+    /** What the currently running timer of the controller is for. */
+    uint8_t timer_purpose;
+    /** Number of heater off retries since the last successful heater command. */
+    uint8_t off_retry_count;
+    /** Heater was on or cooling down at some point since the previous readout completed. */
+    bool heater_seen;
+    bool read_in_flight;
+    bool read_queued;
+    uint8_t read_flags;
+    SHT3XPreparedMeas read_prepared;
+    SHT3XHeaterCtrlMeasCompleteCb read_cb;
+    void *read_cb_user_data;
+} SHT3XHeaterCtrl;
+
+/**
+ * @brief Initialize a heater controller.
+ *
+ * Assumes that the heater is off. Does not perform any I2C transactions.
+ *
+ * @param[out] ctrl Caller-provided memory for the controller state.
+ * @param[in] cfg Controller options. Copied into @p ctrl.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p ctrl or @p cfg is NULL, instance or start_timer is NULL, or one of the
+ * options is out of range.
+ */
+uint8_t sht3x_heater_ctrl_init(SHT3XHeaterCtrl *const ctrl, const SHT3XHeaterCtrlConfig *const cfg);
+
+/**
+ * @brief Read out periodic measurement through the heater controller.
+ *
+ * Same as @ref sht3x_read_periodic_measurement, but the readout is coordinated with heater commands, and the
+ * measurement is checked against the humidity threshold. If a heater command is in progress, the readout starts once
+ * it completes.
+ *
+ * @param[in] ctrl Controller initialized by @ref sht3x_heater_ctrl_init.
+ * @param[in] flags Read measurement options, same as in @ref sht3x_read_periodic_measurement.
+ * @param[in] cb Callback to execute once complete. Can be NULL if not needed.
+ * @param[in] user_data User data to pass to @p cb.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Successfully initiated or queued the readout.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p ctrl is NULL, or @p flags is an invalid combination.
+ * @retval SHT3X_RESULT_CODE_BUSY A readout through this controller is already in progress.
+ * @retval SHT3X_RESULT_CODE_WRONG_MODE Device is known to be in single shot mode.
+ */
+uint8_t sht3x_heater_ctrl_read_periodic_measurement(SHT3XHeaterCtrl *const ctrl, uint8_t flags,
+                                                    SHT3XHeaterCtrlMeasCompleteCb cb, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_HEATER_H */
@@ -0,0 +1,193 @@
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_latency.h"
+
+/**
+ * @brief Get the histogram bucket of a value.
+ *
+ * @param[in] value_us Value in microseconds.
+ *
+ * @return size_t Bucket index: 0 for 0, otherwise the number of significant bits, capped at the last bucket.
+ */
+static size_t get_bucket(uint32_t value_us)
+{
+    size_t bucket = 0;
+    while ((value_us > 0) && (bucket < (SHT3X_LATENCY_NUM_BUCKETS - 1))) {
+        value_us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/**
+ * @brief Get the largest value counted by a bucket.
+ *
+ * @param[in] bucket Bucket index.
+ *
+ * @return uint32_t Largest value in microseconds. UINT32_MAX for the last bucket.
+ */
+static uint32_t get_bucket_upper_bound(size_t bucket)
+{
+    if (bucket >= (SHT3X_LATENCY_NUM_BUCKETS - 1)) {
+        return UINT32_MAX;
+    }
+    return (UINT32_C(1) << bucket) - 1;
+}
+
+static void reset_histogram(SHT3XLatencyHistogram *histogram)
+{
+    for (size_t i = 0; i < SHT3X_LATENCY_NUM_BUCKETS; i++) {
+        histogram->buckets[i] = 0;
+    }
+    histogram->count = 0;
+    histogram->sum_us = 0;
+}
+
+static uint32_t saturating_add(uint32_t a, uint32_t b)
+{
+    return ((UINT32_MAX - a) < b) ? UINT32_MAX : (a + b);
+}
+
+static uint64_t saturating_add_u64(uint64_t a, uint64_t b)
+{
+    return ((UINT64_MAX - a) < b) ? UINT64_MAX : (a + b);
+}
+
+uint8_t sht3x_latency_init(SHT3XLatencyMonitor *const monitor, SHT3XLatencyGetTimeUs get_time_us,
+                           void *get_time_us_user_data)
+{
+    if (!monitor || !get_time_us) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    monitor->get_time_us = get_time_us;
+    monitor->get_time_us_user_data = get_time_us_user_data;
+    for (size_t i = 0; i < SHT3X_SEQUENCE_TYPE_NO_SEQ; i++) {
+        reset_histogram(&(monitor->sequence[i]));
+    }
+    reset_histogram(&(monitor->i2c));
+    reset_histogram(&(monitor->timer_overshoot));
+    monitor->sequence_start_us = 0;
+    monitor->i2c_start_us = 0;
+    monitor->timer_start_us = 0;
+    monitor->timer_period_ms = 0;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+void sht3x_latency_hook(const SHT3XTraceEvent *event, void *user_data)
+{
+    SHT3XLatencyMonitor *monitor = (SHT3XLatencyMonitor *)user_data;
+    if (!monitor || !event) {
+        return;
+    }
+
+    uint32_t now = monitor->get_time_us(monitor->get_time_us_user_data);
+    switch (event->type) {
+    case SHT3X_TRACE_EVENT_SEQUENCE_START:
+        monitor->sequence_start_us = now;
+        break;
+    case SHT3X_TRACE_EVENT_SEQUENCE_END:
+        if (event->sequence_type < SHT3X_SEQUENCE_TYPE_NO_SEQ) {
+            sht3x_latency_record(&(monitor->sequence[event->sequence_type]), now - monitor->sequence_start_us);
+        }
+        break;
+    case SHT3X_TRACE_EVENT_I2C_WRITE_ISSUE:
+    case SHT3X_TRACE_EVENT_I2C_READ_ISSUE:
+        monitor->i2c_start_us = now;
+        break;
+    case SHT3X_TRACE_EVENT_I2C_WRITE_COMPLETE:
+    case SHT3X_TRACE_EVENT_I2C_READ_COMPLETE:
+        sht3x_latency_record(&(monitor->i2c), now - monitor->i2c_start_us);
+        break;
+    case SHT3X_TRACE_EVENT_TIMER_ARM:
+        monitor->timer_start_us = now;
+        monitor->timer_period_ms = event->arg;
+        break;
+    case SHT3X_TRACE_EVENT_TIMER_EXPIRE: {
+        uint32_t elapsed_us = now - monitor->timer_start_us;
+        uint64_t period_us = (uint64_t)monitor->timer_period_ms * 1000;
+        /* A timer that expired early counts as no overshoot */
+        uint32_t overshoot_us = (elapsed_us > period_us) ? (uint32_t)(elapsed_us - period_us) : 0;
+        sht3x_latency_record(&(monitor->timer_overshoot), overshoot_us);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+uint8_t sht3x_latency_get_histogram(const SHT3XLatencyMonitor *const monitor, uint8_t kind, uint8_t sequence_type,
+                                    const SHT3XLatencyHistogram **const histogram)
+{
+    if (!monitor || !histogram) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    switch (kind) {
+    case SHT3X_LATENCY_KIND_SEQUENCE:
+        if (sequence_type >= SHT3X_SEQUENCE_TYPE_NO_SEQ) {
+            return SHT3X_RESULT_CODE_INVALID_ARG;
+        }
+        *histogram = &(monitor->sequence[sequence_type]);
+        return SHT3X_RESULT_CODE_OK;
+    case SHT3X_LATENCY_KIND_I2C:
+        *histogram = &(monitor->i2c);
+        return SHT3X_RESULT_CODE_OK;
+    case SHT3X_LATENCY_KIND_TIMER_OVERSHOOT:
+        *histogram = &(monitor->timer_overshoot);
+        return SHT3X_RESULT_CODE_OK;
+    default:
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+}
+
+uint8_t sht3x_latency_record(SHT3XLatencyHistogram *const histogram, uint32_t value_us)
+{
+    if (!histogram) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    size_t bucket = get_bucket(value_us);
+    histogram->buckets[bucket] = saturating_add(histogram->buckets[bucket], 1);
+    histogram->count = saturating_add(histogram->count, 1);
+    histogram->sum_us = saturating_add_u64(histogram->sum_us, value_us);
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_latency_merge(SHT3XLatencyHistogram *const dst, const SHT3XLatencyHistogram *const src)
+{
+    if (!dst || !src) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    for (size_t i = 0; i < SHT3X_LATENCY_NUM_BUCKETS; i++) {
+        dst->buckets[i] = saturating_add(dst->buckets[i], src->buckets[i]);
+    }
+    dst->count = saturating_add(dst->count, src->count);
+    dst->sum_us = saturating_add_u64(dst->sum_us, src->sum_us);
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_latency_percentile(const SHT3XLatencyHistogram *const histogram, uint8_t percentile,
+                                 uint32_t *const upper_bound_us)
+{
+    if (!histogram || !upper_bound_us || (percentile < 1) || (percentile > 100)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (histogram->count == 0) {
+        return SHT3X_RESULT_CODE_NO_DATA;
+    }
+
+    /* Rank of the percentile value, rounded up, 1-based */
+    uint64_t rank = (((uint64_t)histogram->count * percentile) + 99) / 100;
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < SHT3X_LATENCY_NUM_BUCKETS; i++) {
+        cumulative += histogram->buckets[i];
+        if (cumulative >= rank) {
+            *upper_bound_us = get_bucket_upper_bound(i);
+            return SHT3X_RESULT_CODE_OK;
+        }
+    }
+    /* Bucket counts saturated below count, the percentile is in the last bucket */
+    *upper_bound_us = UINT32_MAX;
+    return SHT3X_RESULT_CODE_OK;
+}
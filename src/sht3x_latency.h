@@ -0,0 +1,166 @@
+#ifndef SRC_SHT3X_LATENCY_H
+#define SRC_SHT3X_LATENCY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Latency histograms of driver operations.
+ *
+ * A latency monitor measures, per instance:
+ * - Sequence latency, from the start of the sequence to its complete callback, one histogram per sequence type.
+ * - I2C transaction duration, from issuing a write or read to its completion.
+ * - Timer overshoot, how much later than requested a timer expired.
+ *
+ * To measure an instance, pass @ref sht3x_latency_hook as trace_hook and the monitor as trace_hook_user_data in the
+ * init config. The driver must be built with SHT3X_ENABLE_TRACE defined. The monitor reads time from the get_time_us
+ * function in its config.
+ *
+ * Histograms have @ref SHT3X_LATENCY_NUM_BUCKETS log2-scale buckets: bucket 0 counts 0 us, and bucket i counts values
+ * from 2^(i-1) us to 2^i - 1 us. The last bucket also counts all larger values. Each histogram also keeps the count
+ * and the sum of the recorded values. Recording a value takes constant time, and the histograms take fixed memory. @ref
+ * sht3x_latency_percentile gives an upper bound of a percentile, e.g. p99, with a factor of 2 resolution. Histograms of
+ * several instances can be combined with @ref sht3x_latency_merge.
+ */
+
+/** Number of buckets in a histogram. The last bucket counts all values from 2^22 us, about 4.2 s, on. */
+#define SHT3X_LATENCY_NUM_BUCKETS 24
+
+/**
+ * @brief Get current time in microseconds.
+ *
+ * The time can wrap around, as long as the measured durations are shorter than the wraparound period.
+ *
+ * @param user_data User data from the latency monitor config.
+ *
+ * @return uint32_t Current time in microseconds.
+ */
+typedef uint32_t (*SHT3XLatencyGetTimeUs)(void *user_data);
+
+/** Log2-scale histogram. */
+typedef struct {
+    uint32_t buckets[SHT3X_LATENCY_NUM_BUCKETS];
+    /** Total number of recorded values. */
+    uint32_t count;
+    /** Sum of the recorded values in microseconds. */
+    uint64_t sum_us;
+} SHT3XLatencyHistogram;
+
+/**
+ * @brief Latency monitor state.
+ *
+ * Provided by the caller, and must stay valid as long as the instance that it measures is used. The fields are private
+ * and should not be modified by the caller. Use @ref sht3x_latency_get_histogram to read out the histograms.
+ */
+typedef struct {
+    SHT3XLatencyGetTimeUs get_time_us;
+    void *get_time_us_user_data;
+    /** Indexed by SHT3XSequenceType. */
+    SHT3XLatencyHistogram sequence[SHT3X_SEQUENCE_TYPE_NO_SEQ];
+    SHT3XLatencyHistogram i2c;
+    SHT3XLatencyHistogram timer_overshoot;
+    /** Start times of the operations in progress. */
+    uint32_t sequence_start_us;
+    uint32_t i2c_start_us;
+    uint32_t timer_start_us;
+    /** Period of the running timer in ms. */
+    uint32_t timer_period_ms;
+} SHT3XLatencyMonitor;
+
+/** Histograms of a latency monitor. */
+typedef enum {
+    /** Sequence latency of one sequence type. */
+    SHT3X_LATENCY_KIND_SEQUENCE,
+    /** I2C write and read transaction duration. */
+    SHT3X_LATENCY_KIND_I2C,
+    /** Timer overshoot. */
+    SHT3X_LATENCY_KIND_TIMER_OVERSHOOT,
+} SHT3XLatencyKind;
+
+/**
+ * @brief Initialize a latency monitor with all histograms empty.
+ *
+ * @param[out] monitor Caller-provided memory for the monitor state.
+ * @param[in] get_time_us Time source.
+ * @param[in] get_time_us_user_data User data to pass to @p get_time_us.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p monitor or @p get_time_us is NULL.
+ */
+uint8_t sht3x_latency_init(SHT3XLatencyMonitor *const monitor, SHT3XLatencyGetTimeUs get_time_us,
+                           void *get_time_us_user_data);
+
+/**
+ * @brief Measure a trace event. Meant to be used as trace_hook in @ref SHT3XInitConfig.
+ *
+ * @param[in] event Trace event.
+ * @param[in] user_data Latency monitor initialized by @ref sht3x_latency_init.
+ */
+void sht3x_latency_hook(const SHT3XTraceEvent *event, void *user_data);
+
+/**
+ * @brief Get a histogram of a latency monitor.
+ *
+ * @param[in] monitor Latency monitor.
+ * @param[in] kind Use @ref SHT3XLatencyKind.
+ * @param[in] sequence_type Sequence type, one of SHT3XSequenceType except @ref SHT3X_SEQUENCE_TYPE_NO_SEQ. Only used
+ * if @p kind is @ref SHT3X_LATENCY_KIND_SEQUENCE.
+ * @param[out] histogram Pointer to the histogram is written here. Valid as long as @p monitor is.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p monitor or @p histogram is NULL, or @p kind or @p sequence_type is invalid.
+ */
+uint8_t sht3x_latency_get_histogram(const SHT3XLatencyMonitor *const monitor, uint8_t kind, uint8_t sequence_type,
+                                    const SHT3XLatencyHistogram **const histogram);
+
+/**
+ * @brief Record a value into a histogram.
+ *
+ * @param[in] histogram Histogram.
+ * @param[in] value_us Value in microseconds.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p histogram is NULL.
+ */
+uint8_t sht3x_latency_record(SHT3XLatencyHistogram *const histogram, uint32_t value_us);
+
+/**
+ * @brief Add all values of one histogram to another one, e.g. to combine histograms of several instances.
+ *
+ * Bucket counts saturate.
+ *
+ * @param[in,out] dst Histogram to add to.
+ * @param[in] src Histogram to add.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p dst or @p src is NULL.
+ */
+uint8_t sht3x_latency_merge(SHT3XLatencyHistogram *const dst, const SHT3XLatencyHistogram *const src);
+
+/**
+ * @brief Get an upper bound of a percentile of a histogram.
+ *
+ * @param[in] histogram Histogram.
+ * @param[in] percentile From 1 to 100, e.g. 99 for p99.
+ * @param[out] upper_bound_us Upper bound of the bucket that contains the percentile is written here, in microseconds.
+ * UINT32_MAX if the percentile is in the last bucket.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p histogram or @p upper_bound_us is NULL, or @p percentile is out of range.
+ * @retval SHT3X_RESULT_CODE_NO_DATA Histogram is empty.
+ */
+uint8_t sht3x_latency_percentile(const SHT3XLatencyHistogram *const histogram, uint8_t percentile,
+                                 uint32_t *const upper_bound_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_LATENCY_H */
@@ -0,0 +1,134 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_latest.h"
+
+static bool is_aligned(const void *region)
+{
+    return (((uintptr_t)region % sizeof(uint32_t)) == 0);
+}
+
+uint8_t sht3x_latest_publisher_init(SHT3XLatestPublisher *const publisher, void *region, size_t size,
+                                    uint32_t num_slots)
+{
+    if (!publisher || !region || !is_aligned(region) || (num_slots == 0)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if ((size < sizeof(SHT3XLatestHeader))
+        || (((size - sizeof(SHT3XLatestHeader)) / sizeof(SHT3XLatestSlot)) < num_slots)) {
+        return SHT3X_RESULT_CODE_OUT_OF_MEMORY;
+    }
+
+    publisher->header = (SHT3XLatestHeader *)region;
+    publisher->slots = (SHT3XLatestSlot *)(publisher->header + 1);
+    publisher->num_slots = num_slots;
+
+    volatile SHT3XLatestSlot *slots = publisher->slots;
+    for (uint32_t i = 0; i < num_slots; i++) {
+        slots[i].sequence = 0;
+        slots[i].timestamp = 0;
+        slots[i].raw_values = 0;
+        slots[i].flags = 0;
+    }
+    volatile SHT3XLatestHeader *header = publisher->header;
+    header->version = SHT3X_LATEST_VERSION;
+    header->num_slots = num_slots;
+    header->reserved = 0;
+    /* Readers check the magic value, so it is written last */
+    SHT3X_LATEST_BARRIER();
+    header->magic = SHT3X_LATEST_MAGIC;
+    SHT3X_LATEST_BARRIER();
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_latest_publish(SHT3XLatestPublisher *const publisher, uint32_t slot,
+                             const SHT3XLatestReading *const reading)
+{
+    if (!publisher || !reading || (slot >= publisher->num_slots)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    volatile SHT3XLatestSlot *s = &(publisher->slots[slot]);
+    uint32_t sequence = s->sequence;
+    /* Odd sequence tells readers that a write is in progress */
+    s->sequence = sequence + 1;
+    SHT3X_LATEST_BARRIER();
+    s->timestamp = reading->timestamp;
+    s->raw_values = ((uint32_t)reading->raw_temperature << 16) | reading->raw_humidity;
+    s->flags = reading->flags;
+    SHT3X_LATEST_BARRIER();
+    /* Skip 0 on wraparound, it means that nothing was published */
+    s->sequence = ((sequence + 2) == 0) ? 2 : (sequence + 2);
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_latest_reader_init(SHT3XLatestReader *const reader, const void *region, size_t size)
+{
+    if (!reader || !region || !is_aligned(region) || (size < sizeof(SHT3XLatestHeader))) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    const volatile SHT3XLatestHeader *header = (const SHT3XLatestHeader *)region;
+    if (header->magic != SHT3X_LATEST_MAGIC) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    SHT3X_LATEST_BARRIER();
+    uint32_t num_slots = header->num_slots;
+    if ((header->version != SHT3X_LATEST_VERSION) || (num_slots == 0)
+        || (((size - sizeof(SHT3XLatestHeader)) / sizeof(SHT3XLatestSlot)) < num_slots)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    reader->slots = (const SHT3XLatestSlot *)((const SHT3XLatestHeader *)region + 1);
+    reader->num_slots = num_slots;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_latest_get_num_slots(const SHT3XLatestReader *const reader, uint32_t *const num_slots)
+{
+    if (!reader || !num_slots) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    *num_slots = reader->num_slots;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_latest_read(const SHT3XLatestReader *const reader, uint32_t slot, SHT3XLatestReading *const reading,
+                          uint32_t *const sequence)
+{
+    if (!reader || !reading || (slot >= reader->num_slots)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    const volatile SHT3XLatestSlot *s = &(reader->slots[slot]);
+    for (uint8_t attempt = 0; attempt < SHT3X_LATEST_READ_ATTEMPTS; attempt++) {
+        uint32_t sequence_before = s->sequence;
+        if (sequence_before == 0) {
+            return SHT3X_RESULT_CODE_NO_DATA;
+        }
+        if ((sequence_before & 1) != 0) {
+            /* Write in progress */
+            continue;
+        }
+        SHT3X_LATEST_BARRIER();
+        uint32_t timestamp = s->timestamp;
+        uint32_t raw_values = s->raw_values;
+        uint32_t flags = s->flags;
+        SHT3X_LATEST_BARRIER();
+        if (s->sequence != sequence_before) {
+            /* Written during the copy, the values may be torn */
+            continue;
+        }
+
+        reading->timestamp = timestamp;
+        reading->raw_temperature = (uint16_t)(raw_values >> 16);
+        reading->raw_humidity = (uint16_t)raw_values;
+        reading->flags = (uint8_t)flags;
+        if (sequence) {
+            *sequence = sequence_before;
+        }
+        return SHT3X_RESULT_CODE_OK;
+    }
+    return SHT3X_RESULT_CODE_BUSY;
+}
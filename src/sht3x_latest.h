@@ -0,0 +1,181 @@
+#ifndef SRC_SHT3X_LATEST_H
+#define SRC_SHT3X_LATEST_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Latest readings in a shared memory region.
+ *
+ * A publisher writes the latest reading of every sensor into its own slot of a caller-provided region, e.g. a shared
+ * memory mapping. Any number of readers, e.g. other processes that map the same region, read the slots without locks
+ * and without asking the publisher.
+ *
+ * Each slot is protected by a seqlock: the publisher increments the slot sequence before and after writing the reading,
+ * so the sequence is odd while a write is in progress. A reader copies the reading, and retries if the sequence was odd
+ * or changed during the copy. Readers never block the publisher, and the publisher never waits for readers. Each slot
+ * must only be written by one publisher.
+ *
+ * The region starts with a header that holds a magic value, the layout version and the number of slots, followed by
+ * the slots. All fields are 32-bit words in native byte order, so the publisher and the readers must run on the same
+ * machine.
+ *
+ * Memory barriers are issued with SHT3X_LATEST_BARRIER. It defaults to a full barrier on GCC and Clang, and must be
+ * defined when building with other compilers.
+ */
+
+#ifndef SHT3X_LATEST_BARRIER
+#if defined(__GNUC__)
+#define SHT3X_LATEST_BARRIER() __sync_synchronize()
+#else
+#error "Define SHT3X_LATEST_BARRIER as a full memory barrier for this compiler"
+#endif
+#endif
+
+/** Magic value at the start of a region, "SHTL". */
+#define SHT3X_LATEST_MAGIC 0x5348544CUL
+
+/** Version of the region layout. */
+#define SHT3X_LATEST_VERSION 1
+
+/** Number of times a read is attempted before giving up on a slot that keeps being written. */
+#define SHT3X_LATEST_READ_ATTEMPTS 16
+
+/** Region header. */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_slots;
+    uint32_t reserved;
+} SHT3XLatestHeader;
+
+/** Slot of one sensor. */
+typedef struct {
+    /** Odd while a write is in progress, 0 if nothing was published yet. */
+    uint32_t sequence;
+    uint32_t timestamp;
+    /** Raw temperature ticks in the upper 16 bits, raw humidity ticks in the lower 16 bits. */
+    uint32_t raw_values;
+    uint32_t flags;
+} SHT3XLatestSlot;
+
+/** Size in bytes of a region with @p num_slots slots. */
+#define SHT3X_LATEST_REGION_SIZE(num_slots) (sizeof(SHT3XLatestHeader) + ((num_slots) * sizeof(SHT3XLatestSlot)))
+
+/** Latest reading of one sensor. */
+typedef struct {
+    /** Timestamp in any unit chosen by the publisher, e.g. ms. */
+    uint32_t timestamp;
+    uint16_t raw_temperature;
+    uint16_t raw_humidity;
+    /** Read flags that the measurement was read out with, see @ref SHT3XLazyMeasurement. */
+    uint8_t flags;
+} SHT3XLatestReading;
+
+/**
+ * @brief Latest readings publisher state.
+ *
+ * Provided by the caller. The fields are private and should not be modified by the caller.
+ */
+typedef struct {
+    SHT3XLatestHeader *header;
+    SHT3XLatestSlot *slots;
+    uint32_t num_slots;
+} SHT3XLatestPublisher;
+
+/**
+ * @brief Latest readings reader state.
+ *
+ * Provided by the caller. The fields are private and should not be modified by the caller.
+ */
+typedef struct {
+    const SHT3XLatestSlot *slots;
+    uint32_t num_slots;
+} SHT3XLatestReader;
+
+/**
+ * @brief Initialize a publisher, and write the region header and empty slots.
+ *
+ * Readers should only be initialized after this.
+ *
+ * @param[out] publisher Caller-provided memory for the publisher state.
+ * @param[in] region Region to publish to, aligned to 4 bytes. Must stay valid as long as the publisher is used.
+ * @param[in] size Size of @p region in bytes.
+ * @param[in] num_slots Number of slots, usually the number of sensors.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p publisher or @p region is NULL, @p region is not aligned, or @p num_slots is
+ * 0.
+ * @retval SHT3X_RESULT_CODE_OUT_OF_MEMORY @p size is smaller than @ref SHT3X_LATEST_REGION_SIZE of @p num_slots.
+ */
+uint8_t sht3x_latest_publisher_init(SHT3XLatestPublisher *const publisher, void *region, size_t size,
+                                    uint32_t num_slots);
+
+/**
+ * @brief Publish the latest reading of a sensor.
+ *
+ * @param[in] publisher Publisher.
+ * @param[in] slot Slot of the sensor.
+ * @param[in] reading Reading to publish.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p publisher or @p reading is NULL, or @p slot is out of range.
+ */
+uint8_t sht3x_latest_publish(SHT3XLatestPublisher *const publisher, uint32_t slot,
+                             const SHT3XLatestReading *const reading);
+
+/**
+ * @brief Initialize a reader.
+ *
+ * @param[out] reader Caller-provided memory for the reader state.
+ * @param[in] region Region that a publisher was initialized with. Must stay valid as long as the reader is used.
+ * @param[in] size Size of @p region in bytes.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p reader or @p region is NULL, @p region is not aligned, the header is
+ * invalid, or @p size is too small for the number of slots in the header.
+ */
+uint8_t sht3x_latest_reader_init(SHT3XLatestReader *const reader, const void *region, size_t size);
+
+/**
+ * @brief Get the number of slots in the region.
+ *
+ * @param[in] reader Reader.
+ * @param[out] num_slots Number of slots is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p reader or @p num_slots is NULL.
+ */
+uint8_t sht3x_latest_get_num_slots(const SHT3XLatestReader *const reader, uint32_t *const num_slots);
+
+/**
+ * @brief Read the latest reading of a sensor.
+ *
+ * @param[in] reader Reader.
+ * @param[in] slot Slot of the sensor.
+ * @param[out] reading Reading is written here.
+ * @param[out] sequence Optional, can be NULL. Slot sequence of the reading is written here. It changes with every
+ * publish, so readers that poll can skip readings that they already processed.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p reader or @p reading is NULL, or @p slot is out of range.
+ * @retval SHT3X_RESULT_CODE_NO_DATA Nothing was published to the slot yet.
+ * @retval SHT3X_RESULT_CODE_BUSY The slot was written during all @ref SHT3X_LATEST_READ_ATTEMPTS attempts. Try again
+ * later.
+ */
+uint8_t sht3x_latest_read(const SHT3XLatestReader *const reader, uint32_t slot, SHT3XLatestReading *const reading,
+                          uint32_t *const sequence);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_LATEST_H */
@@ -0,0 +1,341 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "sht3x_metrics.h"
+
+/* Enough for the decimal representation of UINT64_MAX */
+#define SHT3X_METRICS_MAX_DIGITS 20
+
+/* Header lines of a metric family: HELP and TYPE */
+#define SHT3X_METRICS_NUM_HEADER_LINES 2
+
+/** Metric families, in output order. */
+typedef enum {
+    SHT3X_METRICS_FAMILY_TRANSACTIONS,
+    SHT3X_METRICS_FAMILY_FAILED_TRANSACTIONS,
+    SHT3X_METRICS_FAMILY_BYTES_WRITTEN,
+    SHT3X_METRICS_FAMILY_BYTES_READ,
+    SHT3X_METRICS_FAMILY_TRANSACTION_TIME,
+    SHT3X_METRICS_FAMILY_AIRTIME,
+    SHT3X_METRICS_FAMILY_LATENCY,
+    SHT3X_METRICS_FAMILY_HEALTH,
+    SHT3X_METRICS_NUM_FAMILIES,
+} SHT3XMetricsFamily;
+
+typedef struct {
+    const char *name;
+    const char *type;
+    const char *help;
+} SHT3XMetricsFamilyInfo;
+
+/* Indexed by SHT3XMetricsFamily */
+static const SHT3XMetricsFamilyInfo families[] = {
+    [SHT3X_METRICS_FAMILY_TRANSACTIONS] = {"sht3x_i2c_transactions_total", "counter", "Completed I2C transactions."},
+    [SHT3X_METRICS_FAMILY_FAILED_TRANSACTIONS] = {"sht3x_i2c_failed_transactions_total", "counter",
+                                                  "I2C transactions that completed with an error."},
+    [SHT3X_METRICS_FAMILY_BYTES_WRITTEN] = {"sht3x_i2c_bytes_written_total", "counter", "Bytes written over I2C."},
+    [SHT3X_METRICS_FAMILY_BYTES_READ] = {"sht3x_i2c_bytes_read_total", "counter", "Bytes read over I2C."},
+    [SHT3X_METRICS_FAMILY_TRANSACTION_TIME] = {"sht3x_i2c_transaction_time_us_total", "counter",
+                                               "Measured I2C transaction time in microseconds."},
+    [SHT3X_METRICS_FAMILY_AIRTIME] = {"sht3x_i2c_airtime_us_total", "counter",
+                                      "Estimated I2C bus airtime in microseconds."},
+    [SHT3X_METRICS_FAMILY_LATENCY] = {"sht3x_latency_us", "histogram", "Latency in microseconds."},
+    [SHT3X_METRICS_FAMILY_HEALTH] = {"sht3x_health_event_active", "gauge", "1 if the health event is active."},
+};
+
+/* Indexed by SHT3XHealthEvent */
+static const char *const health_event_names[] = {
+    [SHT3X_HEALTH_EVENT_STUCK_VALUE] = "stuck_value",
+    [SHT3X_HEALTH_EVENT_CRC_ERROR_RATE] = "crc_error_rate",
+    [SHT3X_HEALTH_EVENT_NO_DATA] = "no_data",
+};
+
+#define SHT3X_METRICS_NUM_HEALTH_EVENTS (sizeof(health_event_names) / sizeof(health_event_names[0]))
+
+/* Indexed by SHT3XLatencyKind */
+static const char *const latency_kind_names[] = {
+    [SHT3X_LATENCY_KIND_SEQUENCE] = "sequence",
+    [SHT3X_LATENCY_KIND_I2C] = "i2c",
+    [SHT3X_LATENCY_KIND_TIMER_OVERSHOOT] = "timer_overshoot",
+};
+
+/* Lines of one histogram: buckets, including +Inf, the sum and the count */
+#define SHT3X_METRICS_HISTOGRAM_NUM_LINES (SHT3X_LATENCY_NUM_BUCKETS + 2)
+
+/* Histograms of a latency monitor: one per sequence type, I2C and timer overshoot */
+#define SHT3X_METRICS_NUM_LATENCY_HISTOGRAMS (SHT3X_SEQUENCE_TYPE_NO_SEQ + 2)
+
+/** Line buffer that a line is rendered into. */
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t pos;
+} SHT3XMetricsWriter;
+
+static void write_str(SHT3XMetricsWriter *writer, const char *str)
+{
+    for (; *str && (writer->pos < writer->size); str++) {
+        writer->buf[writer->pos++] = *str;
+    }
+}
+
+static void write_uint(SHT3XMetricsWriter *writer, uint64_t val)
+{
+    char digits[SHT3X_METRICS_MAX_DIGITS + 1];
+    size_t idx = SHT3X_METRICS_MAX_DIGITS;
+    digits[idx] = '\0';
+    do {
+        digits[--idx] = (char)('0' + (val % 10));
+        val /= 10;
+    } while (val > 0);
+    write_str(writer, &digits[idx]);
+}
+
+/** Write the metric name with an optional suffix, and open the label set with the sensor label. */
+static void write_sample_start(SHT3XMetricsWriter *writer, const char *name, const char *suffix, uint32_t sensor_id)
+{
+    write_str(writer, name);
+    write_str(writer, suffix);
+    write_str(writer, "{sensor=\"");
+    write_uint(writer, sensor_id);
+    write_str(writer, "\"");
+}
+
+/** Close the label set, and write the value and the end of the line. */
+static void write_sample_end(SHT3XMetricsWriter *writer, uint64_t val)
+{
+    write_str(writer, "} ");
+    write_uint(writer, val);
+    write_str(writer, "\n");
+}
+
+static void write_header_line(SHT3XMetricsWriter *writer, SHT3XMetricsFamily family, size_t item)
+{
+    const SHT3XMetricsFamilyInfo *info = &families[family];
+    write_str(writer, (item == 0) ? "# HELP " : "# TYPE ");
+    write_str(writer, info->name);
+    write_str(writer, " ");
+    write_str(writer, (item == 0) ? info->help : info->type);
+    write_str(writer, "\n");
+}
+
+static uint64_t get_counter(const SHT3XBusCounters *counters, SHT3XMetricsFamily family)
+{
+    switch (family) {
+    case SHT3X_METRICS_FAMILY_TRANSACTIONS:
+        return counters->transactions;
+    case SHT3X_METRICS_FAMILY_FAILED_TRANSACTIONS:
+        return counters->failed_transactions;
+    case SHT3X_METRICS_FAMILY_BYTES_WRITTEN:
+        return counters->bytes_written;
+    case SHT3X_METRICS_FAMILY_BYTES_READ:
+        return counters->bytes_read;
+    case SHT3X_METRICS_FAMILY_TRANSACTION_TIME:
+        return counters->transaction_time_us;
+    case SHT3X_METRICS_FAMILY_AIRTIME:
+        return counters->airtime_us;
+    default:
+        return 0;
+    }
+}
+
+/** Write the kind label, and the sequence label for sequence histograms. */
+static void write_latency_labels(SHT3XMetricsWriter *writer, uint8_t kind, uint8_t sequence_type)
+{
+    write_str(writer, ",kind=\"");
+    write_str(writer, latency_kind_names[kind]);
+    write_str(writer, "\"");
+    if (kind == SHT3X_LATENCY_KIND_SEQUENCE) {
+        write_str(writer, ",sequence=\"");
+        write_str(writer, sht3x_trace_get_sequence_name(sequence_type));
+        write_str(writer, "\"");
+    }
+}
+
+/**
+ * @brief Render one line of the histograms of a latency monitor.
+ *
+ * The histograms of all sequence types come first, in SHT3XSequenceType order, followed by the I2C and timer overshoot
+ * histograms. Within a histogram, lines 0 to SHT3X_LATENCY_NUM_BUCKETS - 2 are the buckets with a finite upper bound,
+ * line SHT3X_LATENCY_NUM_BUCKETS - 1 is the +Inf bucket and line SHT3X_LATENCY_NUM_BUCKETS is the count.
+ *
+ * @retval true The line was rendered.
+ * @retval false @p item is past the last line.
+ */
+static bool write_latency_line(SHT3XMetricsWriter *writer, const char *name, uint32_t sensor_id,
+                               const SHT3XLatencyMonitor *monitor, size_t item)
+{
+    size_t histogram_idx = item / SHT3X_METRICS_HISTOGRAM_NUM_LINES;
+    size_t line = item % SHT3X_METRICS_HISTOGRAM_NUM_LINES;
+    if (histogram_idx >= SHT3X_METRICS_NUM_LATENCY_HISTOGRAMS) {
+        return false;
+    }
+    uint8_t kind = SHT3X_LATENCY_KIND_SEQUENCE;
+    uint8_t sequence_type = 0;
+    if (histogram_idx < SHT3X_SEQUENCE_TYPE_NO_SEQ) {
+        sequence_type = (uint8_t)histogram_idx;
+    } else if (histogram_idx == SHT3X_SEQUENCE_TYPE_NO_SEQ) {
+        kind = SHT3X_LATENCY_KIND_I2C;
+    } else {
+        kind = SHT3X_LATENCY_KIND_TIMER_OVERSHOOT;
+    }
+    const SHT3XLatencyHistogram *histogram;
+    if (sht3x_latency_get_histogram(monitor, kind, sequence_type, &histogram) != SHT3X_RESULT_CODE_OK) {
+        return false;
+    }
+
+    if (line == SHT3X_LATENCY_NUM_BUCKETS) {
+        write_sample_start(writer, name, "_sum", sensor_id);
+        write_latency_labels(writer, kind, sequence_type);
+        write_sample_end(writer, histogram->sum_us);
+        return true;
+    }
+    if (line == (SHT3X_LATENCY_NUM_BUCKETS + 1)) {
+        write_sample_start(writer, name, "_count", sensor_id);
+        write_latency_labels(writer, kind, sequence_type);
+        write_sample_end(writer, histogram->count);
+        return true;
+    }
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i <= line; i++) {
+        cumulative += histogram->buckets[i];
+    }
+    write_sample_start(writer, name, "_bucket", sensor_id);
+    write_latency_labels(writer, kind, sequence_type);
+    write_str(writer, ",le=\"");
+    if (line == (SHT3X_LATENCY_NUM_BUCKETS - 1)) {
+        write_str(writer, "+Inf");
+    } else {
+        write_uint(writer, (UINT32_C(1) << line) - 1);
+    }
+    write_str(writer, "\"");
+    write_sample_end(writer, cumulative);
+    return true;
+}
+
+/**
+ * @brief Render one line of an instance.
+ *
+ * @param[in] writer Line buffer.
+ * @param[in] family Metric family.
+ * @param[in] instance Instance.
+ * @param[in] item Index of the line within the instance.
+ *
+ * @retval true The line was rendered.
+ * @retval false @p item is past the last line of the instance, or the instance does not provide the family.
+ */
+static bool write_instance_line(SHT3XMetricsWriter *writer, SHT3XMetricsFamily family,
+                                const SHT3XMetricsInstance *instance, size_t item)
+{
+    const char *name = families[family].name;
+    switch (family) {
+    case SHT3X_METRICS_FAMILY_LATENCY:
+        if (!instance->latency) {
+            return false;
+        }
+        return write_latency_line(writer, name, instance->sensor_id, instance->latency, item);
+    case SHT3X_METRICS_FAMILY_HEALTH:
+        if (item >= SHT3X_METRICS_NUM_HEALTH_EVENTS) {
+            return false;
+        }
+        write_sample_start(writer, name, "", instance->sensor_id);
+        write_str(writer, ",event=\"");
+        write_str(writer, health_event_names[item]);
+        write_str(writer, "\"");
+        write_sample_end(writer, (instance->health_events >> item) & 1);
+        return true;
+    default:
+        if (!instance->bus_counters || (item > 0)) {
+            return false;
+        }
+        write_sample_start(writer, name, "", instance->sensor_id);
+        write_sample_end(writer, get_counter(instance->bus_counters, family));
+        return true;
+    }
+}
+
+/**
+ * @brief Render the next line into the line buffer, and advance the position.
+ *
+ * @param[in] formatter Metrics formatter.
+ *
+ * @retval true A line was rendered.
+ * @retval false The exposition is complete.
+ */
+static bool render_next_line(SHT3XMetricsFormatter *formatter)
+{
+    SHT3XMetricsWriter writer = {.buf = formatter->line, .size = sizeof(formatter->line), .pos = 0};
+    while (formatter->family < SHT3X_METRICS_NUM_FAMILIES) {
+        SHT3XMetricsFamily family = (SHT3XMetricsFamily)formatter->family;
+        if (!formatter->header_done) {
+            write_header_line(&writer, family, formatter->item);
+            formatter->item++;
+            if (formatter->item == SHT3X_METRICS_NUM_HEADER_LINES) {
+                formatter->header_done = true;
+                formatter->item = 0;
+            }
+            break;
+        }
+        if (formatter->instance >= formatter->num_instances) {
+            formatter->family++;
+            formatter->instance = 0;
+            formatter->item = 0;
+            formatter->header_done = false;
+            continue;
+        }
+        if (write_instance_line(&writer, family, &formatter->instances[formatter->instance], formatter->item)) {
+            formatter->item++;
+            break;
+        }
+        formatter->instance++;
+        formatter->item = 0;
+    }
+    formatter->line_length = writer.pos;
+    formatter->line_pos = 0;
+    return (writer.pos > 0);
+}
+
+uint8_t sht3x_metrics_init(SHT3XMetricsFormatter *const formatter, const SHT3XMetricsInstance *const instances,
+                           size_t num_instances)
+{
+    if (!formatter || (!instances && (num_instances > 0))) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    formatter->instances = instances;
+    formatter->num_instances = num_instances;
+    formatter->family = 0;
+    formatter->instance = 0;
+    formatter->item = 0;
+    formatter->header_done = false;
+    formatter->line_length = 0;
+    formatter->line_pos = 0;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_metrics_format(SHT3XMetricsFormatter *const formatter, char *const buf, size_t size,
+                             size_t *const length)
+{
+    if (!formatter || !buf || !length || (size == 0)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    size_t pos = 0;
+    while (pos < size) {
+        if ((formatter->line_pos >= formatter->line_length) && !render_next_line(formatter)) {
+            break;
+        }
+        size_t num_bytes = formatter->line_length - formatter->line_pos;
+        if (num_bytes > (size - pos)) {
+            num_bytes = size - pos;
+        }
+        memcpy(&buf[pos], &formatter->line[formatter->line_pos], num_bytes);
+        formatter->line_pos += num_bytes;
+        pos += num_bytes;
+    }
+    *length = pos;
+    return SHT3X_RESULT_CODE_OK;
+}
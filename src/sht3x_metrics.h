@@ -0,0 +1,111 @@
+#ifndef SRC_SHT3X_METRICS_H
+#define SRC_SHT3X_METRICS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x.h"
+#include "sht3x_bus.h"
+#include "sht3x_latency.h"
+#include "sht3x_trace.h"
+
+/**
+ * @brief Metrics exposition in the Prometheus text format.
+ *
+ * A metrics formatter renders the counters, latency histograms and health state of a list of instances into a
+ * caller-provided buffer, without heap allocation and without printf. Each instance is identified by a sensor ID, which
+ * is written as the sensor label.
+ *
+ * The output is produced in chunks: every call to @ref sht3x_metrics_format fills the buffer as far as possible and
+ * continues where the previous call stopped, even in the middle of a line. This way, the exposition of a large fleet
+ * can be streamed out through a small buffer, e.g. one network packet at a time. Concatenating all chunks gives the
+ * complete exposition.
+ *
+ * The following metric families are written, each with HELP and TYPE lines, for every instance that provides them:
+ * - Counters from @ref SHT3XBusCounters: sht3x_i2c_transactions_total, sht3x_i2c_failed_transactions_total,
+ *   sht3x_i2c_bytes_written_total, sht3x_i2c_bytes_read_total, sht3x_i2c_transaction_time_us_total and
+ *   sht3x_i2c_airtime_us_total.
+ * - The histogram sht3x_latency_us for every histogram of a @ref SHT3XLatencyMonitor, with the bucket upper bounds as
+ *   le labels, a sum in microseconds and a count. The kind label is "sequence", "i2c" or "timer_overshoot", see @ref
+ *   SHT3XLatencyKind. Sequence histograms also have a sequence label with the name from @ref
+ *   sht3x_trace_get_sequence_name.
+ * - The gauge sht3x_health_event_active, one sample per @ref SHT3XHealthEvent with an event label, 1 if the event is
+ *   active and 0 otherwise.
+ *
+ * Values are read when their line is rendered, so the instance data must stay valid until the exposition is complete.
+ */
+
+/** Size in bytes of the line buffer in the formatter. Fits the longest line. */
+#define SHT3X_METRICS_MAX_LINE_SIZE 128
+
+/** Metrics of one instance. */
+typedef struct {
+    /** Written as the sensor label. */
+    uint32_t sensor_id;
+    /** Bus counters, e.g. from @ref sht3x_bus_member_get_counters. Can be NULL. */
+    const SHT3XBusCounters *bus_counters;
+    /** Latency monitor of the instance, all of its histograms are written. Can be NULL. */
+    const SHT3XLatencyMonitor *latency;
+    /** Active health events, bit (1 << event) for each active @ref SHT3XHealthEvent. Usually set from the health
+     * event callback, and cleared by the caller once the problem is resolved. */
+    uint8_t health_events;
+} SHT3XMetricsInstance;
+
+/**
+ * @brief Metrics formatter state.
+ *
+ * Provided by the caller. The fields are private and should not be modified by the caller.
+ */
+typedef struct {
+    const SHT3XMetricsInstance *instances;
+    size_t num_instances;
+    /** Position of the next line: metric family, instance, and line within the instance or header. */
+    size_t family;
+    size_t instance;
+    size_t item;
+    bool header_done;
+    /** Rendered line that is being copied out. */
+    char line[SHT3X_METRICS_MAX_LINE_SIZE];
+    size_t line_length;
+    size_t line_pos;
+} SHT3XMetricsFormatter;
+
+/**
+ * @brief Initialize a metrics formatter at the start of an exposition.
+ *
+ * @param[out] formatter Caller-provided memory for the formatter state.
+ * @param[in] instances Instances to write metrics of. Must stay valid until the exposition is complete.
+ * @param[in] num_instances Number of instances in @p instances.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p formatter is NULL, or @p instances is NULL and @p num_instances is not 0.
+ */
+uint8_t sht3x_metrics_init(SHT3XMetricsFormatter *const formatter, const SHT3XMetricsInstance *const instances,
+                           size_t num_instances);
+
+/**
+ * @brief Write the next chunk of the exposition.
+ *
+ * @param[in] formatter Metrics formatter.
+ * @param[out] buf Buffer that the chunk is written to. Not null-terminated.
+ * @param[in] size Size of @p buf in bytes.
+ * @param[out] length Number of bytes written to @p buf is written here. Only less than @p size if the exposition is
+ * complete, and 0 once there is nothing left to write.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG One of the pointers is NULL, or @p size is 0.
+ */
+uint8_t sht3x_metrics_format(SHT3XMetricsFormatter *const formatter, char *const buf, size_t size,
+                             size_t *const length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_METRICS_H */
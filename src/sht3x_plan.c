@@ -0,0 +1,131 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_plan.h"
+#include "sht3x_bus.h"
+
+/* Microseconds per ms */
+#define SHT3X_PLAN_US_PER_MS 1000
+#define SHT3X_PLAN_US_PER_S 1000000
+
+/* MPS period in ms, from the datasheet. Indexed by SHT3XMps. */
+static const uint32_t mps_periods_ms[] = {
+    [SHT3X_MPS_0_5] = 2000, [SHT3X_MPS_1] = 1000, [SHT3X_MPS_2] = 500, [SHT3X_MPS_4] = 250, [SHT3X_MPS_10] = 100,
+};
+
+/** Transactions and delays of one sample. */
+typedef struct {
+    size_t write_len;
+    uint32_t delay_ms;
+    size_t read_len;
+    /** Time that the sensor holds the bus during the readout. */
+    uint32_t stretch_ms;
+    /** Time between two measurements of a sensor in periodic mode, 0 in single shot mode. */
+    uint32_t period_ms;
+} SHT3XPlanSampleTiming;
+
+static uint32_t clamp_u32(uint64_t val)
+{
+    return (val > UINT32_MAX) ? UINT32_MAX : (uint32_t)val;
+}
+
+static uint64_t max_u64(uint64_t a, uint64_t b)
+{
+    return (a > b) ? a : b;
+}
+
+/**
+ * @brief Get the transactions and delays of one sample from the driver.
+ *
+ * @param[in] cfg Plan options.
+ * @param[out] timing Transactions and delays are written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG One of the options is invalid.
+ */
+static uint8_t get_sample_timing(const SHT3XPlanConfig *cfg, SHT3XPlanSampleTiming *timing)
+{
+    SHT3XPreparedMeas prepared;
+    uint8_t rc;
+    if (cfg->meas_mode == SHT3X_MEAS_MODE_SINGLE_SHOT) {
+        rc = sht3x_prepare_single_shot_measurement(cfg->repeatability, cfg->clock_stretching, cfg->flags, &prepared);
+        if (rc != SHT3X_RESULT_CODE_OK) {
+            return rc;
+        }
+        timing->period_ms = 0;
+        timing->stretch_ms = 0;
+        if (cfg->clock_stretching == SHT3X_CLOCK_STRETCHING_ENABLED) {
+            /* Without clock stretching, the driver waits for the maximum measurement duration instead */
+            SHT3XPreparedMeas no_stretch;
+            rc = sht3x_prepare_single_shot_measurement(cfg->repeatability, SHT3X_CLOCK_STRETCHING_DISABLED,
+                                                       cfg->flags, &no_stretch);
+            if (rc != SHT3X_RESULT_CODE_OK) {
+                return rc;
+            }
+            if (no_stretch.timer_period > prepared.timer_period) {
+                timing->stretch_ms = no_stretch.timer_period - prepared.timer_period;
+            }
+        }
+    } else if (cfg->meas_mode == SHT3X_MEAS_MODE_PERIODIC) {
+        if (!sht3x_is_valid_periodic_cfg(cfg->meas_mode, cfg->repeatability, cfg->mps)) {
+            return SHT3X_RESULT_CODE_INVALID_ARG;
+        }
+        rc = sht3x_prepare_periodic_measurement(cfg->flags, &prepared);
+        if (rc != SHT3X_RESULT_CODE_OK) {
+            return rc;
+        }
+        timing->period_ms = mps_periods_ms[cfg->mps];
+        timing->stretch_ms = 0;
+    } else {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    timing->write_len = sizeof(prepared.cmd);
+    timing->delay_ms = prepared.timer_period;
+    timing->read_len = prepared.read_len;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_plan(const SHT3XPlanConfig *const cfg, SHT3XPlan *const plan)
+{
+    if (!cfg || !plan || (cfg->bus_speed_hz == 0) || (cfg->num_sensors == 0)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    SHT3XPlanSampleTiming timing;
+    uint8_t rc = get_sample_timing(cfg, &timing);
+    if (rc != SHT3X_RESULT_CODE_OK) {
+        return rc;
+    }
+
+    uint64_t write_airtime_us;
+    uint64_t read_airtime_us;
+    sht3x_bus_estimate_airtime(timing.write_len, cfg->bus_speed_hz, &write_airtime_us);
+    sht3x_bus_estimate_airtime(timing.read_len, cfg->bus_speed_hz, &read_airtime_us);
+    uint64_t stretch_us = (uint64_t)timing.stretch_ms * SHT3X_PLAN_US_PER_MS;
+
+    uint64_t bus_time_us = write_airtime_us + stretch_us + read_airtime_us;
+    uint64_t sample_duration_us = bus_time_us + ((uint64_t)timing.delay_ms * SHT3X_PLAN_US_PER_MS);
+    uint64_t period_us = (uint64_t)timing.period_ms * SHT3X_PLAN_US_PER_MS;
+    uint64_t cmd_gap_us = SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS * SHT3X_PLAN_US_PER_MS;
+    uint64_t min_interval_us = max_u64(sample_duration_us + cmd_gap_us, period_us);
+
+    uint64_t requested_us = (uint64_t)cfg->sample_interval_ms * SHT3X_PLAN_US_PER_MS;
+    /* The bus can only carry one sample at a time, so each sensor waits for the samples of all others */
+    uint64_t bus_interval_us = bus_time_us * cfg->num_sensors;
+    uint64_t interval_us = max_u64(max_u64(requested_us, min_interval_us), bus_interval_us);
+
+    plan->sample_duration_us = clamp_u32(sample_duration_us);
+    plan->bus_time_per_sample_us = clamp_u32(bus_time_us);
+    plan->min_sample_interval_us = clamp_u32(min_interval_us);
+    plan->sample_interval_us = clamp_u32(interval_us);
+    plan->samples_per_s = ((float)cfg->num_sensors * SHT3X_PLAN_US_PER_S) / (float)interval_us;
+    plan->occupancy_permille = (uint16_t)((bus_interval_us * 1000) / interval_us);
+    /* The latest sample was measured at most one MPS period before its fetch, or after the single shot command. It
+     * stays the latest until the next sample of the sensor completes. */
+    plan->worst_case_sample_age_us = clamp_u32(period_us + sample_duration_us + interval_us);
+    plan->meets_interval = ((requested_us == 0) || (requested_us >= min_interval_us))
+                           && (max_u64(requested_us, min_interval_us) >= bus_interval_us);
+    return SHT3X_RESULT_CODE_OK;
+}
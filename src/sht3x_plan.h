@@ -0,0 +1,92 @@
+#ifndef SRC_SHT3X_PLAN_H
+#define SRC_SHT3X_PLAN_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Capacity planning of sensors on one I2C bus.
+ *
+ * Predicts achievable sample rate, bus occupancy and worst-case sample age for a number of sensors that share a bus and
+ * are read out the same way. The predictions follow the driver's own timing: the delays and readout lengths come from
+ * @ref sht3x_prepare_single_shot_measurement and @ref sht3x_prepare_periodic_measurement, and airtime comes from @ref
+ * sht3x_bus_estimate_airtime, so they stay in line with the driver.
+ *
+ * One sample takes:
+ * - Single shot: a command write, a delay, and a readout. With clock stretching, the delay is @ref
+ *   SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS, and the sensor holds the bus during the readout until the measurement
+ *   completes, which is assumed to take the maximum measurement duration. The next command to the same sensor follows
+ *   after @ref SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS.
+ * - Periodic: a fetch command write, a delay of @ref SHT3X_MIN_DELAY_BETWEEN_TWO_I2C_CMDS_MS, and a readout. A sensor
+ *   has new data once per MPS period, so it is not read out more often than that.
+ *
+ * Other bus traffic, software overhead and timer jitter are not included, so the predictions are lower bounds for
+ * times and upper bounds for rates.
+ */
+
+/** Plan options. */
+typedef struct {
+    /** Bus clock speed in Hz, e.g. 100000 or 400000. */
+    uint32_t bus_speed_hz;
+    /** Number of sensors on the bus. */
+    uint16_t num_sensors;
+    /** @ref SHT3X_MEAS_MODE_SINGLE_SHOT or @ref SHT3X_MEAS_MODE_PERIODIC. */
+    uint8_t meas_mode;
+    /** One of @ref SHT3XMeasRepeatability. Does not change the timing in periodic mode, but must still be valid. */
+    uint8_t repeatability;
+    /** One of @ref SHT3XClockStretching. Only used in single shot mode. */
+    uint8_t clock_stretching;
+    /** One of @ref SHT3XMps. Only used in periodic mode. */
+    uint8_t mps;
+    /** Read flags, see @ref sht3x_read_measurement. */
+    uint8_t flags;
+    /** Requested interval between two samples of the same sensor in ms. 0 to sample as fast as possible. */
+    uint32_t sample_interval_ms;
+} SHT3XPlanConfig;
+
+/** Predictions of a plan. */
+typedef struct {
+    /** Time from issuing the first command of a sample to its readout completing. */
+    uint32_t sample_duration_us;
+    /** Time that one sample occupies the bus. */
+    uint32_t bus_time_per_sample_us;
+    /** Shortest interval between two samples of the same sensor that the sensor allows. */
+    uint32_t min_sample_interval_us;
+    /** Interval between two samples of the same sensor that is achieved, limited by the requested interval, the sensor
+     * and the bus. */
+    uint32_t sample_interval_us;
+    /** Samples per second of all sensors together. */
+    float samples_per_s;
+    /** Bus occupancy in permille. */
+    uint16_t occupancy_permille;
+    /** Upper bound of the age of the latest sample of a sensor, from when it was measured. */
+    uint32_t worst_case_sample_age_us;
+    /** true if every sensor is sampled at the requested interval, or if no interval was requested and the bus is not
+     * the limit. */
+    bool meets_interval;
+} SHT3XPlan;
+
+/**
+ * @brief Compute the predictions of a plan.
+ *
+ * @param[in] cfg Plan options.
+ * @param[out] plan Predictions are written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p cfg or @p plan is NULL, or one of the options is invalid.
+ */
+uint8_t sht3x_plan(const SHT3XPlanConfig *const cfg, SHT3XPlan *const plan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_PLAN_H */
@@ -7,6 +7,7 @@ extern "C"
 #endif
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "sht3x_defs.h"
 
@@ -35,8 +36,12 @@ struct SHT3XStruct {
     void *sequence_cb_user_data;
     uint8_t i2c_read_buf[SHT3X_I2C_READ_BUF_SIZE];
     uint8_t i2c_addr;
-    /** Sequence type of the current sequence. One of @ref SHT3xSequenceType. */
+    /** Sequence type of the current sequence. One of @ref SHT3XSequenceType. */
     uint8_t sequence_type;
+    /** Index of the currently executed step in the step table of the current sequence. */
+    uint8_t sequence_step;
+    /** Command to send in WRITE steps that take the command from the sequence. */
+    uint8_t sequence_cmd[2];
     /** Flags for the current sequence. */
     uint8_t sequence_flags;
     /** Number of bytes to read out in the I2C read operation in the current sequence. */
@@ -44,9 +49,57 @@ struct SHT3XStruct {
     /**
      * @brief Timer period for measurement sequence.
      *
-     * The second step of a measurement sequence is a timer delay. This variable defines the period of that delay.
+     * The second step of a measurement sequence is a timer delay. This variable defines the period of that delay. In
+     * the init sequence, holds the time to first sample that is reported once the sequence completes.
      */
     uint32_t sequence_timer_period;
+    /** Callback type of sequence_cb in a measurement sequence. One of @ref SHT3xMeasResultType. */
+    uint8_t sequence_meas_result_type;
+    /** Effect of the command sent in the current sequence on the tracked device state. One of @ref
+     * SHT3xShadowUpdate. */
+    uint8_t sequence_shadow_update;
+    /** Tracked heater state. One of @ref SHT3XHeaterState. */
+    uint8_t heater_state;
+    /** Tracked measurement mode. One of @ref SHT3XMeasMode. */
+    uint8_t meas_mode;
+    /** Repeatability of the running periodic measurement. Only meaningful if meas_mode is
+     * SHT3X_MEAS_MODE_PERIODIC. */
+    uint8_t periodic_repeatability;
+    /** MPS of the running periodic measurement. Only meaningful if meas_mode is SHT3X_MEAS_MODE_PERIODIC. */
+    uint8_t periodic_mps;
+    /** Repeatability of the last single shot measurement command. SHT3X_QUALITY_REPEATABILITY_UNKNOWN if none was
+     * sent. */
+    uint8_t single_shot_repeatability;
+    /** Last known status register value. Only meaningful if status_reg_valid is true. */
+    uint16_t status_reg;
+    /** true if status_reg reflects the status register of the device, false otherwise. */
+    bool status_reg_valid;
+    /** Number of consecutive failed measurement readouts, reported as retry count in the quality word. Saturates at
+     * SHT3X_QUALITY_MAX_RETRY_COUNT. */
+    uint8_t meas_failure_count;
+    /** Health monitor callback. Health monitor is disabled if NULL. */
+    SHT3XHealthEventCb health_cb;
+    void *health_cb_user_data;
+    /** Health monitor thresholds, see @ref SHT3XHealthConfig. */
+    uint16_t health_stuck_threshold;
+    uint16_t health_crc_error_threshold;
+    uint16_t health_crc_window;
+    uint16_t health_no_data_threshold;
+    /** Raw values and read flags of the last successful measurement readout. */
+    uint16_t health_last_raw_temperature;
+    uint16_t health_last_raw_humidity;
+    uint8_t health_last_flags;
+    /** Number of consecutive successful readouts with identical raw values. */
+    uint16_t health_identical_count;
+    /** Outcomes of the last health_crc_window readouts, bit 0 is the most recent one. A set bit is a CRC mismatch. */
+    uint32_t health_crc_history;
+    /** Number of set bits in health_crc_history. */
+    uint16_t health_window_crc_errors;
+    /** Number of consecutive readouts that returned no data. */
+    uint16_t health_no_data_count;
+    /** Executed at every tracepoint if the driver is built with SHT3X_ENABLE_TRACE. Can be NULL. */
+    SHT3XTraceHook trace_hook;
+    void *trace_hook_user_data;
 };
 
 #ifdef __cplusplus
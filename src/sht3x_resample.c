@@ -0,0 +1,210 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_resample.h"
+
+static bool is_valid_cfg(const SHT3XResampleConfig *const cfg)
+{
+    // clang-format off
+    return (
+        (cfg)
+        && (cfg->num_sensors > 0)
+        && (cfg->num_rows > 0)
+        && ((cfg->method == SHT3X_RESAMPLE_METHOD_HOLD) || (cfg->method == SHT3X_RESAMPLE_METHOD_LINEAR))
+        && (cfg->period > 0)
+        && (cfg->sensors)
+        && (cfg->raw_temperature)
+        && (cfg->raw_humidity)
+        && (cfg->status)
+    );
+    // clang-format on
+}
+
+static uint64_t get_row_time(const SHT3XResampleConfig *cfg, uint32_t row)
+{
+    return (uint64_t)cfg->start_time + ((uint64_t)row * cfg->period);
+}
+
+/** Offset of the first value of a row in the ring columns. */
+static size_t get_row_offset(const SHT3XResampleConfig *cfg, uint32_t row)
+{
+    return (size_t)(row % cfg->num_rows) * cfg->num_sensors;
+}
+
+static uint8_t map_flags_to_status(uint8_t flags)
+{
+    uint8_t status = 0;
+    if (flags & SHT3X_FLAG_READ_TEMP) {
+        status |= SHT3X_RESAMPLE_STATUS_TEMP;
+    }
+    if (flags & SHT3X_FLAG_READ_HUM) {
+        status |= SHT3X_RESAMPLE_STATUS_HUM;
+    }
+    return status;
+}
+
+/** Whether the latest sample of a sensor is recent enough to derive a value at a row time after it. */
+static bool is_fresh(const SHT3XResampleConfig *cfg, const SHT3XResampleSensor *sensor, uint64_t row_time)
+{
+    return sensor->has_sample && ((cfg->max_age == 0) || ((row_time - sensor->timestamp) <= cfg->max_age));
+}
+
+/** Interpolate between (t0, v0) and (t1, v1) at t, rounded to the nearest tick. t0 < t < t1. */
+static uint16_t interpolate(uint64_t t0, uint16_t v0, uint64_t t1, uint16_t v1, uint64_t t)
+{
+    int64_t dt = (int64_t)(t1 - t0);
+    int64_t num = ((int64_t)v1 - (int64_t)v0) * (int64_t)(t - t0);
+    int64_t delta = (num >= 0) ? ((num + (dt / 2)) / dt) : ((num - (dt / 2)) / dt);
+    return (uint16_t)((int64_t)v0 + delta);
+}
+
+/**
+ * @brief Fill the value of a sensor in a row by holding its latest sample.
+ *
+ * @param[in] cfg Resampler config.
+ * @param[in] sensor Sensor index.
+ * @param[in] row Row index. The row time is after the latest sample of the sensor.
+ */
+static void fill_hold(const SHT3XResampleConfig *cfg, uint16_t sensor, uint32_t row)
+{
+    const SHT3XResampleSensor *state = &cfg->sensors[sensor];
+    size_t idx = get_row_offset(cfg, row) + sensor;
+    bool fresh = is_fresh(cfg, state, get_row_time(cfg, row));
+    cfg->raw_temperature[idx] = fresh ? state->raw_temperature : 0;
+    cfg->raw_humidity[idx] = fresh ? state->raw_humidity : 0;
+    cfg->status[idx] = fresh ? state->status : 0;
+}
+
+/**
+ * @brief Fill the value of a sensor in a row from a new sample and the latest one before it.
+ *
+ * @param[in] cfg Resampler config.
+ * @param[in] sensor Sensor index.
+ * @param[in] row Row index. The row time is after the latest sample of the sensor, and not after @p timestamp.
+ * @param[in] timestamp Time of the new sample.
+ * @param[in] meas New sample.
+ * @param[in] status SHT3X_RESAMPLE_STATUS_* of the new sample.
+ */
+static void fill_from_sample(const SHT3XResampleConfig *cfg, uint16_t sensor, uint32_t row, uint32_t timestamp,
+                             const SHT3XLazyMeasurement *meas, uint8_t status)
+{
+    const SHT3XResampleSensor *state = &cfg->sensors[sensor];
+    uint64_t row_time = get_row_time(cfg, row);
+    size_t idx = get_row_offset(cfg, row) + sensor;
+
+    if (row_time == timestamp) {
+        cfg->raw_temperature[idx] = (status & SHT3X_RESAMPLE_STATUS_TEMP) ? meas->raw_temperature : 0;
+        cfg->raw_humidity[idx] = (status & SHT3X_RESAMPLE_STATUS_HUM) ? meas->raw_humidity : 0;
+        cfg->status[idx] = status;
+        return;
+    }
+    if (cfg->method == SHT3X_RESAMPLE_METHOD_HOLD) {
+        fill_hold(cfg, sensor, row);
+        return;
+    }
+
+    /* Both samples must have the value */
+    uint8_t valid = is_fresh(cfg, state, row_time) ? (uint8_t)(state->status & status) : 0;
+    cfg->raw_temperature[idx] =
+        (valid & SHT3X_RESAMPLE_STATUS_TEMP)
+            ? interpolate(state->timestamp, state->raw_temperature, timestamp, meas->raw_temperature, row_time)
+            : 0;
+    cfg->raw_humidity[idx] =
+        (valid & SHT3X_RESAMPLE_STATUS_HUM)
+            ? interpolate(state->timestamp, state->raw_humidity, timestamp, meas->raw_humidity, row_time)
+            : 0;
+    cfg->status[idx] = valid;
+}
+
+uint8_t sht3x_resample_init(SHT3XResampler *const resampler, const SHT3XResampleConfig *const cfg)
+{
+    if (!resampler || !is_valid_cfg(cfg)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    resampler->cfg = *cfg;
+    resampler->head_row = 0;
+    for (uint16_t i = 0; i < cfg->num_sensors; i++) {
+        SHT3XResampleSensor *sensor = &cfg->sensors[i];
+        sensor->next_row = 0;
+        sensor->has_sample = false;
+        sensor->timestamp = 0;
+        sensor->raw_temperature = 0;
+        sensor->raw_humidity = 0;
+        sensor->status = 0;
+    }
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_resample_push(SHT3XResampler *const resampler, uint16_t sensor, uint32_t timestamp,
+                            const SHT3XLazyMeasurement *const meas)
+{
+    if (!resampler || !meas || (sensor >= resampler->cfg.num_sensors)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    const SHT3XResampleConfig *cfg = &resampler->cfg;
+    SHT3XResampleSensor *state = &cfg->sensors[sensor];
+    if (state->has_sample && (timestamp < state->timestamp)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    /* Rows that were taken out without this sensor are not filled anymore */
+    uint32_t first_row = (state->next_row > resampler->head_row) ? state->next_row : resampler->head_row;
+    uint8_t status = map_flags_to_status(meas->flags);
+    if (timestamp >= cfg->start_time) {
+        /* Last row whose time is not after the sample */
+        uint32_t last_row = (timestamp - cfg->start_time) / cfg->period;
+        if (last_row >= first_row) {
+            if ((last_row - resampler->head_row) >= cfg->num_rows) {
+                return SHT3X_RESULT_CODE_OUT_OF_MEMORY;
+            }
+            for (uint32_t i = 0; i <= (last_row - first_row); i++) {
+                fill_from_sample(cfg, sensor, first_row + i, timestamp, meas, status);
+            }
+            first_row = last_row + 1;
+        }
+    }
+
+    state->next_row = first_row;
+    state->has_sample = true;
+    state->timestamp = timestamp;
+    state->raw_temperature = meas->raw_temperature;
+    state->raw_humidity = meas->raw_humidity;
+    state->status = status;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_resample_pop_row(SHT3XResampler *const resampler, uint32_t now, SHT3XResampleRow *const row)
+{
+    if (!resampler || !row) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    const SHT3XResampleConfig *cfg = &resampler->cfg;
+    uint32_t head = resampler->head_row;
+    uint64_t row_time = get_row_time(cfg, head);
+
+    uint16_t sensor = 0;
+    while ((sensor < cfg->num_sensors) && (cfg->sensors[sensor].next_row > head)) {
+        sensor++;
+    }
+    if (sensor < cfg->num_sensors) {
+        if (now < (row_time + cfg->max_delay)) {
+            return SHT3X_RESULT_CODE_NO_DATA;
+        }
+        for (; sensor < cfg->num_sensors; sensor++) {
+            if (cfg->sensors[sensor].next_row <= head) {
+                fill_hold(cfg, sensor, head);
+            }
+        }
+    }
+
+    size_t offset = get_row_offset(cfg, head);
+    row->timestamp = (uint32_t)row_time;
+    row->num_sensors = cfg->num_sensors;
+    row->raw_temperature = &cfg->raw_temperature[offset];
+    row->raw_humidity = &cfg->raw_humidity[offset];
+    row->status = &cfg->status[offset];
+    resampler->head_row = head + 1;
+    return SHT3X_RESULT_CODE_OK;
+}
@@ -0,0 +1,162 @@
+#ifndef SRC_SHT3X_RESAMPLE_H
+#define SRC_SHT3X_RESAMPLE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Streaming resampling of many sensors onto a common timeline.
+ *
+ * Sensors that sample at different rates or instants, e.g. in periodic mode with different @ref SHT3XMps, produce
+ * samples at unrelated times. A resampler turns them into rows at the times start_time + k * period, with one raw
+ * temperature and one raw humidity value per sensor.
+ *
+ * Push the samples of each sensor in time order with @ref sht3x_resample_push. A sample fills the rows of its sensor up
+ * to its timestamp:
+ * - @ref SHT3X_RESAMPLE_METHOD_HOLD uses the latest sample at or before the row time.
+ * - @ref SHT3X_RESAMPLE_METHOD_LINEAR interpolates between the samples before and after the row time.
+ *
+ * A value is only valid if the sample before the row time is at most max_age old. Rows are taken out in time order
+ * with @ref sht3x_resample_pop_row, once every sensor filled them, or once max_delay passed after the row time. Sensors
+ * that did not fill a row by then hold their latest sample.
+ *
+ * Memory is bounded by the caller-provided arrays: a state per sensor, and a ring of num_rows rows with the same
+ * structure of arrays layout as a fleet store from sht3x_fleet.h. The ring holds the rows that are filled by some
+ * sensors but not taken out yet. Timestamps are in any unit chosen by the caller, and must not wrap around.
+ */
+
+/** Temperature of the sensor in the row is valid. */
+#define SHT3X_RESAMPLE_STATUS_TEMP (1U << 0)
+/** Humidity of the sensor in the row is valid. */
+#define SHT3X_RESAMPLE_STATUS_HUM (1U << 1)
+
+/** How row values are derived from samples. */
+typedef enum {
+    /** Zero-order hold. */
+    SHT3X_RESAMPLE_METHOD_HOLD,
+    /** Linear interpolation. */
+    SHT3X_RESAMPLE_METHOD_LINEAR,
+} SHT3XResampleMethod;
+
+/**
+ * @brief Resampling state of a sensor.
+ *
+ * Provided by the caller as part of @ref SHT3XResampleConfig. The fields are private and should not be modified by the
+ * caller.
+ */
+typedef struct {
+    /** Index of the first row that the sensor did not fill yet, counted from the first row. */
+    uint32_t next_row;
+    /** Whether the fields below hold the latest sample. */
+    bool has_sample;
+    uint32_t timestamp;
+    uint16_t raw_temperature;
+    uint16_t raw_humidity;
+    /** SHT3X_RESAMPLE_STATUS_* of the latest sample. */
+    uint8_t status;
+} SHT3XResampleSensor;
+
+/** Resampler config. All arrays are provided by the caller, and must stay valid as long as the resampler is used. */
+typedef struct {
+    uint16_t num_sensors;
+    /** Number of rows in the ring. */
+    uint16_t num_rows;
+    /** One of @ref SHT3XResampleMethod. */
+    uint8_t method;
+    /** Time of the first row. */
+    uint32_t start_time;
+    /** Time between two rows. */
+    uint32_t period;
+    /** Largest age of the sample before the row time that a value is derived from. 0 for no limit. */
+    uint32_t max_age;
+    /** Time after the row time at which a row is taken out even if not all sensors filled it. */
+    uint32_t max_delay;
+    /** num_sensors sensor states. */
+    SHT3XResampleSensor *sensors;
+    /** num_sensors * num_rows raw temperature ticks. */
+    uint16_t *raw_temperature;
+    /** num_sensors * num_rows raw humidity ticks. */
+    uint16_t *raw_humidity;
+    /** num_sensors * num_rows status bytes. */
+    uint8_t *status;
+} SHT3XResampleConfig;
+
+/**
+ * @brief Resampler state.
+ *
+ * Provided by the caller. The fields are private and should not be modified by the caller.
+ */
+typedef struct {
+    SHT3XResampleConfig cfg;
+    /** Index of the oldest row that was not taken out yet. */
+    uint32_t head_row;
+} SHT3XResampler;
+
+/** Row of a resampler. The arrays point into the ring and have num_sensors entries each. */
+typedef struct {
+    uint32_t timestamp;
+    uint16_t num_sensors;
+    const uint16_t *raw_temperature;
+    const uint16_t *raw_humidity;
+    /** SHT3X_RESAMPLE_STATUS_* of each sensor. */
+    const uint8_t *status;
+} SHT3XResampleRow;
+
+/**
+ * @brief Initialize a resampler without any samples.
+ *
+ * @param[out] resampler Caller-provided memory for the resampler state.
+ * @param[in] cfg Resampler config. Copied into @p resampler.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p resampler or @p cfg is NULL, one of the arrays is NULL, num_sensors,
+ * num_rows or period is 0, or method is invalid.
+ */
+uint8_t sht3x_resample_init(SHT3XResampler *const resampler, const SHT3XResampleConfig *const cfg);
+
+/**
+ * @brief Push a sample of a sensor, and fill the rows of the sensor up to its timestamp.
+ *
+ * @param[in] resampler Resampler.
+ * @param[in] sensor Sensor index.
+ * @param[in] timestamp Time of the sample. Not earlier than the previous sample of the sensor.
+ * @param[in] meas Measurement that was read out. Only the values that were read out, as marked by its flags, are
+ * used.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p resampler or @p meas is NULL, @p sensor is out of range, or @p timestamp is
+ * earlier than the previous sample of the sensor.
+ * @retval SHT3X_RESULT_CODE_OUT_OF_MEMORY The sample fills rows beyond the ring. Nothing was changed. Take out rows
+ * with @ref sht3x_resample_pop_row first.
+ */
+uint8_t sht3x_resample_push(SHT3XResampler *const resampler, uint16_t sensor, uint32_t timestamp,
+                            const SHT3XLazyMeasurement *const meas);
+
+/**
+ * @brief Take out the oldest row if it is complete.
+ *
+ * @param[in] resampler Resampler.
+ * @param[in] now Current time. If max_delay passed after the row time, sensors that did not fill the row yet hold
+ * their latest sample, and the row is taken out.
+ * @param[out] row Row is written here. Valid until the next call to @ref sht3x_resample_push or @ref
+ * sht3x_resample_pop_row.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p resampler or @p row is NULL.
+ * @retval SHT3X_RESULT_CODE_NO_DATA Not all sensors filled the row, and max_delay did not pass yet.
+ */
+uint8_t sht3x_resample_pop_row(SHT3XResampler *const resampler, uint32_t now, SHT3XResampleRow *const row);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_RESAMPLE_H */
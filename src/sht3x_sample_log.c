@@ -0,0 +1,412 @@
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_sample_log.h"
+
+/* Version of the block format, stored in the first byte of every block */
+#define SHT3X_SAMPLE_LOG_VERSION 1
+
+/* Offsets within a block header */
+#define SHT3X_SAMPLE_LOG_VERSION_OFFSET 0
+#define SHT3X_SAMPLE_LOG_NUM_SAMPLES_OFFSET 2
+#define SHT3X_SAMPLE_LOG_PAYLOAD_LENGTH_OFFSET 4
+#define SHT3X_SAMPLE_LOG_TIMESTAMP_OFFSET 6
+#define SHT3X_SAMPLE_LOG_TEMPERATURE_OFFSET 10
+#define SHT3X_SAMPLE_LOG_HUMIDITY_OFFSET 12
+#define SHT3X_SAMPLE_LOG_CRC_OFFSET 14
+
+/* Varint: 7 bits per byte, top bit set if more bytes follow */
+#define SHT3X_SAMPLE_LOG_VARINT_BITS 7
+#define SHT3X_SAMPLE_LOG_VARINT_MASK 0x7F
+#define SHT3X_SAMPLE_LOG_VARINT_MORE 0x80
+/* A 32-bit value takes at most 5 varint bytes */
+#define SHT3X_SAMPLE_LOG_VARINT_MAX_SIZE 5
+
+static void write_u16(uint8_t *buf, uint16_t val)
+{
+    buf[0] = (uint8_t)(val >> 8);
+    buf[1] = (uint8_t)(val & 0xFF);
+}
+
+static uint16_t read_u16(const uint8_t *buf)
+{
+    return (uint16_t)(((uint16_t)buf[0] << 8) | buf[1]);
+}
+
+static void write_u32(uint8_t *buf, uint32_t val)
+{
+    buf[0] = (uint8_t)(val >> 24);
+    buf[1] = (uint8_t)((val >> 16) & 0xFF);
+    buf[2] = (uint8_t)((val >> 8) & 0xFF);
+    buf[3] = (uint8_t)(val & 0xFF);
+}
+
+static uint32_t read_u32(const uint8_t *buf)
+{
+    return ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) | buf[3];
+}
+
+/**
+ * @brief Run CRC-16/CCITT-FALSE on a number of bytes.
+ *
+ * @param[in] crc Initial value, 0xFFFF to start, or the result of a previous call to continue.
+ * @param[in] data Bytes at this address are used for CRC calculation.
+ * @param[in] length Number of bytes.
+ *
+ * @return uint16_t Resulting CRC.
+ */
+static uint16_t crc16(uint16_t crc, const uint8_t *const data, size_t length)
+{
+    const uint16_t poly = 0x1021;
+
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)((uint16_t)data[i] << 8);
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            if (crc & 0x8000) {
+                crc = (uint16_t)((crc << 1) ^ poly);
+            } else {
+                crc <<= 1;
+            }
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Get the CRC of a block: the header up to the CRC field, then the payload.
+ *
+ * @param[in] block Block.
+ * @param[in] payload_length Payload length in bytes.
+ *
+ * @return uint16_t Block CRC.
+ */
+static uint16_t get_block_crc(const uint8_t *block, size_t payload_length)
+{
+    uint16_t crc = crc16(0xFFFF, block, SHT3X_SAMPLE_LOG_CRC_OFFSET);
+    return crc16(crc, &block[SHT3X_SAMPLE_LOG_BLOCK_HEADER_SIZE], payload_length);
+}
+
+static uint32_t zigzag_encode(int32_t val)
+{
+    return ((uint32_t)val << 1) ^ (uint32_t)(-(int32_t)((uint32_t)val >> 31));
+}
+
+static int32_t zigzag_decode(uint32_t val)
+{
+    return (int32_t)(val >> 1) ^ -(int32_t)(val & 1);
+}
+
+/**
+ * @brief Encode an unsigned varint.
+ *
+ * @param[in] val Value.
+ * @param[out] out Up to @ref SHT3X_SAMPLE_LOG_VARINT_MAX_SIZE bytes are written here.
+ *
+ * @return size_t Number of bytes written.
+ */
+static size_t write_varint(uint32_t val, uint8_t *out)
+{
+    size_t n = 0;
+    while (val > SHT3X_SAMPLE_LOG_VARINT_MASK) {
+        out[n++] = (uint8_t)((val & SHT3X_SAMPLE_LOG_VARINT_MASK) | SHT3X_SAMPLE_LOG_VARINT_MORE);
+        val >>= SHT3X_SAMPLE_LOG_VARINT_BITS;
+    }
+    out[n++] = (uint8_t)val;
+    return n;
+}
+
+/**
+ * @brief Decode an unsigned varint.
+ *
+ * @param[in] data Encoded varint.
+ * @param[in] length Number of bytes available at @p data.
+ * @param[out] val Value is written here.
+ *
+ * @return size_t Number of bytes read, 0 if the varint is longer than @p length or than a 32-bit value.
+ */
+static size_t read_varint(const uint8_t *data, size_t length, uint32_t *val)
+{
+    uint32_t result = 0;
+    for (size_t n = 0; (n < length) && (n < SHT3X_SAMPLE_LOG_VARINT_MAX_SIZE); n++) {
+        result |= (uint32_t)(data[n] & SHT3X_SAMPLE_LOG_VARINT_MASK) << (n * SHT3X_SAMPLE_LOG_VARINT_BITS);
+        if (!(data[n] & SHT3X_SAMPLE_LOG_VARINT_MORE)) {
+            *val = result;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+static bool is_valid_writer_cfg(const SHT3XSampleLogWriterConfig *const cfg)
+{
+    // clang-format off
+    return (
+        (cfg)
+        && (cfg->block_buf)
+        && (cfg->block_size >= SHT3X_SAMPLE_LOG_MIN_BLOCK_SIZE)
+        && (cfg->block_size <= SHT3X_SAMPLE_LOG_MAX_BLOCK_SIZE)
+        && (cfg->write)
+    );
+    // clang-format on
+}
+
+/**
+ * @brief Start a new block with a sample as its first sample.
+ *
+ * @param[in] writer Sample log writer.
+ * @param[in] sample First sample of the block.
+ */
+static void start_block(SHT3XSampleLogWriter *writer, const SHT3XLogSample *sample)
+{
+    uint8_t *block = writer->cfg.block_buf;
+    block[SHT3X_SAMPLE_LOG_VERSION_OFFSET] = SHT3X_SAMPLE_LOG_VERSION;
+    block[SHT3X_SAMPLE_LOG_VERSION_OFFSET + 1] = 0;
+    write_u32(&block[SHT3X_SAMPLE_LOG_TIMESTAMP_OFFSET], sample->timestamp);
+    write_u16(&block[SHT3X_SAMPLE_LOG_TEMPERATURE_OFFSET], sample->raw_temperature);
+    write_u16(&block[SHT3X_SAMPLE_LOG_HUMIDITY_OFFSET], sample->raw_humidity);
+    writer->length = SHT3X_SAMPLE_LOG_BLOCK_HEADER_SIZE;
+    writer->num_samples = 1;
+}
+
+uint8_t sht3x_sample_log_writer_init(SHT3XSampleLogWriter *const writer, const SHT3XSampleLogWriterConfig *const cfg)
+{
+    if (!writer || !is_valid_writer_cfg(cfg)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    writer->cfg = *cfg;
+    writer->length = 0;
+    writer->num_samples = 0;
+    writer->has_prev = false;
+    writer->prev.timestamp = 0;
+    writer->prev.raw_temperature = 0;
+    writer->prev.raw_humidity = 0;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_sample_log_append(SHT3XSampleLogWriter *const writer, const SHT3XLogSample *const sample)
+{
+    if (!writer || !sample) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (writer->has_prev && (sample->timestamp < writer->prev.timestamp)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    if (writer->num_samples == 0) {
+        start_block(writer, sample);
+        writer->prev = *sample;
+        writer->has_prev = true;
+        return SHT3X_RESULT_CODE_OK;
+    }
+
+    bool fits = ((writer->cfg.block_size - writer->length) >= SHT3X_SAMPLE_LOG_MAX_SAMPLE_SIZE) &&
+                (writer->num_samples < UINT16_MAX);
+    if (!fits) {
+        uint8_t rc = sht3x_sample_log_flush(writer);
+        if (rc != SHT3X_RESULT_CODE_OK) {
+            return rc;
+        }
+        start_block(writer, sample);
+        writer->prev = *sample;
+        return SHT3X_RESULT_CODE_OK;
+    }
+
+    int32_t temperature_delta = (int32_t)sample->raw_temperature - (int32_t)writer->prev.raw_temperature;
+    int32_t humidity_delta = (int32_t)sample->raw_humidity - (int32_t)writer->prev.raw_humidity;
+    uint8_t *out = &(writer->cfg.block_buf[writer->length]);
+    size_t n = write_varint(sample->timestamp - writer->prev.timestamp, out);
+    n += write_varint(zigzag_encode(temperature_delta), &out[n]);
+    n += write_varint(zigzag_encode(humidity_delta), &out[n]);
+    writer->length += n;
+    writer->num_samples++;
+    writer->prev = *sample;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_sample_log_flush(SHT3XSampleLogWriter *const writer)
+{
+    if (!writer) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (writer->num_samples == 0) {
+        return SHT3X_RESULT_CODE_OK;
+    }
+
+    uint8_t *block = writer->cfg.block_buf;
+    size_t payload_length = writer->length - SHT3X_SAMPLE_LOG_BLOCK_HEADER_SIZE;
+    write_u16(&block[SHT3X_SAMPLE_LOG_NUM_SAMPLES_OFFSET], writer->num_samples);
+    write_u16(&block[SHT3X_SAMPLE_LOG_PAYLOAD_LENGTH_OFFSET], (uint16_t)payload_length);
+    write_u16(&block[SHT3X_SAMPLE_LOG_CRC_OFFSET], get_block_crc(block, payload_length));
+    if (!writer->cfg.write(block, writer->length, writer->cfg.write_user_data)) {
+        return SHT3X_RESULT_CODE_IO_ERR;
+    }
+
+    /* prev is kept, so that timestamps cannot decrease across blocks */
+    writer->length = 0;
+    writer->num_samples = 0;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+/**
+ * @brief Get the size of the block at an offset.
+ *
+ * @param[in] reader Sample log reader.
+ * @param[in] pos Offset of the block.
+ *
+ * @return size_t Size of the block in bytes, 0 if there is no complete block at @p pos.
+ */
+static size_t get_block_size(const SHT3XSampleLogReader *reader, size_t pos)
+{
+    size_t remaining = reader->length - pos;
+    if (remaining < SHT3X_SAMPLE_LOG_BLOCK_HEADER_SIZE) {
+        return 0;
+    }
+    size_t size = SHT3X_SAMPLE_LOG_BLOCK_HEADER_SIZE +
+                  read_u16(&(reader->log[pos + SHT3X_SAMPLE_LOG_PAYLOAD_LENGTH_OFFSET]));
+    return (size <= remaining) ? size : 0;
+}
+
+uint8_t sht3x_sample_log_reader_init(SHT3XSampleLogReader *const reader, const uint8_t *const log, size_t length)
+{
+    if (!reader || !log) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    reader->log = log;
+    reader->length = length;
+    reader->block_pos = 0;
+    reader->sample_pos = 0;
+    reader->samples_left = 0;
+    reader->in_block = false;
+    reader->prev.timestamp = 0;
+    reader->prev.raw_temperature = 0;
+    reader->prev.raw_humidity = 0;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+/**
+ * @brief Skip the current block.
+ *
+ * @param[in] reader Sample log reader.
+ * @param[in] block_size Size of the current block in bytes.
+ */
+static void next_block(SHT3XSampleLogReader *reader, size_t block_size)
+{
+    reader->block_pos += block_size;
+    reader->in_block = false;
+    reader->samples_left = 0;
+}
+
+/**
+ * @brief Verify the current block, and read its first sample.
+ *
+ * @param[in] reader Sample log reader.
+ * @param[out] sample First sample of the block is written here.
+ *
+ * @return uint8_t Same return values as @ref sht3x_sample_log_read.
+ */
+static uint8_t enter_block(SHT3XSampleLogReader *reader, SHT3XLogSample *sample)
+{
+    size_t block_size = get_block_size(reader, reader->block_pos);
+    if (block_size == 0) {
+        return SHT3X_RESULT_CODE_NO_DATA;
+    }
+
+    const uint8_t *block = &(reader->log[reader->block_pos]);
+    uint16_t num_samples = read_u16(&block[SHT3X_SAMPLE_LOG_NUM_SAMPLES_OFFSET]);
+    // clang-format off
+    bool valid = (
+        (block[SHT3X_SAMPLE_LOG_VERSION_OFFSET] == SHT3X_SAMPLE_LOG_VERSION)
+        && (num_samples > 0)
+        && (read_u16(&block[SHT3X_SAMPLE_LOG_CRC_OFFSET]) ==
+            get_block_crc(block, block_size - SHT3X_SAMPLE_LOG_BLOCK_HEADER_SIZE))
+    );
+    // clang-format on
+    if (!valid) {
+        next_block(reader, block_size);
+        return SHT3X_RESULT_CODE_CRC_MISMATCH;
+    }
+
+    sample->timestamp = read_u32(&block[SHT3X_SAMPLE_LOG_TIMESTAMP_OFFSET]);
+    sample->raw_temperature = read_u16(&block[SHT3X_SAMPLE_LOG_TEMPERATURE_OFFSET]);
+    sample->raw_humidity = read_u16(&block[SHT3X_SAMPLE_LOG_HUMIDITY_OFFSET]);
+    reader->prev = *sample;
+    reader->sample_pos = reader->block_pos + SHT3X_SAMPLE_LOG_BLOCK_HEADER_SIZE;
+    reader->samples_left = num_samples - 1;
+    reader->in_block = true;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_sample_log_read(SHT3XSampleLogReader *const reader, SHT3XLogSample *const sample)
+{
+    if (!reader || !sample) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    size_t block_size = get_block_size(reader, reader->block_pos);
+    if (reader->in_block && (reader->samples_left == 0)) {
+        next_block(reader, block_size);
+    }
+    if (!reader->in_block) {
+        return enter_block(reader, sample);
+    }
+
+    size_t block_end = reader->block_pos + block_size;
+    const uint8_t *data = &(reader->log[reader->sample_pos]);
+    size_t available = block_end - reader->sample_pos;
+    uint32_t deltas[3];
+    size_t n = 0;
+    for (size_t i = 0; i < 3; i++) {
+        size_t len = read_varint(&data[n], available - n, &deltas[i]);
+        if (len == 0) {
+            /* Only possible if the block was corrupted in a way that the CRC did not catch */
+            next_block(reader, block_size);
+            return SHT3X_RESULT_CODE_CRC_MISMATCH;
+        }
+        n += len;
+    }
+
+    sample->timestamp = reader->prev.timestamp + deltas[0];
+    sample->raw_temperature = (uint16_t)((int32_t)reader->prev.raw_temperature + zigzag_decode(deltas[1]));
+    sample->raw_humidity = (uint16_t)((int32_t)reader->prev.raw_humidity + zigzag_decode(deltas[2]));
+    reader->prev = *sample;
+    reader->sample_pos += n;
+    reader->samples_left--;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_sample_log_seek(SHT3XSampleLogReader *const reader, uint32_t timestamp)
+{
+    if (!reader) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    size_t pos = 0;
+    size_t target = 0;
+    bool found = false;
+    size_t block_size = get_block_size(reader, pos);
+    while (block_size > 0) {
+        uint32_t first_timestamp = read_u32(&(reader->log[pos + SHT3X_SAMPLE_LOG_TIMESTAMP_OFFSET]));
+        if (found && (first_timestamp > timestamp)) {
+            break;
+        }
+        target = pos;
+        found = true;
+        if (first_timestamp > timestamp) {
+            /* All blocks start after timestamp */
+            break;
+        }
+        pos += block_size;
+        block_size = get_block_size(reader, pos);
+    }
+    if (!found) {
+        return SHT3X_RESULT_CODE_NO_DATA;
+    }
+
+    reader->block_pos = target;
+    reader->in_block = false;
+    reader->samples_left = 0;
+    return SHT3X_RESULT_CODE_OK;
+}
@@ -0,0 +1,199 @@
+#ifndef SRC_SHT3X_SAMPLE_LOG_H
+#define SRC_SHT3X_SAMPLE_LOG_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Compact log of raw samples.
+ *
+ * Stores timestamped raw temperature and humidity ticks, e.g. from @ref SHT3XLazyMeasurement, in far less space than
+ * the raw structs. Slowly changing values and regular sampling intervals compress best.
+ *
+ * The log is a sequence of blocks. Each block starts with a @ref SHT3X_SAMPLE_LOG_BLOCK_HEADER_SIZE byte header that
+ * holds the number of samples, the payload length, the first sample in full and a CRC-16 over the header and the
+ * payload. Each following sample is stored in the payload as differences to the previous one: the timestamp difference
+ * as an unsigned varint, and the temperature and humidity differences as zigzag varints. A varint stores 7 bits per
+ * byte, least significant group first, with the top bit set on all bytes but the last one. Zigzag maps signed values
+ * to unsigned ones, so that small negative differences stay small.
+ *
+ * The writer fills a caller-provided block buffer, and passes every completed block to a write function that appends
+ * it to storage, e.g. a file or a flash region. Blocks are never modified after they are written.
+ *
+ * The reader decodes a log from memory, e.g. a memory-mapped file, without copying it. It verifies the CRC of every
+ * block before decoding it, and can seek to the block that holds a given timestamp without decoding the blocks before
+ * it.
+ */
+
+/** Size in bytes of a block header. */
+#define SHT3X_SAMPLE_LOG_BLOCK_HEADER_SIZE 16
+
+/** Largest encoded size in bytes of a sample after the first one in a block. */
+#define SHT3X_SAMPLE_LOG_MAX_SAMPLE_SIZE 11
+
+/** Smallest block buffer size for the writer. Fits the header and one more sample. */
+#define SHT3X_SAMPLE_LOG_MIN_BLOCK_SIZE (SHT3X_SAMPLE_LOG_BLOCK_HEADER_SIZE + SHT3X_SAMPLE_LOG_MAX_SAMPLE_SIZE)
+
+/** Largest block buffer size for the writer. The payload length is stored as a 16-bit value. */
+#define SHT3X_SAMPLE_LOG_MAX_BLOCK_SIZE (SHT3X_SAMPLE_LOG_BLOCK_HEADER_SIZE + 0xFFFF)
+
+/** One logged sample. */
+typedef struct {
+    /** Timestamp in any unit chosen by the caller, e.g. ms. Must not decrease from one sample to the next. */
+    uint32_t timestamp;
+    uint16_t raw_temperature;
+    uint16_t raw_humidity;
+} SHT3XLogSample;
+
+/**
+ * @brief Append a completed block to storage.
+ *
+ * @param[in] data Block.
+ * @param[in] length Length of @p data in bytes.
+ * @param[in] user_data User data from the writer config.
+ *
+ * @retval true The block was written.
+ * @retval false The block could not be written.
+ */
+typedef bool (*SHT3XSampleLogWrite)(const uint8_t *data, size_t length, void *user_data);
+
+/** Sample log writer config. */
+typedef struct {
+    /** Buffer that blocks are built in. Must stay valid as long as the writer is used. */
+    uint8_t *block_buf;
+    /** From @ref SHT3X_SAMPLE_LOG_MIN_BLOCK_SIZE to @ref SHT3X_SAMPLE_LOG_MAX_BLOCK_SIZE. Larger blocks have less
+     * header overhead, smaller blocks lose fewer samples on power loss and allow finer seeking. */
+    size_t block_size;
+    SHT3XSampleLogWrite write;
+    void *write_user_data;
+} SHT3XSampleLogWriterConfig;
+
+/**
+ * @brief Sample log writer state.
+ *
+ * Provided by the caller. The fields are private and should not be modified by the caller.
+ */
+typedef struct {
+    SHT3XSampleLogWriterConfig cfg;
+    /** Number of bytes in block_buf, including the header. */
+    size_t length;
+    /** Number of samples in block_buf. 0 if no block is started. */
+    uint16_t num_samples;
+    /** true once a sample has been appended. */
+    bool has_prev;
+    SHT3XLogSample prev;
+} SHT3XSampleLogWriter;
+
+/**
+ * @brief Sample log reader state.
+ *
+ * Provided by the caller. The fields are private and should not be modified by the caller.
+ */
+typedef struct {
+    const uint8_t *log;
+    size_t length;
+    /** Offset of the current block. */
+    size_t block_pos;
+    /** Offset of the next sample in the current block. */
+    size_t sample_pos;
+    /** Number of samples of the current block that were not read yet. */
+    uint16_t samples_left;
+    /** true if the current block has been verified and its first sample has been read. */
+    bool in_block;
+    SHT3XLogSample prev;
+} SHT3XSampleLogReader;
+
+/**
+ * @brief Initialize a sample log writer.
+ *
+ * @param[out] writer Caller-provided memory for the writer state.
+ * @param[in] cfg Writer config. Copied into @p writer.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p writer or @p cfg is NULL, or @p cfg is invalid.
+ */
+uint8_t sht3x_sample_log_writer_init(SHT3XSampleLogWriter *const writer, const SHT3XSampleLogWriterConfig *const cfg);
+
+/**
+ * @brief Append a sample.
+ *
+ * If the sample does not fit into the current block, the block is written first, and the sample starts a new block.
+ *
+ * @param[in] writer Sample log writer.
+ * @param[in] sample Sample to append.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p writer or @p sample is NULL, or the timestamp of @p sample is smaller than
+ * the previous one.
+ * @retval SHT3X_RESULT_CODE_IO_ERR A completed block could not be written. The sample is not appended, and the block
+ * is kept, so the call can be retried.
+ */
+uint8_t sht3x_sample_log_append(SHT3XSampleLogWriter *const writer, const SHT3XLogSample *const sample);
+
+/**
+ * @brief Write the current block, even if it is not full, e.g. before shutdown.
+ *
+ * @param[in] writer Sample log writer.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success, or there were no samples to write.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p writer is NULL.
+ * @retval SHT3X_RESULT_CODE_IO_ERR The block could not be written. The block is kept, so the call can be retried.
+ */
+uint8_t sht3x_sample_log_flush(SHT3XSampleLogWriter *const writer);
+
+/**
+ * @brief Initialize a sample log reader at the first sample of a log.
+ *
+ * @param[out] reader Caller-provided memory for the reader state.
+ * @param[in] log Log. Must stay valid as long as the reader is used.
+ * @param[in] length Length of @p log in bytes.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p reader or @p log is NULL.
+ */
+uint8_t sht3x_sample_log_reader_init(SHT3XSampleLogReader *const reader, const uint8_t *const log, size_t length);
+
+/**
+ * @brief Read the next sample.
+ *
+ * @param[in] reader Sample log reader.
+ * @param[out] sample Sample is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p reader or @p sample is NULL.
+ * @retval SHT3X_RESULT_CODE_NO_DATA No more samples. A block that is cut short at the end of the log, e.g. by power
+ * loss during a write, also ends the log.
+ * @retval SHT3X_RESULT_CODE_CRC_MISMATCH The next block is corrupted. The reader skips it, and the next call continues
+ * with the block after it.
+ */
+uint8_t sht3x_sample_log_read(SHT3XSampleLogReader *const reader, SHT3XLogSample *const sample);
+
+/**
+ * @brief Move the reader to the block that holds a timestamp.
+ *
+ * Reads only block headers. The next @ref sht3x_sample_log_read returns the first sample of the last block that starts
+ * at or before @p timestamp, or of the first block if all blocks start after it. Samples before @p timestamp in that
+ * block have to be skipped by the caller.
+ *
+ * @param[in] reader Sample log reader.
+ * @param[in] timestamp Timestamp to seek to.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p reader is NULL.
+ * @retval SHT3X_RESULT_CODE_NO_DATA The log has no complete blocks.
+ */
+uint8_t sht3x_sample_log_seek(SHT3XSampleLogReader *const reader, uint32_t timestamp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_SAMPLE_LOG_H */
@@ -0,0 +1,270 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "sht3x_serialize.h"
+
+/* CBOR major types, already shifted into the upper 3 bits of the initial byte */
+#define SHT3X_SERIALIZE_CBOR_UINT 0x00
+#define SHT3X_SERIALIZE_CBOR_TEXT 0x60
+#define SHT3X_SERIALIZE_CBOR_ARRAY 0x80
+#define SHT3X_SERIALIZE_CBOR_MAP 0xA0
+/* Initial byte of a single-precision float */
+#define SHT3X_SERIALIZE_CBOR_FLOAT32 0xFA
+/* Additional information values below this are the argument itself */
+#define SHT3X_SERIALIZE_CBOR_MAX_INLINE 23
+/* Additional information values for a 1, 2, 4 and 8 byte argument */
+#define SHT3X_SERIALIZE_CBOR_ARG_U8 24
+#define SHT3X_SERIALIZE_CBOR_ARG_U16 25
+#define SHT3X_SERIALIZE_CBOR_ARG_U32 26
+#define SHT3X_SERIALIZE_CBOR_ARG_U64 27
+/* Number of entries in a record map */
+#define SHT3X_SERIALIZE_CBOR_NUM_KEYS 4
+
+/* Enough for the decimal representation of UINT64_MAX */
+#define SHT3X_SERIALIZE_MAX_DIGITS 20
+/* JSON values are written in hundredths. Values at or above this many hundredths are written as null, which bounds
+ * the line length. */
+#define SHT3X_SERIALIZE_JSON_LIMIT 1e9
+
+/** Output buffer that records are serialized into. */
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t pos;
+    /** Set once something did not fit into buf. */
+    bool overflow;
+} SHT3XSerializeWriter;
+
+static void write_bytes(SHT3XSerializeWriter *writer, const uint8_t *data, size_t length)
+{
+    if (writer->overflow || ((writer->size - writer->pos) < length)) {
+        writer->overflow = true;
+        return;
+    }
+    memcpy(&writer->buf[writer->pos], data, length);
+    writer->pos += length;
+}
+
+static void write_u8(SHT3XSerializeWriter *writer, uint8_t val)
+{
+    write_bytes(writer, &val, 1);
+}
+
+/** Write the @p num_bytes lower bytes of @p val, big-endian. */
+static void write_be(SHT3XSerializeWriter *writer, uint64_t val, size_t num_bytes)
+{
+    uint8_t bytes[sizeof(uint64_t)];
+    for (size_t i = 0; i < num_bytes; i++) {
+        bytes[i] = (uint8_t)((val >> (8 * (num_bytes - 1 - i))) & 0xFF);
+    }
+    write_bytes(writer, bytes, num_bytes);
+}
+
+static void write_str(SHT3XSerializeWriter *writer, const char *str)
+{
+    write_bytes(writer, (const uint8_t *)str, strlen(str));
+}
+
+static uint32_t get_float_bits(float val)
+{
+    uint32_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    return bits;
+}
+
+static void write_binary(SHT3XSerializeWriter *writer, const SHT3XRecord *record)
+{
+    write_be(writer, record->sensor_id, 4);
+    write_be(writer, record->timestamp, 4);
+    write_be(writer, get_float_bits(record->meas.temperature), 4);
+    write_be(writer, get_float_bits(record->meas.humidity), 4);
+}
+
+/**
+ * @brief Write a CBOR initial byte with its argument in the shortest form.
+ *
+ * @param[in] writer Output buffer.
+ * @param[in] major_type Major type, shifted into the upper 3 bits.
+ * @param[in] arg Argument, e.g. the value of an unsigned integer or the length of a string.
+ */
+static void write_cbor_head(SHT3XSerializeWriter *writer, uint8_t major_type, uint64_t arg)
+{
+    if (arg <= SHT3X_SERIALIZE_CBOR_MAX_INLINE) {
+        write_u8(writer, (uint8_t)(major_type | arg));
+    } else if (arg <= UINT8_MAX) {
+        write_u8(writer, major_type | SHT3X_SERIALIZE_CBOR_ARG_U8);
+        write_be(writer, arg, 1);
+    } else if (arg <= UINT16_MAX) {
+        write_u8(writer, major_type | SHT3X_SERIALIZE_CBOR_ARG_U16);
+        write_be(writer, arg, 2);
+    } else if (arg <= UINT32_MAX) {
+        write_u8(writer, major_type | SHT3X_SERIALIZE_CBOR_ARG_U32);
+        write_be(writer, arg, 4);
+    } else {
+        write_u8(writer, major_type | SHT3X_SERIALIZE_CBOR_ARG_U64);
+        write_be(writer, arg, 8);
+    }
+}
+
+static void write_cbor_key(SHT3XSerializeWriter *writer, const char *key)
+{
+    size_t length = strlen(key);
+    write_cbor_head(writer, SHT3X_SERIALIZE_CBOR_TEXT, length);
+    write_bytes(writer, (const uint8_t *)key, length);
+}
+
+static void write_cbor_float(SHT3XSerializeWriter *writer, float val)
+{
+    write_u8(writer, SHT3X_SERIALIZE_CBOR_FLOAT32);
+    write_be(writer, get_float_bits(val), 4);
+}
+
+static void write_cbor(SHT3XSerializeWriter *writer, const SHT3XRecord *record)
+{
+    write_cbor_head(writer, SHT3X_SERIALIZE_CBOR_MAP, SHT3X_SERIALIZE_CBOR_NUM_KEYS);
+    write_cbor_key(writer, "id");
+    write_cbor_head(writer, SHT3X_SERIALIZE_CBOR_UINT, record->sensor_id);
+    write_cbor_key(writer, "ts");
+    write_cbor_head(writer, SHT3X_SERIALIZE_CBOR_UINT, record->timestamp);
+    write_cbor_key(writer, "t");
+    write_cbor_float(writer, record->meas.temperature);
+    write_cbor_key(writer, "rh");
+    write_cbor_float(writer, record->meas.humidity);
+}
+
+static void write_uint(SHT3XSerializeWriter *writer, uint64_t val)
+{
+    char digits[SHT3X_SERIALIZE_MAX_DIGITS + 1];
+    size_t idx = SHT3X_SERIALIZE_MAX_DIGITS;
+    digits[idx] = '\0';
+    do {
+        digits[--idx] = (char)('0' + (val % 10));
+        val /= 10;
+    } while (val > 0);
+    write_str(writer, &digits[idx]);
+}
+
+/**
+ * @brief Write a value with two decimals.
+ *
+ * The value is scaled to hundredths in double precision, which is exact for every float in range, so rounding to the
+ * nearest hundredth can break ties to even, like printf does.
+ *
+ * @param[in] writer Output buffer.
+ * @param[in] val Value to write.
+ */
+static void write_fixed2(SHT3XSerializeWriter *writer, float val)
+{
+    double scaled = (double)val * 100.0;
+    /* Also false for NaN */
+    if (!((scaled > -SHT3X_SERIALIZE_JSON_LIMIT) && (scaled < SHT3X_SERIALIZE_JSON_LIMIT))) {
+        write_str(writer, "null");
+        return;
+    }
+
+    bool negative = (scaled < 0);
+    double magnitude = negative ? -scaled : scaled;
+    uint64_t hundredths = (uint64_t)magnitude;
+    double fraction = magnitude - (double)hundredths;
+    if ((fraction > 0.5) || ((fraction == 0.5) && ((hundredths % 2) != 0))) {
+        hundredths++;
+    }
+
+    if (negative) {
+        write_u8(writer, '-');
+    }
+    write_uint(writer, hundredths / 100);
+    write_u8(writer, '.');
+    write_u8(writer, (uint8_t)('0' + ((hundredths / 10) % 10)));
+    write_u8(writer, (uint8_t)('0' + (hundredths % 10)));
+}
+
+static void write_json_line(SHT3XSerializeWriter *writer, const SHT3XRecord *record)
+{
+    write_str(writer, "{\"id\":");
+    write_uint(writer, record->sensor_id);
+    write_str(writer, ",\"ts\":");
+    write_uint(writer, record->timestamp);
+    write_str(writer, ",\"t\":");
+    write_fixed2(writer, record->meas.temperature);
+    write_str(writer, ",\"rh\":");
+    write_fixed2(writer, record->meas.humidity);
+    write_str(writer, "}\n");
+}
+
+static bool is_valid_format(SHT3XSerializeFormat format)
+{
+    // clang-format off
+    return (
+        (format == SHT3X_SERIALIZE_FORMAT_BINARY)
+        || (format == SHT3X_SERIALIZE_FORMAT_CBOR)
+        || (format == SHT3X_SERIALIZE_FORMAT_JSON_LINES)
+    );
+    // clang-format on
+}
+
+static void write_record(SHT3XSerializeWriter *writer, SHT3XSerializeFormat format, const SHT3XRecord *record)
+{
+    switch (format) {
+    case SHT3X_SERIALIZE_FORMAT_BINARY:
+        write_binary(writer, record);
+        break;
+    case SHT3X_SERIALIZE_FORMAT_CBOR:
+        write_cbor(writer, record);
+        break;
+    case SHT3X_SERIALIZE_FORMAT_JSON_LINES:
+        write_json_line(writer, record);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Report the result of serializing into a writer.
+ *
+ * @param[in] writer Output buffer.
+ * @param[out] length Number of bytes written is written here on success.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_OUT_OF_MEMORY Something did not fit into the buffer.
+ */
+static uint8_t finish(const SHT3XSerializeWriter *writer, size_t *const length)
+{
+    if (writer->overflow) {
+        return SHT3X_RESULT_CODE_OUT_OF_MEMORY;
+    }
+    *length = writer->pos;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_serialize_record(SHT3XSerializeFormat format, const SHT3XRecord *const record, uint8_t *const buf,
+                               size_t size, size_t *const length)
+{
+    if (!record || !buf || !length || !is_valid_format(format)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    SHT3XSerializeWriter writer = {.buf = buf, .size = size, .pos = 0, .overflow = false};
+    write_record(&writer, format, record);
+    return finish(&writer, length);
+}
+
+uint8_t sht3x_serialize_batch(SHT3XSerializeFormat format, const SHT3XRecord *const records, size_t num_records,
+                              uint8_t *const buf, size_t size, size_t *const length)
+{
+    if (!records || !buf || !length || !is_valid_format(format)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    SHT3XSerializeWriter writer = {.buf = buf, .size = size, .pos = 0, .overflow = false};
+    if (format == SHT3X_SERIALIZE_FORMAT_CBOR) {
+        write_cbor_head(&writer, SHT3X_SERIALIZE_CBOR_ARRAY, num_records);
+    }
+    for (size_t i = 0; (i < num_records) && !writer.overflow; i++) {
+        write_record(&writer, format, &records[i]);
+    }
+    return finish(&writer, length);
+}
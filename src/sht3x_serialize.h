@@ -0,0 +1,96 @@
+#ifndef SRC_SHT3X_SERIALIZE_H
+#define SRC_SHT3X_SERIALIZE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Serialization of measurement records into a caller-provided buffer.
+ *
+ * A record is a measurement with the ID of the sensor that it came from and a timestamp. Records are serialized in one
+ * of three formats, without heap allocation and without printf:
+ *
+ * - Binary: @ref SHT3X_SERIALIZE_BINARY_SIZE bytes, all big-endian: sensor ID and timestamp as 32-bit unsigned values,
+ *   then temperature and humidity as IEEE 754 single-precision floats.
+ * - CBOR: a map with the text keys "id", "ts", "t" and "rh". Sensor ID and timestamp are unsigned integers in their
+ *   shortest form, temperature and humidity are single-precision floats.
+ * - JSON lines: an object with the same keys on one line, terminated by a newline, e.g.
+ *   `{"id":3,"ts":1000,"t":23.45,"rh":45.67}`. Temperature and humidity are written with two decimals, rounded the same
+ *   way as printf("%.2f"). Values that are not finite or too large for @ref SHT3X_SERIALIZE_JSON_MAX_SIZE are written
+ *   as null.
+ *
+ * A batch of binary records or JSON lines is the records one after another. A CBOR batch is an array of the records.
+ */
+
+/** Size in bytes of a binary record. */
+#define SHT3X_SERIALIZE_BINARY_SIZE 16
+
+/** Largest size in bytes of a CBOR record. */
+#define SHT3X_SERIALIZE_CBOR_MAX_SIZE 32
+
+/** Largest size in bytes of the array header of a CBOR batch. */
+#define SHT3X_SERIALIZE_CBOR_ARRAY_HEADER_MAX_SIZE 9
+
+/** Largest size in bytes of a JSON line, including the newline. */
+#define SHT3X_SERIALIZE_JSON_MAX_SIZE 67
+
+/** Serialization format. */
+typedef enum {
+    SHT3X_SERIALIZE_FORMAT_BINARY = 0,
+    SHT3X_SERIALIZE_FORMAT_CBOR = 1,
+    SHT3X_SERIALIZE_FORMAT_JSON_LINES = 2,
+} SHT3XSerializeFormat;
+
+/** Measurement record. */
+typedef struct {
+    uint32_t sensor_id;
+    /** Timestamp in any unit chosen by the caller, e.g. seconds since the epoch. */
+    uint32_t timestamp;
+    SHT3XMeasurement meas;
+} SHT3XRecord;
+
+/**
+ * @brief Serialize a record.
+ *
+ * @param[in] format Serialization format.
+ * @param[in] record Record to serialize.
+ * @param[out] buf Buffer that the record is written to.
+ * @param[in] size Size of @p buf in bytes.
+ * @param[out] length Number of bytes written to @p buf is written here. Only written on success.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG One of the pointers is NULL, or @p format is invalid.
+ * @retval SHT3X_RESULT_CODE_OUT_OF_MEMORY The record does not fit into @p buf.
+ */
+uint8_t sht3x_serialize_record(SHT3XSerializeFormat format, const SHT3XRecord *const record, uint8_t *const buf,
+                               size_t size, size_t *const length);
+
+/**
+ * @brief Serialize a batch of records.
+ *
+ * @param[in] format Serialization format.
+ * @param[in] records Records to serialize.
+ * @param[in] num_records Number of records in @p records.
+ * @param[out] buf Buffer that the batch is written to.
+ * @param[in] size Size of @p buf in bytes.
+ * @param[out] length Number of bytes written to @p buf is written here. Only written on success.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG One of the pointers is NULL, or @p format is invalid.
+ * @retval SHT3X_RESULT_CODE_OUT_OF_MEMORY The batch does not fit into @p buf.
+ */
+uint8_t sht3x_serialize_batch(SHT3XSerializeFormat format, const SHT3XRecord *const records, size_t num_records,
+                              uint8_t *const buf, size_t size, size_t *const length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_SERIALIZE_H */
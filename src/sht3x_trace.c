@@ -0,0 +1,198 @@
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_trace.h"
+
+/* Enough for the decimal representation of UINT64_MAX */
+#define SHT3X_TRACE_MAX_DIGITS 20
+
+/** Output buffer that the event is formatted into. */
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t pos;
+    /** Set once something did not fit into buf. */
+    bool overflow;
+} SHT3xTraceWriter;
+
+/* Indexed by SHT3XSequenceType */
+static const char *const sequence_names[] = {
+    [SHT3X_SEQUENCE_TYPE_WRITE_CMD] = "write_cmd",
+    [SHT3X_SEQUENCE_TYPE_READ_MEAS] = "read_meas",
+    [SHT3X_SEQUENCE_TYPE_SINGLE_SHOT_MEAS] = "single_shot_meas",
+    [SHT3X_SEQUENCE_TYPE_READ_PERIODIC_MEAS] = "read_periodic_meas",
+    [SHT3X_SEQUENCE_TYPE_SOFT_RESET_WITH_DELAY] = "soft_reset_with_delay",
+    [SHT3X_SEQUENCE_TYPE_READ_STATUS_REG] = "read_status_reg",
+    [SHT3X_SEQUENCE_TYPE_READ_SERIAL_NUMBER] = "read_serial_number",
+    [SHT3X_SEQUENCE_TYPE_INIT] = "init",
+    [SHT3X_SEQUENCE_TYPE_INIT_VERIFY] = "init_verify",
+    [SHT3X_SEQUENCE_TYPE_NO_SEQ] = "no_seq",
+};
+
+static void write_str(SHT3xTraceWriter *writer, const char *str)
+{
+    for (; *str; str++) {
+        if (writer->pos >= writer->size) {
+            writer->overflow = true;
+            return;
+        }
+        writer->buf[writer->pos++] = *str;
+    }
+}
+
+static void write_uint(SHT3xTraceWriter *writer, uint64_t val)
+{
+    char digits[SHT3X_TRACE_MAX_DIGITS + 1];
+    size_t idx = SHT3X_TRACE_MAX_DIGITS;
+    digits[idx] = '\0';
+    do {
+        digits[--idx] = (char)('0' + (val % 10));
+        val /= 10;
+    } while (val > 0);
+    write_str(writer, &digits[idx]);
+}
+
+static void write_hex16(SHT3xTraceWriter *writer, uint16_t val)
+{
+    static const char hex_digits[] = "0123456789ABCDEF";
+    char digits[5];
+    for (size_t i = 0; i < 4; i++) {
+        digits[i] = hex_digits[(val >> (12 - (4 * i))) & 0x0F];
+    }
+    digits[4] = '\0';
+    write_str(writer, digits);
+}
+
+/**
+ * @brief Get the slice name and category of a trace event.
+ *
+ * @param[in] event Trace event.
+ * @param[out] name Slice name is written here.
+ * @param[out] category Slice category is written here.
+ *
+ * @retval true Success.
+ * @retval false Event type or sequence type is invalid.
+ */
+static bool get_slice(const SHT3XTraceEvent *event, const char **name, const char **category)
+{
+    switch (event->type) {
+    case SHT3X_TRACE_EVENT_SEQUENCE_START:
+    case SHT3X_TRACE_EVENT_SEQUENCE_END:
+        *name = sht3x_trace_get_sequence_name(event->sequence_type);
+        if (!*name) {
+            return false;
+        }
+        *category = "sequence";
+        return true;
+    case SHT3X_TRACE_EVENT_I2C_WRITE_ISSUE:
+    case SHT3X_TRACE_EVENT_I2C_WRITE_COMPLETE:
+        *name = "i2c_write";
+        *category = "i2c";
+        return true;
+    case SHT3X_TRACE_EVENT_I2C_READ_ISSUE:
+    case SHT3X_TRACE_EVENT_I2C_READ_COMPLETE:
+        *name = "i2c_read";
+        *category = "i2c";
+        return true;
+    case SHT3X_TRACE_EVENT_TIMER_ARM:
+    case SHT3X_TRACE_EVENT_TIMER_EXPIRE:
+        *name = "timer";
+        *category = "timer";
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Check whether a trace event begins a slice.
+ *
+ * @param[in] type Use @ref SHT3XTraceEventType.
+ *
+ * @retval true Event begins a slice.
+ * @retval false Event ends a slice.
+ */
+static bool is_begin_event(uint8_t type)
+{
+    // clang-format off
+    return (
+        (type == SHT3X_TRACE_EVENT_SEQUENCE_START)
+        || (type == SHT3X_TRACE_EVENT_I2C_WRITE_ISSUE)
+        || (type == SHT3X_TRACE_EVENT_I2C_READ_ISSUE)
+        || (type == SHT3X_TRACE_EVENT_TIMER_ARM)
+    );
+    // clang-format on
+}
+
+uint8_t sht3x_trace_format_chrome_event(const SHT3XTraceEvent *const event, uint64_t timestamp_us, uint32_t track_id,
+                                        char *const buf, size_t size, size_t *const length)
+{
+    const char *name;
+    const char *category;
+    if (!event || !buf || !length || !get_slice(event, &name, &category)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    bool begin = is_begin_event(event->type);
+    SHT3xTraceWriter writer = {
+        .buf = buf,
+        .size = size,
+        .pos = 0,
+        .overflow = false,
+    };
+    write_str(&writer, "{\"name\":\"");
+    write_str(&writer, name);
+    write_str(&writer, "\",\"cat\":\"");
+    write_str(&writer, category);
+    write_str(&writer, begin ? "\",\"ph\":\"B\",\"ts\":" : "\",\"ph\":\"E\",\"ts\":");
+    write_uint(&writer, timestamp_us);
+    write_str(&writer, ",\"pid\":1,\"tid\":");
+    write_uint(&writer, track_id);
+
+    if (event->type == SHT3X_TRACE_EVENT_TIMER_ARM) {
+        write_str(&writer, ",\"args\":{\"duration_ms\":");
+        write_uint(&writer, event->arg);
+        write_str(&writer, "}");
+    } else if (event->type == SHT3X_TRACE_EVENT_I2C_WRITE_ISSUE) {
+        write_str(&writer, ",\"args\":{\"cmd\":\"0x");
+        write_hex16(&writer, (uint16_t)event->arg);
+        write_str(&writer, "\"}");
+    } else if (event->type == SHT3X_TRACE_EVENT_I2C_READ_ISSUE) {
+        write_str(&writer, ",\"args\":{\"length\":");
+        write_uint(&writer, event->arg);
+        write_str(&writer, "}");
+    } else if (!begin && (event->type != SHT3X_TRACE_EVENT_TIMER_EXPIRE)) {
+        write_str(&writer, ",\"args\":{\"rc\":");
+        write_uint(&writer, event->result_code);
+        write_str(&writer, "}");
+    }
+    write_str(&writer, "}");
+
+    if (writer.overflow) {
+        return SHT3X_RESULT_CODE_OUT_OF_MEMORY;
+    }
+    *length = writer.pos;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+const char *sht3x_trace_get_sequence_name(uint8_t sequence_type)
+{
+    if (sequence_type > SHT3X_SEQUENCE_TYPE_NO_SEQ) {
+        return NULL;
+    }
+    return sequence_names[sequence_type];
+}
+
+void sht3x_trace_fanout_hook(const SHT3XTraceEvent *event, void *user_data)
+{
+    const SHT3XTraceFanout *fanout = (const SHT3XTraceFanout *)user_data;
+    if (!fanout || !fanout->entries) {
+        return;
+    }
+
+    for (size_t i = 0; i < fanout->num_entries; i++) {
+        if (fanout->entries[i].hook) {
+            fanout->entries[i].hook(event, fanout->entries[i].user_data);
+        }
+    }
+}
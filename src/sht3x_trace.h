@@ -0,0 +1,85 @@
+#ifndef SRC_SHT3X_TRACE_H
+#define SRC_SHT3X_TRACE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Export of trace events to Chrome trace JSON.
+ *
+ * Trace events from the trace_hook of @ref SHT3XInitConfig are formatted as Chrome trace "duration" events, which can
+ * be loaded into chrome://tracing or Perfetto UI:
+ * - Sequence start and end become a slice named after the sequence type, with the result code of the sequence.
+ * - I2C write and read issue and completion become a nested "i2c_write" or "i2c_read" slice, with the command code or
+ * the number of bytes read, and the I2C result code.
+ * - Timer start and expiry become a nested "timer" slice, with the duration.
+ *
+ * The events are usually recorded with a timestamp on the target, and formatted later, e.g. on the host. A trace file
+ * is the character '[', followed by formatted events separated by ',', followed by the character ']'.
+ *
+ * An instance has a single trace_hook. To feed several consumers, e.g. @ref sht3x_flight_recorder_hook and @ref
+ * sht3x_latency_hook, use @ref sht3x_trace_fanout_hook as trace_hook, which passes every event on to each hook of a
+ * @ref SHT3XTraceFanout.
+ */
+
+/** A trace hook and the user data to pass to it. */
+typedef struct {
+    SHT3XTraceHook hook;
+    void *user_data;
+} SHT3XTraceHookEntry;
+
+/** Hooks that @ref sht3x_trace_fanout_hook passes events on to. Must stay valid as long as the instance is used. */
+typedef struct {
+    /** Executed in order of the array. Entries with a NULL hook are skipped. */
+    const SHT3XTraceHookEntry *entries;
+    size_t num_entries;
+} SHT3XTraceFanout;
+
+/**
+ * @brief Format a trace event as a Chrome trace JSON object.
+ *
+ * Does not write a null terminator.
+ *
+ * @param[in] event Trace event.
+ * @param[in] timestamp_us Time at which the event happened, in microseconds.
+ * @param[in] track_id Timeline that the event is shown on, e.g. one per instance.
+ * @param[out] buf Formatted event is written here.
+ * @param[in] size Size of @p buf in bytes.
+ * @param[out] length Number of bytes written to @p buf is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p event, @p buf or @p length is NULL, or event type is invalid.
+ * @retval SHT3X_RESULT_CODE_OUT_OF_MEMORY @p buf is too small. Nothing meaningful is written.
+ */
+uint8_t sht3x_trace_format_chrome_event(const SHT3XTraceEvent *const event, uint64_t timestamp_us, uint32_t track_id,
+                                        char *const buf, size_t size, size_t *const length);
+
+/**
+ * @brief Get the name of a sequence type, as used for slice names, e.g. "read_periodic_meas".
+ *
+ * @param[in] sequence_type Use @ref SHT3XSequenceType.
+ *
+ * @return const char* Null-terminated name, or NULL if @p sequence_type is invalid.
+ */
+const char *sht3x_trace_get_sequence_name(uint8_t sequence_type);
+
+/**
+ * @brief Pass a trace event on to several hooks. Meant to be used as trace_hook in @ref SHT3XInitConfig.
+ *
+ * @param[in] event Trace event.
+ * @param[in] user_data @ref SHT3XTraceFanout with the hooks.
+ */
+void sht3x_trace_fanout_hook(const SHT3XTraceEvent *event, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_TRACE_H */
@@ -0,0 +1,465 @@
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x_transcript.h"
+
+/* Version of the transcript format, stored in the first byte of the transcript */
+#define SHT3X_TRANSCRIPT_VERSION 1
+
+/* Record types */
+#define SHT3X_TRANSCRIPT_RECORD_NONE 0
+#define SHT3X_TRANSCRIPT_RECORD_I2C_WRITE 1
+#define SHT3X_TRANSCRIPT_RECORD_I2C_READ 2
+#define SHT3X_TRANSCRIPT_RECORD_TIMER 3
+
+/* Offsets within a record */
+#define SHT3X_TRANSCRIPT_TYPE_OFFSET 0
+#define SHT3X_TRANSCRIPT_TIMESTAMP_OFFSET 1
+#define SHT3X_TRANSCRIPT_DURATION_OFFSET 5
+#define SHT3X_TRANSCRIPT_I2C_ADDR_OFFSET 9
+#define SHT3X_TRANSCRIPT_I2C_RESULT_CODE_OFFSET 10
+#define SHT3X_TRANSCRIPT_I2C_LENGTH_OFFSET 11
+#define SHT3X_TRANSCRIPT_I2C_DATA_OFFSET 12
+#define SHT3X_TRANSCRIPT_TIMER_PERIOD_OFFSET 9
+
+/* I2C record length is stored in one byte */
+#define SHT3X_TRANSCRIPT_MAX_I2C_LENGTH 0xFF
+
+static void write_u32(uint8_t *buf, uint32_t val)
+{
+    buf[0] = (uint8_t)(val >> 24);
+    buf[1] = (uint8_t)((val >> 16) & 0xFF);
+    buf[2] = (uint8_t)((val >> 8) & 0xFF);
+    buf[3] = (uint8_t)(val & 0xFF);
+}
+
+static uint32_t read_u32(const uint8_t *buf)
+{
+    return ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) | buf[3];
+}
+
+static bool is_valid_recorder_cfg(const SHT3XTranscriptRecorderConfig *const cfg)
+{
+    // clang-format off
+    return (
+        (cfg)
+        && (cfg->buf)
+        && (cfg->size >= SHT3X_TRANSCRIPT_HEADER_SIZE)
+        && (cfg->i2c_write)
+        && (cfg->i2c_read)
+        && (cfg->start_timer)
+        && (cfg->get_time_us)
+    );
+    // clang-format on
+}
+
+static uint32_t recorder_now(SHT3XTranscriptRecorder *recorder)
+{
+    return recorder->cfg.get_time_us(recorder->cfg.get_time_us_user_data);
+}
+
+/**
+ * @brief Reserve space for a record, and write its type and timestamp.
+ *
+ * @param[in] recorder Transcript recorder.
+ * @param[in] type Record type.
+ * @param[in] record_size Size of the whole record in bytes.
+ * @param[in] start_us Time at which the transaction or timer started.
+ *
+ * @return uint8_t* Start of the record, or NULL if it does not fit. Once a record does not fit, no more records are
+ * written, so that the transcript stays replayable up to that point.
+ */
+static uint8_t *begin_record(SHT3XTranscriptRecorder *recorder, uint8_t type, size_t record_size, uint32_t start_us)
+{
+    if (recorder->truncated || ((recorder->cfg.size - recorder->length) < record_size)) {
+        recorder->truncated = true;
+        return NULL;
+    }
+
+    uint8_t *record = &(recorder->cfg.buf[recorder->length]);
+    record[SHT3X_TRANSCRIPT_TYPE_OFFSET] = type;
+    write_u32(&record[SHT3X_TRANSCRIPT_TIMESTAMP_OFFSET], start_us - recorder->init_us);
+    recorder->length += record_size;
+    return record;
+}
+
+/**
+ * @brief Record a completed I2C transaction, then pass the result to the driver.
+ *
+ * @param[in] result_code I2C result code.
+ * @param[in] user_data Transcript recorder.
+ */
+static void record_i2c_complete_cb(uint8_t result_code, void *user_data)
+{
+    SHT3XTranscriptRecorder *recorder = (SHT3XTranscriptRecorder *)user_data;
+    if (!recorder) {
+        return;
+    }
+
+    uint8_t *record = recorder->i2c_record;
+    if (record) {
+        write_u32(&record[SHT3X_TRANSCRIPT_DURATION_OFFSET], recorder_now(recorder) - recorder->i2c_start_us);
+        record[SHT3X_TRANSCRIPT_I2C_RESULT_CODE_OFFSET] = result_code;
+        /* Read data is only valid once the read is complete */
+        for (size_t i = 0; recorder->i2c_read_data && (i < record[SHT3X_TRANSCRIPT_I2C_LENGTH_OFFSET]); i++) {
+            record[SHT3X_TRANSCRIPT_I2C_DATA_OFFSET + i] = recorder->i2c_read_data[i];
+        }
+    }
+
+    SHT3X_I2CTransactionCompleteCb cb = recorder->i2c_cb;
+    void *cb_user_data = recorder->i2c_cb_user_data;
+    recorder->i2c_cb = NULL;
+    recorder->i2c_cb_user_data = NULL;
+    recorder->i2c_record = NULL;
+    recorder->i2c_read_data = NULL;
+    if (cb) {
+        cb(result_code, cb_user_data);
+    }
+}
+
+/**
+ * @brief Record an expired timer, then pass it on to the driver.
+ *
+ * @param[in] user_data Transcript recorder.
+ */
+static void record_timer_expired_cb(void *user_data)
+{
+    SHT3XTranscriptRecorder *recorder = (SHT3XTranscriptRecorder *)user_data;
+    if (!recorder) {
+        return;
+    }
+
+    uint8_t *record = begin_record(recorder, SHT3X_TRANSCRIPT_RECORD_TIMER, SHT3X_TRANSCRIPT_TIMER_RECORD_SIZE,
+                                   recorder->timer_start_us);
+    if (record) {
+        write_u32(&record[SHT3X_TRANSCRIPT_DURATION_OFFSET], recorder_now(recorder) - recorder->timer_start_us);
+        write_u32(&record[SHT3X_TRANSCRIPT_TIMER_PERIOD_OFFSET], recorder->timer_duration_ms);
+    }
+
+    SHT3XTimerExpiredCb cb = recorder->timer_cb;
+    void *cb_user_data = recorder->timer_cb_user_data;
+    recorder->timer_cb = NULL;
+    recorder->timer_cb_user_data = NULL;
+    if (cb) {
+        cb(cb_user_data);
+    }
+}
+
+/**
+ * @brief Reserve the record of an I2C transaction that is about to be issued.
+ *
+ * Written data is copied right away, because the driver only guarantees that it is valid during the i2c_write call.
+ * The rest of the record is written once the transaction is complete. Until then, it reads as a failed transaction.
+ *
+ * @param[in] recorder Transcript recorder.
+ * @param[in] type @ref SHT3X_TRANSCRIPT_RECORD_I2C_WRITE or @ref SHT3X_TRANSCRIPT_RECORD_I2C_READ.
+ * @param[in] data Data of the transaction.
+ * @param[in] length Number of bytes in @p data.
+ * @param[in] i2c_addr I2C address.
+ * @param[in] cb Driver callback to execute once the transaction is complete.
+ * @param[in] cb_user_data User data to pass to @p cb.
+ */
+static void begin_i2c(SHT3XTranscriptRecorder *recorder, uint8_t type, uint8_t *data, size_t length, uint8_t i2c_addr,
+                      SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data)
+{
+    recorder->i2c_cb = cb;
+    recorder->i2c_cb_user_data = cb_user_data;
+    recorder->i2c_start_us = recorder_now(recorder);
+    recorder->i2c_read_data = (type == SHT3X_TRANSCRIPT_RECORD_I2C_READ) ? data : NULL;
+    recorder->i2c_record = NULL;
+    if (length > SHT3X_TRANSCRIPT_MAX_I2C_LENGTH) {
+        recorder->truncated = true;
+        return;
+    }
+
+    uint8_t *record =
+        begin_record(recorder, type, SHT3X_TRANSCRIPT_I2C_RECORD_OVERHEAD + length, recorder->i2c_start_us);
+    if (!record) {
+        return;
+    }
+    write_u32(&record[SHT3X_TRANSCRIPT_DURATION_OFFSET], 0);
+    record[SHT3X_TRANSCRIPT_I2C_ADDR_OFFSET] = i2c_addr;
+    record[SHT3X_TRANSCRIPT_I2C_RESULT_CODE_OFFSET] = SHT3X_I2C_RESULT_CODE_BUS_ERROR;
+    record[SHT3X_TRANSCRIPT_I2C_LENGTH_OFFSET] = (uint8_t)length;
+    for (size_t i = 0; i < length; i++) {
+        record[SHT3X_TRANSCRIPT_I2C_DATA_OFFSET + i] = (type == SHT3X_TRANSCRIPT_RECORD_I2C_WRITE) ? data[i] : 0;
+    }
+    recorder->i2c_record = record;
+}
+
+uint8_t sht3x_transcript_recorder_init(SHT3XTranscriptRecorder *const recorder,
+                                       const SHT3XTranscriptRecorderConfig *const cfg)
+{
+    if (!recorder || !is_valid_recorder_cfg(cfg)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    recorder->cfg = *cfg;
+    recorder->cfg.buf[0] = SHT3X_TRANSCRIPT_VERSION;
+    recorder->cfg.buf[1] = 0;
+    recorder->length = SHT3X_TRANSCRIPT_HEADER_SIZE;
+    recorder->truncated = false;
+    recorder->init_us = recorder_now(recorder);
+    recorder->i2c_cb = NULL;
+    recorder->i2c_cb_user_data = NULL;
+    recorder->i2c_record = NULL;
+    recorder->i2c_read_data = NULL;
+    recorder->i2c_start_us = 0;
+    recorder->timer_cb = NULL;
+    recorder->timer_cb_user_data = NULL;
+    recorder->timer_duration_ms = 0;
+    recorder->timer_start_us = 0;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+void sht3x_transcript_record_i2c_write(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                                       SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data)
+{
+    SHT3XTranscriptRecorder *recorder = (SHT3XTranscriptRecorder *)user_data;
+    if (!recorder) {
+        return;
+    }
+
+    begin_i2c(recorder, SHT3X_TRANSCRIPT_RECORD_I2C_WRITE, data, length, i2c_addr, cb, cb_user_data);
+    recorder->cfg.i2c_write(data, length, i2c_addr, recorder->cfg.i2c_write_user_data, record_i2c_complete_cb,
+                            recorder);
+}
+
+void sht3x_transcript_record_i2c_read(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                                      SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data)
+{
+    SHT3XTranscriptRecorder *recorder = (SHT3XTranscriptRecorder *)user_data;
+    if (!recorder) {
+        return;
+    }
+
+    begin_i2c(recorder, SHT3X_TRANSCRIPT_RECORD_I2C_READ, data, length, i2c_addr, cb, cb_user_data);
+    recorder->cfg.i2c_read(data, length, i2c_addr, recorder->cfg.i2c_read_user_data, record_i2c_complete_cb, recorder);
+}
+
+void sht3x_transcript_record_start_timer(uint32_t duration_ms, void *user_data, SHT3XTimerExpiredCb cb,
+                                         void *cb_user_data)
+{
+    SHT3XTranscriptRecorder *recorder = (SHT3XTranscriptRecorder *)user_data;
+    if (!recorder) {
+        return;
+    }
+
+    recorder->timer_cb = cb;
+    recorder->timer_cb_user_data = cb_user_data;
+    recorder->timer_duration_ms = duration_ms;
+    recorder->timer_start_us = recorder_now(recorder);
+    recorder->cfg.start_timer(duration_ms, recorder->cfg.start_timer_user_data, record_timer_expired_cb, recorder);
+}
+
+uint8_t sht3x_transcript_recorder_get_length(const SHT3XTranscriptRecorder *const recorder, size_t *const length)
+{
+    if (!recorder || !length) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    *length = recorder->length;
+    return recorder->truncated ? SHT3X_RESULT_CODE_OUT_OF_MEMORY : SHT3X_RESULT_CODE_OK;
+}
+
+/**
+ * @brief Get the size of the next record of a replay.
+ *
+ * @param[in] replay Transcript replay.
+ * @param[out] type Type of the next record is written here.
+ *
+ * @return size_t Size of the next record in bytes, or 0 if there are no more records or the next one is truncated.
+ */
+static size_t get_next_record(const SHT3XTranscriptReplay *replay, uint8_t *type)
+{
+    size_t remaining = replay->length - replay->pos;
+    const uint8_t *record = &(replay->transcript[replay->pos]);
+    size_t size = 0;
+    if (remaining == 0) {
+        return 0;
+    }
+
+    *type = record[SHT3X_TRANSCRIPT_TYPE_OFFSET];
+    if ((*type == SHT3X_TRANSCRIPT_RECORD_I2C_WRITE) || (*type == SHT3X_TRANSCRIPT_RECORD_I2C_READ)) {
+        if (remaining < SHT3X_TRANSCRIPT_I2C_RECORD_OVERHEAD) {
+            return 0;
+        }
+        size = SHT3X_TRANSCRIPT_I2C_RECORD_OVERHEAD + record[SHT3X_TRANSCRIPT_I2C_LENGTH_OFFSET];
+    } else if (*type == SHT3X_TRANSCRIPT_RECORD_TIMER) {
+        size = SHT3X_TRANSCRIPT_TIMER_RECORD_SIZE;
+    }
+    return (size <= remaining) ? size : 0;
+}
+
+/**
+ * @brief Replay an I2C transaction.
+ *
+ * @param[in] replay Transcript replay.
+ * @param[in] type @ref SHT3X_TRANSCRIPT_RECORD_I2C_WRITE or @ref SHT3X_TRANSCRIPT_RECORD_I2C_READ.
+ * @param[in,out] data Written data is compared to the record, read data is copied from the record.
+ * @param[in] length Number of bytes in @p data.
+ * @param[in] i2c_addr I2C address.
+ * @param[in] cb Driver callback to execute from @ref sht3x_transcript_replay_complete.
+ * @param[in] cb_user_data User data to pass to @p cb.
+ */
+static void replay_i2c(SHT3XTranscriptReplay *replay, uint8_t type, uint8_t *data, size_t length, uint8_t i2c_addr,
+                       SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data)
+{
+    replay->pending_type = type;
+    replay->i2c_cb = cb;
+    replay->cb_user_data = cb_user_data;
+    replay->i2c_result_code = SHT3X_I2C_RESULT_CODE_BUS_ERROR;
+    replay->pending_duration_us = 0;
+
+    uint8_t record_type = SHT3X_TRANSCRIPT_RECORD_NONE;
+    size_t record_size = get_next_record(replay, &record_type);
+    const uint8_t *record = &(replay->transcript[replay->pos]);
+    // clang-format off
+    bool match = (
+        (record_size > 0)
+        && (record_type == type)
+        && (record[SHT3X_TRANSCRIPT_I2C_ADDR_OFFSET] == i2c_addr)
+        && (record[SHT3X_TRANSCRIPT_I2C_LENGTH_OFFSET] == length)
+    );
+    // clang-format on
+    if ((record_size > 0) && (record_type == type)) {
+        /* Consume the record even if it does not match, so that the replay stays in step with the transcript */
+        replay->pos += record_size;
+        replay->pending_duration_us = read_u32(&record[SHT3X_TRANSCRIPT_DURATION_OFFSET]);
+    }
+    for (size_t i = 0; match && (i < length); i++) {
+        if (type == SHT3X_TRANSCRIPT_RECORD_I2C_READ) {
+            data[i] = record[SHT3X_TRANSCRIPT_I2C_DATA_OFFSET + i];
+        } else if (data[i] != record[SHT3X_TRANSCRIPT_I2C_DATA_OFFSET + i]) {
+            match = false;
+        }
+    }
+
+    if (match) {
+        replay->i2c_result_code = record[SHT3X_TRANSCRIPT_I2C_RESULT_CODE_OFFSET];
+    } else if (replay->mismatches < UINT32_MAX) {
+        replay->mismatches++;
+    }
+}
+
+uint8_t sht3x_transcript_replay_init(SHT3XTranscriptReplay *const replay, const uint8_t *const transcript,
+                                     size_t length)
+{
+    if (!replay || !transcript || (length < SHT3X_TRANSCRIPT_HEADER_SIZE)) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (transcript[0] != SHT3X_TRANSCRIPT_VERSION) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+
+    replay->transcript = transcript;
+    replay->length = length;
+    replay->pos = SHT3X_TRANSCRIPT_HEADER_SIZE;
+    replay->mismatches = 0;
+    replay->pending_type = SHT3X_TRANSCRIPT_RECORD_NONE;
+    replay->i2c_cb = NULL;
+    replay->timer_cb = NULL;
+    replay->cb_user_data = NULL;
+    replay->i2c_result_code = SHT3X_I2C_RESULT_CODE_OK;
+    replay->pending_duration_us = 0;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+void sht3x_transcript_replay_i2c_write(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                                       SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data)
+{
+    SHT3XTranscriptReplay *replay = (SHT3XTranscriptReplay *)user_data;
+    if (!replay) {
+        return;
+    }
+    replay_i2c(replay, SHT3X_TRANSCRIPT_RECORD_I2C_WRITE, data, length, i2c_addr, cb, cb_user_data);
+}
+
+void sht3x_transcript_replay_i2c_read(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                                      SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data)
+{
+    SHT3XTranscriptReplay *replay = (SHT3XTranscriptReplay *)user_data;
+    if (!replay) {
+        return;
+    }
+    replay_i2c(replay, SHT3X_TRANSCRIPT_RECORD_I2C_READ, data, length, i2c_addr, cb, cb_user_data);
+}
+
+void sht3x_transcript_replay_start_timer(uint32_t duration_ms, void *user_data, SHT3XTimerExpiredCb cb,
+                                         void *cb_user_data)
+{
+    SHT3XTranscriptReplay *replay = (SHT3XTranscriptReplay *)user_data;
+    if (!replay) {
+        return;
+    }
+
+    replay->pending_type = SHT3X_TRANSCRIPT_RECORD_TIMER;
+    replay->timer_cb = cb;
+    replay->cb_user_data = cb_user_data;
+    /* Without a matching record, the timer expires after the requested period */
+    replay->pending_duration_us = duration_ms * 1000;
+
+    uint8_t record_type = SHT3X_TRANSCRIPT_RECORD_NONE;
+    size_t record_size = get_next_record(replay, &record_type);
+    const uint8_t *record = &(replay->transcript[replay->pos]);
+    bool match = false;
+    if ((record_size > 0) && (record_type == SHT3X_TRANSCRIPT_RECORD_TIMER)) {
+        replay->pos += record_size;
+        replay->pending_duration_us = read_u32(&record[SHT3X_TRANSCRIPT_DURATION_OFFSET]);
+        match = (read_u32(&record[SHT3X_TRANSCRIPT_TIMER_PERIOD_OFFSET]) == duration_ms);
+    }
+    if (!match && (replay->mismatches < UINT32_MAX)) {
+        replay->mismatches++;
+    }
+}
+
+uint8_t sht3x_transcript_replay_get_pending(const SHT3XTranscriptReplay *const replay, uint32_t *const duration_us)
+{
+    if (!replay || !duration_us) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (replay->pending_type == SHT3X_TRANSCRIPT_RECORD_NONE) {
+        return SHT3X_RESULT_CODE_NO_DATA;
+    }
+    *duration_us = replay->pending_duration_us;
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_transcript_replay_complete(SHT3XTranscriptReplay *const replay)
+{
+    if (!replay) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    if (replay->pending_type == SHT3X_TRANSCRIPT_RECORD_NONE) {
+        return SHT3X_RESULT_CODE_NO_DATA;
+    }
+
+    /* Clear the pending completion first, the callback may start the next transaction or timer */
+    uint8_t type = replay->pending_type;
+    SHT3X_I2CTransactionCompleteCb i2c_cb = replay->i2c_cb;
+    SHT3XTimerExpiredCb timer_cb = replay->timer_cb;
+    void *cb_user_data = replay->cb_user_data;
+    replay->pending_type = SHT3X_TRANSCRIPT_RECORD_NONE;
+    replay->i2c_cb = NULL;
+    replay->timer_cb = NULL;
+    replay->cb_user_data = NULL;
+
+    if (type == SHT3X_TRANSCRIPT_RECORD_TIMER) {
+        if (timer_cb) {
+            timer_cb(cb_user_data);
+        }
+    } else if (i2c_cb) {
+        i2c_cb(replay->i2c_result_code, cb_user_data);
+    }
+    return SHT3X_RESULT_CODE_OK;
+}
+
+uint8_t sht3x_transcript_replay_get_status(const SHT3XTranscriptReplay *const replay, bool *const done,
+                                           uint32_t *const mismatches)
+{
+    if (!replay || !done || !mismatches) {
+        return SHT3X_RESULT_CODE_INVALID_ARG;
+    }
+    *done = (replay->pos >= replay->length) && (replay->pending_type == SHT3X_TRANSCRIPT_RECORD_NONE);
+    *mismatches = replay->mismatches;
+    return SHT3X_RESULT_CODE_OK;
+}
@@ -0,0 +1,252 @@
+#ifndef SRC_SHT3X_TRANSCRIPT_H
+#define SRC_SHT3X_TRANSCRIPT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sht3x.h"
+
+/**
+ * @brief Record and replay of I2C and timer transcripts.
+ *
+ * A transcript recorder wraps the i2c_write, i2c_read and start_timer functions of one instance, and appends a
+ * timestamped record of every completed transaction and expired timer to a caller-provided buffer: written data, read
+ * data, I2C result codes and timer periods. The caller can then store the transcript, e.g. in a file, and load it
+ * elsewhere, e.g. on a host.
+ *
+ * A transcript replay implements i2c_write, i2c_read and start_timer from a transcript, so that an instance can be run
+ * against recorded traffic without a sensor. Written data is compared to the recorded data, read data and result codes
+ * come from the transcript. Completions are not executed from within i2c_write, i2c_read or start_timer. Instead, the
+ * caller executes them with @ref sht3x_transcript_replay_complete: right away to replay at full speed, or after the
+ * recorded duration from @ref sht3x_transcript_replay_get_pending to replay in real time.
+ *
+ * A transcript starts with a @ref SHT3X_TRANSCRIPT_HEADER_SIZE byte header, followed by records. Each record starts
+ * with its type, the time since the recorder was initialized and the duration of the transaction or timer, in
+ * microseconds, as 32-bit big-endian values. I2C records add the address, the result code, the length and the data.
+ * Timer records add the requested period in ms.
+ */
+
+/** Size in bytes of the header at the start of a transcript. */
+#define SHT3X_TRANSCRIPT_HEADER_SIZE 2
+
+/** Size in bytes of an I2C record, without the data. */
+#define SHT3X_TRANSCRIPT_I2C_RECORD_OVERHEAD 12
+
+/** Size in bytes of a timer record. */
+#define SHT3X_TRANSCRIPT_TIMER_RECORD_SIZE 13
+
+/**
+ * @brief Get current time in microseconds.
+ *
+ * @param user_data User data from the transcript recorder config.
+ *
+ * @return uint32_t Current time in microseconds.
+ */
+typedef uint32_t (*SHT3XTranscriptGetTimeUs)(void *user_data);
+
+/** Transcript recorder config. */
+typedef struct {
+    /** Buffer that the transcript is written to. Must stay valid as long as the recorder is used. */
+    uint8_t *buf;
+    size_t size;
+    /** Functions that perform the transactions and timers, usually the ones that would otherwise be in the init
+     * config. */
+    SHT3X_I2CWrite i2c_write;
+    void *i2c_write_user_data;
+    SHT3X_I2CRead i2c_read;
+    void *i2c_read_user_data;
+    SHT3XStartTimer start_timer;
+    void *start_timer_user_data;
+    SHT3XTranscriptGetTimeUs get_time_us;
+    void *get_time_us_user_data;
+} SHT3XTranscriptRecorderConfig;
+
+/**
+ * @brief Transcript recorder state.
+ *
+ * Provided by the caller, and must stay valid as long as the instance that uses it. The fields are private and should
+ * not be modified by the caller.
+ */
+typedef struct {
+    SHT3XTranscriptRecorderConfig cfg;
+    /** Number of bytes written to buf. */
+    size_t length;
+    /** Set once a record did not fit into buf. No records are written after that. */
+    bool truncated;
+    uint32_t init_us;
+    /** I2C transaction in progress. */
+    SHT3X_I2CTransactionCompleteCb i2c_cb;
+    void *i2c_cb_user_data;
+    /** Reserved record of the transaction, NULL if it did not fit. */
+    uint8_t *i2c_record;
+    /** Driver buffer of a read, NULL for a write. */
+    uint8_t *i2c_read_data;
+    uint32_t i2c_start_us;
+    /** Timer in progress. */
+    SHT3XTimerExpiredCb timer_cb;
+    void *timer_cb_user_data;
+    uint32_t timer_duration_ms;
+    uint32_t timer_start_us;
+} SHT3XTranscriptRecorder;
+
+/**
+ * @brief Transcript replay state.
+ *
+ * Provided by the caller, and must stay valid as long as the instance that uses it. The fields are private and should
+ * not be modified by the caller.
+ */
+typedef struct {
+    const uint8_t *transcript;
+    size_t length;
+    /** Offset of the next record. */
+    size_t pos;
+    uint32_t mismatches;
+    /** Completion in progress. At most one, because the driver waits for each completion before the next step. */
+    uint8_t pending_type;
+    SHT3X_I2CTransactionCompleteCb i2c_cb;
+    SHT3XTimerExpiredCb timer_cb;
+    void *cb_user_data;
+    uint8_t i2c_result_code;
+    uint32_t pending_duration_us;
+} SHT3XTranscriptReplay;
+
+/**
+ * @brief Initialize a transcript recorder, and write the transcript header.
+ *
+ * @param[out] recorder Caller-provided memory for the recorder state.
+ * @param[in] cfg Recorder config. Copied into @p recorder.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p recorder or @p cfg is NULL, one of the functions in @p cfg is NULL, or the
+ * buffer is NULL or smaller than @ref SHT3X_TRANSCRIPT_HEADER_SIZE.
+ */
+uint8_t sht3x_transcript_recorder_init(SHT3XTranscriptRecorder *const recorder,
+                                       const SHT3XTranscriptRecorderConfig *const cfg);
+
+/**
+ * @brief I2C write that is recorded. Meant to be used as i2c_write in @ref SHT3XInitConfig.
+ *
+ * @p user_data must be the recorder. See @ref SHT3X_I2CWrite for the other parameters.
+ */
+void sht3x_transcript_record_i2c_write(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                                       SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data);
+
+/**
+ * @brief I2C read that is recorded. Meant to be used as i2c_read in @ref SHT3XInitConfig.
+ *
+ * @p user_data must be the recorder. See @ref SHT3X_I2CRead for the other parameters.
+ */
+void sht3x_transcript_record_i2c_read(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                                      SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data);
+
+/**
+ * @brief Timer that is recorded. Meant to be used as start_timer in @ref SHT3XInitConfig.
+ *
+ * @p user_data must be the recorder. See @ref SHT3XStartTimer for the other parameters.
+ */
+void sht3x_transcript_record_start_timer(uint32_t duration_ms, void *user_data, SHT3XTimerExpiredCb cb,
+                                         void *cb_user_data);
+
+/**
+ * @brief Get the length of the recorded transcript.
+ *
+ * @param[in] recorder Transcript recorder.
+ * @param[out] length Number of bytes of the transcript in the recorder buffer is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p recorder or @p length is NULL.
+ * @retval SHT3X_RESULT_CODE_OUT_OF_MEMORY The buffer filled up, and the transcript is missing the latest records. @p
+ * length is still written, and the transcript can be replayed up to that point.
+ */
+uint8_t sht3x_transcript_recorder_get_length(const SHT3XTranscriptRecorder *const recorder, size_t *const length);
+
+/**
+ * @brief Initialize a transcript replay.
+ *
+ * @param[out] replay Caller-provided memory for the replay state.
+ * @param[in] transcript Transcript written by a recorder. Must stay valid as long as the replay is used.
+ * @param[in] length Length of @p transcript in bytes.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p replay or @p transcript is NULL, or the transcript header is invalid.
+ */
+uint8_t sht3x_transcript_replay_init(SHT3XTranscriptReplay *const replay, const uint8_t *const transcript,
+                                     size_t length);
+
+/**
+ * @brief I2C write from a transcript. Meant to be used as i2c_write in @ref SHT3XInitConfig.
+ *
+ * If the next record is not a write of the same data to the same address, a mismatch is counted and the write
+ * completes with @ref SHT3X_I2C_RESULT_CODE_BUS_ERROR. @p user_data must be the replay. See @ref SHT3X_I2CWrite for
+ * the other parameters.
+ */
+void sht3x_transcript_replay_i2c_write(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                                       SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data);
+
+/**
+ * @brief I2C read from a transcript. Meant to be used as i2c_read in @ref SHT3XInitConfig.
+ *
+ * If the next record is not a read of the same length from the same address, a mismatch is counted and the read
+ * completes with @ref SHT3X_I2C_RESULT_CODE_BUS_ERROR. @p user_data must be the replay. See @ref SHT3X_I2CRead for the
+ * other parameters.
+ */
+void sht3x_transcript_replay_i2c_read(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                                      SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data);
+
+/**
+ * @brief Timer from a transcript. Meant to be used as start_timer in @ref SHT3XInitConfig.
+ *
+ * If the next record is not a timer of the same period, a mismatch is counted and the timer still expires. @p
+ * user_data must be the replay. See @ref SHT3XStartTimer for the other parameters.
+ */
+void sht3x_transcript_replay_start_timer(uint32_t duration_ms, void *user_data, SHT3XTimerExpiredCb cb,
+                                         void *cb_user_data);
+
+/**
+ * @brief Check if a completion is pending.
+ *
+ * @param[in] replay Transcript replay.
+ * @param[out] duration_us Recorded duration of the pending transaction or timer is written here. To replay in real
+ * time, wait this long before calling @ref sht3x_transcript_replay_complete.
+ *
+ * @retval SHT3X_RESULT_CODE_OK A completion is pending.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p replay or @p duration_us is NULL.
+ * @retval SHT3X_RESULT_CODE_NO_DATA No completion is pending.
+ */
+uint8_t sht3x_transcript_replay_get_pending(const SHT3XTranscriptReplay *const replay, uint32_t *const duration_us);
+
+/**
+ * @brief Execute the pending completion: the I2C complete callback or the timer expired callback.
+ *
+ * @param[in] replay Transcript replay.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG @p replay is NULL.
+ * @retval SHT3X_RESULT_CODE_NO_DATA No completion is pending.
+ */
+uint8_t sht3x_transcript_replay_complete(SHT3XTranscriptReplay *const replay);
+
+/**
+ * @brief Get the replay progress.
+ *
+ * @param[in] replay Transcript replay.
+ * @param[out] done true is written here if all records were replayed.
+ * @param[out] mismatches Number of transactions and timers that did not match the transcript is written here.
+ *
+ * @retval SHT3X_RESULT_CODE_OK Success.
+ * @retval SHT3X_RESULT_CODE_INVALID_ARG One of the pointers is NULL.
+ */
+uint8_t sht3x_transcript_replay_get_status(const SHT3XTranscriptReplay *const replay, bool *const done,
+                                           uint32_t *const mismatches);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHT3X_TRANSCRIPT_H */
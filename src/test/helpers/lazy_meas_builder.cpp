@@ -0,0 +1,13 @@
+#include <string.h>
+
+#include "lazy_meas_builder.h"
+
+SHT3XLazyMeasurement build_lazy_meas(uint8_t flags, uint16_t raw_temp, uint16_t raw_hum)
+{
+    SHT3XLazyMeasurement meas;
+    memset(&meas, 0, sizeof(meas));
+    meas.raw_temperature = raw_temp;
+    meas.raw_humidity = raw_hum;
+    meas.flags = flags;
+    return meas;
+}
@@ -0,0 +1,23 @@
+#ifndef SRC_TEST_HELPERS_LAZY_MEAS_BUILDER_H
+#define SRC_TEST_HELPERS_LAZY_MEAS_BUILDER_H
+
+#include "sht3x.h"
+
+/** Read both values and verify both CRCs. */
+#define SHT3X_TEST_ALL_FLAGS                                                                                           \
+    (SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM | SHT3X_FLAG_VERIFY_CRC_TEMP | SHT3X_FLAG_VERIFY_CRC_HUM)
+
+/**
+ * @brief Build a measurement the way the driver passes it to a lazy measurement complete callback.
+ *
+ * All other fields are zero.
+ *
+ * @param[in] flags Read flags that the measurement was read out with.
+ * @param[in] raw_temp Raw temperature ticks.
+ * @param[in] raw_hum Raw humidity ticks.
+ *
+ * @return SHT3XLazyMeasurement Measurement.
+ */
+SHT3XLazyMeasurement build_lazy_meas(uint8_t flags, uint16_t raw_temp, uint16_t raw_hum);
+
+#endif /* SRC_TEST_HELPERS_LAZY_MEAS_BUILDER_H */
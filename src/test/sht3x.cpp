@@ -41,6 +41,18 @@ static uint8_t meas_complete_cb_result_code;
 static SHT3XMeasurement meas_complete_cb_meas;
 static void *meas_complete_cb_user_data;
 
+static size_t lazy_meas_complete_cb_call_count;
+static uint8_t lazy_meas_complete_cb_result_code;
+static SHT3XLazyMeasurement lazy_meas_complete_cb_meas;
+static bool lazy_meas_complete_cb_meas_null;
+static void *lazy_meas_complete_cb_user_data;
+
+static size_t ext_meas_complete_cb_call_count;
+static uint8_t ext_meas_complete_cb_result_code;
+static SHT3XExtMeasurement ext_meas_complete_cb_meas;
+static bool ext_meas_complete_cb_meas_null;
+static void *ext_meas_complete_cb_user_data;
+
 static size_t complete_cb_call_count;
 static uint8_t complete_cb_result_code;
 static void *complete_cb_user_data;
@@ -60,6 +72,28 @@ static void sht3x_meas_complete_cb(uint8_t result_code, SHT3XMeasurement *meas,
     meas_complete_cb_user_data = user_data;
 }
 
+static void sht3x_lazy_meas_complete_cb(uint8_t result_code, SHT3XLazyMeasurement *meas, void *user_data)
+{
+    lazy_meas_complete_cb_call_count++;
+    lazy_meas_complete_cb_result_code = result_code;
+    lazy_meas_complete_cb_meas_null = (meas == NULL);
+    if (meas) {
+        memcpy(&lazy_meas_complete_cb_meas, meas, sizeof(SHT3XLazyMeasurement));
+    }
+    lazy_meas_complete_cb_user_data = user_data;
+}
+
+static void sht3x_ext_meas_complete_cb(uint8_t result_code, SHT3XExtMeasurement *meas, void *user_data)
+{
+    ext_meas_complete_cb_call_count++;
+    ext_meas_complete_cb_result_code = result_code;
+    ext_meas_complete_cb_meas_null = (meas == NULL);
+    if (meas) {
+        memcpy(&ext_meas_complete_cb_meas, meas, sizeof(SHT3XExtMeasurement));
+    }
+    ext_meas_complete_cb_user_data = user_data;
+}
+
 static void sht3x_complete_cb(uint8_t result_code, void *user_data)
 {
     complete_cb_call_count++;
@@ -67,6 +101,32 @@ static void sht3x_complete_cb(uint8_t result_code, void *user_data)
     complete_cb_user_data = user_data;
 }
 
+static size_t read_serial_number_complete_cb_call_count;
+static uint8_t read_serial_number_complete_cb_result_code;
+static uint32_t read_serial_number_complete_cb_serial_number;
+static void *read_serial_number_complete_cb_user_data;
+
+static void sht3x_read_serial_number_complete_cb(uint8_t result_code, uint32_t serial_number, void *user_data)
+{
+    read_serial_number_complete_cb_call_count++;
+    read_serial_number_complete_cb_result_code = result_code;
+    read_serial_number_complete_cb_serial_number = serial_number;
+    read_serial_number_complete_cb_user_data = user_data;
+}
+
+static size_t init_sequence_complete_cb_call_count;
+static uint8_t init_sequence_complete_cb_result_code;
+static uint32_t init_sequence_complete_cb_time_to_first_sample_ms;
+static void *init_sequence_complete_cb_user_data;
+
+static void sht3x_init_sequence_complete_cb(uint8_t result_code, uint32_t time_to_first_sample_ms, void *user_data)
+{
+    init_sequence_complete_cb_call_count++;
+    init_sequence_complete_cb_result_code = result_code;
+    init_sequence_complete_cb_time_to_first_sample_ms = time_to_first_sample_ms;
+    init_sequence_complete_cb_user_data = user_data;
+}
+
 static void sht3x_read_status_reg_complete_cb(uint8_t result_code, uint16_t reg_val, void *user_data)
 {
     read_status_reg_complete_cb_call_count++;
@@ -106,6 +166,20 @@ TEST_GROUP(SHT3X)
         memset(&meas_complete_cb_meas, 0, sizeof(SHT3XMeasurement));
         meas_complete_cb_user_data = NULL;
 
+        /* Reset values populated whenever sht3x_lazy_meas_complete_cb gets called */
+        lazy_meas_complete_cb_call_count = 0;
+        lazy_meas_complete_cb_result_code = 0xFF; /* 0 is a valid code, reset to an invalid code */
+        memset(&lazy_meas_complete_cb_meas, 0, sizeof(SHT3XLazyMeasurement));
+        lazy_meas_complete_cb_meas_null = false;
+        lazy_meas_complete_cb_user_data = NULL;
+
+        /* Reset values populated whenever sht3x_ext_meas_complete_cb gets called */
+        ext_meas_complete_cb_call_count = 0;
+        ext_meas_complete_cb_result_code = 0xFF; /* 0 is a valid code, reset to an invalid code */
+        memset(&ext_meas_complete_cb_meas, 0, sizeof(SHT3XExtMeasurement));
+        ext_meas_complete_cb_meas_null = false;
+        ext_meas_complete_cb_user_data = NULL;
+
         /* Reset values populated whenever sht3x_complete_cb gets called */
         complete_cb_call_count = 0;
         complete_cb_result_code = 0xFF; /* 0 is a valid code, reset to an invalid code */
@@ -116,6 +190,18 @@ TEST_GROUP(SHT3X)
         read_status_reg_complete_cb_result_code = 0xFF; /* 0 is a valid code, reset to an invalid code */
         read_status_reg_complete_cb_reg_val = 0x00FF;
         read_status_reg_complete_cb_user_data = NULL;
+
+        /* Reset values populated whenever sht3x_read_serial_number_complete_cb gets called */
+        read_serial_number_complete_cb_call_count = 0;
+        read_serial_number_complete_cb_result_code = 0xFF; /* 0 is a valid code, reset to an invalid code */
+        read_serial_number_complete_cb_serial_number = 0;
+        read_serial_number_complete_cb_user_data = NULL;
+
+        /* Reset values populated whenever sht3x_init_sequence_complete_cb gets called */
+        init_sequence_complete_cb_call_count = 0;
+        init_sequence_complete_cb_result_code = 0xFF; /* 0 is a valid code, reset to an invalid code */
+        init_sequence_complete_cb_time_to_first_sample_ms = 0;
+        init_sequence_complete_cb_user_data = NULL;
         
         sht3x = NULL;
         memset(&init_cfg, 0, sizeof(SHT3XInitConfig));
@@ -1566,7 +1652,7 @@ static void test_read_meas_wrong_crc(uint8_t *i2c_read_data, size_t length, uint
 
     mock()
         .expectOneCall("mock_sht3x_i2c_read")
-        .withOutputParameterReturning("data", i2c_read_data, sizeof(i2c_read_data))
+        .withOutputParameterReturning("data", i2c_read_data, length)
         .withParameter("length", length)
         .withParameter("i2c_addr", SHT3X_TEST_DEFAULT_I2C_ADDR)
         .withParameter("user_data", i2c_read_user_data)
@@ -3013,6 +3099,8 @@ static void test_busy_if_seq_in_progress(SHT3XFunction function)
     CHECK_EQUAL(0, complete_cb_call_count);
     CHECK_EQUAL(0, meas_complete_cb_call_count);
     CHECK_EQUAL(0, read_status_reg_complete_cb_call_count);
+    CHECK_EQUAL(0, read_serial_number_complete_cb_call_count);
+    CHECK_EQUAL(0, init_sequence_complete_cb_call_count);
 }
 
 static uint8_t send_single_shot_meas_cmd()
@@ -3768,3 +3856,1521 @@ TEST(SHT3X, ReadStatusRegSelfNull)
     CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, rc);
     CHECK_EQUAL(0, read_status_reg_complete_cb_call_count);
 }
+
+TEST(SHT3X, ReadPeriodicMeasLazyTempHumCrcTempCrcHum)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Fetch data command */
+    uint8_t i2c_write_data[] = {0xE0, 0x0};
+    mock()
+        .expectOneCall("mock_sht3x_i2c_write")
+        .withMemoryBufferParameter("data", i2c_write_data, 2)
+        .withParameter("length", 2)
+        .withParameter("i2c_addr", SHT3X_TEST_DEFAULT_I2C_ADDR)
+        .withParameter("user_data", i2c_write_user_data)
+        .ignoreOtherParameters();
+    mock()
+        .expectOneCall("mock_sht3x_start_timer")
+        .withParameter("duration_ms", 1)
+        .withParameter("user_data", start_timer_user_data)
+        .ignoreOtherParameters();
+    /* Taken from real device output, temp 22.25 Celsius, humidity 44.80 RH% */
+    uint8_t i2c_read_data[] = {0x62, 0x60, 0xB6, 0x72, 0xB3, 0x8F};
+    mock()
+        .expectOneCall("mock_sht3x_i2c_read")
+        .withOutputParameterReturning("data", i2c_read_data, sizeof(i2c_read_data))
+        .withParameter("length", 6)
+        .withParameter("i2c_addr", SHT3X_TEST_DEFAULT_I2C_ADDR)
+        .withParameter("user_data", i2c_read_user_data)
+        .ignoreOtherParameters();
+
+    uint8_t flags = SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM | SHT3X_FLAG_VERIFY_CRC_TEMP | SHT3X_FLAG_VERIFY_CRC_HUM;
+    void *user_data = (void *)0x3C;
+    uint8_t rc = sht3x_read_periodic_measurement_lazy(sht3x, flags, sht3x_lazy_meas_complete_cb, user_data);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    timer_expired_cb(timer_expired_cb_user_data);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+
+    CHECK_EQUAL(1, lazy_meas_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, lazy_meas_complete_cb_result_code);
+    POINTERS_EQUAL(user_data, lazy_meas_complete_cb_user_data);
+    CHECK_EQUAL(0x6260, lazy_meas_complete_cb_meas.raw_temperature);
+    CHECK_EQUAL(0x72B3, lazy_meas_complete_cb_meas.raw_humidity);
+    CHECK_EQUAL(flags, lazy_meas_complete_cb_meas.flags);
+    /* Nothing is converted until the values are requested */
+    CHECK_EQUAL(0, lazy_meas_complete_cb_meas.converted);
+
+    float temperature;
+    float humidity;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_lazy_meas_get_temperature(&lazy_meas_complete_cb_meas, &temperature));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_lazy_meas_get_humidity(&lazy_meas_complete_cb_meas, &humidity));
+    DOUBLES_EQUAL(22.25f, temperature, SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD);
+    DOUBLES_EQUAL(44.80f, humidity, SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD);
+}
+
+TEST(SHT3X, ReadPeriodicMeasLazyWrongCrcTemp)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    mock().expectOneCall("mock_sht3x_i2c_write").ignoreOtherParameters();
+    mock().expectOneCall("mock_sht3x_start_timer").ignoreOtherParameters();
+    /* Third byte modified to yield wrong temperature CRC */
+    uint8_t i2c_read_data[] = {0x62, 0x60, 0x88};
+    mock()
+        .expectOneCall("mock_sht3x_i2c_read")
+        .withOutputParameterReturning("data", i2c_read_data, sizeof(i2c_read_data))
+        .withParameter("length", 3)
+        .ignoreOtherParameters();
+
+    uint8_t rc = sht3x_read_periodic_measurement_lazy(sht3x, SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_VERIFY_CRC_TEMP,
+                                                      sht3x_lazy_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    timer_expired_cb(timer_expired_cb_user_data);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+
+    CHECK_EQUAL(1, lazy_meas_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_CRC_MISMATCH, lazy_meas_complete_cb_result_code);
+    CHECK_TRUE(lazy_meas_complete_cb_meas_null);
+}
+
+TEST(SHT3X, ReadSingleShotMeasLazyHum)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Single shot measurement with low repeatability and clock stretching disabled */
+    uint8_t i2c_write_data[] = {0x24, 0x16};
+    mock()
+        .expectOneCall("mock_sht3x_i2c_write")
+        .withMemoryBufferParameter("data", i2c_write_data, 2)
+        .withParameter("length", 2)
+        .withParameter("i2c_addr", SHT3X_TEST_DEFAULT_I2C_ADDR)
+        .withParameter("user_data", i2c_write_user_data)
+        .ignoreOtherParameters();
+    mock()
+        .expectOneCall("mock_sht3x_start_timer")
+        .withParameter("duration_ms", 5)
+        .withParameter("user_data", start_timer_user_data)
+        .ignoreOtherParameters();
+    uint8_t i2c_read_data[] = {0x62, 0x60, 0xB6, 0x72, 0xB3};
+    mock()
+        .expectOneCall("mock_sht3x_i2c_read")
+        .withOutputParameterReturning("data", i2c_read_data, sizeof(i2c_read_data))
+        .withParameter("length", 5)
+        .withParameter("i2c_addr", SHT3X_TEST_DEFAULT_I2C_ADDR)
+        .withParameter("user_data", i2c_read_user_data)
+        .ignoreOtherParameters();
+
+    uint8_t rc = sht3x_read_single_shot_measurement_lazy(sht3x, SHT3X_MEAS_REPEATABILITY_LOW,
+                                                         SHT3X_CLOCK_STRETCHING_DISABLED, SHT3X_FLAG_READ_HUM,
+                                                         sht3x_lazy_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    timer_expired_cb(timer_expired_cb_user_data);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+
+    CHECK_EQUAL(1, lazy_meas_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, lazy_meas_complete_cb_result_code);
+    CHECK_EQUAL(0x72B3, lazy_meas_complete_cb_meas.raw_humidity);
+
+    /* Temperature was not read out */
+    float temperature;
+    uint8_t rc_get_temperature = sht3x_lazy_meas_get_temperature(&lazy_meas_complete_cb_meas, &temperature);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, rc_get_temperature);
+    float humidity;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_lazy_meas_get_humidity(&lazy_meas_complete_cb_meas, &humidity));
+    DOUBLES_EQUAL(44.80f, humidity, SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD);
+}
+
+TEST(SHT3X, ReadMeasurementLazyAddressNack)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    mock().expectOneCall("mock_sht3x_i2c_read").withParameter("length", 2).ignoreOtherParameters();
+
+    void *user_data = (void *)0x3D;
+    uint8_t rc = sht3x_read_measurement_lazy(sht3x, SHT3X_FLAG_READ_TEMP, sht3x_lazy_meas_complete_cb, user_data);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_ADDRESS_NACK, i2c_read_complete_cb_user_data);
+
+    CHECK_EQUAL(1, lazy_meas_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, lazy_meas_complete_cb_result_code);
+    CHECK_TRUE(lazy_meas_complete_cb_meas_null);
+    POINTERS_EQUAL(user_data, lazy_meas_complete_cb_user_data);
+}
+
+TEST(SHT3X, ReadMeasurementLazyInvalidFlags)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    uint8_t rc = sht3x_read_measurement_lazy(sht3x, SHT3X_FLAG_VERIFY_CRC_TEMP, sht3x_lazy_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, rc);
+    CHECK_EQUAL(0, lazy_meas_complete_cb_call_count);
+}
+
+static void expect_i2c_write_cmd(uint8_t *i2c_write_data)
+{
+    mock()
+        .expectOneCall("mock_sht3x_i2c_write")
+        .withMemoryBufferParameter("data", i2c_write_data, 2)
+        .withParameter("length", 2)
+        .withParameter("i2c_addr", SHT3X_TEST_DEFAULT_I2C_ADDR)
+        .withParameter("user_data", i2c_write_user_data)
+        .ignoreOtherParameters();
+}
+
+static void read_status_reg_no_crc(uint8_t *i2c_read_data)
+{
+    /* Read status reg command */
+    uint8_t i2c_write_data[] = {0xF3, 0x2D};
+    expect_i2c_write_cmd(i2c_write_data);
+    mock().expectOneCall("mock_sht3x_start_timer").ignoreOtherParameters();
+    mock()
+        .expectOneCall("mock_sht3x_i2c_read")
+        .withOutputParameterReturning("data", i2c_read_data, 2)
+        .withParameter("length", 2)
+        .ignoreOtherParameters();
+
+    uint8_t rc = sht3x_read_status_register(sht3x, SHT3X_VERIFY_CRC_NO, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    timer_expired_cb(timer_expired_cb_user_data);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+}
+
+TEST(SHT3X, ShadowStateUnknownAfterCreate)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    SHT3XShadowState state;
+    uint8_t rc = sht3x_get_shadow_state(sht3x, &state);
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(SHT3X_HEATER_STATE_UNKNOWN, state.heater_state);
+    CHECK_EQUAL(SHT3X_MEAS_MODE_UNKNOWN, state.meas_mode);
+    CHECK_FALSE(state.status_reg_valid);
+}
+
+TEST(SHT3X, GetShadowStateNull)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    SHT3XShadowState state;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_get_shadow_state(NULL, &state));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_get_shadow_state(sht3x, NULL));
+}
+
+TEST(SHT3X, EnableHeaterElidedWhenHeaterKnownOn)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Enable heater command - sent only once */
+    uint8_t i2c_write_data[] = {0x30, 0x6D};
+    expect_i2c_write_cmd(i2c_write_data);
+
+    uint8_t rc = sht3x_enable_heater(sht3x, sht3x_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    CHECK_EQUAL(1, complete_cb_call_count);
+
+    void *user_data = (void *)0x3A;
+    rc = sht3x_enable_heater(sht3x, sht3x_complete_cb, user_data);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    /* Complete cb executed before sht3x_enable_heater returned */
+    CHECK_EQUAL(2, complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, complete_cb_result_code);
+    POINTERS_EQUAL(user_data, complete_cb_user_data);
+
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_EQUAL(SHT3X_HEATER_STATE_ON, state.heater_state);
+}
+
+TEST(SHT3X, EnableHeaterSentAgainAfterFailure)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Enable heater command */
+    uint8_t i2c_write_data[] = {0x30, 0x6D};
+    expect_i2c_write_cmd(i2c_write_data);
+    expect_i2c_write_cmd(i2c_write_data);
+
+    uint8_t rc = sht3x_enable_heater(sht3x, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_BUS_ERROR, i2c_write_complete_cb_user_data);
+
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_EQUAL(SHT3X_HEATER_STATE_UNKNOWN, state.heater_state);
+
+    rc = sht3x_enable_heater(sht3x, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+}
+
+TEST(SHT3X, DisableHeaterSentAfterEnable)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Enable heater command */
+    uint8_t i2c_write_data_enable[] = {0x30, 0x6D};
+    expect_i2c_write_cmd(i2c_write_data_enable);
+    /* Disable heater command */
+    uint8_t i2c_write_data_disable[] = {0x30, 0x66};
+    expect_i2c_write_cmd(i2c_write_data_disable);
+
+    sht3x_enable_heater(sht3x, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    sht3x_disable_heater(sht3x, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    /* Heater known to be off - elided */
+    uint8_t rc = sht3x_disable_heater(sht3x, sht3x_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(1, complete_cb_call_count);
+}
+
+TEST(SHT3X, StartPeriodicMeasElidedWithSameOptions)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Start periodic meas, high repeatability, 1 mps */
+    uint8_t i2c_write_data[] = {0x21, 0x30};
+    expect_i2c_write_cmd(i2c_write_data);
+    /* Start periodic meas, high repeatability, 2 mps */
+    uint8_t i2c_write_data_2_mps[] = {0x22, 0x36};
+    expect_i2c_write_cmd(i2c_write_data_2_mps);
+
+    sht3x_start_periodic_measurement(sht3x, SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_MPS_1, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    uint8_t rc = sht3x_start_periodic_measurement(sht3x, SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_MPS_1,
+                                                  sht3x_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(1, complete_cb_call_count);
+
+    /* Different options - sent */
+    rc = sht3x_start_periodic_measurement(sht3x, SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_MPS_2, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_EQUAL(SHT3X_MEAS_MODE_PERIODIC, state.meas_mode);
+    CHECK_EQUAL(SHT3X_MEAS_REPEATABILITY_HIGH, state.repeatability);
+    CHECK_EQUAL(SHT3X_MPS_2, state.mps);
+}
+
+TEST(SHT3X, StartPeriodicMeasArtElidedWhenArtRunning)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* ART command */
+    uint8_t i2c_write_data[] = {0x2B, 0x32};
+    expect_i2c_write_cmd(i2c_write_data);
+
+    sht3x_start_periodic_measurement_art(sht3x, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    uint8_t rc = sht3x_start_periodic_measurement_art(sht3x, sht3x_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(1, complete_cb_call_count);
+}
+
+TEST(SHT3X, StopPeriodicMeasElidedAfterSoftReset)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Soft reset command */
+    uint8_t i2c_write_data[] = {0x30, 0xA2};
+    expect_i2c_write_cmd(i2c_write_data);
+
+    sht3x_soft_reset(sht3x, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_EQUAL(SHT3X_HEATER_STATE_OFF, state.heater_state);
+    CHECK_EQUAL(SHT3X_MEAS_MODE_SINGLE_SHOT, state.meas_mode);
+    CHECK_TRUE(state.status_reg_valid);
+    CHECK_EQUAL(0x8010, state.status_reg);
+
+    uint8_t rc = sht3x_stop_periodic_measurement(sht3x, sht3x_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(1, complete_cb_call_count);
+    rc = sht3x_disable_heater(sht3x, sht3x_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(2, complete_cb_call_count);
+}
+
+TEST(SHT3X, ClearStatusRegUpdatesShadowStatusReg)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Soft reset command */
+    uint8_t i2c_write_data_reset[] = {0x30, 0xA2};
+    expect_i2c_write_cmd(i2c_write_data_reset);
+    /* Clear status register command */
+    uint8_t i2c_write_data_clear[] = {0x30, 0x41};
+    expect_i2c_write_cmd(i2c_write_data_clear);
+
+    sht3x_soft_reset(sht3x, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    sht3x_clear_status_register(sht3x, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_TRUE(state.status_reg_valid);
+    CHECK_EQUAL(0, state.status_reg);
+}
+
+TEST(SHT3X, ReadStatusRegUpdatesShadowState)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Heater on */
+    uint8_t i2c_read_data[] = {0x20, 0x00};
+    read_status_reg_no_crc(i2c_read_data);
+
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_TRUE(state.status_reg_valid);
+    CHECK_EQUAL(0x2000, state.status_reg);
+    CHECK_EQUAL(SHT3X_HEATER_STATE_ON, state.heater_state);
+
+    /* Heater known to be on - elided */
+    uint8_t rc = sht3x_enable_heater(sht3x, sht3x_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(1, complete_cb_call_count);
+}
+
+TEST(SHT3X, ReadStatusRegUnexpectedResetInvalidatesMeasMode)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* ART command */
+    uint8_t i2c_write_data[] = {0x2B, 0x32};
+    expect_i2c_write_cmd(i2c_write_data);
+    sht3x_start_periodic_measurement_art(sht3x, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    /* System reset detected flag set */
+    uint8_t i2c_read_data[] = {0x00, 0x10};
+    read_status_reg_no_crc(i2c_read_data);
+
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_EQUAL(SHT3X_MEAS_MODE_UNKNOWN, state.meas_mode);
+    CHECK_EQUAL(SHT3X_HEATER_STATE_OFF, state.heater_state);
+    CHECK_TRUE(state.status_reg_valid);
+}
+
+TEST(SHT3X, ReadStatusRegExpectedResetKeepsMeasMode)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Soft reset command */
+    uint8_t i2c_write_data[] = {0x30, 0xA2};
+    expect_i2c_write_cmd(i2c_write_data);
+    sht3x_soft_reset(sht3x, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    /* Alert pending and system reset detected flags set - the reset was initiated by the driver */
+    uint8_t i2c_read_data[] = {0x80, 0x10};
+    read_status_reg_no_crc(i2c_read_data);
+
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_EQUAL(SHT3X_MEAS_MODE_SINGLE_SHOT, state.meas_mode);
+}
+
+TEST(SHT3X, InvalidateShadowState)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Enable heater command */
+    uint8_t i2c_write_data[] = {0x30, 0x6D};
+    expect_i2c_write_cmd(i2c_write_data);
+    expect_i2c_write_cmd(i2c_write_data);
+
+    sht3x_enable_heater(sht3x, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    uint8_t rc = sht3x_invalidate_shadow_state(sht3x);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+    /* Heater state unknown - sent again */
+    rc = sht3x_enable_heater(sht3x, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+    /* Sequence in progress */
+    rc = sht3x_invalidate_shadow_state(sht3x);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_BUSY, rc);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_invalidate_shadow_state(NULL));
+}
+
+static void start_periodic_meas_art_successfully()
+{
+    /* ART command */
+    uint8_t i2c_write_data[] = {0x2B, 0x32};
+    expect_i2c_write_cmd(i2c_write_data);
+    uint8_t rc = sht3x_start_periodic_measurement_art(sht3x, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+}
+
+static void soft_reset_successfully()
+{
+    /* Soft reset command */
+    uint8_t i2c_write_data[] = {0x30, 0xA2};
+    expect_i2c_write_cmd(i2c_write_data);
+    uint8_t rc = sht3x_soft_reset(sht3x, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+}
+
+TEST(SHT3X, SendSingleShotMeasCmdWrongModePeriodic)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Start periodic meas, high repeatability, 1 mps */
+    uint8_t i2c_write_data[] = {0x21, 0x30};
+    expect_i2c_write_cmd(i2c_write_data);
+    sht3x_start_periodic_measurement(sht3x, SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_MPS_1, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    uint8_t rc = sht3x_send_single_shot_measurement_cmd(sht3x, SHT3X_MEAS_REPEATABILITY_HIGH,
+                                                        SHT3X_CLOCK_STRETCHING_DISABLED, sht3x_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_WRONG_MODE, rc);
+    CHECK_EQUAL(0, complete_cb_call_count);
+}
+
+TEST(SHT3X, ReadSingleShotMeasWrongModeArt)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+    start_periodic_meas_art_successfully();
+
+    uint8_t rc = sht3x_read_single_shot_measurement(sht3x, SHT3X_MEAS_REPEATABILITY_HIGH,
+                                                    SHT3X_CLOCK_STRETCHING_DISABLED, SHT3X_FLAG_READ_TEMP,
+                                                    sht3x_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_WRONG_MODE, rc);
+    rc = sht3x_read_single_shot_measurement_lazy(sht3x, SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_CLOCK_STRETCHING_DISABLED,
+                                                 SHT3X_FLAG_READ_TEMP, sht3x_lazy_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_WRONG_MODE, rc);
+    CHECK_EQUAL(0, meas_complete_cb_call_count);
+    CHECK_EQUAL(0, lazy_meas_complete_cb_call_count);
+}
+
+TEST(SHT3X, SendSingleShotMeasCmdAllowedAfterStop)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+    start_periodic_meas_art_successfully();
+
+    /* Stop periodic meas command */
+    uint8_t i2c_write_data_stop[] = {0x30, 0x93};
+    expect_i2c_write_cmd(i2c_write_data_stop);
+    /* Single shot meas with high repeatability and clock stretching disabled command */
+    uint8_t i2c_write_data_single_shot[] = {0x24, 0x00};
+    expect_i2c_write_cmd(i2c_write_data_single_shot);
+
+    sht3x_stop_periodic_measurement(sht3x, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    uint8_t rc = sht3x_send_single_shot_measurement_cmd(sht3x, SHT3X_MEAS_REPEATABILITY_HIGH,
+                                                        SHT3X_CLOCK_STRETCHING_DISABLED, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+}
+
+TEST(SHT3X, FetchPeriodicMeasDataWrongModeSingleShot)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+    soft_reset_successfully();
+
+    uint8_t rc = sht3x_fetch_periodic_measurement_data(sht3x, sht3x_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_WRONG_MODE, rc);
+    CHECK_EQUAL(0, complete_cb_call_count);
+}
+
+TEST(SHT3X, ReadPeriodicMeasWrongModeSingleShot)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+    soft_reset_successfully();
+
+    uint8_t rc = sht3x_read_periodic_measurement(sht3x, SHT3X_FLAG_READ_TEMP, sht3x_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_WRONG_MODE, rc);
+    rc = sht3x_read_periodic_measurement_lazy(sht3x, SHT3X_FLAG_READ_TEMP, sht3x_lazy_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_WRONG_MODE, rc);
+    CHECK_EQUAL(0, meas_complete_cb_call_count);
+    CHECK_EQUAL(0, lazy_meas_complete_cb_call_count);
+}
+
+static void expect_issued_meas(uint8_t *i2c_write_data, uint32_t timer_period, uint8_t *i2c_read_data,
+                               size_t i2c_data_len)
+{
+    expect_i2c_write_cmd(i2c_write_data);
+    mock()
+        .expectOneCall("mock_sht3x_start_timer")
+        .withParameter("duration_ms", timer_period)
+        .withParameter("user_data", start_timer_user_data)
+        .ignoreOtherParameters();
+    mock()
+        .expectOneCall("mock_sht3x_i2c_read")
+        .withOutputParameterReturning("data", i2c_read_data, i2c_data_len)
+        .withParameter("length", i2c_data_len)
+        .withParameter("i2c_addr", SHT3X_TEST_DEFAULT_I2C_ADDR)
+        .withParameter("user_data", i2c_read_user_data)
+        .ignoreOtherParameters();
+}
+
+static void complete_issued_meas()
+{
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    timer_expired_cb(timer_expired_cb_user_data);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+}
+
+TEST(SHT3X, IssuePreparedSingleShotMeasTwice)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    SHT3XPreparedMeas prepared;
+    uint8_t rc = sht3x_prepare_single_shot_measurement(SHT3X_MEAS_REPEATABILITY_MEDIUM, SHT3X_CLOCK_STRETCHING_DISABLED,
+                                                       SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM, &prepared);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+    /* Single shot meas with medium repeatability and clock stretching disabled command */
+    uint8_t i2c_write_data[] = {0x24, 0x0B};
+    /* Taken from real device output, temp 22.31 Celsius, humidity 45.24 RH% */
+    uint8_t i2c_read_data[] = {0x62, 0x76, 0x53, 0x73, 0xD3};
+    expect_issued_meas(i2c_write_data, 7, i2c_read_data, 5);
+    expect_issued_meas(i2c_write_data, 7, i2c_read_data, 5);
+
+    void *user_data = (void *)0x81;
+    for (size_t i = 0; i < 2; i++) {
+        rc = sht3x_issue(sht3x, &prepared, sht3x_meas_complete_cb, user_data);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+        complete_issued_meas();
+
+        CHECK_EQUAL(i + 1, meas_complete_cb_call_count);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, meas_complete_cb_result_code);
+        POINTERS_EQUAL(user_data, meas_complete_cb_user_data);
+        DOUBLES_EQUAL(22.31, meas_complete_cb_meas.temperature, SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD);
+        DOUBLES_EQUAL(45.24, meas_complete_cb_meas.humidity, SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD);
+    }
+}
+
+TEST(SHT3X, IssueLazyPreparedPeriodicMeas)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    SHT3XPreparedMeas prepared;
+    uint8_t rc = sht3x_prepare_periodic_measurement(SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_VERIFY_CRC_TEMP, &prepared);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+    /* Fetch data command */
+    uint8_t i2c_write_data[] = {0xE0, 0x00};
+    /* Taken from real device output, temp 22.25 Celsius */
+    uint8_t i2c_read_data[] = {0x62, 0x60, 0xB6};
+    expect_issued_meas(i2c_write_data, 1, i2c_read_data, 3);
+
+    rc = sht3x_issue_lazy(sht3x, &prepared, sht3x_lazy_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    complete_issued_meas();
+
+    CHECK_EQUAL(1, lazy_meas_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, lazy_meas_complete_cb_result_code);
+    CHECK_EQUAL(0x6260, lazy_meas_complete_cb_meas.raw_temperature);
+}
+
+TEST(SHT3X, ReadSingleShotMeasExtQuality)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Single shot measurement with low repeatability and clock stretching disabled */
+    uint8_t i2c_write_data[] = {0x24, 0x16};
+    /* Taken from real device output, temp 22.25 Celsius, humidity 44.80 RH% */
+    uint8_t i2c_read_data[] = {0x62, 0x60, 0xB6, 0x72, 0xB3, 0x8F};
+    expect_issued_meas(i2c_write_data, 5, i2c_read_data, 6);
+
+    uint8_t flags = SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM | SHT3X_FLAG_VERIFY_CRC_TEMP | SHT3X_FLAG_VERIFY_CRC_HUM;
+    void *user_data = (void *)0x3E;
+    uint8_t rc = sht3x_read_single_shot_measurement_ext(sht3x, SHT3X_MEAS_REPEATABILITY_LOW,
+                                                        SHT3X_CLOCK_STRETCHING_DISABLED, flags,
+                                                        sht3x_ext_meas_complete_cb, user_data);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    complete_issued_meas();
+
+    CHECK_EQUAL(1, ext_meas_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, ext_meas_complete_cb_result_code);
+    POINTERS_EQUAL(user_data, ext_meas_complete_cb_user_data);
+    DOUBLES_EQUAL(22.25f, ext_meas_complete_cb_meas.temperature, SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD);
+    DOUBLES_EQUAL(44.80f, ext_meas_complete_cb_meas.humidity, SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD);
+    uint16_t quality = ext_meas_complete_cb_meas.quality;
+    CHECK_EQUAL(flags, sht3x_quality_get_flags(quality));
+    CHECK_EQUAL(SHT3X_HEATER_STATE_UNKNOWN, sht3x_quality_get_heater_state(quality));
+    CHECK_EQUAL(SHT3X_MEAS_MODE_SINGLE_SHOT, sht3x_quality_get_meas_mode(quality));
+    CHECK_EQUAL(SHT3X_MEAS_REPEATABILITY_LOW, sht3x_quality_get_repeatability(quality));
+    CHECK_EQUAL(0, sht3x_quality_get_retry_count(quality));
+    /* Measurement was complete at the latest when the delay before the readout elapsed */
+    CHECK_EQUAL(5, ext_meas_complete_cb_meas.sample_age_ms);
+}
+
+TEST(SHT3X, ReadPeriodicMeasExtQualityWithHeater)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Start periodic meas, high repeatability, 10 mps */
+    uint8_t i2c_write_data_start[] = {0x27, 0x37};
+    expect_i2c_write_cmd(i2c_write_data_start);
+    /* Enable heater command */
+    uint8_t i2c_write_data_heater[] = {0x30, 0x6D};
+    expect_i2c_write_cmd(i2c_write_data_heater);
+    sht3x_start_periodic_measurement(sht3x, SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_MPS_10, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    sht3x_enable_heater(sht3x, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    /* Fetch data command */
+    uint8_t i2c_write_data[] = {0xE0, 0x00};
+    /* Taken from real device output, temp 22.25 Celsius */
+    uint8_t i2c_read_data[] = {0x62, 0x60};
+    expect_issued_meas(i2c_write_data, 1, i2c_read_data, 2);
+
+    uint8_t rc = sht3x_read_periodic_measurement_ext(sht3x, SHT3X_FLAG_READ_TEMP, sht3x_ext_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    complete_issued_meas();
+
+    CHECK_EQUAL(1, ext_meas_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, ext_meas_complete_cb_result_code);
+    DOUBLES_EQUAL(22.25f, ext_meas_complete_cb_meas.temperature, SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD);
+    /* Humidity was not read out */
+    DOUBLES_EQUAL(0.0f, ext_meas_complete_cb_meas.humidity, SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD);
+    uint16_t quality = ext_meas_complete_cb_meas.quality;
+    /* CRC was skipped */
+    CHECK_EQUAL(SHT3X_FLAG_READ_TEMP, sht3x_quality_get_flags(quality));
+    CHECK_EQUAL(SHT3X_HEATER_STATE_ON, sht3x_quality_get_heater_state(quality));
+    CHECK_EQUAL(SHT3X_MEAS_MODE_PERIODIC, sht3x_quality_get_meas_mode(quality));
+    CHECK_EQUAL(SHT3X_MEAS_REPEATABILITY_HIGH, sht3x_quality_get_repeatability(quality));
+    /* One 100 ms period, plus the delay between fetch and readout */
+    CHECK_EQUAL(101, ext_meas_complete_cb_meas.sample_age_ms);
+}
+
+TEST(SHT3X, ReadPeriodicMeasLazyQualityArt)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+    start_periodic_meas_art_successfully();
+
+    /* Fetch data command */
+    uint8_t i2c_write_data[] = {0xE0, 0x00};
+    uint8_t i2c_read_data[] = {0x62, 0x60, 0xB6, 0x72, 0xB3, 0x8F};
+    expect_issued_meas(i2c_write_data, 1, i2c_read_data, 6);
+
+    uint8_t flags = SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM | SHT3X_FLAG_VERIFY_CRC_HUM;
+    uint8_t rc = sht3x_read_periodic_measurement_lazy(sht3x, flags, sht3x_lazy_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    complete_issued_meas();
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, lazy_meas_complete_cb_result_code);
+    uint16_t quality = lazy_meas_complete_cb_meas.quality;
+    CHECK_EQUAL(flags, sht3x_quality_get_flags(quality));
+    CHECK_EQUAL(SHT3X_MEAS_MODE_PERIODIC_ART, sht3x_quality_get_meas_mode(quality));
+    CHECK_EQUAL(SHT3X_QUALITY_REPEATABILITY_UNKNOWN, sht3x_quality_get_repeatability(quality));
+    /* ART samples at 4 Hz */
+    CHECK_EQUAL(251, lazy_meas_complete_cb_meas.sample_age_ms);
+}
+
+TEST(SHT3X, MeasQualityRetryCount)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    uint8_t i2c_read_data[] = {0x62, 0x60};
+    for (size_t i = 0; i < 2; i++) {
+        mock().expectOneCall("mock_sht3x_i2c_read").withParameter("length", 2).ignoreOtherParameters();
+        sht3x_read_measurement_lazy(sht3x, SHT3X_FLAG_READ_TEMP, sht3x_lazy_meas_complete_cb, NULL);
+        i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_ADDRESS_NACK, i2c_read_complete_cb_user_data);
+    }
+    for (size_t i = 0; i < 2; i++) {
+        mock()
+            .expectOneCall("mock_sht3x_i2c_read")
+            .withOutputParameterReturning("data", i2c_read_data, sizeof(i2c_read_data))
+            .withParameter("length", 2)
+            .ignoreOtherParameters();
+    }
+
+    uint8_t rc = sht3x_read_measurement_ext(sht3x, SHT3X_FLAG_READ_TEMP, sht3x_ext_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, ext_meas_complete_cb_result_code);
+    CHECK_EQUAL(2, sht3x_quality_get_retry_count(ext_meas_complete_cb_meas.quality));
+    /* Nothing is known about the device, and the measurement was not fetched by the driver */
+    CHECK_EQUAL(SHT3X_MEAS_MODE_UNKNOWN, sht3x_quality_get_meas_mode(ext_meas_complete_cb_meas.quality));
+    CHECK_EQUAL(SHT3X_QUALITY_REPEATABILITY_UNKNOWN,
+                sht3x_quality_get_repeatability(ext_meas_complete_cb_meas.quality));
+    CHECK_EQUAL(SHT3X_SAMPLE_AGE_UNKNOWN, ext_meas_complete_cb_meas.sample_age_ms);
+
+    /* Successful readout resets the count */
+    rc = sht3x_read_measurement_ext(sht3x, SHT3X_FLAG_READ_TEMP, sht3x_ext_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+    CHECK_EQUAL(0, sht3x_quality_get_retry_count(ext_meas_complete_cb_meas.quality));
+}
+
+TEST(SHT3X, MeasQualityRetryCountSaturates)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    for (size_t i = 0; i < (SHT3X_QUALITY_MAX_RETRY_COUNT + 3); i++) {
+        mock().expectOneCall("mock_sht3x_i2c_read").withParameter("length", 2).ignoreOtherParameters();
+        sht3x_read_measurement(sht3x, SHT3X_FLAG_READ_TEMP, sht3x_meas_complete_cb, NULL);
+        i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_BUS_ERROR, i2c_read_complete_cb_user_data);
+    }
+    uint8_t i2c_read_data[] = {0x62, 0x60};
+    mock()
+        .expectOneCall("mock_sht3x_i2c_read")
+        .withOutputParameterReturning("data", i2c_read_data, sizeof(i2c_read_data))
+        .withParameter("length", 2)
+        .ignoreOtherParameters();
+
+    sht3x_read_measurement_lazy(sht3x, SHT3X_FLAG_READ_TEMP, sht3x_lazy_meas_complete_cb, NULL);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, lazy_meas_complete_cb_result_code);
+    CHECK_EQUAL(SHT3X_QUALITY_MAX_RETRY_COUNT, sht3x_quality_get_retry_count(lazy_meas_complete_cb_meas.quality));
+}
+
+TEST(SHT3X, ReadMeasurementExtAddressNack)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    mock().expectOneCall("mock_sht3x_i2c_read").withParameter("length", 2).ignoreOtherParameters();
+
+    void *user_data = (void *)0x3F;
+    uint8_t rc = sht3x_read_measurement_ext(sht3x, SHT3X_FLAG_READ_TEMP, sht3x_ext_meas_complete_cb, user_data);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_ADDRESS_NACK, i2c_read_complete_cb_user_data);
+
+    CHECK_EQUAL(1, ext_meas_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, ext_meas_complete_cb_result_code);
+    CHECK_TRUE(ext_meas_complete_cb_meas_null);
+    POINTERS_EQUAL(user_data, ext_meas_complete_cb_user_data);
+}
+
+TEST(SHT3X, IssuePreparedMeasWrongMode)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+    start_periodic_meas_art_successfully();
+
+    SHT3XPreparedMeas prepared;
+    uint8_t rc = sht3x_prepare_single_shot_measurement(SHT3X_MEAS_REPEATABILITY_LOW, SHT3X_CLOCK_STRETCHING_ENABLED,
+                                                       SHT3X_FLAG_READ_HUM, &prepared);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+    rc = sht3x_issue(sht3x, &prepared, sht3x_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_WRONG_MODE, rc);
+    CHECK_EQUAL(0, meas_complete_cb_call_count);
+}
+
+TEST(SHT3X, IssueInvalidPreparedMeas)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    SHT3XPreparedMeas prepared;
+    memset(&prepared, 0, sizeof(prepared));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_issue(sht3x, &prepared, sht3x_meas_complete_cb, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_issue(sht3x, NULL, sht3x_meas_complete_cb, NULL));
+
+    uint8_t rc = sht3x_prepare_periodic_measurement(SHT3X_FLAG_READ_TEMP, &prepared);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_issue_lazy(NULL, &prepared, sht3x_lazy_meas_complete_cb, NULL));
+}
+
+static void test_read_serial_number(uint8_t i2c_write_rc, uint8_t *i2c_read_data, uint8_t i2c_read_rc,
+                                    uint8_t expected_rc, uint32_t expected_serial_number)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Read serial number command, clock stretching disabled */
+    uint8_t i2c_write_data[] = {0x37, 0x80};
+    expect_i2c_write_cmd(i2c_write_data);
+    if (i2c_write_rc == SHT3X_I2C_RESULT_CODE_OK) {
+        mock()
+            .expectOneCall("mock_sht3x_start_timer")
+            .withParameter("duration_ms", 1)
+            .withParameter("user_data", start_timer_user_data)
+            .ignoreOtherParameters();
+        mock()
+            .expectOneCall("mock_sht3x_i2c_read")
+            .withOutputParameterReturning("data", i2c_read_data, 6)
+            .withParameter("length", 6)
+            .withParameter("i2c_addr", SHT3X_TEST_DEFAULT_I2C_ADDR)
+            .withParameter("user_data", i2c_read_user_data)
+            .ignoreOtherParameters();
+    }
+
+    void *user_data = (void *)0x5E;
+    uint8_t rc = sht3x_read_serial_number(sht3x, sht3x_read_serial_number_complete_cb, user_data);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(i2c_write_rc, i2c_write_complete_cb_user_data);
+    if (i2c_write_rc == SHT3X_I2C_RESULT_CODE_OK) {
+        timer_expired_cb(timer_expired_cb_user_data);
+        i2c_read_complete_cb(i2c_read_rc, i2c_read_complete_cb_user_data);
+    }
+
+    CHECK_EQUAL(1, read_serial_number_complete_cb_call_count);
+    CHECK_EQUAL(expected_rc, read_serial_number_complete_cb_result_code);
+    CHECK_EQUAL(expected_serial_number, read_serial_number_complete_cb_serial_number);
+    POINTERS_EQUAL(user_data, read_serial_number_complete_cb_user_data);
+}
+
+TEST(SHT3X, ReadSerialNumber)
+{
+    uint8_t i2c_read_data[] = {0x12, 0x34, 0x37, 0x56, 0x78, 0x7D};
+    test_read_serial_number(SHT3X_I2C_RESULT_CODE_OK, i2c_read_data, SHT3X_I2C_RESULT_CODE_OK, SHT3X_RESULT_CODE_OK,
+                            0x12345678);
+}
+
+TEST(SHT3X, ReadSerialNumberWrongCrc)
+{
+    /* CRC of the second word is wrong */
+    uint8_t i2c_read_data[] = {0x12, 0x34, 0x37, 0x56, 0x78, 0x7E};
+    test_read_serial_number(SHT3X_I2C_RESULT_CODE_OK, i2c_read_data, SHT3X_I2C_RESULT_CODE_OK,
+                            SHT3X_RESULT_CODE_CRC_MISMATCH, 0);
+}
+
+TEST(SHT3X, ReadSerialNumberWriteAddressNack)
+{
+    test_read_serial_number(SHT3X_I2C_RESULT_CODE_ADDRESS_NACK, NULL, SHT3X_I2C_RESULT_CODE_OK,
+                            SHT3X_RESULT_CODE_IO_ERR, 0);
+}
+
+TEST(SHT3X, ReadSerialNumberReadAddressNack)
+{
+    uint8_t i2c_read_data[] = {0x12, 0x34, 0x37, 0x56, 0x78, 0x7D};
+    test_read_serial_number(SHT3X_I2C_RESULT_CODE_OK, i2c_read_data, SHT3X_I2C_RESULT_CODE_ADDRESS_NACK,
+                            SHT3X_RESULT_CODE_IO_ERR, 0);
+}
+
+TEST(SHT3X, ReadSerialNumberSelfNull)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    uint8_t rc = sht3x_read_serial_number(NULL, sht3x_read_serial_number_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, rc);
+}
+
+static uint8_t read_serial_number()
+{
+    return sht3x_read_serial_number(sht3x, NULL, NULL);
+}
+
+TEST(SHT3X, ReadSerialNumberBusy)
+{
+    test_busy_if_seq_in_progress(read_serial_number);
+}
+
+static void expect_timer(uint32_t duration_ms)
+{
+    mock()
+        .expectOneCall("mock_sht3x_start_timer")
+        .withParameter("duration_ms", duration_ms)
+        .withParameter("user_data", start_timer_user_data)
+        .ignoreOtherParameters();
+}
+
+/* Soft reset, 2 ms delay, clear status register, 1 ms delay. I2C callbacks are executed with I2C_RESULT_CODE_OK. */
+static void init_sequence_reset_and_clear_status()
+{
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    timer_expired_cb(timer_expired_cb_user_data);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    timer_expired_cb(timer_expired_cb_user_data);
+}
+
+static void expect_init_sequence_reset_and_clear_status()
+{
+    /* Soft reset command */
+    uint8_t soft_reset_cmd[] = {0x30, 0xA2};
+    expect_i2c_write_cmd(soft_reset_cmd);
+    expect_timer(2);
+    /* Clear status register command */
+    uint8_t clear_status_cmd[] = {0x30, 0x41};
+    expect_i2c_write_cmd(clear_status_cmd);
+    expect_timer(1);
+}
+
+static void expect_init_sequence_read_status(uint8_t *i2c_read_data)
+{
+    /* Read status reg command */
+    uint8_t read_status_cmd[] = {0xF3, 0x2D};
+    expect_i2c_write_cmd(read_status_cmd);
+    expect_timer(1);
+    mock()
+        .expectOneCall("mock_sht3x_i2c_read")
+        .withOutputParameterReturning("data", i2c_read_data, 3)
+        .withParameter("length", 3)
+        .withParameter("i2c_addr", SHT3X_TEST_DEFAULT_I2C_ADDR)
+        .withParameter("user_data", i2c_read_user_data)
+        .ignoreOtherParameters();
+}
+
+TEST(SHT3X, InitSequencePeriodic)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    expect_init_sequence_reset_and_clear_status();
+    /* Start periodic meas, medium repeatability, 10 mps */
+    uint8_t start_periodic_cmd[] = {0x27, 0x21};
+    expect_i2c_write_cmd(start_periodic_cmd);
+
+    SHT3XInitSequenceConfig cfg = {
+        .meas_mode = SHT3X_MEAS_MODE_PERIODIC,
+        .repeatability = SHT3X_MEAS_REPEATABILITY_MEDIUM,
+        .mps = SHT3X_MPS_10,
+        .verify_status = false,
+    };
+    void *user_data = (void *)0x71;
+    uint8_t rc = sht3x_init_sequence(sht3x, &cfg, sht3x_init_sequence_complete_cb, user_data);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    init_sequence_reset_and_clear_status();
+    CHECK_EQUAL(0, init_sequence_complete_cb_call_count);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    CHECK_EQUAL(1, init_sequence_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, init_sequence_complete_cb_result_code);
+    /* Max measurement duration for medium repeatability */
+    CHECK_EQUAL(7, init_sequence_complete_cb_time_to_first_sample_ms);
+    POINTERS_EQUAL(user_data, init_sequence_complete_cb_user_data);
+
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_EQUAL(SHT3X_MEAS_MODE_PERIODIC, state.meas_mode);
+    CHECK_EQUAL(SHT3X_MEAS_REPEATABILITY_MEDIUM, state.repeatability);
+    CHECK_EQUAL(SHT3X_MPS_10, state.mps);
+    CHECK_EQUAL(SHT3X_HEATER_STATE_OFF, state.heater_state);
+    CHECK_TRUE(state.status_reg_valid);
+    CHECK_EQUAL(0x0000, state.status_reg);
+}
+
+TEST(SHT3X, InitSequenceArtVerifyStatus)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    expect_init_sequence_reset_and_clear_status();
+    /* All flags cleared, correct CRC */
+    uint8_t i2c_read_data[] = {0x00, 0x00, 0x81};
+    expect_init_sequence_read_status(i2c_read_data);
+    /* ART command */
+    uint8_t art_cmd[] = {0x2B, 0x32};
+    expect_i2c_write_cmd(art_cmd);
+
+    SHT3XInitSequenceConfig cfg = {
+        .meas_mode = SHT3X_MEAS_MODE_PERIODIC_ART,
+        .repeatability = 0,
+        .mps = 0,
+        .verify_status = true,
+    };
+    uint8_t rc = sht3x_init_sequence(sht3x, &cfg, sht3x_init_sequence_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    init_sequence_reset_and_clear_status();
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    timer_expired_cb(timer_expired_cb_user_data);
+    /* Start command is sent right after the status register is verified */
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    CHECK_EQUAL(1, init_sequence_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, init_sequence_complete_cb_result_code);
+    /* ART is assumed to use high repeatability */
+    CHECK_EQUAL(16, init_sequence_complete_cb_time_to_first_sample_ms);
+
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_EQUAL(SHT3X_MEAS_MODE_PERIODIC_ART, state.meas_mode);
+}
+
+static void test_init_sequence_verify_fails(uint8_t *i2c_read_data, uint8_t expected_rc, uint8_t expected_meas_mode)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    expect_init_sequence_reset_and_clear_status();
+    expect_init_sequence_read_status(i2c_read_data);
+    /* Start periodic command is not sent */
+
+    SHT3XInitSequenceConfig cfg = {
+        .meas_mode = SHT3X_MEAS_MODE_PERIODIC,
+        .repeatability = SHT3X_MEAS_REPEATABILITY_HIGH,
+        .mps = SHT3X_MPS_1,
+        .verify_status = true,
+    };
+    uint8_t rc = sht3x_init_sequence(sht3x, &cfg, sht3x_init_sequence_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    init_sequence_reset_and_clear_status();
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    timer_expired_cb(timer_expired_cb_user_data);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+
+    CHECK_EQUAL(1, init_sequence_complete_cb_call_count);
+    CHECK_EQUAL(expected_rc, init_sequence_complete_cb_result_code);
+
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_EQUAL(expected_meas_mode, state.meas_mode);
+}
+
+TEST(SHT3X, InitSequenceVerifyStatusUnexpected)
+{
+    /* System reset detected flag is still set, correct CRC */
+    uint8_t i2c_read_data[] = {0x00, 0x10, 0xC2};
+    /* Reset flag was cleared by the driver, so the device went through a reset that the driver did not initiate */
+    test_init_sequence_verify_fails(i2c_read_data, SHT3X_RESULT_CODE_UNEXPECTED_STATUS, SHT3X_MEAS_MODE_UNKNOWN);
+}
+
+TEST(SHT3X, InitSequenceVerifyStatusWrongCrc)
+{
+    uint8_t i2c_read_data[] = {0x00, 0x00, 0x82};
+    test_init_sequence_verify_fails(i2c_read_data, SHT3X_RESULT_CODE_CRC_MISMATCH, SHT3X_MEAS_MODE_SINGLE_SHOT);
+}
+
+TEST(SHT3X, InitSequenceClearStatusFails)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Soft reset command */
+    uint8_t soft_reset_cmd[] = {0x30, 0xA2};
+    expect_i2c_write_cmd(soft_reset_cmd);
+    expect_timer(2);
+    /* Clear status register command */
+    uint8_t clear_status_cmd[] = {0x30, 0x41};
+    expect_i2c_write_cmd(clear_status_cmd);
+
+    SHT3XInitSequenceConfig cfg = {
+        .meas_mode = SHT3X_MEAS_MODE_PERIODIC_ART,
+        .repeatability = 0,
+        .mps = 0,
+        .verify_status = false,
+    };
+    uint8_t rc = sht3x_init_sequence(sht3x, &cfg, sht3x_init_sequence_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    timer_expired_cb(timer_expired_cb_user_data);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_BUS_ERROR, i2c_write_complete_cb_user_data);
+
+    CHECK_EQUAL(1, init_sequence_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_IO_ERR, init_sequence_complete_cb_result_code);
+
+    /* Reset went through, status register is no longer known */
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_EQUAL(SHT3X_MEAS_MODE_SINGLE_SHOT, state.meas_mode);
+    CHECK_FALSE(state.status_reg_valid);
+}
+
+TEST(SHT3X, InitSequenceInvalidArgs)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    SHT3XInitSequenceConfig cfg = {
+        .meas_mode = SHT3X_MEAS_MODE_PERIODIC,
+        .repeatability = SHT3X_MEAS_REPEATABILITY_HIGH,
+        .mps = SHT3X_MPS_1,
+        .verify_status = false,
+    };
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_init_sequence(NULL, &cfg, NULL, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_init_sequence(sht3x, NULL, NULL, NULL));
+
+    cfg.mps = 0xFF;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_init_sequence(sht3x, &cfg, NULL, NULL));
+    cfg.mps = SHT3X_MPS_1;
+    cfg.repeatability = 0xFF;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_init_sequence(sht3x, &cfg, NULL, NULL));
+    cfg.repeatability = SHT3X_MEAS_REPEATABILITY_HIGH;
+    cfg.meas_mode = SHT3X_MEAS_MODE_SINGLE_SHOT;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_init_sequence(sht3x, &cfg, NULL, NULL));
+}
+
+static uint8_t init_sequence()
+{
+    SHT3XInitSequenceConfig cfg = {
+        .meas_mode = SHT3X_MEAS_MODE_PERIODIC_ART,
+        .repeatability = 0,
+        .mps = 0,
+        .verify_status = false,
+    };
+    return sht3x_init_sequence(sht3x, &cfg, NULL, NULL);
+}
+
+TEST(SHT3X, InitSequenceBusy)
+{
+    test_busy_if_seq_in_progress(init_sequence);
+}
+
+/* Start periodic meas with high repeatability and 1 mps, take a snapshot, then simulate wakeup from deep sleep by
+ * creating a new instance in the same memory. */
+static void snapshot_periodic_meas_and_recreate(uint8_t *snapshot)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    /* Start periodic meas, high repeatability, 1 mps */
+    uint8_t i2c_write_data[] = {0x21, 0x30};
+    expect_i2c_write_cmd(i2c_write_data);
+    sht3x_start_periodic_measurement(sht3x, SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_MPS_1, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    uint8_t rc = sht3x_snapshot(sht3x, snapshot, SHT3X_SNAPSHOT_SIZE);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+    memset(&instance_memory, 0, sizeof(struct SHT3XStruct));
+    mock()
+        .expectOneCall("mock_sht3x_get_instance_memory")
+        .withParameter("user_data", (void *)NULL)
+        .andReturnValue((void *)&instance_memory);
+    rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+}
+
+TEST(SHT3X, RestoreSnapshot)
+{
+    uint8_t snapshot[SHT3X_SNAPSHOT_SIZE];
+    snapshot_periodic_meas_and_recreate(snapshot);
+
+    uint8_t rc = sht3x_restore(sht3x, snapshot, sizeof(snapshot));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_EQUAL(SHT3X_MEAS_MODE_PERIODIC, state.meas_mode);
+    CHECK_EQUAL(SHT3X_MEAS_REPEATABILITY_HIGH, state.repeatability);
+    CHECK_EQUAL(SHT3X_MPS_1, state.mps);
+    CHECK_EQUAL(SHT3X_HEATER_STATE_UNKNOWN, state.heater_state);
+    CHECK_FALSE(state.status_reg_valid);
+
+    /* Periodic measurement is known to be running with the same options, start command is not sent again */
+    rc = sht3x_start_periodic_measurement(sht3x, SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_MPS_1, sht3x_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(1, complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, complete_cb_result_code);
+}
+
+TEST(SHT3X, RestoreSnapshotCorrupted)
+{
+    uint8_t snapshot[SHT3X_SNAPSHOT_SIZE];
+    snapshot_periodic_meas_and_recreate(snapshot);
+    snapshot[3] ^= 0x01;
+
+    uint8_t rc = sht3x_restore(sht3x, snapshot, sizeof(snapshot));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_CRC_MISMATCH, rc);
+
+    /* Tracked state is left untouched */
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_EQUAL(SHT3X_MEAS_MODE_UNKNOWN, state.meas_mode);
+}
+
+TEST(SHT3X, RestoreSnapshotDifferentI2cAddr)
+{
+    uint8_t snapshot[SHT3X_SNAPSHOT_SIZE];
+    snapshot_periodic_meas_and_recreate(snapshot);
+
+    memset(&instance_memory, 0, sizeof(struct SHT3XStruct));
+    mock()
+        .expectOneCall("mock_sht3x_get_instance_memory")
+        .withParameter("user_data", (void *)NULL)
+        .andReturnValue((void *)&instance_memory);
+    init_cfg.i2c_addr = 0x45;
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    uint8_t rc = sht3x_restore(sht3x, snapshot, sizeof(snapshot));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, rc);
+}
+
+TEST(SHT3X, SnapshotRestoreInvalidArgs)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    uint8_t snapshot[SHT3X_SNAPSHOT_SIZE];
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_snapshot(NULL, snapshot, sizeof(snapshot)));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_snapshot(sht3x, NULL, sizeof(snapshot)));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_snapshot(sht3x, snapshot, sizeof(snapshot) - 1));
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_snapshot(sht3x, snapshot, sizeof(snapshot)));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_restore(NULL, snapshot, sizeof(snapshot)));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_restore(sht3x, NULL, sizeof(snapshot)));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_restore(sht3x, snapshot, sizeof(snapshot) - 1));
+}
+
+static uint8_t snapshot()
+{
+    uint8_t buf[SHT3X_SNAPSHOT_SIZE];
+    return sht3x_snapshot(sht3x, buf, sizeof(buf));
+}
+
+TEST(SHT3X, SnapshotBusy)
+{
+    test_busy_if_seq_in_progress(snapshot);
+}
+
+static size_t health_event_cb_call_count;
+static uint8_t health_event_cb_event;
+static void *health_event_cb_user_data;
+
+static void health_event_cb(uint8_t event, void *user_data)
+{
+    health_event_cb_call_count++;
+    health_event_cb_event = event;
+    health_event_cb_user_data = user_data;
+}
+
+static void enable_health_monitor(uint16_t stuck_threshold, uint16_t crc_error_threshold, uint16_t crc_window,
+                                  uint16_t no_data_threshold)
+{
+    health_event_cb_call_count = 0;
+    health_event_cb_event = 0xFF;
+    health_event_cb_user_data = NULL;
+
+    SHT3XHealthConfig cfg = {
+        .stuck_threshold = stuck_threshold,
+        .crc_error_threshold = crc_error_threshold,
+        .crc_window = crc_window,
+        .no_data_threshold = no_data_threshold,
+        .cb = health_event_cb,
+        .user_data = (void *)0x4E,
+    };
+    uint8_t rc = sht3x_enable_health_monitor(sht3x, &cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+}
+
+/* Read out temperature and humidity with CRC verification. i2c_read_data is ignored if i2c_rc is not OK. */
+static void health_read_meas(uint8_t *i2c_read_data, uint8_t i2c_rc)
+{
+    uint8_t no_data[6] = {0};
+    mock()
+        .expectOneCall("mock_sht3x_i2c_read")
+        .withOutputParameterReturning("data", i2c_read_data ? i2c_read_data : no_data, 6)
+        .withParameter("length", 6)
+        .ignoreOtherParameters();
+    uint8_t flags = SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM | SHT3X_FLAG_VERIFY_CRC_TEMP | SHT3X_FLAG_VERIFY_CRC_HUM;
+    uint8_t rc = sht3x_read_measurement(sht3x, flags, sht3x_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_read_complete_cb(i2c_rc, i2c_read_complete_cb_user_data);
+}
+
+static uint8_t health_meas_a[] = {0x12, 0x34, 0x37, 0x56, 0x78, 0x7D};
+static uint8_t health_meas_b[] = {0x56, 0x78, 0x7D, 0x12, 0x34, 0x37};
+/* Humidity CRC is wrong */
+static uint8_t health_meas_bad_crc[] = {0x12, 0x34, 0x37, 0x56, 0x78, 0x7E};
+
+TEST(SHT3X, HealthStuckValue)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+    enable_health_monitor(3, 0, 0, 0);
+
+    health_read_meas(health_meas_a, SHT3X_I2C_RESULT_CODE_OK);
+    health_read_meas(health_meas_b, SHT3X_I2C_RESULT_CODE_OK);
+    health_read_meas(health_meas_b, SHT3X_I2C_RESULT_CODE_OK);
+    CHECK_EQUAL(0, health_event_cb_call_count);
+    health_read_meas(health_meas_b, SHT3X_I2C_RESULT_CODE_OK);
+    CHECK_EQUAL(1, health_event_cb_call_count);
+    CHECK_EQUAL(SHT3X_HEALTH_EVENT_STUCK_VALUE, health_event_cb_event);
+    POINTERS_EQUAL((void *)0x4E, health_event_cb_user_data);
+    /* Measurement complete callback is still executed with the measurement */
+    CHECK_EQUAL(4, meas_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, meas_complete_cb_result_code);
+
+    /* Event fires once per run of identical values */
+    health_read_meas(health_meas_b, SHT3X_I2C_RESULT_CODE_OK);
+    CHECK_EQUAL(1, health_event_cb_call_count);
+    health_read_meas(health_meas_a, SHT3X_I2C_RESULT_CODE_OK);
+    health_read_meas(health_meas_a, SHT3X_I2C_RESULT_CODE_OK);
+    health_read_meas(health_meas_a, SHT3X_I2C_RESULT_CODE_OK);
+    CHECK_EQUAL(2, health_event_cb_call_count);
+}
+
+TEST(SHT3X, HealthCrcErrorRate)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+    enable_health_monitor(0, 2, 4, 0);
+
+    /* One CRC mismatch in the first window of 4 readouts */
+    health_read_meas(health_meas_bad_crc, SHT3X_I2C_RESULT_CODE_OK);
+    health_read_meas(health_meas_a, SHT3X_I2C_RESULT_CODE_OK);
+    health_read_meas(health_meas_b, SHT3X_I2C_RESULT_CODE_OK);
+    health_read_meas(health_meas_a, SHT3X_I2C_RESULT_CODE_OK);
+    /* Second window */
+    health_read_meas(health_meas_bad_crc, SHT3X_I2C_RESULT_CODE_OK);
+    CHECK_EQUAL(0, health_event_cb_call_count);
+    health_read_meas(health_meas_bad_crc, SHT3X_I2C_RESULT_CODE_OK);
+    CHECK_EQUAL(1, health_event_cb_call_count);
+    CHECK_EQUAL(SHT3X_HEALTH_EVENT_CRC_ERROR_RATE, health_event_cb_event);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_CRC_MISMATCH, meas_complete_cb_result_code);
+}
+
+TEST(SHT3X, HealthCrcErrorRateAcrossWindowBoundary)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+    enable_health_monitor(0, 3, 10, 0);
+
+    for (size_t i = 0; i < 8; i++) {
+        health_read_meas(health_meas_a, SHT3X_I2C_RESULT_CODE_OK);
+    }
+    /* Readouts 9, 10 and 11 are all within the last 10 readouts */
+    health_read_meas(health_meas_bad_crc, SHT3X_I2C_RESULT_CODE_OK);
+    health_read_meas(health_meas_bad_crc, SHT3X_I2C_RESULT_CODE_OK);
+    CHECK_EQUAL(0, health_event_cb_call_count);
+    health_read_meas(health_meas_bad_crc, SHT3X_I2C_RESULT_CODE_OK);
+    CHECK_EQUAL(1, health_event_cb_call_count);
+    CHECK_EQUAL(SHT3X_HEALTH_EVENT_CRC_ERROR_RATE, health_event_cb_event);
+
+    /* Readout 9 leaves the window as readout 19 enters it, the count stays at the threshold */
+    for (size_t i = 0; i < 7; i++) {
+        health_read_meas(health_meas_a, SHT3X_I2C_RESULT_CODE_OK);
+    }
+    health_read_meas(health_meas_bad_crc, SHT3X_I2C_RESULT_CODE_OK);
+    CHECK_EQUAL(1, health_event_cb_call_count);
+    /* Readouts 10 and 11 leave the window, two new mismatches bring the count back to the threshold */
+    health_read_meas(health_meas_a, SHT3X_I2C_RESULT_CODE_OK);
+    health_read_meas(health_meas_a, SHT3X_I2C_RESULT_CODE_OK);
+    health_read_meas(health_meas_bad_crc, SHT3X_I2C_RESULT_CODE_OK);
+    CHECK_EQUAL(1, health_event_cb_call_count);
+    health_read_meas(health_meas_bad_crc, SHT3X_I2C_RESULT_CODE_OK);
+    CHECK_EQUAL(2, health_event_cb_call_count);
+}
+
+TEST(SHT3X, HealthNoData)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+    enable_health_monitor(0, 0, 0, 2);
+
+    health_read_meas(NULL, SHT3X_I2C_RESULT_CODE_ADDRESS_NACK);
+    /* Successful readout resets the count */
+    health_read_meas(health_meas_a, SHT3X_I2C_RESULT_CODE_OK);
+    health_read_meas(NULL, SHT3X_I2C_RESULT_CODE_ADDRESS_NACK);
+    CHECK_EQUAL(0, health_event_cb_call_count);
+    health_read_meas(NULL, SHT3X_I2C_RESULT_CODE_ADDRESS_NACK);
+    CHECK_EQUAL(1, health_event_cb_call_count);
+    CHECK_EQUAL(SHT3X_HEALTH_EVENT_NO_DATA, health_event_cb_event);
+}
+
+static void soft_reset_with_delay_from_health_cb(uint8_t event, void *user_data)
+{
+    health_event_cb(event, user_data);
+    uint8_t rc = sht3x_soft_reset_with_delay(sht3x, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+}
+
+TEST(SHT3X, HealthCbCanStartRecovery)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+    SHT3XHealthConfig cfg = {
+        .stuck_threshold = 0,
+        .crc_error_threshold = 0,
+        .crc_window = 0,
+        .no_data_threshold = 1,
+        .cb = soft_reset_with_delay_from_health_cb,
+        .user_data = NULL,
+    };
+    health_event_cb_call_count = 0;
+    sht3x_enable_health_monitor(sht3x, &cfg);
+
+    /* Soft reset command */
+    uint8_t i2c_write_data[] = {0x30, 0xA2};
+    mock().expectOneCall("mock_sht3x_i2c_read").ignoreOtherParameters();
+    expect_i2c_write_cmd(i2c_write_data);
+    uint8_t rc = sht3x_read_measurement(sht3x, SHT3X_FLAG_READ_TEMP, sht3x_meas_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_ADDRESS_NACK, i2c_read_complete_cb_user_data);
+
+    CHECK_EQUAL(1, meas_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, meas_complete_cb_result_code);
+    CHECK_EQUAL(1, health_event_cb_call_count);
+}
+
+TEST(SHT3X, HealthDisabled)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+    enable_health_monitor(0, 0, 0, 1);
+    uint8_t rc = sht3x_disable_health_monitor(sht3x);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+    health_read_meas(NULL, SHT3X_I2C_RESULT_CODE_ADDRESS_NACK);
+    CHECK_EQUAL(0, health_event_cb_call_count);
+}
+
+TEST(SHT3X, HealthEnableInvalidArgs)
+{
+    uint8_t rc_create = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc_create);
+
+    SHT3XHealthConfig cfg = {
+        .stuck_threshold = 2,
+        .crc_error_threshold = 2,
+        .crc_window = 10,
+        .no_data_threshold = 2,
+        .cb = health_event_cb,
+        .user_data = NULL,
+    };
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_enable_health_monitor(NULL, &cfg));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_enable_health_monitor(sht3x, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_disable_health_monitor(NULL));
+    SHT3XHealthConfig invalid_cfg = cfg;
+    invalid_cfg.cb = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_enable_health_monitor(sht3x, &invalid_cfg));
+    invalid_cfg = cfg;
+    invalid_cfg.stuck_threshold = 1;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_enable_health_monitor(sht3x, &invalid_cfg));
+    invalid_cfg = cfg;
+    invalid_cfg.crc_window = 1;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_enable_health_monitor(sht3x, &invalid_cfg));
+    invalid_cfg = cfg;
+    invalid_cfg.crc_window = SHT3X_HEALTH_MAX_CRC_WINDOW + 1;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_enable_health_monitor(sht3x, &invalid_cfg));
+}
@@ -0,0 +1,347 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+#include "sht3x.h"
+#include "sht3x_adaptive.h"
+/* Included to know the size of SHT3X instance we need to define to return from mock_sht3x_get_instance_memory. */
+#include "sht3x_private.h"
+#include "mock_cfg_functions.h"
+
+#define SHT3X_ADAPTIVE_TEST_I2C_ADDR 0x44
+
+/* To return from mock_sht3x_get_instance_memory */
+static struct SHT3XStruct instance_memory;
+
+static void *i2c_write_user_data = (void *)0x10;
+static void *i2c_read_user_data = (void *)0x11;
+static void *start_timer_user_data = (void *)0x56;
+static void *adaptive_start_timer_user_data = (void *)0x78;
+
+static SHT3X sht3x;
+static SHT3XAdaptive adaptive;
+static SHT3XAdaptiveConfig adaptive_cfg;
+
+static const SHT3XAdaptiveLevel levels[] = {
+    {SHT3X_MEAS_MODE_PERIODIC, SHT3X_MEAS_REPEATABILITY_LOW, SHT3X_MPS_0_5},
+    {SHT3X_MEAS_MODE_PERIODIC, SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_MPS_1},
+    {SHT3X_MEAS_MODE_PERIODIC_ART, 0, 0},
+};
+
+/* Populated by mock object whenever mock_sht3x_i2c_write is called */
+static SHT3X_I2CTransactionCompleteCb i2c_write_complete_cb;
+static void *i2c_write_complete_cb_user_data;
+
+/* Populated by mock object whenever mock_sht3x_i2c_read is called */
+static SHT3X_I2CTransactionCompleteCb i2c_read_complete_cb;
+static void *i2c_read_complete_cb_user_data;
+
+/* Populated by mock object whenever mock_sht3x_start_timer is called */
+static SHT3XTimerExpiredCb timer_expired_cb;
+static void *timer_expired_cb_user_data;
+
+static size_t transition_cb_call_count;
+static uint8_t transition_cb_result_code;
+static SHT3XAdaptiveTransition transition_cb_transition;
+static void *transition_cb_user_data;
+
+static uint8_t stop_cmd[] = {0x30, 0x93};
+/* Periodic meas, low repeatability, 0.5 mps */
+static uint8_t level_0_cmd[] = {0x20, 0x2F};
+/* Periodic meas, high repeatability, 1 mps */
+static uint8_t level_1_cmd[] = {0x21, 0x30};
+static uint8_t art_cmd[] = {0x2B, 0x32};
+
+static void transition_cb(uint8_t result_code, const SHT3XAdaptiveTransition *transition, void *user_data)
+{
+    transition_cb_call_count++;
+    transition_cb_result_code = result_code;
+    transition_cb_transition = *transition;
+    transition_cb_user_data = user_data;
+}
+
+// clang-format off
+TEST_GROUP(SHT3XAdaptive)
+{
+    void setup() {
+        /* Order of expected calls is important for these tests. Fail the test if the expected mock calls do not happen
+        in the specified order. */
+        mock().strictOrder();
+
+        i2c_write_complete_cb = NULL;
+        i2c_write_complete_cb_user_data = NULL;
+        i2c_read_complete_cb = NULL;
+        i2c_read_complete_cb_user_data = NULL;
+        timer_expired_cb = NULL;
+        timer_expired_cb_user_data = NULL;
+
+        mock().setData("i2cWriteCompleteCb", (void *)&i2c_write_complete_cb);
+        mock().setData("i2cWriteCompleteCbUserData", &i2c_write_complete_cb_user_data);
+        mock().setData("i2cReadCompleteCb", (void *)&i2c_read_complete_cb);
+        mock().setData("i2cReadCompleteCbUserData", &i2c_read_complete_cb_user_data);
+        mock().setData("timerExpiredCb", (void *)&timer_expired_cb);
+        mock().setData("timerExpiredCbUserData", &timer_expired_cb_user_data);
+
+        transition_cb_call_count = 0;
+        transition_cb_result_code = 0xFF; /* 0 is a valid code, reset to an invalid code */
+        memset(&transition_cb_transition, 0, sizeof(transition_cb_transition));
+        transition_cb_user_data = NULL;
+
+        memset(&instance_memory, 0, sizeof(instance_memory));
+        memset(&adaptive, 0, sizeof(adaptive));
+
+        mock()
+            .expectOneCall("mock_sht3x_get_instance_memory")
+            .withParameter("user_data", (void *)NULL)
+            .andReturnValue((void *)&instance_memory);
+        SHT3XInitConfig init_cfg = {
+            .get_instance_memory = mock_sht3x_get_instance_memory,
+            .get_instance_memory_user_data = NULL,
+            .i2c_write = mock_sht3x_i2c_write,
+            .i2c_write_user_data = i2c_write_user_data,
+            .i2c_read = mock_sht3x_i2c_read,
+            .i2c_read_user_data = i2c_read_user_data,
+            .start_timer = mock_sht3x_start_timer,
+            .start_timer_user_data = start_timer_user_data,
+            .i2c_addr = SHT3X_ADAPTIVE_TEST_I2C_ADDR,
+        };
+        uint8_t rc = sht3x_create(&sht3x, &init_cfg);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+        memset(&adaptive_cfg, 0, sizeof(adaptive_cfg));
+        adaptive_cfg.instance = sht3x;
+        adaptive_cfg.levels = levels;
+        adaptive_cfg.num_levels = sizeof(levels) / sizeof(levels[0]);
+        adaptive_cfg.initial_level = 1;
+        adaptive_cfg.temp_fast_threshold = 0.5f;
+        adaptive_cfg.temp_slow_threshold = 0.1f;
+        adaptive_cfg.hum_fast_threshold = 2.0f;
+        adaptive_cfg.hum_slow_threshold = 0.5f;
+        adaptive_cfg.settle_count = 3;
+        adaptive_cfg.transition_cb = transition_cb;
+        adaptive_cfg.transition_cb_user_data = (void *)0x9A;
+        adaptive_cfg.start_timer = mock_sht3x_start_timer;
+        adaptive_cfg.start_timer_user_data = adaptive_start_timer_user_data;
+    }
+};
+// clang-format on
+
+static void expect_write(uint8_t *cmd)
+{
+    mock()
+        .expectOneCall("mock_sht3x_i2c_write")
+        .withMemoryBufferParameter("data", cmd, 2)
+        .withParameter("length", 2)
+        .withParameter("i2c_addr", SHT3X_ADAPTIVE_TEST_I2C_ADDR)
+        .withParameter("user_data", i2c_write_user_data)
+        .ignoreOtherParameters();
+}
+
+/* Expect stop command, mandatory delay and start command of the new level */
+static void expect_transition(uint8_t *start_cmd)
+{
+    expect_write(stop_cmd);
+    mock()
+        .expectOneCall("mock_sht3x_start_timer")
+        .withParameter("duration_ms", 1)
+        .withParameter("user_data", adaptive_start_timer_user_data)
+        .ignoreOtherParameters();
+    expect_write(start_cmd);
+}
+
+/* Complete the stop command, the mandatory delay and the start command */
+static void complete_transition()
+{
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    timer_expired_cb(timer_expired_cb_user_data);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+}
+
+static void update(float temperature, float humidity, uint32_t elapsed_ms)
+{
+    SHT3XMeasurement meas = {.temperature = temperature, .humidity = humidity};
+    uint8_t rc = sht3x_adaptive_update(&adaptive, &meas, elapsed_ms);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+}
+
+static void check_level(uint8_t expected_level)
+{
+    uint8_t level = 0xFF;
+    uint8_t rc = sht3x_adaptive_get_level(&adaptive, &level);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(expected_level, level);
+}
+
+TEST(SHT3XAdaptive, InitInvalidArgs)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_init(NULL, &adaptive_cfg));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_init(&adaptive, NULL));
+
+    SHT3XAdaptiveConfig cfg = adaptive_cfg;
+    cfg.num_levels = 1;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_init(&adaptive, &cfg));
+    cfg = adaptive_cfg;
+    cfg.initial_level = 3;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_init(&adaptive, &cfg));
+    cfg = adaptive_cfg;
+    /* No hysteresis */
+    cfg.temp_slow_threshold = cfg.temp_fast_threshold;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_init(&adaptive, &cfg));
+    cfg = adaptive_cfg;
+    cfg.settle_count = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_init(&adaptive, &cfg));
+    cfg = adaptive_cfg;
+    cfg.start_timer = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_init(&adaptive, &cfg));
+
+    SHT3XAdaptiveLevel invalid_levels[] = {
+        {SHT3X_MEAS_MODE_PERIODIC, SHT3X_MEAS_REPEATABILITY_LOW, SHT3X_MPS_0_5},
+        {SHT3X_MEAS_MODE_SINGLE_SHOT, 0, 0},
+    };
+    cfg = adaptive_cfg;
+    cfg.levels = invalid_levels;
+    cfg.num_levels = 2;
+    cfg.initial_level = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_init(&adaptive, &cfg));
+    invalid_levels[1] = {SHT3X_MEAS_MODE_PERIODIC, 0xFF, SHT3X_MPS_1};
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_init(&adaptive, &cfg));
+    invalid_levels[1] = {SHT3X_MEAS_MODE_PERIODIC, SHT3X_MEAS_REPEATABILITY_HIGH, 0xFF};
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_init(&adaptive, &cfg));
+}
+
+TEST(SHT3XAdaptive, FastTemperatureChangeMovesUp)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_adaptive_init(&adaptive, &adaptive_cfg));
+    update(20.0f, 50.0f, 0);
+    /* 0.6 degrees per second */
+    expect_transition(art_cmd);
+    update(20.6f, 50.0f, 1000);
+    complete_transition();
+
+    CHECK_EQUAL(1, transition_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, transition_cb_result_code);
+    CHECK_EQUAL(1, transition_cb_transition.from_level);
+    CHECK_EQUAL(2, transition_cb_transition.to_level);
+    DOUBLES_EQUAL(0.6, transition_cb_transition.temp_rate, 0.001);
+    DOUBLES_EQUAL(0.0, transition_cb_transition.hum_rate, 0.001);
+    POINTERS_EQUAL((void *)0x9A, transition_cb_user_data);
+    check_level(2);
+
+    SHT3XShadowState state;
+    sht3x_get_shadow_state(sht3x, &state);
+    CHECK_EQUAL(SHT3X_MEAS_MODE_PERIODIC_ART, state.meas_mode);
+
+    /* Already at the fastest level */
+    update(21.6f, 50.0f, 1000);
+    CHECK_EQUAL(1, transition_cb_call_count);
+}
+
+TEST(SHT3XAdaptive, FastHumidityChangeMovesUp)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_adaptive_init(&adaptive, &adaptive_cfg));
+    update(20.0f, 50.0f, 0);
+    /* 2 RH% per second, measured over 250 ms */
+    expect_transition(art_cmd);
+    update(20.0f, 49.5f, 250);
+    complete_transition();
+    CHECK_EQUAL(1, transition_cb_call_count);
+    DOUBLES_EQUAL(2.0, transition_cb_transition.hum_rate, 0.001);
+}
+
+TEST(SHT3XAdaptive, SettledMeasurementsMoveDownAfterSettleCount)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_adaptive_init(&adaptive, &adaptive_cfg));
+    update(20.0f, 50.0f, 0);
+    update(20.0f, 50.0f, 1000);
+    update(20.05f, 50.0f, 1000);
+    CHECK_EQUAL(0, transition_cb_call_count);
+
+    expect_transition(level_0_cmd);
+    update(20.05f, 50.2f, 1000);
+    complete_transition();
+    CHECK_EQUAL(1, transition_cb_call_count);
+    CHECK_EQUAL(1, transition_cb_transition.from_level);
+    CHECK_EQUAL(0, transition_cb_transition.to_level);
+    check_level(0);
+
+    uint32_t num_up = 0xFF;
+    uint32_t num_down = 0xFF;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_adaptive_get_transition_counts(&adaptive, &num_up, &num_down));
+    CHECK_EQUAL(0, num_up);
+    CHECK_EQUAL(1, num_down);
+}
+
+TEST(SHT3XAdaptive, RateWithinHysteresisBandResetsSettleCount)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_adaptive_init(&adaptive, &adaptive_cfg));
+    update(20.0f, 50.0f, 0);
+    update(20.0f, 50.0f, 1000);
+    update(20.0f, 50.0f, 1000);
+    /* 0.3 degrees per second is neither fast nor settled */
+    update(20.3f, 50.0f, 1000);
+    update(20.3f, 50.0f, 1000);
+    update(20.3f, 50.0f, 1000);
+    CHECK_EQUAL(0, transition_cb_call_count);
+    check_level(1);
+
+    expect_transition(level_0_cmd);
+    update(20.3f, 50.0f, 1000);
+    complete_transition();
+    check_level(0);
+}
+
+TEST(SHT3XAdaptive, UpdateBusyDuringTransition)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_adaptive_init(&adaptive, &adaptive_cfg));
+    update(20.0f, 50.0f, 0);
+    expect_transition(art_cmd);
+    update(21.0f, 50.0f, 1000);
+
+    SHT3XMeasurement meas = {.temperature = 22.0f, .humidity = 50.0f};
+    CHECK_EQUAL(SHT3X_RESULT_CODE_BUSY, sht3x_adaptive_update(&adaptive, &meas, 1000));
+    complete_transition();
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_adaptive_update(&adaptive, &meas, 1000));
+}
+
+TEST(SHT3XAdaptive, FailedStopKeepsLevel)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_adaptive_init(&adaptive, &adaptive_cfg));
+    update(20.0f, 50.0f, 0);
+    expect_write(stop_cmd);
+    update(21.0f, 50.0f, 1000);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_BUS_ERROR, i2c_write_complete_cb_user_data);
+
+    CHECK_EQUAL(1, transition_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_IO_ERR, transition_cb_result_code);
+    check_level(1);
+    uint32_t num_up = 0xFF;
+    uint32_t num_down = 0xFF;
+    sht3x_adaptive_get_transition_counts(&adaptive, &num_up, &num_down);
+    CHECK_EQUAL(0, num_up);
+    CHECK_EQUAL(0, num_down);
+}
+
+TEST(SHT3XAdaptive, MoveUpFromSlowestLevel)
+{
+    adaptive_cfg.initial_level = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_adaptive_init(&adaptive, &adaptive_cfg));
+    update(20.0f, 50.0f, 0);
+    expect_transition(level_1_cmd);
+    update(20.0f, 55.0f, 2000);
+    complete_transition();
+    check_level(1);
+}
+
+TEST(SHT3XAdaptive, UpdateInvalidArgs)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_adaptive_init(&adaptive, &adaptive_cfg));
+    SHT3XMeasurement meas = {.temperature = 20.0f, .humidity = 50.0f};
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_update(NULL, &meas, 1000));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_update(&adaptive, NULL, 1000));
+    uint8_t level;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_get_level(NULL, &level));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_get_level(&adaptive, NULL));
+    uint32_t count;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_adaptive_get_transition_counts(&adaptive, NULL, &count));
+}
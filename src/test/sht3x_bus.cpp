@@ -0,0 +1,269 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+#include "sht3x.h"
+#include "sht3x_bus.h"
+/* Included to know the size of SHT3X instance we need to define to return from mock_sht3x_get_instance_memory. */
+#include "sht3x_private.h"
+#include "mock_cfg_functions.h"
+
+#define SHT3X_BUS_TEST_I2C_ADDR 0x44
+#define SHT3X_BUS_TEST_SPEED_HZ 100000
+/* Start, address byte, 2 data bytes, stop at 100 kHz */
+#define SHT3X_BUS_TEST_2_BYTE_AIRTIME_US 290
+
+/* To return from mock_sht3x_get_instance_memory */
+static struct SHT3XStruct instance_memory;
+
+static SHT3X sht3x;
+static SHT3XBus bus;
+static SHT3XBusMember member;
+static uint32_t now_us;
+
+/* Populated by mock object whenever mock_sht3x_i2c_write is called */
+static SHT3X_I2CTransactionCompleteCb i2c_write_complete_cb;
+static void *i2c_write_complete_cb_user_data;
+
+/* Populated by mock object whenever mock_sht3x_i2c_read is called */
+static SHT3X_I2CTransactionCompleteCb i2c_read_complete_cb;
+static void *i2c_read_complete_cb_user_data;
+
+/* Populated by mock object whenever mock_sht3x_start_timer is called */
+static SHT3XTimerExpiredCb timer_expired_cb;
+static void *timer_expired_cb_user_data;
+
+static size_t complete_cb_call_count;
+static uint8_t complete_cb_result_code;
+
+static uint32_t get_time_us(void *user_data)
+{
+    (void)user_data;
+    return now_us;
+}
+
+static void read_status_reg_complete_cb(uint8_t result_code, uint16_t reg_val, void *user_data)
+{
+    (void)reg_val;
+    (void)user_data;
+    complete_cb_call_count++;
+    complete_cb_result_code = result_code;
+}
+
+static void i2c_complete_cb(uint8_t result_code, void *user_data)
+{
+    (void)user_data;
+    complete_cb_call_count++;
+    complete_cb_result_code = result_code;
+}
+
+// clang-format off
+TEST_GROUP(SHT3XBus)
+{
+    void setup() {
+        /* Order of expected calls is important for these tests. Fail the test if the expected mock calls do not happen
+        in the specified order. */
+        mock().strictOrder();
+
+        i2c_write_complete_cb = NULL;
+        i2c_write_complete_cb_user_data = NULL;
+        i2c_read_complete_cb = NULL;
+        i2c_read_complete_cb_user_data = NULL;
+        timer_expired_cb = NULL;
+        timer_expired_cb_user_data = NULL;
+        mock().setData("i2cWriteCompleteCb", (void *)&i2c_write_complete_cb);
+        mock().setData("i2cWriteCompleteCbUserData", &i2c_write_complete_cb_user_data);
+        mock().setData("i2cReadCompleteCb", (void *)&i2c_read_complete_cb);
+        mock().setData("i2cReadCompleteCbUserData", &i2c_read_complete_cb_user_data);
+        mock().setData("timerExpiredCb", (void *)&timer_expired_cb);
+        mock().setData("timerExpiredCbUserData", &timer_expired_cb_user_data);
+
+        complete_cb_call_count = 0;
+        complete_cb_result_code = 0xFF;
+        now_us = 0;
+        memset(&instance_memory, 0, sizeof(instance_memory));
+
+        uint8_t rc = sht3x_bus_init(&bus, SHT3X_BUS_TEST_SPEED_HZ, get_time_us, NULL);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+        SHT3XBusMemberConfig member_cfg = {
+            .bus = &bus,
+            .i2c_write = mock_sht3x_i2c_write,
+            .i2c_write_user_data = NULL,
+            .i2c_read = mock_sht3x_i2c_read,
+            .i2c_read_user_data = NULL,
+        };
+        rc = sht3x_bus_member_init(&member, &member_cfg);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+        mock()
+            .expectOneCall("mock_sht3x_get_instance_memory")
+            .withParameter("user_data", (void *)NULL)
+            .andReturnValue((void *)&instance_memory);
+        SHT3XInitConfig init_cfg = {
+            .get_instance_memory = mock_sht3x_get_instance_memory,
+            .get_instance_memory_user_data = NULL,
+            .i2c_write = sht3x_bus_i2c_write,
+            .i2c_write_user_data = &member,
+            .i2c_read = sht3x_bus_i2c_read,
+            .i2c_read_user_data = &member,
+            .start_timer = mock_sht3x_start_timer,
+            .start_timer_user_data = NULL,
+            .i2c_addr = SHT3X_BUS_TEST_I2C_ADDR,
+        };
+        rc = sht3x_create(&sht3x, &init_cfg);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    }
+};
+// clang-format on
+
+/* Read status register without CRC: 2-byte write at 0 us completes at 400 us, 2-byte read at 1500 us completes at
+ * 1800 us. */
+static void read_status_register()
+{
+    uint8_t i2c_write_data[] = {0xF3, 0x2D};
+    uint8_t i2c_read_data[] = {0x80, 0x10};
+    mock()
+        .expectOneCall("mock_sht3x_i2c_write")
+        .withMemoryBufferParameter("data", i2c_write_data, sizeof(i2c_write_data))
+        .withParameter("length", sizeof(i2c_write_data))
+        .withParameter("i2c_addr", SHT3X_BUS_TEST_I2C_ADDR)
+        .ignoreOtherParameters();
+    mock().expectOneCall("mock_sht3x_start_timer").withParameter("duration_ms", 1).ignoreOtherParameters();
+    mock()
+        .expectOneCall("mock_sht3x_i2c_read")
+        .withOutputParameterReturning("data", i2c_read_data, sizeof(i2c_read_data))
+        .withParameter("length", sizeof(i2c_read_data))
+        .ignoreOtherParameters();
+
+    now_us = 0;
+    uint8_t rc = sht3x_read_status_register(sht3x, SHT3X_VERIFY_CRC_NO, read_status_reg_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    now_us = 400;
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    now_us = 1500;
+    timer_expired_cb(timer_expired_cb_user_data);
+    now_us = 1800;
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+
+    CHECK_EQUAL(1, complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, complete_cb_result_code);
+}
+
+TEST(SHT3XBus, AccountsDriverTransactions)
+{
+    read_status_register();
+
+    SHT3XBusCounters counters;
+    uint8_t rc = sht3x_bus_member_get_counters(&member, &counters);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(2, counters.transactions);
+    CHECK_EQUAL(0, counters.failed_transactions);
+    CHECK_EQUAL(2, counters.bytes_written);
+    CHECK_EQUAL(2, counters.bytes_read);
+    CHECK_EQUAL(700, counters.transaction_time_us);
+    CHECK_EQUAL(2 * SHT3X_BUS_TEST_2_BYTE_AIRTIME_US, counters.airtime_us);
+
+    rc = sht3x_bus_get_counters(&bus, &counters);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(2, counters.transactions);
+    CHECK_EQUAL(2 * SHT3X_BUS_TEST_2_BYTE_AIRTIME_US, counters.airtime_us);
+}
+
+TEST(SHT3XBus, BusSumsAllMembers)
+{
+    read_status_register();
+
+    SHT3XBusMember other;
+    SHT3XBusMemberConfig other_cfg = {
+        .bus = &bus,
+        .i2c_write = mock_sht3x_i2c_write,
+        .i2c_write_user_data = (void *)0x55,
+        .i2c_read = mock_sht3x_i2c_read,
+        .i2c_read_user_data = NULL,
+    };
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_bus_member_init(&other, &other_cfg));
+
+    uint8_t data[] = {0x30, 0x66, 0x00};
+    mock()
+        .expectOneCall("mock_sht3x_i2c_write")
+        .withParameter("length", sizeof(data))
+        .withParameter("i2c_addr", 0x45)
+        .withParameter("user_data", (void *)0x55)
+        .ignoreOtherParameters();
+    now_us = 2000;
+    sht3x_bus_i2c_write(data, sizeof(data), 0x45, &other, i2c_complete_cb, NULL);
+    now_us = 2100;
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_ADDRESS_NACK, i2c_write_complete_cb_user_data);
+    CHECK_EQUAL(2, complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_I2C_RESULT_CODE_ADDRESS_NACK, complete_cb_result_code);
+
+    SHT3XBusCounters counters;
+    sht3x_bus_member_get_counters(&other, &counters);
+    CHECK_EQUAL(1, counters.transactions);
+    CHECK_EQUAL(1, counters.failed_transactions);
+    CHECK_EQUAL(3, counters.bytes_written);
+    CHECK_EQUAL(100, counters.transaction_time_us);
+    /* 38 bits at 100 kHz */
+    CHECK_EQUAL(380, counters.airtime_us);
+
+    sht3x_bus_get_counters(&bus, &counters);
+    CHECK_EQUAL(3, counters.transactions);
+    CHECK_EQUAL(1, counters.failed_transactions);
+    CHECK_EQUAL(5, counters.bytes_written);
+    CHECK_EQUAL(2, counters.bytes_read);
+    CHECK_EQUAL(800, counters.transaction_time_us);
+    CHECK_EQUAL((2 * SHT3X_BUS_TEST_2_BYTE_AIRTIME_US) + 380, counters.airtime_us);
+}
+
+TEST(SHT3XBus, Occupancy)
+{
+    read_status_register();
+
+    uint16_t permille = 0;
+    uint8_t rc = sht3x_bus_get_occupancy(&bus, 5800, &permille);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(100, permille);
+    /* Airtime longer than the period */
+    rc = sht3x_bus_get_occupancy(&bus, 100, &permille);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(1000, permille);
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_bus_reset_counters(&bus));
+    rc = sht3x_bus_get_occupancy(&bus, 5800, &permille);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(0, permille);
+
+    /* Member counters are kept */
+    SHT3XBusCounters counters;
+    sht3x_bus_member_get_counters(&member, &counters);
+    CHECK_EQUAL(2, counters.transactions);
+}
+
+TEST(SHT3XBus, InvalidArgs)
+{
+    SHT3XBus other_bus;
+    SHT3XBusMember other;
+    SHT3XBusCounters counters;
+    uint16_t permille;
+    SHT3XBusMemberConfig cfg = {
+        .bus = &bus,
+        .i2c_write = mock_sht3x_i2c_write,
+        .i2c_write_user_data = NULL,
+        .i2c_read = NULL,
+        .i2c_read_user_data = NULL,
+    };
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_bus_init(NULL, SHT3X_BUS_TEST_SPEED_HZ, get_time_us, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_bus_init(&other_bus, 0, get_time_us, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_bus_init(&other_bus, SHT3X_BUS_TEST_SPEED_HZ, NULL, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_bus_member_init(&other, &cfg));
+    cfg.i2c_read = mock_sht3x_i2c_read;
+    cfg.bus = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_bus_member_init(&other, &cfg));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_bus_member_init(&other, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_bus_get_counters(&bus, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_bus_member_get_counters(NULL, &counters));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_bus_reset_counters(NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_bus_get_occupancy(&bus, 0, &permille));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_bus_get_occupancy(&bus, 1000, NULL));
+}
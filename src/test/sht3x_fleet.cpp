@@ -0,0 +1,196 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+
+#include "sht3x_fleet.h"
+#include "lazy_meas_builder.h"
+
+#define SHT3X_FLEET_TEST_NUM_SENSORS 4
+#define SHT3X_FLEET_TEST_NUM_FRAMES 3
+#define SHT3X_FLEET_TEST_NUM_SAMPLES (SHT3X_FLEET_TEST_NUM_SENSORS * SHT3X_FLEET_TEST_NUM_FRAMES)
+
+static SHT3XFleet fleet;
+static SHT3XFleetSlot slots[SHT3X_FLEET_TEST_NUM_SENSORS];
+static uint16_t raw_temperature[SHT3X_FLEET_TEST_NUM_SAMPLES];
+static uint16_t raw_humidity[SHT3X_FLEET_TEST_NUM_SAMPLES];
+static uint8_t status[SHT3X_FLEET_TEST_NUM_SAMPLES];
+static uint32_t timestamps[SHT3X_FLEET_TEST_NUM_FRAMES];
+
+static SHT3XFleetConfig get_cfg()
+{
+    SHT3XFleetConfig cfg = {
+        .num_sensors = SHT3X_FLEET_TEST_NUM_SENSORS,
+        .num_frames = SHT3X_FLEET_TEST_NUM_FRAMES,
+        .raw_temperature = raw_temperature,
+        .raw_humidity = raw_humidity,
+        .status = status,
+        .timestamps = timestamps,
+    };
+    return cfg;
+}
+
+// clang-format off
+TEST_GROUP(SHT3XFleet)
+{
+    void setup() {
+        memset(raw_temperature, 0xAA, sizeof(raw_temperature));
+        memset(raw_humidity, 0xAA, sizeof(raw_humidity));
+        memset(status, 0xAA, sizeof(status));
+        SHT3XFleetConfig cfg = get_cfg();
+        uint8_t rc = sht3x_fleet_init(&fleet, &cfg);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+        for (uint16_t i = 0; i < SHT3X_FLEET_TEST_NUM_SENSORS; i++) {
+            rc = sht3x_fleet_slot_init(&slots[i], &fleet, i);
+            CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+        }
+    }
+};
+// clang-format on
+
+/* Complete a readout of a sensor the way the driver does */
+static void complete_readout(uint16_t sensor, uint8_t result_code, uint8_t flags, uint16_t raw_temp, uint16_t raw_hum)
+{
+    SHT3XLazyMeasurement meas = build_lazy_meas(flags, raw_temp, raw_hum);
+    sht3x_fleet_lazy_meas_complete_cb(result_code, &meas, &slots[sensor]);
+}
+
+TEST(SHT3XFleet, FrameIsContiguous)
+{
+    sht3x_fleet_begin_frame(&fleet, 100);
+    complete_readout(0, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 0x6000, 0x8000);
+    complete_readout(2, SHT3X_RESULT_CODE_OK, SHT3X_FLAG_READ_TEMP, 0x6100, 0x1234);
+    complete_readout(3, SHT3X_RESULT_CODE_CRC_MISMATCH, SHT3X_TEST_ALL_FLAGS, 0x6200, 0x8200);
+
+    SHT3XFleetFrame frame;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_fleet_get_frame(&fleet, 0, &frame));
+    CHECK_EQUAL(100, frame.timestamp);
+    CHECK_EQUAL(SHT3X_FLEET_TEST_NUM_SENSORS, frame.num_sensors);
+    POINTERS_EQUAL(&raw_temperature[0], frame.raw_temperature);
+    POINTERS_EQUAL(&raw_humidity[0], frame.raw_humidity);
+
+    CHECK_EQUAL(SHT3X_FLEET_STATUS_TEMP | SHT3X_FLEET_STATUS_HUM, frame.status[0]);
+    CHECK_EQUAL(0x6000, frame.raw_temperature[0]);
+    CHECK_EQUAL(0x8000, frame.raw_humidity[0]);
+    /* Not read out */
+    CHECK_EQUAL(0, frame.status[1]);
+    /* Humidity was not read out */
+    CHECK_EQUAL(SHT3X_FLEET_STATUS_TEMP, frame.status[2]);
+    CHECK_EQUAL(0x6100, frame.raw_temperature[2]);
+    CHECK_EQUAL(SHT3X_FLEET_STATUS_CRC_MISMATCH, frame.status[3]);
+}
+
+TEST(SHT3XFleet, FramesFormARing)
+{
+    SHT3XFleetFrame frame;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_fleet_get_frame(&fleet, 0, &frame));
+    for (uint32_t t = 0; t < 5; t++) {
+        sht3x_fleet_begin_frame(&fleet, t);
+        complete_readout(1, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, (uint16_t)t, (uint16_t)t);
+    }
+
+    for (uint16_t age = 0; age < SHT3X_FLEET_TEST_NUM_FRAMES; age++) {
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_fleet_get_frame(&fleet, age, &frame));
+        CHECK_EQUAL(4 - age, frame.timestamp);
+        CHECK_EQUAL(4 - age, frame.raw_temperature[1]);
+        /* Status of a reused frame is cleared */
+        CHECK_EQUAL(0, frame.status[0]);
+    }
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_fleet_get_frame(&fleet, SHT3X_FLEET_TEST_NUM_FRAMES, &frame));
+}
+
+TEST(SHT3XFleet, ScanStats)
+{
+    sht3x_fleet_begin_frame(&fleet, 0);
+    complete_readout(0, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 100, 1000);
+    complete_readout(1, SHT3X_RESULT_CODE_OK, SHT3X_FLAG_READ_TEMP, 301, 0);
+    complete_readout(2, SHT3X_RESULT_CODE_NO_DATA, 0, 0, 0);
+    complete_readout(3, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 200, 3000);
+
+    SHT3XFleetFrame frame;
+    sht3x_fleet_get_frame(&fleet, 0, &frame);
+    SHT3XFleetStats stats;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_fleet_scan_stats(&frame, SHT3X_FLEET_COLUMN_TEMPERATURE, &stats));
+    CHECK_EQUAL(3, stats.count);
+    CHECK_EQUAL(100, stats.min);
+    CHECK_EQUAL(301, stats.max);
+    CHECK_EQUAL(601, stats.sum);
+    /* 200.33 */
+    CHECK_EQUAL(200, stats.mean);
+
+    /* Sensor 1 did not read out humidity */
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_fleet_scan_stats(&frame, SHT3X_FLEET_COLUMN_HUMIDITY, &stats));
+    CHECK_EQUAL(2, stats.count);
+    CHECK_EQUAL(1000, stats.min);
+    CHECK_EQUAL(3000, stats.max);
+    CHECK_EQUAL(2000, stats.mean);
+}
+
+TEST(SHT3XFleet, ScanStatsWithoutValidValues)
+{
+    sht3x_fleet_begin_frame(&fleet, 0);
+    SHT3XFleetFrame frame;
+    sht3x_fleet_get_frame(&fleet, 0, &frame);
+    SHT3XFleetStats stats;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_fleet_scan_stats(&frame, SHT3X_FLEET_COLUMN_TEMPERATURE, &stats));
+    CHECK_EQUAL(0, stats.count);
+    CHECK_EQUAL(0, stats.sum);
+    CHECK_EQUAL(0, stats.mean);
+}
+
+TEST(SHT3XFleet, ScanThreshold)
+{
+    sht3x_fleet_begin_frame(&fleet, 0);
+    complete_readout(0, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 100, 0);
+    complete_readout(1, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 500, 0);
+    /* Failed readout does not count, even with a large stale value */
+    complete_readout(2, SHT3X_RESULT_CODE_IO_ERR, SHT3X_TEST_ALL_FLAGS, 900, 0);
+    complete_readout(3, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 200, 0);
+
+    SHT3XFleetFrame frame;
+    sht3x_fleet_get_frame(&fleet, 0, &frame);
+    CHECK_EQUAL(SHT3X_FLEET_STATUS_ERROR, frame.status[2]);
+
+    uint8_t above[SHT3X_FLEET_TEST_NUM_SENSORS];
+    uint16_t count = 0;
+    uint8_t rc = sht3x_fleet_scan_threshold(&frame, SHT3X_FLEET_COLUMN_TEMPERATURE, 200, above, &count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(1, count);
+    uint8_t expected[] = {0, 1, 0, 0};
+    MEMCMP_EQUAL(expected, above, sizeof(expected));
+
+    rc = sht3x_fleet_scan_threshold(&frame, SHT3X_FLEET_COLUMN_TEMPERATURE, 99, NULL, &count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(3, count);
+}
+
+TEST(SHT3XFleet, InvalidArgs)
+{
+    SHT3XFleet other;
+    SHT3XFleetConfig cfg = get_cfg();
+    cfg.num_frames = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fleet_init(&other, &cfg));
+    cfg = get_cfg();
+    cfg.status = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fleet_init(&other, &cfg));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fleet_init(NULL, &cfg));
+
+    SHT3XLazyMeasurement meas = build_lazy_meas(0, 0, 0);
+    /* No frame yet */
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_fleet_store(&fleet, 0, SHT3X_RESULT_CODE_OK, &meas));
+    sht3x_fleet_begin_frame(&fleet, 0);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_fleet_store(&fleet, SHT3X_FLEET_TEST_NUM_SENSORS, SHT3X_RESULT_CODE_OK, &meas));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fleet_store(&fleet, 0, SHT3X_RESULT_CODE_OK, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_fleet_store(&fleet, 0, SHT3X_RESULT_CODE_IO_ERR, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fleet_slot_init(&slots[0], &fleet, SHT3X_FLEET_TEST_NUM_SENSORS));
+
+    SHT3XFleetFrame frame;
+    SHT3XFleetStats stats;
+    uint16_t count;
+    sht3x_fleet_get_frame(&fleet, 0, &frame);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fleet_scan_stats(&frame, 2, &stats));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fleet_scan_stats(NULL, SHT3X_FLEET_COLUMN_TEMPERATURE, &stats));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fleet_scan_threshold(&frame, 2, 0, NULL, &count));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_fleet_scan_threshold(&frame, SHT3X_FLEET_COLUMN_TEMPERATURE, 0, NULL, NULL));
+}
@@ -0,0 +1,191 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+#include "sht3x.h"
+#include "sht3x_flight_recorder.h"
+/* Included to know the size of SHT3X instance we need to define to return from mock_sht3x_get_instance_memory. */
+#include "sht3x_private.h"
+#include "mock_cfg_functions.h"
+
+#define SHT3X_FLIGHT_RECORDER_TEST_I2C_ADDR 0x44
+#define SHT3X_FLIGHT_RECORDER_TEST_NUM_EVENTS 3
+
+/* To return from mock_sht3x_get_instance_memory */
+static struct SHT3XStruct instance_memory;
+
+static SHT3X sht3x;
+static SHT3XFlightRecorder recorder;
+static uint8_t ring[SHT3X_FLIGHT_RECORDER_TEST_NUM_EVENTS * SHT3X_FLIGHT_RECORDER_EVENT_SIZE];
+static uint8_t dump[SHT3X_FLIGHT_RECORDER_DUMP_HEADER_SIZE + sizeof(ring)];
+
+/* Populated by mock object whenever mock_sht3x_i2c_write is called */
+static SHT3X_I2CTransactionCompleteCb i2c_write_complete_cb;
+static void *i2c_write_complete_cb_user_data;
+
+// clang-format off
+TEST_GROUP(SHT3XFlightRecorder)
+{
+    void setup() {
+        /* Order of expected calls is important for these tests. Fail the test if the expected mock calls do not happen
+        in the specified order. */
+        mock().strictOrder();
+
+        i2c_write_complete_cb = NULL;
+        i2c_write_complete_cb_user_data = NULL;
+        mock().setData("i2cWriteCompleteCb", (void *)&i2c_write_complete_cb);
+        mock().setData("i2cWriteCompleteCbUserData", &i2c_write_complete_cb_user_data);
+
+        memset(&instance_memory, 0, sizeof(instance_memory));
+        memset(ring, 0, sizeof(ring));
+        memset(dump, 0, sizeof(dump));
+        uint8_t rc = sht3x_flight_recorder_init(&recorder, ring, sizeof(ring));
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+        mock()
+            .expectOneCall("mock_sht3x_get_instance_memory")
+            .withParameter("user_data", (void *)NULL)
+            .andReturnValue((void *)&instance_memory);
+        SHT3XInitConfig init_cfg = {
+            .get_instance_memory = mock_sht3x_get_instance_memory,
+            .get_instance_memory_user_data = NULL,
+            .i2c_write = mock_sht3x_i2c_write,
+            .i2c_write_user_data = NULL,
+            .i2c_read = mock_sht3x_i2c_read,
+            .i2c_read_user_data = NULL,
+            .start_timer = mock_sht3x_start_timer,
+            .start_timer_user_data = NULL,
+            .i2c_addr = SHT3X_FLIGHT_RECORDER_TEST_I2C_ADDR,
+            .trace_hook = sht3x_flight_recorder_hook,
+            .trace_hook_user_data = &recorder,
+        };
+        rc = sht3x_create(&sht3x, &init_cfg);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    }
+};
+// clang-format on
+
+static void check_decoded(size_t length, size_t idx, uint8_t type, uint8_t sequence_type, uint8_t result_code,
+                          uint32_t arg)
+{
+    SHT3XTraceEvent event;
+    uint8_t rc = sht3x_flight_recorder_decode_event(dump, length, idx, &event);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    POINTERS_EQUAL(NULL, event.instance);
+    CHECK_EQUAL(type, event.type);
+    CHECK_EQUAL(sequence_type, event.sequence_type);
+    CHECK_EQUAL(result_code, event.result_code);
+    CHECK_EQUAL(arg, event.arg);
+}
+
+TEST(SHT3XFlightRecorder, RecordsDriverEvents)
+{
+    mock().expectOneCall("mock_sht3x_i2c_write").ignoreOtherParameters();
+    uint8_t rc = sht3x_enable_heater(sht3x, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_ADDRESS_NACK, i2c_write_complete_cb_user_data);
+
+    size_t length = 0;
+    rc = sht3x_flight_recorder_dump(&recorder, dump, sizeof(dump), &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(SHT3X_FLIGHT_RECORDER_DUMP_HEADER_SIZE + (3 * SHT3X_FLIGHT_RECORDER_EVENT_SIZE), length);
+
+    size_t num_events = 0;
+    uint32_t total = 0;
+    rc = sht3x_flight_recorder_decode_header(dump, length, &num_events, &total);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(3, num_events);
+    /* Sequence start was overwritten */
+    CHECK_EQUAL(4, total);
+
+    uint8_t seq = SHT3X_SEQUENCE_TYPE_WRITE_CMD;
+    /* Heater on command */
+    check_decoded(length, 0, SHT3X_TRACE_EVENT_I2C_WRITE_ISSUE, seq, 0, 0x306D);
+    check_decoded(length, 1, SHT3X_TRACE_EVENT_I2C_WRITE_COMPLETE, seq, SHT3X_I2C_RESULT_CODE_ADDRESS_NACK, 0);
+    check_decoded(length, 2, SHT3X_TRACE_EVENT_SEQUENCE_END, seq, SHT3X_RESULT_CODE_IO_ERR, 0);
+}
+
+TEST(SHT3XFlightRecorder, DumpBeforeWrapIsOldestFirst)
+{
+    SHT3XTraceEvent event = {
+        .instance = sht3x,
+        .type = SHT3X_TRACE_EVENT_TIMER_ARM,
+        .sequence_type = SHT3X_SEQUENCE_TYPE_SINGLE_SHOT_MEAS,
+        .result_code = 0,
+        .arg = 16,
+    };
+    sht3x_flight_recorder_hook(&event, &recorder);
+    /* Does not fit into 16 bits */
+    event.arg = 70000;
+    sht3x_flight_recorder_hook(&event, &recorder);
+
+    size_t length = 0;
+    uint8_t rc = sht3x_flight_recorder_dump(&recorder, dump, sizeof(dump), &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    uint8_t expected[] = {
+        0x01, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02, /* Header */
+        0x62, 0x00, 0x00, 0x10, /* Timer arm, single shot meas, 16 ms */
+        0x62, 0x00, 0xFF, 0xFF, /* Timer arm, single shot meas, saturated */
+    };
+    CHECK_EQUAL(sizeof(expected), length);
+    MEMCMP_EQUAL(expected, dump, sizeof(expected));
+    check_decoded(length, 1, SHT3X_TRACE_EVENT_TIMER_ARM, SHT3X_SEQUENCE_TYPE_SINGLE_SHOT_MEAS, 0, 0xFFFF);
+}
+
+TEST(SHT3XFlightRecorder, ClearRemovesEvents)
+{
+    SHT3XTraceEvent event = {
+        .instance = sht3x,
+        .type = SHT3X_TRACE_EVENT_TIMER_EXPIRE,
+        .sequence_type = SHT3X_SEQUENCE_TYPE_READ_MEAS,
+        .result_code = 0,
+        .arg = 0,
+    };
+    sht3x_flight_recorder_hook(&event, &recorder);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_flight_recorder_clear(&recorder));
+
+    size_t length = 0;
+    uint8_t rc = sht3x_flight_recorder_dump(&recorder, dump, sizeof(dump), &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(SHT3X_FLIGHT_RECORDER_DUMP_HEADER_SIZE, length);
+    size_t num_events = 0xFF;
+    uint32_t total = 0xFF;
+    sht3x_flight_recorder_decode_header(dump, length, &num_events, &total);
+    CHECK_EQUAL(0, num_events);
+    CHECK_EQUAL(0, total);
+}
+
+TEST(SHT3XFlightRecorder, InvalidArgs)
+{
+    SHT3XFlightRecorder other;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_flight_recorder_init(NULL, ring, sizeof(ring)));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_flight_recorder_init(&other, NULL, sizeof(ring)));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_flight_recorder_init(&other, ring, 0));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_flight_recorder_init(&other, ring, sizeof(ring) - 1));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_flight_recorder_clear(NULL));
+
+    SHT3XTraceEvent event = {
+        .instance = sht3x,
+        .type = SHT3X_TRACE_EVENT_TIMER_EXPIRE,
+        .sequence_type = SHT3X_SEQUENCE_TYPE_READ_MEAS,
+        .result_code = 0,
+        .arg = 0,
+    };
+    sht3x_flight_recorder_hook(&event, &recorder);
+    size_t length = 0;
+    /* One event does not fit */
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OUT_OF_MEMORY,
+                sht3x_flight_recorder_dump(&recorder, dump, SHT3X_FLIGHT_RECORDER_DUMP_HEADER_SIZE, &length));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_flight_recorder_dump(&recorder, dump, sizeof(dump), NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_flight_recorder_dump(&recorder, dump, sizeof(dump), &length));
+
+    SHT3XTraceEvent decoded;
+    /* Out of range */
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_flight_recorder_decode_event(dump, length, 1, &decoded));
+    /* Truncated */
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_flight_recorder_decode_event(dump, length - 1, 0, &decoded));
+    /* Unknown version */
+    dump[0] = 2;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_flight_recorder_decode_event(dump, length, 0, &decoded));
+}
@@ -0,0 +1,396 @@
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+
+#include "CppUTest/TestHarness.h"
+
+#include "sht3x_fusion.h"
+#include "sht3x_fleet.h"
+#include "lazy_meas_builder.h"
+
+#define SHT3X_FUSION_TEST_NUM_GROUPS 200
+
+static SHT3XFusionGroup group;
+static uint8_t complete_cb_call_count;
+static uint8_t complete_cb_result_code;
+static SHT3XFusionResult complete_cb_result;
+
+static void complete_cb(uint8_t result_code, const SHT3XFusionResult *result, void *user_data)
+{
+    POINTERS_EQUAL(&group, user_data);
+    complete_cb_call_count++;
+    complete_cb_result_code = result_code;
+    complete_cb_result = *result;
+}
+
+static SHT3XFusionConfig get_cfg(uint8_t method, uint8_t trim, uint16_t max_deviation, uint8_t min_members)
+{
+    SHT3XFusionConfig cfg = {
+        .method = method,
+        .trim = trim,
+        .max_deviation = max_deviation,
+        .min_members = min_members,
+    };
+    return cfg;
+}
+
+static void init_group(const SHT3XFusionConfig *cfg, uint8_t num_members)
+{
+    uint8_t rc = sht3x_fusion_init(&group, cfg, num_members, complete_cb, &group);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+}
+
+// clang-format off
+TEST_GROUP(SHT3XFusion)
+{
+    void setup() {
+        complete_cb_call_count = 0;
+        complete_cb_result_code = 0xFF;
+        memset(&complete_cb_result, 0xAA, sizeof(complete_cb_result));
+    }
+};
+// clang-format on
+
+/* Complete a readout of a member the way the driver does */
+static void complete_readout(uint8_t index, uint8_t result_code, uint8_t flags, uint16_t raw_temp, uint16_t raw_hum)
+{
+    SHT3XFusionMember *member;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_fusion_get_member(&group, index, &member));
+    SHT3XLazyMeasurement meas = build_lazy_meas(flags, raw_temp, raw_hum);
+    sht3x_fusion_lazy_meas_complete_cb(result_code, &meas, member);
+}
+
+static SHT3XFusionMemberCounters get_counters(uint8_t index)
+{
+    SHT3XFusionMemberCounters counters;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_fusion_get_member_counters(&group, index, &counters));
+    return counters;
+}
+
+TEST(SHT3XFusion, MedianOfThree)
+{
+    SHT3XFusionConfig cfg = get_cfg(SHT3X_FUSION_METHOD_MEDIAN, 0, 0, 1);
+    init_group(&cfg, 3);
+
+    complete_readout(0, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 0x6200, 0x8000);
+    complete_readout(1, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 0x6000, 0x9000);
+    CHECK_EQUAL(0, complete_cb_call_count);
+    complete_readout(2, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 0x6100, 0x2000);
+
+    CHECK_EQUAL(1, complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, complete_cb_result_code);
+    CHECK_EQUAL(0x6100, complete_cb_result.raw_temperature);
+    CHECK_EQUAL(0x8000, complete_cb_result.raw_humidity);
+    CHECK_EQUAL(3, complete_cb_result.temperature_members);
+    CHECK_EQUAL(3, complete_cb_result.humidity_members);
+}
+
+TEST(SHT3XFusion, MedianOfEvenCountIsRoundedMean)
+{
+    SHT3XFusionConfig cfg = get_cfg(SHT3X_FUSION_METHOD_MEDIAN, 0, 0, 1);
+    init_group(&cfg, 4);
+
+    complete_readout(0, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 100, 7);
+    complete_readout(1, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 101, 1);
+    complete_readout(2, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 90, 2);
+    complete_readout(3, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 200, 10);
+
+    CHECK_EQUAL(1, complete_cb_call_count);
+    /* (100 + 101) / 2 and (2 + 7) / 2, rounded up */
+    CHECK_EQUAL(101, complete_cb_result.raw_temperature);
+    CHECK_EQUAL(5, complete_cb_result.raw_humidity);
+}
+
+TEST(SHT3XFusion, OutlierIsRejectedAndCounted)
+{
+    SHT3XFusionConfig cfg = get_cfg(SHT3X_FUSION_METHOD_MEDIAN, 0, 20, 2);
+    init_group(&cfg, 3);
+
+    complete_readout(0, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 100, 1000);
+    complete_readout(1, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 110, 1020);
+    complete_readout(2, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 500, 1010);
+
+    CHECK_EQUAL(1, complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, complete_cb_result_code);
+    /* Median 110, member 2 is 390 ticks off */
+    CHECK_EQUAL(105, complete_cb_result.raw_temperature);
+    CHECK_EQUAL(2, complete_cb_result.temperature_members);
+    CHECK_EQUAL(1010, complete_cb_result.raw_humidity);
+    CHECK_EQUAL(3, complete_cb_result.humidity_members);
+
+    CHECK_EQUAL(0, get_counters(0).outliers);
+    CHECK_EQUAL(0, get_counters(1).outliers);
+    CHECK_EQUAL(1, get_counters(2).outliers);
+
+    /* Next round, member 2 is off in both values */
+    complete_readout(0, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 100, 1000);
+    complete_readout(1, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 110, 1020);
+    complete_readout(2, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 500, 3000);
+
+    CHECK_EQUAL(2, complete_cb_call_count);
+    CHECK_EQUAL(1010, complete_cb_result.raw_humidity);
+    CHECK_EQUAL(2, complete_cb_result.humidity_members);
+    CHECK_EQUAL(3, get_counters(2).outliers);
+    CHECK_EQUAL(2, get_counters(2).readouts);
+    CHECK_EQUAL(0, get_counters(2).failures);
+}
+
+TEST(SHT3XFusion, FailedReadoutIsLeftOutAndCounted)
+{
+    SHT3XFusionConfig cfg = get_cfg(SHT3X_FUSION_METHOD_MEDIAN, 0, 0, 2);
+    init_group(&cfg, 3);
+
+    complete_readout(0, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 100, 1000);
+    complete_readout(1, SHT3X_RESULT_CODE_CRC_MISMATCH, SHT3X_TEST_ALL_FLAGS, 9000, 9000);
+    /* Humidity was not read out */
+    complete_readout(2, SHT3X_RESULT_CODE_OK, SHT3X_FLAG_READ_TEMP, 120, 9000);
+
+    CHECK_EQUAL(1, complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, complete_cb_result_code);
+    CHECK_EQUAL(110, complete_cb_result.raw_temperature);
+    CHECK_EQUAL(2, complete_cb_result.temperature_members);
+    /* Only one humidity, below min_members */
+    CHECK_EQUAL(0, complete_cb_result.raw_humidity);
+    CHECK_EQUAL(0, complete_cb_result.humidity_members);
+
+    CHECK_EQUAL(1, get_counters(1).readouts);
+    CHECK_EQUAL(1, get_counters(1).failures);
+    CHECK_EQUAL(0, get_counters(0).failures);
+    CHECK_EQUAL(0, get_counters(2).failures);
+}
+
+TEST(SHT3XFusion, NoDataWithoutQuorum)
+{
+    SHT3XFusionConfig cfg = get_cfg(SHT3X_FUSION_METHOD_MEDIAN, 0, 0, 2);
+    init_group(&cfg, 3);
+
+    complete_readout(0, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 100, 1000);
+    complete_readout(1, SHT3X_RESULT_CODE_IO_ERR, 0, 0, 0);
+    complete_readout(2, SHT3X_RESULT_CODE_NO_DATA, 0, 0, 0);
+
+    CHECK_EQUAL(1, complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, complete_cb_result_code);
+    CHECK_EQUAL(0, complete_cb_result.temperature_members);
+    CHECK_EQUAL(0, complete_cb_result.humidity_members);
+}
+
+TEST(SHT3XFusion, TrimmedMean)
+{
+    SHT3XFusionConfig cfg = get_cfg(SHT3X_FUSION_METHOD_TRIMMED_MEAN, 1, 0, 1);
+    init_group(&cfg, 5);
+
+    complete_readout(0, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 40, 10);
+    complete_readout(1, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 1000, 20);
+    complete_readout(2, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 20, 0);
+    complete_readout(3, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 10, 21);
+    complete_readout(4, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 31, 65535);
+
+    CHECK_EQUAL(1, complete_cb_call_count);
+    /* (20 + 31 + 40) / 3 and (10 + 20 + 21) / 3 */
+    CHECK_EQUAL(30, complete_cb_result.raw_temperature);
+    CHECK_EQUAL(5, complete_cb_result.temperature_members);
+    CHECK_EQUAL(17, complete_cb_result.raw_humidity);
+}
+
+TEST(SHT3XFusion, TrimIsReducedForFewValues)
+{
+    SHT3XFusionConfig cfg = get_cfg(SHT3X_FUSION_METHOD_TRIMMED_MEAN, 2, 0, 1);
+    init_group(&cfg, 5);
+
+    complete_readout(0, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 10, 10);
+    complete_readout(1, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 20, 20);
+    complete_readout(2, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 60, 30);
+    complete_readout(3, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 90, 40);
+    complete_readout(4, SHT3X_RESULT_CODE_IO_ERR, 0, 0, 0);
+
+    CHECK_EQUAL(1, complete_cb_call_count);
+    /* Trim 1 of 4 values */
+    CHECK_EQUAL(40, complete_cb_result.raw_temperature);
+    CHECK_EQUAL(4, complete_cb_result.temperature_members);
+    CHECK_EQUAL(25, complete_cb_result.raw_humidity);
+}
+
+TEST(SHT3XFusion, RepeatedReportReplacesReadout)
+{
+    SHT3XFusionConfig cfg = get_cfg(SHT3X_FUSION_METHOD_MEDIAN, 0, 0, 1);
+    init_group(&cfg, 2);
+
+    complete_readout(0, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 100, 100);
+    complete_readout(0, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 200, 200);
+    CHECK_EQUAL(0, complete_cb_call_count);
+    complete_readout(1, SHT3X_RESULT_CODE_OK, SHT3X_TEST_ALL_FLAGS, 300, 300);
+
+    CHECK_EQUAL(1, complete_cb_call_count);
+    CHECK_EQUAL(250, complete_cb_result.raw_temperature);
+    CHECK_EQUAL(2, get_counters(0).readouts);
+    CHECK_EQUAL(1, get_counters(1).readouts);
+}
+
+/* Straightforward fusion of one group, to compare the batch against */
+static uint8_t reference_fuse(const SHT3XFusionConfig *cfg, const uint16_t *values, const uint8_t *status,
+                              uint8_t num_members, uint16_t *fused)
+{
+    uint16_t valid[SHT3X_FUSION_MAX_MEMBERS];
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < num_members; i++) {
+        if (status[i] & SHT3X_FLEET_STATUS_TEMP) {
+            valid[count++] = values[i];
+        }
+    }
+    std::sort(valid, valid + count);
+    if ((count > 0) && (cfg->max_deviation > 0)) {
+        uint32_t median2 = (count & 1) ? (2U * valid[count / 2]) : ((uint32_t)valid[count / 2 - 1] + valid[count / 2]);
+        uint16_t median = (uint16_t)((median2 + 1) / 2);
+        uint8_t kept = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            if (abs((int)valid[i] - (int)median) <= cfg->max_deviation) {
+                valid[kept++] = valid[i];
+            }
+        }
+        count = kept;
+    }
+    if ((count == 0) || (count < cfg->min_members)) {
+        *fused = 0;
+        return 0;
+    }
+    uint8_t trim = 0;
+    if (cfg->method == SHT3X_FUSION_METHOD_TRIMMED_MEAN) {
+        trim = std::min<uint8_t>(cfg->trim, (uint8_t)((count - 1) / 2));
+    } else {
+        /* The median is the trimmed mean of the one or two middle values */
+        trim = (uint8_t)((count - 1) / 2);
+    }
+    uint32_t sum = 0;
+    for (uint8_t i = trim; i < count - trim; i++) {
+        sum += valid[i];
+    }
+    uint8_t n = (uint8_t)(count - 2 * trim);
+    *fused = (uint16_t)((sum + n / 2) / n);
+    return count;
+}
+
+TEST(SHT3XFusion, BatchMatchesReference)
+{
+    static uint16_t values[SHT3X_FUSION_TEST_NUM_GROUPS * SHT3X_FUSION_MAX_MEMBERS];
+    static uint8_t status[SHT3X_FUSION_TEST_NUM_GROUPS * SHT3X_FUSION_MAX_MEMBERS];
+    static uint16_t fused[SHT3X_FUSION_TEST_NUM_GROUPS];
+    static uint8_t fused_members[SHT3X_FUSION_TEST_NUM_GROUPS];
+
+    srand(7);
+    for (uint8_t num_members = 1; num_members <= SHT3X_FUSION_MAX_MEMBERS; num_members++) {
+        for (uint8_t method = SHT3X_FUSION_METHOD_MEDIAN; method <= SHT3X_FUSION_METHOD_TRIMMED_MEAN; method++) {
+            SHT3XFusionConfig cfg =
+                get_cfg(method, (uint8_t)(rand() % 3), (uint16_t)(rand() % 2 ? 0 : 300), (uint8_t)(1 + rand() % 2));
+            if (cfg.min_members > num_members) {
+                cfg.min_members = num_members;
+            }
+            size_t num_values = (size_t)SHT3X_FUSION_TEST_NUM_GROUPS * num_members;
+            for (size_t i = 0; i < num_values; i++) {
+                values[i] = (uint16_t)(0x6000 + (rand() % 1000) - 500 + ((rand() % 8 == 0) ? 5000 : 0));
+                status[i] = (rand() % 6 == 0) ? SHT3X_FLEET_STATUS_CRC_MISMATCH : SHT3X_FLEET_STATUS_TEMP;
+            }
+
+            uint8_t rc = sht3x_fusion_batch(&cfg, num_members, values, status, SHT3X_FLEET_STATUS_TEMP,
+                                            SHT3X_FUSION_TEST_NUM_GROUPS, fused, fused_members);
+            CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+            for (size_t g = 0; g < SHT3X_FUSION_TEST_NUM_GROUPS; g++) {
+                uint16_t expected;
+                size_t offset = g * num_members;
+                uint8_t expected_members = reference_fuse(&cfg, &values[offset], &status[offset], num_members,
+                                                          &expected);
+                CHECK_EQUAL(expected_members, fused_members[g]);
+                CHECK_EQUAL(expected, fused[g]);
+            }
+        }
+    }
+}
+
+TEST(SHT3XFusion, BatchOverFleetFrame)
+{
+    /* Two groups of three sensors in consecutive slots */
+    static uint16_t raw_temperature[6];
+    static uint16_t raw_humidity[6];
+    static uint8_t status[6];
+    static uint32_t timestamps[1];
+    SHT3XFleetConfig fleet_cfg = {
+        .num_sensors = 6,
+        .num_frames = 1,
+        .raw_temperature = raw_temperature,
+        .raw_humidity = raw_humidity,
+        .status = status,
+        .timestamps = timestamps,
+    };
+    SHT3XFleet fleet;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_fleet_init(&fleet, &fleet_cfg));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_fleet_begin_frame(&fleet, 0));
+
+    const uint16_t temps[6] = {100, 300, 200, 50, 60, 70};
+    for (uint16_t i = 0; i < 6; i++) {
+        SHT3XLazyMeasurement meas = build_lazy_meas(SHT3X_FLAG_READ_TEMP, temps[i], 0);
+        uint8_t rc = (i == 5) ? SHT3X_RESULT_CODE_IO_ERR : SHT3X_RESULT_CODE_OK;
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_fleet_store(&fleet, i, rc, &meas));
+    }
+
+    SHT3XFleetFrame frame;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_fleet_get_frame(&fleet, 0, &frame));
+    SHT3XFusionConfig cfg = get_cfg(SHT3X_FUSION_METHOD_MEDIAN, 0, 0, 1);
+    uint16_t fused[2];
+    uint8_t fused_members[2];
+    uint8_t rc = sht3x_fusion_batch(&cfg, 3, frame.raw_temperature, frame.status, SHT3X_FLEET_STATUS_TEMP, 2, fused,
+                                    fused_members);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(200, fused[0]);
+    CHECK_EQUAL(3, fused_members[0]);
+    CHECK_EQUAL(55, fused[1]);
+    CHECK_EQUAL(2, fused_members[1]);
+}
+
+TEST(SHT3XFusion, InvalidArgs)
+{
+    SHT3XFusionConfig cfg = get_cfg(SHT3X_FUSION_METHOD_MEDIAN, 0, 0, 2);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fusion_init(NULL, &cfg, 3, complete_cb, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fusion_init(&group, NULL, 3, complete_cb, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fusion_init(&group, &cfg, 3, NULL, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fusion_init(&group, &cfg, 0, complete_cb, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_fusion_init(&group, &cfg, SHT3X_FUSION_MAX_MEMBERS + 1, complete_cb, NULL));
+    /* min_members above num_members */
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fusion_init(&group, &cfg, 1, complete_cb, NULL));
+    cfg.min_members = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fusion_init(&group, &cfg, 3, complete_cb, NULL));
+    cfg.min_members = 1;
+    cfg.method = 2;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fusion_init(&group, &cfg, 3, complete_cb, NULL));
+    cfg.method = SHT3X_FUSION_METHOD_MEDIAN;
+    init_group(&cfg, 3);
+
+    SHT3XFusionMember *member;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fusion_get_member(NULL, 0, &member));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fusion_get_member(&group, 0, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fusion_get_member(&group, 3, &member));
+
+    SHT3XFusionMemberCounters counters;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fusion_get_member_counters(NULL, 0, &counters));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fusion_get_member_counters(&group, 0, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_fusion_get_member_counters(&group, 3, &counters));
+
+    /* Must not crash */
+    sht3x_fusion_lazy_meas_complete_cb(SHT3X_RESULT_CODE_OK, NULL, NULL);
+
+    uint16_t values[3] = {0};
+    uint8_t status[3] = {0};
+    uint16_t fused;
+    uint8_t fused_members;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_fusion_batch(NULL, 3, values, status, 1, 1, &fused, &fused_members));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_fusion_batch(&cfg, 0, values, status, 1, 1, &fused, &fused_members));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_fusion_batch(&cfg, 3, NULL, status, 1, 1, &fused, &fused_members));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_fusion_batch(&cfg, 3, values, NULL, 1, 1, &fused, &fused_members));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_fusion_batch(&cfg, 3, values, status, 1, 1, NULL, &fused_members));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_fusion_batch(&cfg, 3, values, status, 1, 1, &fused, NULL));
+}
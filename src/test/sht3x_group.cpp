@@ -0,0 +1,318 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+#include "sht3x.h"
+#include "sht3x_group.h"
+/* Included to know the size of SHT3X instance we need to define to return from mock_sht3x_get_instance_memory. */
+#include "sht3x_private.h"
+#include "mock_cfg_functions.h"
+
+#define SHT3X_GROUP_TEST_NUM_INSTANCES 3
+
+/* To return from mock_sht3x_get_instance_memory */
+static struct SHT3XStruct instance_memory[SHT3X_GROUP_TEST_NUM_INSTANCES];
+
+/* Devices 0 and 1 are on one bus, device 2 is on another bus. I2C write/read user data identifies the bus. */
+static const uint8_t i2c_addrs[SHT3X_GROUP_TEST_NUM_INSTANCES] = {0x44, 0x45, 0x44};
+static void *i2c_user_data[SHT3X_GROUP_TEST_NUM_INSTANCES] = {(void *)0x10, (void *)0x10, (void *)0x20};
+static void *start_timer_user_data = (void *)0x56;
+static void *group_start_timer_user_data = (void *)0x78;
+
+static SHT3X instances[SHT3X_GROUP_TEST_NUM_INSTANCES];
+static uint8_t results[SHT3X_GROUP_TEST_NUM_INSTANCES];
+static SHT3XGroup group;
+static SHT3XGroupConfig group_cfg;
+
+/* Populated by mock object whenever mock_sht3x_i2c_write is called */
+static SHT3X_I2CTransactionCompleteCb i2c_write_complete_cb;
+static void *i2c_write_complete_cb_user_data;
+
+/* Populated by mock object whenever mock_sht3x_i2c_read is called */
+static SHT3X_I2CTransactionCompleteCb i2c_read_complete_cb;
+static void *i2c_read_complete_cb_user_data;
+
+/* Populated by mock object whenever mock_sht3x_start_timer is called */
+static SHT3XTimerExpiredCb timer_expired_cb;
+static void *timer_expired_cb_user_data;
+
+static size_t group_init_complete_cb_call_count;
+static uint8_t group_init_complete_cb_result_code;
+static void *group_init_complete_cb_user_data;
+
+static void group_init_complete_cb(uint8_t result_code, void *user_data)
+{
+    group_init_complete_cb_call_count++;
+    group_init_complete_cb_result_code = result_code;
+    group_init_complete_cb_user_data = user_data;
+}
+
+// clang-format off
+TEST_GROUP(SHT3XGroup)
+{
+    void setup() {
+        /* Order of expected calls is important for these tests. Fail the test if the expected mock calls do not happen
+        in the specified order. */
+        mock().strictOrder();
+
+        i2c_write_complete_cb = NULL;
+        i2c_write_complete_cb_user_data = NULL;
+        i2c_read_complete_cb = NULL;
+        i2c_read_complete_cb_user_data = NULL;
+        timer_expired_cb = NULL;
+        timer_expired_cb_user_data = NULL;
+
+        mock().setData("i2cWriteCompleteCb", (void *)&i2c_write_complete_cb);
+        mock().setData("i2cWriteCompleteCbUserData", &i2c_write_complete_cb_user_data);
+        mock().setData("i2cReadCompleteCb", (void *)&i2c_read_complete_cb);
+        mock().setData("i2cReadCompleteCbUserData", &i2c_read_complete_cb_user_data);
+        mock().setData("timerExpiredCb", (void *)&timer_expired_cb);
+        mock().setData("timerExpiredCbUserData", &timer_expired_cb_user_data);
+
+        group_init_complete_cb_call_count = 0;
+        group_init_complete_cb_result_code = 0xFF; /* 0 is a valid code, reset to an invalid code */
+        group_init_complete_cb_user_data = NULL;
+
+        memset(instance_memory, 0, sizeof(instance_memory));
+        memset(results, 0xFF, sizeof(results));
+        memset(&group, 0, sizeof(group));
+
+        for (size_t i = 0; i < SHT3X_GROUP_TEST_NUM_INSTANCES; i++) {
+            mock()
+                .expectOneCall("mock_sht3x_get_instance_memory")
+                .withParameter("user_data", (void *)NULL)
+                .andReturnValue((void *)&instance_memory[i]);
+            SHT3XInitConfig init_cfg = {
+                .get_instance_memory = mock_sht3x_get_instance_memory,
+                .get_instance_memory_user_data = NULL,
+                .i2c_write = mock_sht3x_i2c_write,
+                .i2c_write_user_data = i2c_user_data[i],
+                .i2c_read = mock_sht3x_i2c_read,
+                .i2c_read_user_data = i2c_user_data[i],
+                .start_timer = mock_sht3x_start_timer,
+                .start_timer_user_data = start_timer_user_data,
+                .i2c_addr = i2c_addrs[i],
+            };
+            uint8_t rc = sht3x_create(&instances[i], &init_cfg);
+            CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+        }
+
+        memset(&group_cfg, 0, sizeof(group_cfg));
+        group_cfg.instances = instances;
+        group_cfg.results = results;
+        group_cfg.num_instances = SHT3X_GROUP_TEST_NUM_INSTANCES;
+        group_cfg.init_cfg.meas_mode = SHT3X_MEAS_MODE_PERIODIC;
+        group_cfg.init_cfg.repeatability = SHT3X_MEAS_REPEATABILITY_HIGH;
+        group_cfg.init_cfg.mps = SHT3X_MPS_1;
+        group_cfg.init_cfg.verify_status = false;
+        group_cfg.start_timer = mock_sht3x_start_timer;
+        group_cfg.start_timer_user_data = group_start_timer_user_data;
+    }
+};
+// clang-format on
+
+static void expect_write(size_t idx, uint8_t *cmd)
+{
+    mock()
+        .expectOneCall("mock_sht3x_i2c_write")
+        .withMemoryBufferParameter("data", cmd, 2)
+        .withParameter("length", 2)
+        .withParameter("i2c_addr", i2c_addrs[idx])
+        .withParameter("user_data", i2c_user_data[idx])
+        .ignoreOtherParameters();
+}
+
+static void expect_group_timer(uint32_t duration_ms)
+{
+    mock()
+        .expectOneCall("mock_sht3x_start_timer")
+        .withParameter("duration_ms", duration_ms)
+        .withParameter("user_data", group_start_timer_user_data)
+        .ignoreOtherParameters();
+}
+
+/* Expect a command to every instance whose bit is set in instance_mask */
+static void expect_write_to_instances(uint8_t *cmd, uint8_t instance_mask)
+{
+    for (size_t i = 0; i < SHT3X_GROUP_TEST_NUM_INSTANCES; i++) {
+        if (instance_mask & (1U << i)) {
+            expect_write(i, cmd);
+        }
+    }
+}
+
+/* Complete I2C writes of all instances whose bit is set in instance_mask. Write to instance with index fail_idx fails
+ * with a bus error. */
+static void complete_writes(uint8_t instance_mask, size_t fail_idx)
+{
+    for (size_t i = 0; i < SHT3X_GROUP_TEST_NUM_INSTANCES; i++) {
+        if (instance_mask & (1U << i)) {
+            uint8_t rc = (i == fail_idx) ? SHT3X_I2C_RESULT_CODE_BUS_ERROR : SHT3X_I2C_RESULT_CODE_OK;
+            i2c_write_complete_cb(rc, i2c_write_complete_cb_user_data);
+        }
+    }
+}
+
+#define ALL_INSTANCES 0x07
+#define NO_FAIL SHT3X_GROUP_TEST_NUM_INSTANCES
+
+static uint8_t soft_reset_cmd[] = {0x30, 0xA2};
+static uint8_t clear_status_cmd[] = {0x30, 0x41};
+/* Start periodic meas, high repeatability, 1 mps */
+static uint8_t start_periodic_cmd[] = {0x21, 0x30};
+
+TEST(SHT3XGroup, InitSharesDelaysBetweenInstances)
+{
+    expect_write_to_instances(soft_reset_cmd, ALL_INSTANCES);
+    /* One soft reset delay for all instances */
+    expect_group_timer(2);
+    expect_write_to_instances(clear_status_cmd, ALL_INSTANCES);
+    /* One mandatory delay for all instances */
+    expect_group_timer(1);
+    expect_write_to_instances(start_periodic_cmd, ALL_INSTANCES);
+
+    void *user_data = (void *)0x9A;
+    uint8_t rc = sht3x_group_init(&group, &group_cfg, group_init_complete_cb, user_data);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    complete_writes(ALL_INSTANCES, NO_FAIL);
+    timer_expired_cb(timer_expired_cb_user_data);
+    complete_writes(ALL_INSTANCES, NO_FAIL);
+    timer_expired_cb(timer_expired_cb_user_data);
+    CHECK_EQUAL(0, group_init_complete_cb_call_count);
+    complete_writes(ALL_INSTANCES, NO_FAIL);
+
+    CHECK_EQUAL(1, group_init_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, group_init_complete_cb_result_code);
+    POINTERS_EQUAL(user_data, group_init_complete_cb_user_data);
+    for (size_t i = 0; i < SHT3X_GROUP_TEST_NUM_INSTANCES; i++) {
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, results[i]);
+        SHT3XShadowState state;
+        sht3x_get_shadow_state(instances[i], &state);
+        CHECK_EQUAL(SHT3X_MEAS_MODE_PERIODIC, state.meas_mode);
+    }
+}
+
+TEST(SHT3XGroup, InitSkipsFailedInstance)
+{
+    expect_write_to_instances(soft_reset_cmd, ALL_INSTANCES);
+    expect_group_timer(2);
+    /* Instance 1 failed soft reset, so it is skipped */
+    expect_write_to_instances(clear_status_cmd, 0x05);
+    expect_group_timer(1);
+    expect_write_to_instances(start_periodic_cmd, 0x05);
+
+    uint8_t rc = sht3x_group_init(&group, &group_cfg, group_init_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    complete_writes(ALL_INSTANCES, 1);
+    timer_expired_cb(timer_expired_cb_user_data);
+    complete_writes(0x05, NO_FAIL);
+    timer_expired_cb(timer_expired_cb_user_data);
+    complete_writes(0x05, NO_FAIL);
+
+    CHECK_EQUAL(1, group_init_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_IO_ERR, group_init_complete_cb_result_code);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, results[0]);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_IO_ERR, results[1]);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, results[2]);
+}
+
+TEST(SHT3XGroup, InitArtVerifyStatus)
+{
+    group_cfg.init_cfg.meas_mode = SHT3X_MEAS_MODE_PERIODIC_ART;
+    group_cfg.init_cfg.verify_status = true;
+
+    expect_write_to_instances(soft_reset_cmd, ALL_INSTANCES);
+    expect_group_timer(2);
+    expect_write_to_instances(clear_status_cmd, ALL_INSTANCES);
+    expect_group_timer(1);
+    /* Instance 0 and 2 report clean status register. Instance 1 reports system reset detected flag. */
+    uint8_t clean_status[] = {0x00, 0x00, 0x81};
+    uint8_t reset_status[] = {0x00, 0x10, 0xC2};
+    uint8_t *status[] = {clean_status, reset_status, clean_status};
+    uint8_t read_status_cmd[] = {0xF3, 0x2D};
+    for (size_t i = 0; i < SHT3X_GROUP_TEST_NUM_INSTANCES; i++) {
+        expect_write(i, read_status_cmd);
+        mock()
+            .expectOneCall("mock_sht3x_start_timer")
+            .withParameter("duration_ms", 1)
+            .withParameter("user_data", start_timer_user_data)
+            .ignoreOtherParameters();
+        mock()
+            .expectOneCall("mock_sht3x_i2c_read")
+            .withOutputParameterReturning("data", status[i], 3)
+            .withParameter("length", 3)
+            .withParameter("i2c_addr", i2c_addrs[i])
+            .ignoreOtherParameters();
+    }
+    /* ART command */
+    uint8_t art_cmd[] = {0x2B, 0x32};
+    expect_write_to_instances(art_cmd, 0x05);
+
+    uint8_t rc = sht3x_group_init(&group, &group_cfg, group_init_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    complete_writes(ALL_INSTANCES, NO_FAIL);
+    timer_expired_cb(timer_expired_cb_user_data);
+    complete_writes(ALL_INSTANCES, NO_FAIL);
+    timer_expired_cb(timer_expired_cb_user_data);
+    for (size_t i = 0; i < SHT3X_GROUP_TEST_NUM_INSTANCES; i++) {
+        i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+        timer_expired_cb(timer_expired_cb_user_data);
+        i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+    }
+    complete_writes(0x05, NO_FAIL);
+
+    CHECK_EQUAL(1, group_init_complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_UNEXPECTED_STATUS, group_init_complete_cb_result_code);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, results[0]);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_UNEXPECTED_STATUS, results[1]);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, results[2]);
+}
+
+TEST(SHT3XGroup, InitSkipsBusyInstance)
+{
+    /* Instance 2 has a sequence in progress */
+    uint8_t enable_heater_cmd[] = {0x30, 0x6D};
+    expect_write(2, enable_heater_cmd);
+    sht3x_enable_heater(instances[2], NULL, NULL);
+    SHT3X_I2CTransactionCompleteCb heater_cb = i2c_write_complete_cb;
+    void *heater_cb_user_data = i2c_write_complete_cb_user_data;
+
+    expect_write_to_instances(soft_reset_cmd, 0x03);
+    expect_group_timer(2);
+
+    uint8_t rc = sht3x_group_init(&group, &group_cfg, group_init_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    complete_writes(0x03, NO_FAIL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_BUSY, results[2]);
+
+    heater_cb(SHT3X_I2C_RESULT_CODE_OK, heater_cb_user_data);
+}
+
+TEST(SHT3XGroup, InitInvalidArgs)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_group_init(NULL, &group_cfg, NULL, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_group_init(&group, NULL, NULL, NULL));
+
+    SHT3XGroupConfig cfg = group_cfg;
+    cfg.instances = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_group_init(&group, &cfg, NULL, NULL));
+    cfg = group_cfg;
+    cfg.results = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_group_init(&group, &cfg, NULL, NULL));
+    cfg = group_cfg;
+    cfg.num_instances = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_group_init(&group, &cfg, NULL, NULL));
+    cfg = group_cfg;
+    cfg.start_timer = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_group_init(&group, &cfg, NULL, NULL));
+    cfg = group_cfg;
+    cfg.init_cfg.mps = 0xFF;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_group_init(&group, &cfg, NULL, NULL));
+    cfg = group_cfg;
+    cfg.init_cfg.repeatability = 0xFF;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_group_init(&group, &cfg, NULL, NULL));
+    cfg = group_cfg;
+    cfg.init_cfg.meas_mode = SHT3X_MEAS_MODE_SINGLE_SHOT;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_group_init(&group, &cfg, NULL, NULL));
+}
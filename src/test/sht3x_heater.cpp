@@ -0,0 +1,491 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+#include "sht3x.h"
+#include "sht3x_heater.h"
+/* Included to know the size of SHT3X instance we need to define to return from mock_sht3x_get_instance_memory. */
+#include "sht3x_private.h"
+#include "mock_cfg_functions.h"
+
+#define SHT3X_HEATER_TEST_I2C_ADDR 0x44
+#define SHT3X_HEATER_TEST_FLAGS (SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM)
+
+/* To return from mock_sht3x_get_instance_memory */
+static struct SHT3XStruct instance_memory;
+
+static void *i2c_write_user_data = (void *)0x10;
+static void *i2c_read_user_data = (void *)0x11;
+static void *start_timer_user_data = (void *)0x56;
+static void *ctrl_start_timer_user_data = (void *)0x78;
+
+static SHT3X sht3x;
+static SHT3XHeaterCtrl ctrl;
+static SHT3XHeaterCtrlConfig ctrl_cfg;
+
+/* Populated by mock object whenever mock_sht3x_i2c_write is called */
+static SHT3X_I2CTransactionCompleteCb i2c_write_complete_cb;
+static void *i2c_write_complete_cb_user_data;
+
+/* Populated by mock object whenever mock_sht3x_i2c_read is called */
+static SHT3X_I2CTransactionCompleteCb i2c_read_complete_cb;
+static void *i2c_read_complete_cb_user_data;
+
+/* Populated by mock object whenever mock_sht3x_start_timer is called */
+static SHT3XTimerExpiredCb timer_expired_cb;
+static void *timer_expired_cb_user_data;
+
+/* Populated whenever ctrl_start_timer is called. Kept separately, because the controller timer can run at the same
+ * time as the driver timer. */
+static SHT3XTimerExpiredCb ctrl_timer_expired_cb;
+static void *ctrl_timer_expired_cb_user_data;
+
+static size_t meas_cb_call_count;
+static uint8_t meas_cb_result_code;
+static bool meas_cb_meas_is_null;
+static float meas_cb_humidity;
+static bool meas_cb_heater_affected;
+static void *meas_cb_user_data;
+
+static size_t error_cb_call_count;
+static uint8_t error_cb_result_code;
+static void *error_cb_user_data;
+
+/* High humidity readout, 80 RH%. Humidity CRC is not read out. */
+static uint8_t wet_meas[] = {0x66, 0x66, 0x00, 0xCC, 0xCC};
+/* Low humidity readout, 20 RH%. Humidity CRC is not read out. */
+static uint8_t dry_meas[] = {0x66, 0x66, 0x00, 0x33, 0x33};
+
+static uint8_t fetch_data_cmd[] = {0xE0, 0x00};
+static uint8_t enable_heater_cmd[] = {0x30, 0x6D};
+static uint8_t disable_heater_cmd[] = {0x30, 0x66};
+
+static void ctrl_start_timer(uint32_t duration_ms, void *user_data, SHT3XTimerExpiredCb cb, void *cb_user_data)
+{
+    mock()
+        .actualCall("ctrl_start_timer")
+        .withParameter("duration_ms", duration_ms)
+        .withParameter("user_data", user_data);
+    ctrl_timer_expired_cb = cb;
+    ctrl_timer_expired_cb_user_data = cb_user_data;
+}
+
+static void meas_cb(uint8_t result_code, SHT3XMeasurement *meas, bool heater_affected, void *user_data)
+{
+    meas_cb_call_count++;
+    meas_cb_result_code = result_code;
+    meas_cb_meas_is_null = (meas == NULL);
+    if (meas) {
+        meas_cb_humidity = meas->humidity;
+    }
+    meas_cb_heater_affected = heater_affected;
+    meas_cb_user_data = user_data;
+}
+
+static void error_cb(uint8_t result_code, void *user_data)
+{
+    error_cb_call_count++;
+    error_cb_result_code = result_code;
+    error_cb_user_data = user_data;
+}
+
+// clang-format off
+TEST_GROUP(SHT3XHeater)
+{
+    void setup() {
+        /* Order of expected calls is important for these tests. Fail the test if the expected mock calls do not happen
+        in the specified order. */
+        mock().strictOrder();
+
+        i2c_write_complete_cb = NULL;
+        i2c_write_complete_cb_user_data = NULL;
+        i2c_read_complete_cb = NULL;
+        i2c_read_complete_cb_user_data = NULL;
+        timer_expired_cb = NULL;
+        timer_expired_cb_user_data = NULL;
+        ctrl_timer_expired_cb = NULL;
+        ctrl_timer_expired_cb_user_data = NULL;
+
+        mock().setData("i2cWriteCompleteCb", (void *)&i2c_write_complete_cb);
+        mock().setData("i2cWriteCompleteCbUserData", &i2c_write_complete_cb_user_data);
+        mock().setData("i2cReadCompleteCb", (void *)&i2c_read_complete_cb);
+        mock().setData("i2cReadCompleteCbUserData", &i2c_read_complete_cb_user_data);
+        mock().setData("timerExpiredCb", (void *)&timer_expired_cb);
+        mock().setData("timerExpiredCbUserData", &timer_expired_cb_user_data);
+
+        meas_cb_call_count = 0;
+        meas_cb_result_code = 0xFF; /* 0 is a valid code, reset to an invalid code */
+        meas_cb_meas_is_null = false;
+        meas_cb_humidity = 0.0f;
+        meas_cb_heater_affected = false;
+        meas_cb_user_data = NULL;
+        error_cb_call_count = 0;
+        error_cb_result_code = 0xFF;
+        error_cb_user_data = NULL;
+
+        memset(&instance_memory, 0, sizeof(instance_memory));
+        memset(&ctrl, 0, sizeof(ctrl));
+
+        mock()
+            .expectOneCall("mock_sht3x_get_instance_memory")
+            .withParameter("user_data", (void *)NULL)
+            .andReturnValue((void *)&instance_memory);
+        SHT3XInitConfig init_cfg = {
+            .get_instance_memory = mock_sht3x_get_instance_memory,
+            .get_instance_memory_user_data = NULL,
+            .i2c_write = mock_sht3x_i2c_write,
+            .i2c_write_user_data = i2c_write_user_data,
+            .i2c_read = mock_sht3x_i2c_read,
+            .i2c_read_user_data = i2c_read_user_data,
+            .start_timer = mock_sht3x_start_timer,
+            .start_timer_user_data = start_timer_user_data,
+            .i2c_addr = SHT3X_HEATER_TEST_I2C_ADDR,
+        };
+        uint8_t rc = sht3x_create(&sht3x, &init_cfg);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+        memset(&ctrl_cfg, 0, sizeof(ctrl_cfg));
+        ctrl_cfg.instance = sht3x;
+        ctrl_cfg.rh_threshold = 70.0f;
+        ctrl_cfg.pulse_ms = 10;
+        /* Heater stays off for 30 ms after a 10 ms pulse */
+        ctrl_cfg.max_duty_cycle_percent = 25;
+        ctrl_cfg.suppress_heater_affected = false;
+        ctrl_cfg.start_timer = ctrl_start_timer;
+        ctrl_cfg.start_timer_user_data = ctrl_start_timer_user_data;
+    }
+};
+// clang-format on
+
+static void expect_write(uint8_t *cmd)
+{
+    mock()
+        .expectOneCall("mock_sht3x_i2c_write")
+        .withMemoryBufferParameter("data", cmd, 2)
+        .withParameter("length", 2)
+        .withParameter("i2c_addr", SHT3X_HEATER_TEST_I2C_ADDR)
+        .withParameter("user_data", i2c_write_user_data)
+        .ignoreOtherParameters();
+}
+
+static void expect_ctrl_timer(uint32_t duration_ms)
+{
+    mock()
+        .expectOneCall("ctrl_start_timer")
+        .withParameter("duration_ms", duration_ms)
+        .withParameter("user_data", ctrl_start_timer_user_data);
+}
+
+/* Expect the I2C transactions of periodic measurement readout up to, but not including, the I2C read */
+static void expect_fetch_data()
+{
+    expect_write(fetch_data_cmd);
+    mock()
+        .expectOneCall("mock_sht3x_start_timer")
+        .withParameter("duration_ms", 1)
+        .withParameter("user_data", start_timer_user_data)
+        .ignoreOtherParameters();
+}
+
+static void expect_meas_read(uint8_t *data)
+{
+    mock()
+        .expectOneCall("mock_sht3x_i2c_read")
+        .withOutputParameterReturning("data", data, 5)
+        .withParameter("length", 5)
+        .withParameter("i2c_addr", SHT3X_HEATER_TEST_I2C_ADDR)
+        .withParameter("user_data", i2c_read_user_data)
+        .ignoreOtherParameters();
+}
+
+/* Complete a periodic measurement readout that was sent to the device */
+static void complete_readout()
+{
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    timer_expired_cb(timer_expired_cb_user_data);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+}
+
+/* Read out a measurement through the controller, no heater commands are expected */
+static void read_through_ctrl(uint8_t *data)
+{
+    expect_fetch_data();
+    expect_meas_read(data);
+    uint8_t rc = sht3x_heater_ctrl_read_periodic_measurement(&ctrl, SHT3X_HEATER_TEST_FLAGS, meas_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    complete_readout();
+}
+
+/* Read out a wet measurement, which starts a heater pulse. Heater on command is left in progress. */
+static void start_pulse()
+{
+    expect_fetch_data();
+    expect_meas_read(wet_meas);
+    expect_write(enable_heater_cmd);
+    uint8_t rc = sht3x_heater_ctrl_read_periodic_measurement(&ctrl, SHT3X_HEATER_TEST_FLAGS, meas_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    complete_readout();
+}
+
+TEST(SHT3XHeater, InitInvalidArgs)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_heater_ctrl_init(NULL, &ctrl_cfg));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_heater_ctrl_init(&ctrl, NULL));
+
+    SHT3XHeaterCtrlConfig cfg = ctrl_cfg;
+    cfg.instance = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_heater_ctrl_init(&ctrl, &cfg));
+    cfg = ctrl_cfg;
+    cfg.start_timer = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_heater_ctrl_init(&ctrl, &cfg));
+    cfg = ctrl_cfg;
+    cfg.pulse_ms = 1;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_heater_ctrl_init(&ctrl, &cfg));
+    cfg = ctrl_cfg;
+    cfg.max_duty_cycle_percent = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_heater_ctrl_init(&ctrl, &cfg));
+    cfg = ctrl_cfg;
+    cfg.max_duty_cycle_percent = 101;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_heater_ctrl_init(&ctrl, &cfg));
+    cfg = ctrl_cfg;
+    cfg.rh_threshold = 100.5f;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_heater_ctrl_init(&ctrl, &cfg));
+}
+
+TEST(SHT3XHeater, ReadInvalidArgs)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_heater_ctrl_init(&ctrl, &ctrl_cfg));
+    uint8_t rc = sht3x_heater_ctrl_read_periodic_measurement(NULL, SHT3X_HEATER_TEST_FLAGS, meas_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, rc);
+    rc = sht3x_heater_ctrl_read_periodic_measurement(&ctrl, SHT3X_FLAG_VERIFY_CRC_HUM, meas_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, rc);
+}
+
+TEST(SHT3XHeater, ReadBusyIfReadInProgress)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_heater_ctrl_init(&ctrl, &ctrl_cfg));
+    expect_write(fetch_data_cmd);
+    uint8_t rc = sht3x_heater_ctrl_read_periodic_measurement(&ctrl, SHT3X_HEATER_TEST_FLAGS, meas_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    rc = sht3x_heater_ctrl_read_periodic_measurement(&ctrl, SHT3X_HEATER_TEST_FLAGS, meas_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_BUSY, rc);
+}
+
+TEST(SHT3XHeater, DryMeasDoesNotStartPulse)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_heater_ctrl_init(&ctrl, &ctrl_cfg));
+    read_through_ctrl(dry_meas);
+
+    CHECK_EQUAL(1, meas_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, meas_cb_result_code);
+    DOUBLES_EQUAL(20.0, meas_cb_humidity, 0.01);
+    CHECK_FALSE(meas_cb_heater_affected);
+}
+
+TEST(SHT3XHeater, WetMeasStartsPulseAndKeepsDutyCycle)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_heater_ctrl_init(&ctrl, &ctrl_cfg));
+    start_pulse();
+    /* Measurement that started the pulse was taken before the heater was on */
+    CHECK_EQUAL(1, meas_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, meas_cb_result_code);
+    DOUBLES_EQUAL(80.0, meas_cb_humidity, 0.01);
+    CHECK_FALSE(meas_cb_heater_affected);
+
+    /* Mandatory delay after heater on command, then the rest of the pulse */
+    expect_ctrl_timer(1);
+    expect_ctrl_timer(9);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+
+    /* End of pulse, then the cooling phase */
+    expect_write(disable_heater_cmd);
+    expect_ctrl_timer(1);
+    expect_ctrl_timer(29);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+
+    /* First readout after the pulse is affected, the one after it is not */
+    read_through_ctrl(dry_meas);
+    CHECK_EQUAL(2, meas_cb_call_count);
+    CHECK_TRUE(meas_cb_heater_affected);
+    read_through_ctrl(dry_meas);
+    CHECK_EQUAL(3, meas_cb_call_count);
+    CHECK_FALSE(meas_cb_heater_affected);
+}
+
+TEST(SHT3XHeater, WetMeasDuringCoolingDoesNotStartPulse)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_heater_ctrl_init(&ctrl, &ctrl_cfg));
+    start_pulse();
+    expect_ctrl_timer(1);
+    expect_ctrl_timer(9);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+    expect_write(disable_heater_cmd);
+    expect_ctrl_timer(1);
+    expect_ctrl_timer(29);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+
+    /* No heater on command */
+    read_through_ctrl(wet_meas);
+    CHECK_EQUAL(2, meas_cb_call_count);
+    CHECK_TRUE(meas_cb_heater_affected);
+}
+
+TEST(SHT3XHeater, ReadQueuedWhileHeaterCmdInProgress)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_heater_ctrl_init(&ctrl, &ctrl_cfg));
+    start_pulse();
+
+    /* Heater on command is in progress, readout is queued instead of failing with BUSY */
+    void *user_data = (void *)0x9A;
+    uint8_t rc = sht3x_heater_ctrl_read_periodic_measurement(&ctrl, SHT3X_HEATER_TEST_FLAGS, meas_cb, user_data);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+    /* Readout is sent after the mandatory delay that follows heater on command */
+    expect_ctrl_timer(1);
+    expect_ctrl_timer(9);
+    expect_fetch_data();
+    expect_meas_read(wet_meas);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+    complete_readout();
+
+    CHECK_EQUAL(2, meas_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, meas_cb_result_code);
+    CHECK_TRUE(meas_cb_heater_affected);
+    POINTERS_EQUAL(user_data, meas_cb_user_data);
+}
+
+TEST(SHT3XHeater, HeaterOffDeferredWhileReadInProgress)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_heater_ctrl_init(&ctrl, &ctrl_cfg));
+    start_pulse();
+    expect_ctrl_timer(1);
+    expect_ctrl_timer(9);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+
+    expect_fetch_data();
+    expect_meas_read(dry_meas);
+    uint8_t rc = sht3x_heater_ctrl_read_periodic_measurement(&ctrl, SHT3X_HEATER_TEST_FLAGS, meas_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    /* End of pulse while the readout is in progress, heater off command is not sent yet */
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+
+    /* Heater off command is sent once the readout completes */
+    expect_write(disable_heater_cmd);
+    timer_expired_cb(timer_expired_cb_user_data);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+    CHECK_EQUAL(2, meas_cb_call_count);
+    CHECK_TRUE(meas_cb_heater_affected);
+
+    expect_ctrl_timer(1);
+    expect_ctrl_timer(29);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+}
+
+TEST(SHT3XHeater, HeaterAffectedMeasSuppressed)
+{
+    ctrl_cfg.suppress_heater_affected = true;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_heater_ctrl_init(&ctrl, &ctrl_cfg));
+    start_pulse();
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, meas_cb_result_code);
+    expect_ctrl_timer(1);
+    expect_ctrl_timer(9);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+
+    read_through_ctrl(dry_meas);
+    CHECK_EQUAL(2, meas_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, meas_cb_result_code);
+    CHECK_TRUE(meas_cb_meas_is_null);
+    CHECK_TRUE(meas_cb_heater_affected);
+}
+
+TEST(SHT3XHeater, HeaterOnFailureRetriesHeaterOff)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_heater_ctrl_init(&ctrl, &ctrl_cfg));
+    start_pulse();
+
+    /* Heater could be on after a failed heater on command, so heater off is sent after the mandatory delay */
+    expect_ctrl_timer(1);
+    expect_write(disable_heater_cmd);
+    expect_ctrl_timer(1);
+    expect_ctrl_timer(29);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_BUS_ERROR, i2c_write_complete_cb_user_data);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+}
+
+TEST(SHT3XHeater, HeaterOffKeepsFailing)
+{
+    void *user_data = (void *)0xE5;
+    ctrl_cfg.error_cb = error_cb;
+    ctrl_cfg.error_cb_user_data = user_data;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_heater_ctrl_init(&ctrl, &ctrl_cfg));
+    start_pulse();
+    uint8_t rc = sht3x_heater_ctrl_read_periodic_measurement(&ctrl, SHT3X_HEATER_TEST_FLAGS, meas_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+    /* Heater on fails, then every heater off retry fails */
+    expect_ctrl_timer(1);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_BUS_ERROR, i2c_write_complete_cb_user_data);
+    for (size_t i = 0; i < SHT3X_HEATER_CTRL_MAX_OFF_RETRIES; i++) {
+        CHECK_EQUAL(0, error_cb_call_count);
+        expect_write(disable_heater_cmd);
+        expect_ctrl_timer(1);
+        ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+        i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_BUS_ERROR, i2c_write_complete_cb_user_data);
+    }
+
+    /* Controller gave up, and the queued readout is completed with the error */
+    CHECK_EQUAL(1, error_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_IO_ERR, error_cb_result_code);
+    POINTERS_EQUAL(user_data, error_cb_user_data);
+    CHECK_EQUAL(2, meas_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_IO_ERR, meas_cb_result_code);
+    CHECK_TRUE(meas_cb_meas_is_null);
+    CHECK_TRUE(meas_cb_heater_affected);
+
+    /* No more heater commands after the mandatory delay */
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+
+    /* Readouts still work, are tagged, and do not start a pulse */
+    read_through_ctrl(wet_meas);
+    CHECK_EQUAL(3, meas_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, meas_cb_result_code);
+    CHECK_TRUE(meas_cb_heater_affected);
+    CHECK_EQUAL(1, error_cb_call_count);
+}
+
+TEST(SHT3XHeater, FullDutyCycleSkipsCooling)
+{
+    ctrl_cfg.max_duty_cycle_percent = 100;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_heater_ctrl_init(&ctrl, &ctrl_cfg));
+    start_pulse();
+    expect_ctrl_timer(1);
+    expect_ctrl_timer(9);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+    expect_write(disable_heater_cmd);
+    expect_ctrl_timer(1);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    ctrl_timer_expired_cb(ctrl_timer_expired_cb_user_data);
+
+    /* Heater is idle right away, so the next wet measurement starts another pulse */
+    read_through_ctrl(dry_meas);
+    CHECK_TRUE(meas_cb_heater_affected);
+    start_pulse();
+    CHECK_FALSE(meas_cb_heater_affected);
+}
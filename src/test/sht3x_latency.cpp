@@ -0,0 +1,194 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+#include "sht3x.h"
+#include "sht3x_latency.h"
+/* Included to know the size of SHT3X instance we need to define to return from mock_sht3x_get_instance_memory. */
+#include "sht3x_private.h"
+#include "mock_cfg_functions.h"
+
+#define SHT3X_LATENCY_TEST_I2C_ADDR 0x44
+
+/* To return from mock_sht3x_get_instance_memory */
+static struct SHT3XStruct instance_memory;
+
+static SHT3X sht3x;
+static SHT3XLatencyMonitor monitor;
+static uint32_t now_us;
+
+/* Populated by mock object whenever mock_sht3x_i2c_write is called */
+static SHT3X_I2CTransactionCompleteCb i2c_write_complete_cb;
+static void *i2c_write_complete_cb_user_data;
+
+static uint32_t get_time_us(void *user_data)
+{
+    (void)user_data;
+    return now_us;
+}
+
+// clang-format off
+TEST_GROUP(SHT3XLatency)
+{
+    void setup() {
+        /* Order of expected calls is important for these tests. Fail the test if the expected mock calls do not happen
+        in the specified order. */
+        mock().strictOrder();
+
+        i2c_write_complete_cb = NULL;
+        i2c_write_complete_cb_user_data = NULL;
+        mock().setData("i2cWriteCompleteCb", (void *)&i2c_write_complete_cb);
+        mock().setData("i2cWriteCompleteCbUserData", &i2c_write_complete_cb_user_data);
+
+        memset(&instance_memory, 0, sizeof(instance_memory));
+        now_us = 0;
+        uint8_t rc = sht3x_latency_init(&monitor, get_time_us, NULL);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+        mock()
+            .expectOneCall("mock_sht3x_get_instance_memory")
+            .withParameter("user_data", (void *)NULL)
+            .andReturnValue((void *)&instance_memory);
+        SHT3XInitConfig init_cfg = {
+            .get_instance_memory = mock_sht3x_get_instance_memory,
+            .get_instance_memory_user_data = NULL,
+            .i2c_write = mock_sht3x_i2c_write,
+            .i2c_write_user_data = NULL,
+            .i2c_read = mock_sht3x_i2c_read,
+            .i2c_read_user_data = NULL,
+            .start_timer = mock_sht3x_start_timer,
+            .start_timer_user_data = NULL,
+            .i2c_addr = SHT3X_LATENCY_TEST_I2C_ADDR,
+            .trace_hook = sht3x_latency_hook,
+            .trace_hook_user_data = &monitor,
+        };
+        rc = sht3x_create(&sht3x, &init_cfg);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    }
+};
+// clang-format on
+
+static void check_percentile(const SHT3XLatencyHistogram *histogram, uint8_t percentile, uint32_t expected)
+{
+    uint32_t upper_bound_us = 0;
+    uint8_t rc = sht3x_latency_percentile(histogram, percentile, &upper_bound_us);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(expected, upper_bound_us);
+}
+
+static void send_event(uint8_t type, uint32_t arg)
+{
+    SHT3XTraceEvent event = {
+        .instance = sht3x,
+        .type = type,
+        .sequence_type = SHT3X_SEQUENCE_TYPE_SINGLE_SHOT_MEAS,
+        .result_code = 0,
+        .arg = arg,
+    };
+    sht3x_latency_hook(&event, &monitor);
+}
+
+TEST(SHT3XLatency, MeasuresSequenceAndI2C)
+{
+    now_us = 100;
+    mock().expectOneCall("mock_sht3x_i2c_write").ignoreOtherParameters();
+    uint8_t rc = sht3x_enable_heater(sht3x, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    now_us = 350;
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_ADDRESS_NACK, i2c_write_complete_cb_user_data);
+
+    const SHT3XLatencyHistogram *histogram = NULL;
+    rc = sht3x_latency_get_histogram(&monitor, SHT3X_LATENCY_KIND_SEQUENCE, SHT3X_SEQUENCE_TYPE_WRITE_CMD, &histogram);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(1, histogram->count);
+    CHECK_EQUAL(250, histogram->sum_us);
+    /* 250 us is in the 128..255 us bucket */
+    CHECK_EQUAL(1, histogram->buckets[8]);
+    check_percentile(histogram, 99, 255);
+
+    rc = sht3x_latency_get_histogram(&monitor, SHT3X_LATENCY_KIND_I2C, 0, &histogram);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(1, histogram->count);
+    check_percentile(histogram, 50, 255);
+
+    rc = sht3x_latency_get_histogram(&monitor, SHT3X_LATENCY_KIND_SEQUENCE, SHT3X_SEQUENCE_TYPE_READ_MEAS, &histogram);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(0, histogram->count);
+}
+
+TEST(SHT3XLatency, MeasuresTimerOvershoot)
+{
+    now_us = 0xFFFFFF00;
+    send_event(SHT3X_TRACE_EVENT_TIMER_ARM, 16);
+    /* Time wraps around, expires 16 ms + 40 us later */
+    now_us = 16000 + 40 - 0x100;
+    send_event(SHT3X_TRACE_EVENT_TIMER_EXPIRE, 0);
+
+    now_us = 0;
+    send_event(SHT3X_TRACE_EVENT_TIMER_ARM, 1);
+    /* Expired early */
+    now_us = 900;
+    send_event(SHT3X_TRACE_EVENT_TIMER_EXPIRE, 0);
+
+    const SHT3XLatencyHistogram *histogram = NULL;
+    uint8_t rc = sht3x_latency_get_histogram(&monitor, SHT3X_LATENCY_KIND_TIMER_OVERSHOOT, 0, &histogram);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(2, histogram->count);
+    CHECK_EQUAL(1, histogram->buckets[0]);
+    /* 40 us is in the 32..63 us bucket */
+    CHECK_EQUAL(1, histogram->buckets[6]);
+    check_percentile(histogram, 50, 0);
+    check_percentile(histogram, 51, 63);
+}
+
+TEST(SHT3XLatency, PercentilesAndMerge)
+{
+    SHT3XLatencyHistogram a;
+    SHT3XLatencyHistogram b;
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+
+    uint32_t upper_bound_us = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_latency_percentile(&a, 50, &upper_bound_us));
+
+    for (int i = 0; i < 99; i++) {
+        sht3x_latency_record(&a, 1000);
+    }
+    sht3x_latency_record(&a, 100000);
+    /* 1000 us is in the 512..1023 us bucket, 100000 us in the 65536..131071 us bucket */
+    check_percentile(&a, 99, 1023);
+    check_percentile(&a, 100, 131071);
+
+    /* Larger than the last bucket's lower bound */
+    sht3x_latency_record(&b, UINT32_MAX);
+    sht3x_latency_record(&b, 10000000);
+    CHECK_EQUAL(2, b.buckets[SHT3X_LATENCY_NUM_BUCKETS - 1]);
+    check_percentile(&b, 1, UINT32_MAX);
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_latency_merge(&a, &b));
+    CHECK_EQUAL(102, a.count);
+    CHECK_EQUAL((99 * 1000) + 100000 + (uint64_t)UINT32_MAX + 10000000, a.sum_us);
+    check_percentile(&a, 97, 1023);
+    check_percentile(&a, 98, 131071);
+    check_percentile(&a, 99, UINT32_MAX);
+}
+
+TEST(SHT3XLatency, InvalidArgs)
+{
+    SHT3XLatencyMonitor other;
+    const SHT3XLatencyHistogram *histogram = NULL;
+    uint32_t upper_bound_us = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latency_init(NULL, get_time_us, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latency_init(&other, NULL, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_latency_get_histogram(&monitor, SHT3X_LATENCY_KIND_SEQUENCE, SHT3X_SEQUENCE_TYPE_NO_SEQ,
+                                            &histogram));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latency_get_histogram(&monitor, 0xFF, 0, &histogram));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latency_get_histogram(&monitor, SHT3X_LATENCY_KIND_I2C, 0, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latency_record(NULL, 0));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latency_merge(&monitor.i2c, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latency_percentile(&monitor.i2c, 0, &upper_bound_us));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latency_percentile(&monitor.i2c, 101, &upper_bound_us));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latency_percentile(&monitor.i2c, 50, NULL));
+}
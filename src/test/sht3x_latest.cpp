@@ -0,0 +1,129 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+
+#include "sht3x_latest.h"
+
+#define SHT3X_LATEST_TEST_NUM_SLOTS 3
+
+/* uint32_t for alignment */
+static uint32_t region[SHT3X_LATEST_REGION_SIZE(SHT3X_LATEST_TEST_NUM_SLOTS) / sizeof(uint32_t)];
+static SHT3XLatestPublisher publisher;
+static SHT3XLatestReader reader;
+
+// clang-format off
+TEST_GROUP(SHT3XLatest)
+{
+    void setup() {
+        memset(region, 0xAA, sizeof(region));
+        uint8_t rc = sht3x_latest_publisher_init(&publisher, region, sizeof(region), SHT3X_LATEST_TEST_NUM_SLOTS);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+        rc = sht3x_latest_reader_init(&reader, region, sizeof(region));
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    }
+};
+// clang-format on
+
+static SHT3XLatestSlot *get_slot(uint32_t slot)
+{
+    return &((SHT3XLatestSlot *)((SHT3XLatestHeader *)region + 1))[slot];
+}
+
+TEST(SHT3XLatest, PublishAndRead)
+{
+    uint32_t num_slots = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_latest_get_num_slots(&reader, &num_slots));
+    CHECK_EQUAL(SHT3X_LATEST_TEST_NUM_SLOTS, num_slots);
+
+    SHT3XLatestReading published = {.timestamp = 1234, .raw_temperature = 0x6000, .raw_humidity = 0x8001, .flags = 3};
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_latest_publish(&publisher, 2, &published));
+
+    SHT3XLatestReading reading;
+    uint32_t sequence = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_latest_read(&reader, 2, &reading, &sequence));
+    CHECK_EQUAL(1234, reading.timestamp);
+    CHECK_EQUAL(0x6000, reading.raw_temperature);
+    CHECK_EQUAL(0x8001, reading.raw_humidity);
+    CHECK_EQUAL(3, reading.flags);
+    CHECK_EQUAL(2, sequence);
+
+    /* Other slots are untouched */
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_latest_read(&reader, 0, &reading, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_latest_read(&reader, 1, &reading, NULL));
+}
+
+TEST(SHT3XLatest, SequenceChangesWithEveryPublish)
+{
+    SHT3XLatestReading published = {.timestamp = 1, .raw_temperature = 0, .raw_humidity = 0, .flags = 0};
+    SHT3XLatestReading reading;
+    uint32_t first = 0;
+    uint32_t second = 0;
+    sht3x_latest_publish(&publisher, 0, &published);
+    sht3x_latest_read(&reader, 0, &reading, &first);
+    published.timestamp = 2;
+    sht3x_latest_publish(&publisher, 0, &published);
+    sht3x_latest_read(&reader, 0, &reading, &second);
+    CHECK(first != second);
+    CHECK_EQUAL(0, second & 1);
+    CHECK_EQUAL(2, reading.timestamp);
+}
+
+TEST(SHT3XLatest, SequenceSkipsZeroOnWraparound)
+{
+    get_slot(0)->sequence = UINT32_MAX - 1;
+    SHT3XLatestReading published = {.timestamp = 7, .raw_temperature = 0, .raw_humidity = 0, .flags = 0};
+    sht3x_latest_publish(&publisher, 0, &published);
+
+    SHT3XLatestReading reading;
+    uint32_t sequence = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_latest_read(&reader, 0, &reading, &sequence));
+    CHECK_EQUAL(2, sequence);
+    CHECK_EQUAL(7, reading.timestamp);
+}
+
+TEST(SHT3XLatest, WriteInProgressIsBusy)
+{
+    SHT3XLatestReading published = {.timestamp = 1, .raw_temperature = 0, .raw_humidity = 0, .flags = 0};
+    sht3x_latest_publish(&publisher, 1, &published);
+    /* Publisher stopped in the middle of a write */
+    get_slot(1)->sequence++;
+
+    SHT3XLatestReading reading;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_BUSY, sht3x_latest_read(&reader, 1, &reading, NULL));
+
+    get_slot(1)->sequence++;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_latest_read(&reader, 1, &reading, NULL));
+}
+
+TEST(SHT3XLatest, ReaderRejectsInvalidRegion)
+{
+    SHT3XLatestReader other;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latest_reader_init(&other, region, sizeof(SHT3XLatestHeader)));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latest_reader_init(&other, (uint8_t *)region + 1, 64));
+
+    SHT3XLatestHeader *header = (SHT3XLatestHeader *)region;
+    header->version = SHT3X_LATEST_VERSION + 1;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latest_reader_init(&other, region, sizeof(region)));
+    header->version = SHT3X_LATEST_VERSION;
+    header->magic = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latest_reader_init(&other, region, sizeof(region)));
+}
+
+TEST(SHT3XLatest, InvalidArgs)
+{
+    SHT3XLatestPublisher other;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latest_publisher_init(NULL, region, sizeof(region), 1));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latest_publisher_init(&other, NULL, sizeof(region), 1));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latest_publisher_init(&other, region, sizeof(region), 0));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OUT_OF_MEMORY,
+                sht3x_latest_publisher_init(&other, region, sizeof(region), SHT3X_LATEST_TEST_NUM_SLOTS + 1));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OUT_OF_MEMORY, sht3x_latest_publisher_init(&other, region, 4, 1));
+
+    SHT3XLatestReading reading = {.timestamp = 0, .raw_temperature = 0, .raw_humidity = 0, .flags = 0};
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_latest_publish(&publisher, SHT3X_LATEST_TEST_NUM_SLOTS, &reading));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latest_publish(&publisher, 0, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latest_read(&reader, SHT3X_LATEST_TEST_NUM_SLOTS, &reading, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latest_read(&reader, 0, NULL, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_latest_get_num_slots(&reader, NULL));
+}
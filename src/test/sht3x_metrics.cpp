@@ -0,0 +1,226 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+
+#include "sht3x_metrics.h"
+
+static SHT3XMetricsFormatter formatter;
+static SHT3XBusCounters counters;
+static SHT3XLatencyMonitor monitor;
+static uint32_t now_us;
+static SHT3XMetricsInstance instances[2];
+static char output[65536];
+static size_t output_length;
+
+static uint32_t get_time_us(void *user_data)
+{
+    (void)user_data;
+    return now_us;
+}
+
+// clang-format off
+TEST_GROUP(SHT3XMetrics)
+{
+    void setup() {
+        memset(output, 0, sizeof(output));
+        output_length = 0;
+        now_us = 0;
+        sht3x_latency_init(&monitor, get_time_us, NULL);
+
+        counters.transactions = 5;
+        counters.failed_transactions = 1;
+        counters.bytes_written = 10;
+        counters.bytes_read = 12;
+        counters.transaction_time_us = UINT64_MAX;
+        counters.airtime_us = 400;
+
+        instances[0].sensor_id = 7;
+        instances[0].bus_counters = &counters;
+        instances[0].latency = &monitor;
+        instances[0].health_events = (1 << SHT3X_HEALTH_EVENT_NO_DATA);
+        instances[1].sensor_id = 4294967295;
+        instances[1].bus_counters = NULL;
+        instances[1].latency = NULL;
+        instances[1].health_events = 0;
+    }
+};
+// clang-format on
+
+/* Format the whole exposition into output, chunk_size bytes per call */
+static void format_all(size_t chunk_size)
+{
+    output_length = 0;
+    size_t length = 0;
+    do {
+        /* Room for the null terminator */
+        size_t size = sizeof(output) - 1 - output_length;
+        size = (size < chunk_size) ? size : chunk_size;
+        CHECK(size > 0);
+        uint8_t rc = sht3x_metrics_format(&formatter, &output[output_length], size, &length);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+        output_length += length;
+    } while (length > 0);
+    output[output_length] = '\0';
+}
+
+/* Record a duration into the monitor through its trace hook, as the driver would */
+static void record_latency(uint8_t start_type, uint8_t end_type, uint8_t sequence_type, uint32_t duration_us)
+{
+    SHT3XTraceEvent event = {
+        .instance = NULL,
+        .type = start_type,
+        .sequence_type = sequence_type,
+        .result_code = 0,
+        .arg = 0,
+    };
+    now_us = 0;
+    sht3x_latency_hook(&event, &monitor);
+    event.type = end_type;
+    now_us = duration_us;
+    sht3x_latency_hook(&event, &monitor);
+}
+
+static void record_sequence_latency(uint8_t sequence_type, uint32_t duration_us)
+{
+    record_latency(SHT3X_TRACE_EVENT_SEQUENCE_START, SHT3X_TRACE_EVENT_SEQUENCE_END, sequence_type, duration_us);
+}
+
+static void check_line(const char *line)
+{
+    if (!strstr(output, line)) {
+        FAIL(line);
+    }
+}
+
+TEST(SHT3XMetrics, Counters)
+{
+    sht3x_metrics_init(&formatter, instances, 1);
+    format_all(sizeof(output) - 1);
+
+    check_line("# HELP sht3x_i2c_transactions_total Completed I2C transactions.\n"
+               "# TYPE sht3x_i2c_transactions_total counter\n"
+               "sht3x_i2c_transactions_total{sensor=\"7\"} 5\n");
+    check_line("\nsht3x_i2c_failed_transactions_total{sensor=\"7\"} 1\n");
+    check_line("\nsht3x_i2c_bytes_written_total{sensor=\"7\"} 10\n");
+    check_line("\nsht3x_i2c_bytes_read_total{sensor=\"7\"} 12\n");
+    check_line("\nsht3x_i2c_transaction_time_us_total{sensor=\"7\"} 18446744073709551615\n");
+    check_line("\nsht3x_i2c_airtime_us_total{sensor=\"7\"} 400\n");
+}
+
+TEST(SHT3XMetrics, Histogram)
+{
+    record_sequence_latency(SHT3X_SEQUENCE_TYPE_WRITE_CMD, 0);
+    record_sequence_latency(SHT3X_SEQUENCE_TYPE_WRITE_CMD, 3);
+    record_sequence_latency(SHT3X_SEQUENCE_TYPE_WRITE_CMD, 3);
+    record_sequence_latency(SHT3X_SEQUENCE_TYPE_WRITE_CMD, UINT32_MAX);
+    sht3x_metrics_init(&formatter, instances, 1);
+    format_all(sizeof(output) - 1);
+
+    check_line("# TYPE sht3x_latency_us histogram\n"
+               "sht3x_latency_us_bucket{sensor=\"7\",kind=\"sequence\",sequence=\"write_cmd\",le=\"0\"} 1\n"
+               "sht3x_latency_us_bucket{sensor=\"7\",kind=\"sequence\",sequence=\"write_cmd\",le=\"1\"} 1\n"
+               "sht3x_latency_us_bucket{sensor=\"7\",kind=\"sequence\",sequence=\"write_cmd\",le=\"3\"} 3\n"
+               "sht3x_latency_us_bucket{sensor=\"7\",kind=\"sequence\",sequence=\"write_cmd\",le=\"7\"} 3\n");
+    check_line("\nsht3x_latency_us_bucket{sensor=\"7\",kind=\"sequence\",sequence=\"write_cmd\",le=\"4194303\"} 3\n"
+               "sht3x_latency_us_bucket{sensor=\"7\",kind=\"sequence\",sequence=\"write_cmd\",le=\"+Inf\"} 4\n"
+               "sht3x_latency_us_sum{sensor=\"7\",kind=\"sequence\",sequence=\"write_cmd\"} 4294967301\n"
+               "sht3x_latency_us_count{sensor=\"7\",kind=\"sequence\",sequence=\"write_cmd\"} 4\n"
+               "sht3x_latency_us_bucket{sensor=\"7\",kind=\"sequence\",sequence=\"read_meas\",le=\"0\"} 0\n");
+    /* Timer overshoot is the last histogram */
+    check_line("\nsht3x_latency_us_sum{sensor=\"7\",kind=\"timer_overshoot\"} 0\n"
+               "sht3x_latency_us_count{sensor=\"7\",kind=\"timer_overshoot\"} 0\n"
+               "# HELP sht3x_health_event_active");
+}
+
+TEST(SHT3XMetrics, AllHistogramsOfOneSensor)
+{
+    record_sequence_latency(SHT3X_SEQUENCE_TYPE_READ_PERIODIC_MEAS, 100);
+    record_latency(SHT3X_TRACE_EVENT_I2C_READ_ISSUE, SHT3X_TRACE_EVENT_I2C_READ_COMPLETE, 0, 5);
+    record_latency(SHT3X_TRACE_EVENT_I2C_WRITE_ISSUE, SHT3X_TRACE_EVENT_I2C_WRITE_COMPLETE, 0, 6);
+    sht3x_metrics_init(&formatter, instances, 1);
+    format_all(sizeof(output) - 1);
+
+    check_line("\nsht3x_latency_us_count{sensor=\"7\",kind=\"sequence\",sequence=\"read_periodic_meas\"} 1\n");
+    check_line("\nsht3x_latency_us_bucket{sensor=\"7\",kind=\"i2c\",le=\"7\"} 2\n");
+    check_line("\nsht3x_latency_us_sum{sensor=\"7\",kind=\"i2c\"} 11\n"
+               "sht3x_latency_us_count{sensor=\"7\",kind=\"i2c\"} 2\n");
+    /* Every histogram of the monitor is a separate series */
+    size_t num_count_lines = 0;
+    for (const char *p = strstr(output, "sht3x_latency_us_count{"); p; p = strstr(p + 1, "sht3x_latency_us_count{")) {
+        num_count_lines++;
+    }
+    CHECK_EQUAL(SHT3X_SEQUENCE_TYPE_NO_SEQ + 2, num_count_lines);
+}
+
+TEST(SHT3XMetrics, Health)
+{
+    sht3x_metrics_init(&formatter, instances, 2);
+    format_all(sizeof(output) - 1);
+
+    check_line("# TYPE sht3x_health_event_active gauge\n"
+               "sht3x_health_event_active{sensor=\"7\",event=\"stuck_value\"} 0\n"
+               "sht3x_health_event_active{sensor=\"7\",event=\"crc_error_rate\"} 0\n"
+               "sht3x_health_event_active{sensor=\"7\",event=\"no_data\"} 1\n"
+               "sht3x_health_event_active{sensor=\"4294967295\",event=\"stuck_value\"} 0\n");
+    /* Ends with the last health line */
+    const char *last = "sht3x_health_event_active{sensor=\"4294967295\",event=\"no_data\"} 0\n";
+    STRCMP_EQUAL(last, &output[output_length - strlen(last)]);
+}
+
+TEST(SHT3XMetrics, FamiliesAreGrouped)
+{
+    instances[1].bus_counters = &counters;
+    sht3x_metrics_init(&formatter, instances, 2);
+    format_all(sizeof(output) - 1);
+
+    /* Both instances follow the header of the family, before the next family */
+    check_line("# TYPE sht3x_i2c_bytes_read_total counter\n"
+               "sht3x_i2c_bytes_read_total{sensor=\"7\"} 12\n"
+               "sht3x_i2c_bytes_read_total{sensor=\"4294967295\"} 12\n"
+               "# HELP sht3x_i2c_transaction_time_us_total");
+    /* Instance without a latency monitor is left out */
+    POINTERS_EQUAL(NULL, strstr(output, "sht3x_latency_us_count{sensor=\"4294967295\","));
+}
+
+TEST(SHT3XMetrics, ChunksAreResumable)
+{
+    record_sequence_latency(SHT3X_SEQUENCE_TYPE_SOFT_RESET_WITH_DELAY, 100);
+    sht3x_metrics_init(&formatter, instances, 2);
+    format_all(sizeof(output) - 1);
+    static char expected[sizeof(output)];
+    memcpy(expected, output, output_length + 1);
+    size_t expected_length = output_length;
+
+    size_t chunk_sizes[] = {1, 7, 64, SHT3X_METRICS_MAX_LINE_SIZE + 1};
+    for (size_t i = 0; i < (sizeof(chunk_sizes) / sizeof(chunk_sizes[0])); i++) {
+        sht3x_metrics_init(&formatter, instances, 2);
+        format_all(chunk_sizes[i]);
+        CHECK_EQUAL(expected_length, output_length);
+        STRCMP_EQUAL(expected, output);
+    }
+}
+
+TEST(SHT3XMetrics, NoInstances)
+{
+    sht3x_metrics_init(&formatter, NULL, 0);
+    format_all(sizeof(output) - 1);
+    /* Only the headers */
+    POINTERS_EQUAL(NULL, strstr(output, "{sensor="));
+    check_line("# TYPE sht3x_health_event_active gauge\n");
+
+    size_t length = 1;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_metrics_format(&formatter, output, sizeof(output), &length));
+    CHECK_EQUAL(0, length);
+}
+
+TEST(SHT3XMetrics, InvalidArgs)
+{
+    size_t length;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_metrics_init(NULL, instances, 1));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_metrics_init(&formatter, NULL, 1));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_metrics_init(&formatter, instances, 1));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_metrics_format(NULL, output, sizeof(output), &length));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_metrics_format(&formatter, NULL, sizeof(output), &length));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_metrics_format(&formatter, output, 0, &length));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_metrics_format(&formatter, output, sizeof(output), NULL));
+}
@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "CppUTest/TestHarness.h"
 #include "CppUTestExt/MockSupport.h"
 
@@ -6,6 +8,8 @@
 #include "sht3x_private.h"
 #include "mock_cfg_functions.h"
 
+#define SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD 0.01
+
 /* To return from mock_sht3x_get_instance_memory */
 static struct SHT3XStruct instance_memory;
 
@@ -324,3 +328,83 @@ TEST(SHT3XNoSetup, IsAtLeastOneAlertPendingFalse)
     bool ret = sht3x_is_at_least_one_alert_pending(status_reg_val);
     CHECK_FALSE(ret);
 }
+
+TEST(SHT3XNoSetup, LazyMeasConversionIsMemoized)
+{
+    SHT3XLazyMeasurement meas;
+    memset(&meas, 0, sizeof(SHT3XLazyMeasurement));
+    meas.raw_temperature = 0x6260;
+    meas.raw_humidity = 0x72B3;
+    meas.flags = SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM;
+
+    float temperature;
+    float humidity;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_lazy_meas_get_temperature(&meas, &temperature));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_lazy_meas_get_humidity(&meas, &humidity));
+    DOUBLES_EQUAL(22.25f, temperature, SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD);
+    DOUBLES_EQUAL(44.80f, humidity, SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD);
+
+    /* Second call returns the memoized values instead of converting the raw ticks again */
+    meas.raw_temperature = 0;
+    meas.raw_humidity = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_lazy_meas_get_temperature(&meas, &temperature));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_lazy_meas_get_humidity(&meas, &humidity));
+    DOUBLES_EQUAL(22.25f, temperature, SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD);
+    DOUBLES_EQUAL(44.80f, humidity, SHT3X_TEST_DOUBLES_EQUAL_THRESHOLD);
+}
+
+TEST(SHT3XNoSetup, LazyMeasGetTemperatureNull)
+{
+    SHT3XLazyMeasurement meas;
+    memset(&meas, 0, sizeof(SHT3XLazyMeasurement));
+    meas.flags = SHT3X_FLAG_READ_TEMP;
+    float temperature;
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_lazy_meas_get_temperature(NULL, &temperature));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_lazy_meas_get_temperature(&meas, NULL));
+}
+
+TEST(SHT3XNoSetup, LazyMeasGetHumidityNotRead)
+{
+    SHT3XLazyMeasurement meas;
+    memset(&meas, 0, sizeof(SHT3XLazyMeasurement));
+    meas.flags = SHT3X_FLAG_READ_TEMP;
+    float humidity;
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_lazy_meas_get_humidity(&meas, &humidity));
+}
+
+TEST(SHT3XNoSetup, PrepareSingleShotMeasInvalidArgs)
+{
+    SHT3XPreparedMeas prepared;
+    uint8_t rc;
+    rc = sht3x_prepare_single_shot_measurement(SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_CLOCK_STRETCHING_ENABLED,
+                                               SHT3X_FLAG_READ_TEMP, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, rc);
+    rc = sht3x_prepare_single_shot_measurement(0xFF, SHT3X_CLOCK_STRETCHING_ENABLED, SHT3X_FLAG_READ_TEMP, &prepared);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, rc);
+    rc = sht3x_prepare_single_shot_measurement(SHT3X_MEAS_REPEATABILITY_HIGH, 0xFF, SHT3X_FLAG_READ_TEMP, &prepared);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, rc);
+    rc = sht3x_prepare_single_shot_measurement(SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_CLOCK_STRETCHING_ENABLED,
+                                               SHT3X_FLAG_VERIFY_CRC_HUM, &prepared);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, rc);
+}
+
+TEST(SHT3XNoSetup, PreparePeriodicMeasInvalidArgs)
+{
+    SHT3XPreparedMeas prepared;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_prepare_periodic_measurement(SHT3X_FLAG_READ_TEMP, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_prepare_periodic_measurement(0, &prepared));
+}
+
+TEST(SHT3XNoSetup, IsValidPeriodicCfg)
+{
+    CHECK_TRUE(sht3x_is_valid_periodic_cfg(SHT3X_MEAS_MODE_PERIODIC, SHT3X_MEAS_REPEATABILITY_LOW, SHT3X_MPS_10));
+    CHECK_TRUE(sht3x_is_valid_periodic_cfg(SHT3X_MEAS_MODE_PERIODIC, SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_MPS_0_5));
+    /* Repeatability and MPS are not used by ART */
+    CHECK_TRUE(sht3x_is_valid_periodic_cfg(SHT3X_MEAS_MODE_PERIODIC_ART, 0xFF, 0xFF));
+    CHECK_FALSE(sht3x_is_valid_periodic_cfg(SHT3X_MEAS_MODE_PERIODIC, 0xFF, SHT3X_MPS_1));
+    CHECK_FALSE(sht3x_is_valid_periodic_cfg(SHT3X_MEAS_MODE_PERIODIC, SHT3X_MEAS_REPEATABILITY_HIGH, 0xFF));
+    CHECK_FALSE(sht3x_is_valid_periodic_cfg(SHT3X_MEAS_MODE_SINGLE_SHOT, SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_MPS_1));
+    CHECK_FALSE(sht3x_is_valid_periodic_cfg(SHT3X_MEAS_MODE_UNKNOWN, SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_MPS_1));
+}
@@ -0,0 +1,321 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+
+#include "sht3x.h"
+#include "sht3x_bus.h"
+#include "sht3x_plan.h"
+/* Included to know the size of SHT3X instance we need to define to return from get_instance_memory. */
+#include "sht3x_private.h"
+
+#define SHT3X_PLAN_TEST_I2C_ADDR 0x44
+#define SHT3X_PLAN_TEST_ALL_FLAGS                                                                                      \
+    (SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM | SHT3X_FLAG_VERIFY_CRC_TEMP | SHT3X_FLAG_VERIFY_CRC_HUM)
+
+/* Single shot commands with clock stretching enabled start with this byte */
+#define SHT3X_PLAN_TEST_CLK_STRETCH_EN_MSB 0x2C
+
+static struct SHT3XStruct instance_memory;
+static SHT3X sht3x;
+
+/*
+ * Simulated sensor on a simulated bus. Transactions take their airtime, timers take their period, and a readout with
+ * clock stretching is held until the single shot measurement is done. Completions are executed by run_until_idle.
+ */
+static uint32_t sim_bus_speed_hz;
+static uint64_t sim_now_us;
+static uint64_t sim_bus_busy_us;
+static uint64_t sim_meas_done_us;
+static uint32_t sim_meas_duration_us;
+static bool sim_clock_stretching;
+static SHT3X_I2CTransactionCompleteCb sim_i2c_cb;
+static SHT3XTimerExpiredCb sim_timer_cb;
+static void *sim_cb_user_data;
+static uint64_t sim_complete_at_us;
+
+static size_t meas_complete_count;
+static uint8_t meas_result_code;
+
+static void *get_instance_memory(void *user_data)
+{
+    (void)user_data;
+    return &instance_memory;
+}
+
+static uint64_t get_airtime_us(size_t length)
+{
+    uint64_t airtime_us = 0;
+    sht3x_bus_estimate_airtime(length, sim_bus_speed_hz, &airtime_us);
+    return airtime_us;
+}
+
+static void sim_i2c_write(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                          SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data)
+{
+    (void)i2c_addr;
+    (void)user_data;
+    uint64_t airtime_us = get_airtime_us(length);
+    /* Every write in these tests starts a measurement, or fetches periodic data that is already there */
+    sim_clock_stretching = (data[0] == SHT3X_PLAN_TEST_CLK_STRETCH_EN_MSB);
+    sim_meas_done_us = sim_now_us + airtime_us + sim_meas_duration_us;
+    sim_bus_busy_us += airtime_us;
+    sim_i2c_cb = cb;
+    sim_cb_user_data = cb_user_data;
+    sim_complete_at_us = sim_now_us + airtime_us;
+}
+
+static void sim_i2c_read(uint8_t *data, size_t length, uint8_t i2c_addr, void *user_data,
+                         SHT3X_I2CTransactionCompleteCb cb, void *cb_user_data)
+{
+    (void)i2c_addr;
+    (void)user_data;
+    /* Raw value 0 with its CRC */
+    static const uint8_t word[] = {0x00, 0x00, 0x81};
+    for (size_t i = 0; i < length; i++) {
+        data[i] = word[i % sizeof(word)];
+    }
+    uint64_t stretch_us = (sim_clock_stretching && (sim_meas_done_us > sim_now_us)) ? (sim_meas_done_us - sim_now_us)
+                                                                                      : 0;
+    uint64_t busy_us = stretch_us + get_airtime_us(length);
+    sim_bus_busy_us += busy_us;
+    sim_i2c_cb = cb;
+    sim_cb_user_data = cb_user_data;
+    sim_complete_at_us = sim_now_us + busy_us;
+}
+
+static void sim_start_timer(uint32_t duration_ms, void *user_data, SHT3XTimerExpiredCb cb, void *cb_user_data)
+{
+    (void)user_data;
+    sim_timer_cb = cb;
+    sim_cb_user_data = cb_user_data;
+    sim_complete_at_us = sim_now_us + ((uint64_t)duration_ms * 1000);
+}
+
+static void run_until_idle()
+{
+    while (sim_i2c_cb || sim_timer_cb) {
+        sim_now_us = sim_complete_at_us;
+        SHT3X_I2CTransactionCompleteCb i2c_cb = sim_i2c_cb;
+        SHT3XTimerExpiredCb timer_cb = sim_timer_cb;
+        sim_i2c_cb = NULL;
+        sim_timer_cb = NULL;
+        if (i2c_cb) {
+            i2c_cb(SHT3X_I2C_RESULT_CODE_OK, sim_cb_user_data);
+        } else {
+            timer_cb(sim_cb_user_data);
+        }
+    }
+}
+
+static void meas_complete_cb(uint8_t result_code, SHT3XMeasurement *meas, void *user_data)
+{
+    (void)meas;
+    (void)user_data;
+    meas_complete_count++;
+    meas_result_code = result_code;
+}
+
+static void complete_cb(uint8_t result_code, void *user_data)
+{
+    (void)user_data;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, result_code);
+}
+
+/* Issue one sample on the simulated backend, and check its duration and bus time against the plan */
+static void check_sample_against_sim(const SHT3XPlanConfig *cfg, const SHT3XPreparedMeas *prepared)
+{
+    SHT3XPlan plan;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_plan(cfg, &plan));
+
+    uint64_t start_us = sim_now_us;
+    sim_bus_busy_us = 0;
+    meas_complete_count = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_issue(sht3x, prepared, meas_complete_cb, NULL));
+    run_until_idle();
+    CHECK_EQUAL(1, meas_complete_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, meas_result_code);
+
+    uint64_t duration_us = sim_now_us - start_us;
+    if (sim_clock_stretching) {
+        /* The driver rounds measurement durations up to whole ms, so the plan may be up to 1 ms pessimistic */
+        CHECK(duration_us <= plan.sample_duration_us);
+        CHECK(duration_us + 1000 > plan.sample_duration_us);
+        CHECK(sim_bus_busy_us <= plan.bus_time_per_sample_us);
+        CHECK(sim_bus_busy_us + 1000 > plan.bus_time_per_sample_us);
+    } else {
+        CHECK_EQUAL(plan.sample_duration_us, duration_us);
+        CHECK_EQUAL(plan.bus_time_per_sample_us, sim_bus_busy_us);
+    }
+}
+
+// clang-format off
+TEST_GROUP(SHT3XPlan)
+{
+    void setup() {
+        sim_bus_speed_hz = 100000;
+        sim_now_us = 0;
+        sim_bus_busy_us = 0;
+        sim_meas_done_us = 0;
+        /* Maximum high repeatability measurement duration from the datasheet */
+        sim_meas_duration_us = 15500;
+        sim_clock_stretching = false;
+        sim_i2c_cb = NULL;
+        sim_timer_cb = NULL;
+        sim_cb_user_data = NULL;
+        sim_complete_at_us = 0;
+
+        SHT3XInitConfig init_cfg = {
+            .get_instance_memory = get_instance_memory,
+            .get_instance_memory_user_data = NULL,
+            .i2c_write = sim_i2c_write,
+            .i2c_write_user_data = NULL,
+            .i2c_read = sim_i2c_read,
+            .i2c_read_user_data = NULL,
+            .start_timer = sim_start_timer,
+            .start_timer_user_data = NULL,
+            .i2c_addr = SHT3X_PLAN_TEST_I2C_ADDR,
+            .trace_hook = NULL,
+            .trace_hook_user_data = NULL,
+        };
+        uint8_t rc = sht3x_create(&sht3x, &init_cfg);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    }
+};
+// clang-format on
+
+static SHT3XPlanConfig make_cfg(uint8_t meas_mode, uint8_t clock_stretching, uint8_t flags)
+{
+    SHT3XPlanConfig cfg;
+    cfg.bus_speed_hz = sim_bus_speed_hz;
+    cfg.num_sensors = 1;
+    cfg.meas_mode = meas_mode;
+    cfg.repeatability = SHT3X_MEAS_REPEATABILITY_HIGH;
+    cfg.clock_stretching = clock_stretching;
+    cfg.mps = SHT3X_MPS_1;
+    cfg.flags = flags;
+    cfg.sample_interval_ms = 0;
+    return cfg;
+}
+
+TEST(SHT3XPlan, SingleShot)
+{
+    SHT3XPlanConfig cfg = make_cfg(SHT3X_MEAS_MODE_SINGLE_SHOT, SHT3X_CLOCK_STRETCHING_DISABLED,
+                                   SHT3X_PLAN_TEST_ALL_FLAGS);
+    cfg.num_sensors = 10;
+    SHT3XPlan plan;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_plan(&cfg, &plan));
+
+    /* 290 us command, 16 ms delay, 650 us readout of 6 bytes at 100 kHz */
+    CHECK_EQUAL(940, plan.bus_time_per_sample_us);
+    CHECK_EQUAL(16940, plan.sample_duration_us);
+    CHECK_EQUAL(17940, plan.min_sample_interval_us);
+    CHECK_EQUAL(17940, plan.sample_interval_us);
+    DOUBLES_EQUAL(10e6 / 17940, plan.samples_per_s, 0.01);
+    CHECK_EQUAL(523, plan.occupancy_permille);
+    CHECK_EQUAL(16940 + 17940, plan.worst_case_sample_age_us);
+    CHECK_TRUE(plan.meets_interval);
+}
+
+TEST(SHT3XPlan, BusLimited)
+{
+    SHT3XPlanConfig cfg = make_cfg(SHT3X_MEAS_MODE_SINGLE_SHOT, SHT3X_CLOCK_STRETCHING_DISABLED,
+                                   SHT3X_PLAN_TEST_ALL_FLAGS);
+    cfg.num_sensors = 20;
+    SHT3XPlan plan;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_plan(&cfg, &plan));
+
+    /* Each sensor waits for the samples of the 19 others */
+    CHECK_EQUAL(20 * 940, plan.sample_interval_us);
+    CHECK_EQUAL(1000, plan.occupancy_permille);
+    DOUBLES_EQUAL(1e6 / 940, plan.samples_per_s, 0.01);
+    CHECK_FALSE(plan.meets_interval);
+
+    /* Faster bus has room */
+    cfg.bus_speed_hz = 400000;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_plan(&cfg, &plan));
+    CHECK_TRUE(plan.meets_interval);
+}
+
+TEST(SHT3XPlan, Periodic)
+{
+    SHT3XPlanConfig cfg = make_cfg(SHT3X_MEAS_MODE_PERIODIC, SHT3X_CLOCK_STRETCHING_DISABLED, SHT3X_FLAG_READ_TEMP);
+    cfg.bus_speed_hz = 400000;
+    cfg.sample_interval_ms = 500;
+    SHT3XPlan plan;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_plan(&cfg, &plan));
+
+    /* 73 us command, 1 ms delay, 73 us readout of 2 bytes at 400 kHz */
+    CHECK_EQUAL(146, plan.bus_time_per_sample_us);
+    CHECK_EQUAL(1146, plan.sample_duration_us);
+    /* New data only once per second at 1 MPS */
+    CHECK_EQUAL(1000000, plan.min_sample_interval_us);
+    CHECK_EQUAL(1000000, plan.sample_interval_us);
+    CHECK_EQUAL(1000000 + 1146 + 1000000, plan.worst_case_sample_age_us);
+    CHECK_FALSE(plan.meets_interval);
+
+    cfg.sample_interval_ms = 2000;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_plan(&cfg, &plan));
+    CHECK_EQUAL(2000000, plan.sample_interval_us);
+    CHECK_TRUE(plan.meets_interval);
+}
+
+TEST(SHT3XPlan, SingleShotMatchesSimulation)
+{
+    uint8_t flags_options[] = {SHT3X_FLAG_READ_TEMP, SHT3X_FLAG_READ_HUM | SHT3X_FLAG_VERIFY_CRC_HUM,
+                               SHT3X_PLAN_TEST_ALL_FLAGS};
+    for (size_t i = 0; i < sizeof(flags_options); i++) {
+        SHT3XPlanConfig cfg = make_cfg(SHT3X_MEAS_MODE_SINGLE_SHOT, SHT3X_CLOCK_STRETCHING_DISABLED, flags_options[i]);
+        SHT3XPreparedMeas prepared;
+        sht3x_prepare_single_shot_measurement(cfg.repeatability, cfg.clock_stretching, cfg.flags, &prepared);
+        check_sample_against_sim(&cfg, &prepared);
+    }
+}
+
+TEST(SHT3XPlan, ClockStretchingMatchesSimulation)
+{
+    SHT3XPlanConfig cfg = make_cfg(SHT3X_MEAS_MODE_SINGLE_SHOT, SHT3X_CLOCK_STRETCHING_ENABLED,
+                                   SHT3X_PLAN_TEST_ALL_FLAGS);
+    SHT3XPreparedMeas prepared;
+    sht3x_prepare_single_shot_measurement(cfg.repeatability, cfg.clock_stretching, cfg.flags, &prepared);
+    check_sample_against_sim(&cfg, &prepared);
+    CHECK_TRUE(sim_clock_stretching);
+}
+
+TEST(SHT3XPlan, PeriodicMatchesSimulation)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK,
+                sht3x_start_periodic_measurement(sht3x, SHT3X_MEAS_REPEATABILITY_HIGH, SHT3X_MPS_1, complete_cb, NULL));
+    run_until_idle();
+
+    SHT3XPlanConfig cfg = make_cfg(SHT3X_MEAS_MODE_PERIODIC, SHT3X_CLOCK_STRETCHING_DISABLED,
+                                   SHT3X_PLAN_TEST_ALL_FLAGS);
+    SHT3XPreparedMeas prepared;
+    sht3x_prepare_periodic_measurement(cfg.flags, &prepared);
+    check_sample_against_sim(&cfg, &prepared);
+}
+
+TEST(SHT3XPlan, InvalidArgs)
+{
+    SHT3XPlan plan;
+    SHT3XPlanConfig cfg = make_cfg(SHT3X_MEAS_MODE_SINGLE_SHOT, SHT3X_CLOCK_STRETCHING_DISABLED, SHT3X_FLAG_READ_TEMP);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_plan(NULL, &plan));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_plan(&cfg, NULL));
+
+    cfg.num_sensors = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_plan(&cfg, &plan));
+    cfg.num_sensors = 1;
+    cfg.bus_speed_hz = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_plan(&cfg, &plan));
+    cfg.bus_speed_hz = 100000;
+    cfg.flags = SHT3X_FLAG_VERIFY_CRC_HUM;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_plan(&cfg, &plan));
+    cfg.flags = SHT3X_FLAG_READ_TEMP;
+    cfg.meas_mode = SHT3X_MEAS_MODE_PERIODIC_ART;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_plan(&cfg, &plan));
+    cfg.meas_mode = SHT3X_MEAS_MODE_PERIODIC;
+    cfg.mps = SHT3X_MPS_10 + 1;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_plan(&cfg, &plan));
+    cfg.mps = SHT3X_MPS_1;
+    cfg.repeatability = SHT3X_MEAS_REPEATABILITY_LOW + 1;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_plan(&cfg, &plan));
+}
@@ -0,0 +1,356 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+
+#include "sht3x_resample.h"
+#include "lazy_meas_builder.h"
+
+#define SHT3X_RESAMPLE_TEST_MAX_SENSORS 5
+#define SHT3X_RESAMPLE_TEST_MAX_ROWS 4
+#define SHT3X_RESAMPLE_TEST_MAX_VALUES (SHT3X_RESAMPLE_TEST_MAX_SENSORS * SHT3X_RESAMPLE_TEST_MAX_ROWS)
+#define SHT3X_RESAMPLE_TEST_MANY_SENSORS 10000
+#define SHT3X_RESAMPLE_TEST_BOTH (SHT3X_RESAMPLE_STATUS_TEMP | SHT3X_RESAMPLE_STATUS_HUM)
+
+static SHT3XResampler resampler;
+static SHT3XResampleSensor sensors[SHT3X_RESAMPLE_TEST_MAX_SENSORS];
+static uint16_t raw_temperature[SHT3X_RESAMPLE_TEST_MAX_VALUES];
+static uint16_t raw_humidity[SHT3X_RESAMPLE_TEST_MAX_VALUES];
+static uint8_t status[SHT3X_RESAMPLE_TEST_MAX_VALUES];
+static SHT3XResampleRow row;
+
+static SHT3XResampleConfig get_cfg(uint16_t num_sensors, uint8_t method)
+{
+    SHT3XResampleConfig cfg = {
+        .num_sensors = num_sensors,
+        .num_rows = SHT3X_RESAMPLE_TEST_MAX_ROWS,
+        .method = method,
+        .start_time = 1000,
+        .period = 1000,
+        .max_age = 0,
+        .max_delay = 500,
+        .sensors = sensors,
+        .raw_temperature = raw_temperature,
+        .raw_humidity = raw_humidity,
+        .status = status,
+    };
+    return cfg;
+}
+
+static void init_resampler(const SHT3XResampleConfig *cfg)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_init(&resampler, cfg));
+}
+
+// clang-format off
+TEST_GROUP(SHT3XResample)
+{
+    void setup() {
+        memset(sensors, 0xAA, sizeof(sensors));
+        memset(raw_temperature, 0xAA, sizeof(raw_temperature));
+        memset(raw_humidity, 0xAA, sizeof(raw_humidity));
+        memset(status, 0xAA, sizeof(status));
+        memset(&row, 0, sizeof(row));
+    }
+};
+// clang-format on
+
+static uint8_t push(uint16_t sensor, uint32_t timestamp, uint8_t flags, uint16_t raw_temp, uint16_t raw_hum)
+{
+    SHT3XLazyMeasurement meas = build_lazy_meas(flags, raw_temp, raw_hum);
+    return sht3x_resample_push(&resampler, sensor, timestamp, &meas);
+}
+
+static void push_ok(uint16_t sensor, uint32_t timestamp, uint16_t raw_temp, uint16_t raw_hum)
+{
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK,
+                push(sensor, timestamp, SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM, raw_temp, raw_hum));
+}
+
+TEST(SHT3XResample, HoldUsesLatestSampleAtOrBeforeRowTime)
+{
+    SHT3XResampleConfig cfg = get_cfg(2, SHT3X_RESAMPLE_METHOD_HOLD);
+    init_resampler(&cfg);
+
+    /* Sensor 0 samples at 4 Hz, sensor 1 every 2 s */
+    push_ok(0, 750, 10, 20);
+    push_ok(1, 900, 50, 60);
+    push_ok(0, 1000, 11, 21);
+    push_ok(0, 1250, 12, 22);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_resample_pop_row(&resampler, 1000, &row));
+    push_ok(1, 2900, 51, 61);
+    push_ok(0, 2100, 13, 23);
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 1000, &row));
+    CHECK_EQUAL(1000, row.timestamp);
+    CHECK_EQUAL(2, row.num_sensors);
+    CHECK_EQUAL(11, row.raw_temperature[0]);
+    CHECK_EQUAL(21, row.raw_humidity[0]);
+    CHECK_EQUAL(SHT3X_RESAMPLE_TEST_BOTH, row.status[0]);
+    CHECK_EQUAL(50, row.raw_temperature[1]);
+    CHECK_EQUAL(60, row.raw_humidity[1]);
+    CHECK_EQUAL(SHT3X_RESAMPLE_TEST_BOTH, row.status[1]);
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 1000, &row));
+    CHECK_EQUAL(2000, row.timestamp);
+    CHECK_EQUAL(12, row.raw_temperature[0]);
+    CHECK_EQUAL(50, row.raw_temperature[1]);
+
+    /* Sensor 0 did not pass 3000 yet */
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_resample_pop_row(&resampler, 3000, &row));
+}
+
+TEST(SHT3XResample, LinearInterpolatesBetweenSamples)
+{
+    SHT3XResampleConfig cfg = get_cfg(1, SHT3X_RESAMPLE_METHOD_LINEAR);
+    init_resampler(&cfg);
+
+    push_ok(0, 500, 100, 1000);
+    push_ok(0, 3500, 400, 700);
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 0, &row));
+    CHECK_EQUAL(1000, row.timestamp);
+    CHECK_EQUAL(150, row.raw_temperature[0]);
+    CHECK_EQUAL(950, row.raw_humidity[0]);
+    CHECK_EQUAL(SHT3X_RESAMPLE_TEST_BOTH, row.status[0]);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 0, &row));
+    CHECK_EQUAL(250, row.raw_temperature[0]);
+    CHECK_EQUAL(850, row.raw_humidity[0]);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 0, &row));
+    CHECK_EQUAL(350, row.raw_temperature[0]);
+    CHECK_EQUAL(750, row.raw_humidity[0]);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_resample_pop_row(&resampler, 0, &row));
+}
+
+TEST(SHT3XResample, LinearRoundsToNearestTick)
+{
+    SHT3XResampleConfig cfg = get_cfg(1, SHT3X_RESAMPLE_METHOD_LINEAR);
+    init_resampler(&cfg);
+
+    /* Rows at 1/3 and 2/3 of one tick up and one tick down */
+    push_ok(0, 0, 10, 10);
+    push_ok(0, 3000, 11, 9);
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 0, &row));
+    CHECK_EQUAL(10, row.raw_temperature[0]);
+    CHECK_EQUAL(10, row.raw_humidity[0]);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 0, &row));
+    CHECK_EQUAL(11, row.raw_temperature[0]);
+    CHECK_EQUAL(9, row.raw_humidity[0]);
+}
+
+TEST(SHT3XResample, LinearNeedsValueInBothSamples)
+{
+    SHT3XResampleConfig cfg = get_cfg(1, SHT3X_RESAMPLE_METHOD_LINEAR);
+    init_resampler(&cfg);
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, push(0, 500, SHT3X_FLAG_READ_TEMP, 100, 0));
+    push_ok(0, 1500, 200, 300);
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 0, &row));
+    CHECK_EQUAL(150, row.raw_temperature[0]);
+    CHECK_EQUAL(SHT3X_RESAMPLE_STATUS_TEMP, row.status[0]);
+}
+
+TEST(SHT3XResample, FirstRowWithoutEarlierSample)
+{
+    SHT3XResampleConfig cfg = get_cfg(2, SHT3X_RESAMPLE_METHOD_LINEAR);
+    init_resampler(&cfg);
+
+    /* Sensor 0 has a sample at the row time, sensor 1 only after it */
+    push_ok(0, 1000, 100, 200);
+    push_ok(1, 1200, 300, 400);
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 0, &row));
+    CHECK_EQUAL(100, row.raw_temperature[0]);
+    CHECK_EQUAL(SHT3X_RESAMPLE_TEST_BOTH, row.status[0]);
+    CHECK_EQUAL(0, row.status[1]);
+}
+
+TEST(SHT3XResample, MaxDelayForcesRowWithHold)
+{
+    SHT3XResampleConfig cfg = get_cfg(2, SHT3X_RESAMPLE_METHOD_LINEAR);
+    init_resampler(&cfg);
+
+    push_ok(0, 800, 100, 200);
+    push_ok(0, 1800, 110, 210);
+    push_ok(1, 900, 300, 400);
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_resample_pop_row(&resampler, 1499, &row));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 1500, &row));
+    CHECK_EQUAL(1000, row.timestamp);
+    CHECK_EQUAL(102, row.raw_temperature[0]);
+    CHECK_EQUAL(300, row.raw_temperature[1]);
+    CHECK_EQUAL(400, row.raw_humidity[1]);
+    CHECK_EQUAL(SHT3X_RESAMPLE_TEST_BOTH, row.status[1]);
+
+    /* The late sample only fills the rows that were not taken out */
+    push_ok(1, 2000, 500, 600);
+    push_ok(0, 2000, 120, 220);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 0, &row));
+    CHECK_EQUAL(2000, row.timestamp);
+    CHECK_EQUAL(120, row.raw_temperature[0]);
+    CHECK_EQUAL(500, row.raw_temperature[1]);
+}
+
+TEST(SHT3XResample, MaxAgeInvalidatesOldSamples)
+{
+    SHT3XResampleConfig cfg = get_cfg(1, SHT3X_RESAMPLE_METHOD_HOLD);
+    cfg.max_age = 1500;
+    init_resampler(&cfg);
+
+    push_ok(0, 900, 100, 200);
+    push_ok(0, 3100, 110, 210);
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 0, &row));
+    CHECK_EQUAL(SHT3X_RESAMPLE_TEST_BOTH, row.status[0]);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 0, &row));
+    CHECK_EQUAL(SHT3X_RESAMPLE_TEST_BOTH, row.status[0]);
+    CHECK_EQUAL(100, row.raw_temperature[0]);
+    /* 2100 after the sample */
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 0, &row));
+    CHECK_EQUAL(3000, row.timestamp);
+    CHECK_EQUAL(0, row.status[0]);
+    CHECK_EQUAL(0, row.raw_temperature[0]);
+}
+
+TEST(SHT3XResample, RingFull)
+{
+    SHT3XResampleConfig cfg = get_cfg(2, SHT3X_RESAMPLE_METHOD_HOLD);
+    init_resampler(&cfg);
+
+    push_ok(0, 4000, 100, 200);
+    /* Would fill the fifth row */
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OUT_OF_MEMORY, push(0, 5000, SHT3X_FLAG_READ_TEMP, 110, 210));
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 1500, &row));
+    push_ok(0, 5000, 110, 210);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OUT_OF_MEMORY, push(0, 6000, SHT3X_FLAG_READ_TEMP, 120, 220));
+
+    /* The rejected sample was not stored */
+    push_ok(1, 5000, 300, 400);
+    for (uint32_t time = 2000; time <= 5000; time += 1000) {
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_resample_pop_row(&resampler, 0, &row));
+        CHECK_EQUAL(time, row.timestamp);
+    }
+    CHECK_EQUAL(110, row.raw_temperature[0]);
+    CHECK_EQUAL(SHT3X_RESAMPLE_TEST_BOTH, row.status[0]);
+}
+
+TEST(SHT3XResample, SamplesOutOfOrder)
+{
+    SHT3XResampleConfig cfg = get_cfg(1, SHT3X_RESAMPLE_METHOD_HOLD);
+    init_resampler(&cfg);
+
+    push_ok(0, 1500, 100, 200);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, push(0, 1499, SHT3X_FLAG_READ_TEMP, 100, 200));
+    push_ok(0, 1500, 110, 210);
+}
+
+/* Raw value of a linear ramp at a time in ms */
+static uint16_t ramp(uint16_t sensor, uint32_t time)
+{
+    return (uint16_t)(1000 * (sensor % 50) + time / 10);
+}
+
+/**
+ * Push the samples of sensors in periodic mode with MPS 10, 4, 2, 1 and 0.5 in turn, from time 0 to end_ms, and check
+ * every row that is taken out. Returns the time of the first row that was not taken out.
+ */
+static uint32_t run_periodic_modes(uint16_t num_sensors, uint32_t *next_sample_ms, uint32_t end_ms)
+{
+    static const uint32_t periods_ms[] = {100, 250, 500, 1000, 2000};
+    static const uint32_t offsets_ms[] = {30, 70, 110, 130, 170};
+    const uint16_t num_modes = sizeof(periods_ms) / sizeof(periods_ms[0]);
+    for (uint16_t i = 0; i < num_sensors; i++) {
+        next_sample_ms[i] = offsets_ms[i % num_modes];
+    }
+
+    uint32_t expected_time = 1000;
+    for (uint32_t now = 0; now <= end_ms; now += 10) {
+        for (uint16_t i = 0; i < num_sensors; i++) {
+            if (now == next_sample_ms[i]) {
+                push_ok(i, now, ramp(i, now), ramp(i, now));
+                next_sample_ms[i] += periods_ms[i % num_modes];
+            }
+        }
+        while (sht3x_resample_pop_row(&resampler, now, &row) == SHT3X_RESULT_CODE_OK) {
+            CHECK_EQUAL(expected_time, row.timestamp);
+            CHECK_EQUAL(num_sensors, row.num_sensors);
+            for (uint16_t i = 0; i < num_sensors; i++) {
+                CHECK_EQUAL(SHT3X_RESAMPLE_TEST_BOTH, row.status[i]);
+                CHECK_EQUAL(ramp(i, expected_time), row.raw_temperature[i]);
+                CHECK_EQUAL(ramp(i, expected_time), row.raw_humidity[i]);
+            }
+            expected_time += 1000;
+        }
+    }
+    return expected_time;
+}
+
+TEST(SHT3XResample, PeriodicModesOntoOneHertzRows)
+{
+    uint32_t next_sample_ms[SHT3X_RESAMPLE_TEST_MAX_SENSORS];
+    SHT3XResampleConfig cfg = get_cfg(SHT3X_RESAMPLE_TEST_MAX_SENSORS, SHT3X_RESAMPLE_METHOD_LINEAR);
+    cfg.max_delay = 2500;
+    init_resampler(&cfg);
+
+    /* Every row is taken out once the slowest sensor passed it */
+    CHECK_EQUAL(29000, run_periodic_modes(SHT3X_RESAMPLE_TEST_MAX_SENSORS, next_sample_ms, 30000));
+}
+
+TEST(SHT3XResample, TenThousandSensors)
+{
+    static SHT3XResampleSensor many_sensors[SHT3X_RESAMPLE_TEST_MANY_SENSORS];
+    static uint16_t many_raw_temperature[SHT3X_RESAMPLE_TEST_MANY_SENSORS * SHT3X_RESAMPLE_TEST_MAX_ROWS];
+    static uint16_t many_raw_humidity[SHT3X_RESAMPLE_TEST_MANY_SENSORS * SHT3X_RESAMPLE_TEST_MAX_ROWS];
+    static uint8_t many_status[SHT3X_RESAMPLE_TEST_MANY_SENSORS * SHT3X_RESAMPLE_TEST_MAX_ROWS];
+    static uint32_t next_sample_ms[SHT3X_RESAMPLE_TEST_MANY_SENSORS];
+    SHT3XResampleConfig cfg = get_cfg(SHT3X_RESAMPLE_TEST_MANY_SENSORS, SHT3X_RESAMPLE_METHOD_LINEAR);
+    cfg.max_delay = 2500;
+    cfg.sensors = many_sensors;
+    cfg.raw_temperature = many_raw_temperature;
+    cfg.raw_humidity = many_raw_humidity;
+    cfg.status = many_status;
+    init_resampler(&cfg);
+
+    /* The slowest sensors sample at 8170 ms, and next at 10170 ms */
+    CHECK_EQUAL(9000, run_periodic_modes(SHT3X_RESAMPLE_TEST_MANY_SENSORS, next_sample_ms, 10000));
+}
+
+TEST(SHT3XResample, InvalidArgs)
+{
+    SHT3XResampleConfig cfg = get_cfg(2, SHT3X_RESAMPLE_METHOD_HOLD);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_init(NULL, &cfg));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_init(&resampler, NULL));
+    cfg.num_sensors = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_init(&resampler, &cfg));
+    cfg = get_cfg(2, SHT3X_RESAMPLE_METHOD_HOLD);
+    cfg.num_rows = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_init(&resampler, &cfg));
+    cfg = get_cfg(2, SHT3X_RESAMPLE_METHOD_HOLD);
+    cfg.period = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_init(&resampler, &cfg));
+    cfg = get_cfg(2, 2);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_init(&resampler, &cfg));
+    cfg = get_cfg(2, SHT3X_RESAMPLE_METHOD_HOLD);
+    cfg.sensors = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_init(&resampler, &cfg));
+    cfg = get_cfg(2, SHT3X_RESAMPLE_METHOD_HOLD);
+    cfg.raw_temperature = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_init(&resampler, &cfg));
+    cfg = get_cfg(2, SHT3X_RESAMPLE_METHOD_HOLD);
+    cfg.raw_humidity = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_init(&resampler, &cfg));
+    cfg = get_cfg(2, SHT3X_RESAMPLE_METHOD_HOLD);
+    cfg.status = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_init(&resampler, &cfg));
+
+    cfg = get_cfg(2, SHT3X_RESAMPLE_METHOD_HOLD);
+    init_resampler(&cfg);
+    SHT3XLazyMeasurement meas = build_lazy_meas(0, 0, 0);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_push(NULL, 0, 0, &meas));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_push(&resampler, 0, 0, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_push(&resampler, 2, 0, &meas));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_pop_row(NULL, 0, &row));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_resample_pop_row(&resampler, 0, NULL));
+}
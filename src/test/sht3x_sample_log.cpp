@@ -0,0 +1,222 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+
+#include "sht3x_sample_log.h"
+
+#define SHT3X_SAMPLE_LOG_TEST_BLOCK_SIZE 256
+#define SHT3X_SAMPLE_LOG_TEST_NUM_SAMPLES 300
+
+static SHT3XSampleLogWriter writer;
+static SHT3XSampleLogReader reader;
+static uint8_t block_buf[SHT3X_SAMPLE_LOG_TEST_BLOCK_SIZE];
+/* Storage that the writer appends blocks to */
+static uint8_t storage[4096];
+static size_t storage_length;
+static size_t num_blocks_written;
+static bool write_fails;
+
+static bool write_block(const uint8_t *data, size_t length, void *user_data)
+{
+    (void)user_data;
+    if (write_fails || ((sizeof(storage) - storage_length) < length)) {
+        return false;
+    }
+    memcpy(&storage[storage_length], data, length);
+    storage_length += length;
+    num_blocks_written++;
+    return true;
+}
+
+// clang-format off
+TEST_GROUP(SHT3XSampleLog)
+{
+    void setup() {
+        memset(storage, 0, sizeof(storage));
+        storage_length = 0;
+        num_blocks_written = 0;
+        write_fails = false;
+
+        SHT3XSampleLogWriterConfig cfg = {
+            .block_buf = block_buf,
+            .block_size = sizeof(block_buf),
+            .write = write_block,
+            .write_user_data = NULL,
+        };
+        uint8_t rc = sht3x_sample_log_writer_init(&writer, &cfg);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    }
+};
+// clang-format on
+
+/* Sample i of a slowly changing series, sampled every second, with a large jump */
+static SHT3XLogSample get_sample(size_t i)
+{
+    SHT3XLogSample sample;
+    sample.timestamp = (uint32_t)i;
+    sample.raw_temperature = (uint16_t)(0x6000 + ((i % 7) * 3) - (i / 20));
+    sample.raw_humidity = (uint16_t)((i == 100) ? 0xFFFF : (0x8000 + (i % 5)));
+    return sample;
+}
+
+static void append_samples(size_t num_samples)
+{
+    for (size_t i = 0; i < num_samples; i++) {
+        SHT3XLogSample sample = get_sample(i);
+        uint8_t rc = sht3x_sample_log_append(&writer, &sample);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    }
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_flush(&writer));
+}
+
+static void check_sample(const SHT3XLogSample *expected, const SHT3XLogSample *actual)
+{
+    CHECK_EQUAL(expected->timestamp, actual->timestamp);
+    CHECK_EQUAL(expected->raw_temperature, actual->raw_temperature);
+    CHECK_EQUAL(expected->raw_humidity, actual->raw_humidity);
+}
+
+TEST(SHT3XSampleLog, EncodesBlock)
+{
+    SHT3XLogSample samples[] = {
+        {.timestamp = 1000, .raw_temperature = 0x6000, .raw_humidity = 0x8000},
+        {.timestamp = 2000, .raw_temperature = 0x5FFF, .raw_humidity = 0x8002},
+    };
+    sht3x_sample_log_append(&writer, &samples[0]);
+    sht3x_sample_log_append(&writer, &samples[1]);
+    CHECK_EQUAL(0, num_blocks_written);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_flush(&writer));
+    CHECK_EQUAL(1, num_blocks_written);
+
+    uint8_t expected[] = {
+        /* Version, reserved, 2 samples, 4 bytes of payload */
+        0x01, 0x00, 0x00, 0x02, 0x00, 0x04,
+        /* First sample */
+        0x00, 0x00, 0x03, 0xE8, 0x60, 0x00, 0x80, 0x00,
+        /* CRC */
+        0x8C, 0xDD,
+        /* Timestamp +1000, temperature -1, humidity +2 */
+        0xE8, 0x07, 0x01, 0x04,
+    };
+    CHECK_EQUAL(sizeof(expected), storage_length);
+    MEMCMP_EQUAL(expected, storage, sizeof(expected));
+}
+
+TEST(SHT3XSampleLog, RoundTrip)
+{
+    append_samples(SHT3X_SAMPLE_LOG_TEST_NUM_SAMPLES);
+    CHECK(num_blocks_written > 1);
+    /* Less than half the size of the raw structs */
+    CHECK(storage_length < ((SHT3X_SAMPLE_LOG_TEST_NUM_SAMPLES * sizeof(SHT3XLogSample)) / 2));
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_reader_init(&reader, storage, storage_length));
+    for (size_t i = 0; i < SHT3X_SAMPLE_LOG_TEST_NUM_SAMPLES; i++) {
+        SHT3XLogSample expected = get_sample(i);
+        SHT3XLogSample sample;
+        uint8_t rc = sht3x_sample_log_read(&reader, &sample);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+        check_sample(&expected, &sample);
+    }
+    SHT3XLogSample sample;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_sample_log_read(&reader, &sample));
+}
+
+TEST(SHT3XSampleLog, Seek)
+{
+    append_samples(SHT3X_SAMPLE_LOG_TEST_NUM_SAMPLES);
+    sht3x_sample_log_reader_init(&reader, storage, storage_length);
+
+    uint32_t target = 150;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_seek(&reader, target));
+    SHT3XLogSample sample;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_read(&reader, &sample));
+    CHECK(sample.timestamp <= target);
+    /* Samples follow on from the block start */
+    SHT3XLogSample expected = get_sample(sample.timestamp);
+    check_sample(&expected, &sample);
+    /* Block that was sought to holds the target */
+    while (sample.timestamp <= target) {
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_read(&reader, &sample));
+    }
+    CHECK_EQUAL(151, sample.timestamp);
+
+    /* Before the first block */
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_seek(&reader, 0));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_read(&reader, &sample));
+    CHECK_EQUAL(0, sample.timestamp);
+}
+
+TEST(SHT3XSampleLog, CorruptedBlockIsSkipped)
+{
+    append_samples(SHT3X_SAMPLE_LOG_TEST_NUM_SAMPLES);
+    sht3x_sample_log_reader_init(&reader, storage, storage_length);
+
+    /* Corrupt the payload of the first block */
+    storage[SHT3X_SAMPLE_LOG_BLOCK_HEADER_SIZE] ^= 0x01;
+    SHT3XLogSample sample;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_CRC_MISMATCH, sht3x_sample_log_read(&reader, &sample));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_read(&reader, &sample));
+    CHECK(sample.timestamp > 0);
+    SHT3XLogSample expected = get_sample(sample.timestamp);
+    check_sample(&expected, &sample);
+}
+
+TEST(SHT3XSampleLog, TruncatedBlockEndsLog)
+{
+    SHT3XLogSample first = get_sample(0);
+    sht3x_sample_log_append(&writer, &first);
+    sht3x_sample_log_flush(&writer);
+    append_samples(3);
+
+    /* Cut the second block short */
+    sht3x_sample_log_reader_init(&reader, storage, storage_length - 1);
+    SHT3XLogSample sample;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_read(&reader, &sample));
+    check_sample(&first, &sample);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_sample_log_read(&reader, &sample));
+}
+
+TEST(SHT3XSampleLog, WriteFailureKeepsBlock)
+{
+    SHT3XLogSample sample = get_sample(0);
+    sht3x_sample_log_append(&writer, &sample);
+    write_fails = true;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_IO_ERR, sht3x_sample_log_flush(&writer));
+    write_fails = false;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_flush(&writer));
+    CHECK_EQUAL(1, num_blocks_written);
+    /* Nothing left to write */
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_flush(&writer));
+    CHECK_EQUAL(1, num_blocks_written);
+}
+
+TEST(SHT3XSampleLog, InvalidArgs)
+{
+    SHT3XSampleLogWriter other;
+    SHT3XSampleLogWriterConfig cfg = {
+        .block_buf = block_buf,
+        .block_size = SHT3X_SAMPLE_LOG_MIN_BLOCK_SIZE - 1,
+        .write = write_block,
+        .write_user_data = NULL,
+    };
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_sample_log_writer_init(&other, &cfg));
+    cfg.block_size = SHT3X_SAMPLE_LOG_MIN_BLOCK_SIZE;
+    cfg.write = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_sample_log_writer_init(&other, &cfg));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_sample_log_writer_init(NULL, &cfg));
+
+    SHT3XLogSample sample = get_sample(5);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_append(&writer, &sample));
+    sht3x_sample_log_flush(&writer);
+    /* Timestamp decreases, also across blocks */
+    sample = get_sample(4);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_sample_log_append(&writer, &sample));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_sample_log_append(&writer, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_sample_log_flush(NULL));
+
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_sample_log_reader_init(&reader, NULL, 0));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_sample_log_reader_init(&reader, storage, 0));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_sample_log_seek(&reader, 0));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_sample_log_read(&reader, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_sample_log_seek(NULL, 0));
+}
@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+
+#include "sht3x_serialize.h"
+
+static uint8_t buf[512];
+static size_t length;
+
+// clang-format off
+TEST_GROUP(SHT3XSerialize)
+{
+    void setup() {
+        memset(buf, 0, sizeof(buf));
+        length = 0;
+    }
+};
+// clang-format on
+
+static SHT3XRecord make_record(uint32_t sensor_id, uint32_t timestamp, float temperature, float humidity)
+{
+    SHT3XRecord record;
+    record.sensor_id = sensor_id;
+    record.timestamp = timestamp;
+    record.meas.temperature = temperature;
+    record.meas.humidity = humidity;
+    return record;
+}
+
+static void check_json(const char *expected, const SHT3XRecord *record)
+{
+    uint8_t rc = sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_JSON_LINES, record, buf, sizeof(buf), &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(strlen(expected), length);
+    MEMCMP_EQUAL(expected, buf, length);
+}
+
+TEST(SHT3XSerialize, Binary)
+{
+    SHT3XRecord record = make_record(0x01020304, 1000, 23.5f, 50.0f);
+    uint8_t rc = sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_BINARY, &record, buf, sizeof(buf), &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+    uint8_t expected[] = {
+        0x01, 0x02, 0x03, 0x04, /* Sensor ID */
+        0x00, 0x00, 0x03, 0xE8, /* Timestamp */
+        0x41, 0xBC, 0x00, 0x00, /* 23.5 */
+        0x42, 0x48, 0x00, 0x00, /* 50.0 */
+    };
+    CHECK_EQUAL(SHT3X_SERIALIZE_BINARY_SIZE, length);
+    MEMCMP_EQUAL(expected, buf, sizeof(expected));
+}
+
+TEST(SHT3XSerialize, Cbor)
+{
+    SHT3XRecord record = make_record(3, 1000, 23.5f, 50.0f);
+    uint8_t rc = sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_CBOR, &record, buf, sizeof(buf), &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+    uint8_t expected[] = {
+        /* Map with 4 entries */
+        0xA4,
+        /* "id": 3 */
+        0x62, 'i', 'd', 0x03,
+        /* "ts": 1000 */
+        0x62, 't', 's', 0x19, 0x03, 0xE8,
+        /* "t": 23.5 */
+        0x61, 't', 0xFA, 0x41, 0xBC, 0x00, 0x00,
+        /* "rh": 50.0 */
+        0x62, 'r', 'h', 0xFA, 0x42, 0x48, 0x00, 0x00,
+    };
+    CHECK_EQUAL(sizeof(expected), length);
+    MEMCMP_EQUAL(expected, buf, sizeof(expected));
+}
+
+TEST(SHT3XSerialize, CborMaxSize)
+{
+    SHT3XRecord record = make_record(UINT32_MAX, UINT32_MAX, -45.0f, 100.0f);
+    uint8_t rc = sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_CBOR, &record, buf, sizeof(buf), &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(SHT3X_SERIALIZE_CBOR_MAX_SIZE, length);
+}
+
+TEST(SHT3XSerialize, JsonLine)
+{
+    SHT3XRecord record = make_record(3, 1000, 23.456f, 45.0f);
+    check_json("{\"id\":3,\"ts\":1000,\"t\":23.46,\"rh\":45.00}\n", &record);
+
+    record = make_record(0, 0, -0.004f, 0.0f);
+    check_json("{\"id\":0,\"ts\":0,\"t\":-0.00,\"rh\":0.00}\n", &record);
+
+    record = make_record(1, 2, -12.345678f, 99.999f);
+    check_json("{\"id\":1,\"ts\":2,\"t\":-12.35,\"rh\":100.00}\n", &record);
+}
+
+TEST(SHT3XSerialize, JsonTiesRoundToEven)
+{
+    /* Exactly representable, so these are true ties */
+    SHT3XRecord record = make_record(0, 0, 0.125f, 0.375f);
+    check_json("{\"id\":0,\"ts\":0,\"t\":0.12,\"rh\":0.38}\n", &record);
+}
+
+TEST(SHT3XSerialize, JsonOutOfRangeIsNull)
+{
+    float zero = 0.0f;
+    SHT3XRecord record = make_record(0, 0, zero / zero, 1e7f);
+    check_json("{\"id\":0,\"ts\":0,\"t\":null,\"rh\":null}\n", &record);
+}
+
+TEST(SHT3XSerialize, JsonMaxSize)
+{
+    SHT3XRecord record = make_record(UINT32_MAX, UINT32_MAX, -9999999.0f, -9999999.0f);
+    uint8_t rc = sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_JSON_LINES, &record, buf, sizeof(buf), &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(SHT3X_SERIALIZE_JSON_MAX_SIZE, length);
+}
+
+TEST(SHT3XSerialize, JsonMatchesPrintf)
+{
+    /* Every temperature and humidity value that the driver can convert raw ticks to */
+    for (uint32_t raw = 0; raw <= UINT16_MAX; raw++) {
+        float temperature = (175.0f / 65535.0f) * (float)raw - 45;
+        float humidity = (100.0f / 65535.0f) * (float)raw;
+        SHT3XRecord record = make_record(raw, raw, temperature, humidity);
+
+        char expected[SHT3X_SERIALIZE_JSON_MAX_SIZE + 1];
+        int expected_length = snprintf(expected, sizeof(expected), "{\"id\":%u,\"ts\":%u,\"t\":%.2f,\"rh\":%.2f}\n",
+                                       (unsigned)raw, (unsigned)raw, (double)temperature, (double)humidity);
+        uint8_t rc = sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_JSON_LINES, &record, buf, sizeof(buf), &length);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+        CHECK_EQUAL((size_t)expected_length, length);
+        MEMCMP_EQUAL(expected, buf, length);
+    }
+}
+
+TEST(SHT3XSerialize, Batch)
+{
+    SHT3XRecord records[] = {
+        make_record(1, 10, 20.0f, 40.0f),
+        make_record(2, 20, 21.0f, 41.0f),
+    };
+
+    uint8_t rc = sht3x_serialize_batch(SHT3X_SERIALIZE_FORMAT_BINARY, records, 2, buf, sizeof(buf), &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(2 * SHT3X_SERIALIZE_BINARY_SIZE, length);
+    CHECK_EQUAL(2, buf[SHT3X_SERIALIZE_BINARY_SIZE + 3]);
+
+    size_t record_length = 0;
+    uint8_t record_buf[SHT3X_SERIALIZE_CBOR_MAX_SIZE];
+    sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_CBOR, &records[1], record_buf, sizeof(record_buf), &record_length);
+    rc = sht3x_serialize_batch(SHT3X_SERIALIZE_FORMAT_CBOR, records, 2, buf, sizeof(buf), &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    /* Array with 2 entries */
+    CHECK_EQUAL(0x82, buf[0]);
+    CHECK_EQUAL(1 + (2 * record_length), length);
+    MEMCMP_EQUAL(record_buf, &buf[1 + record_length], record_length);
+
+    const char *expected = "{\"id\":1,\"ts\":10,\"t\":20.00,\"rh\":40.00}\n"
+                           "{\"id\":2,\"ts\":20,\"t\":21.00,\"rh\":41.00}\n";
+    rc = sht3x_serialize_batch(SHT3X_SERIALIZE_FORMAT_JSON_LINES, records, 2, buf, sizeof(buf), &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(strlen(expected), length);
+    MEMCMP_EQUAL(expected, buf, length);
+
+    /* Empty CBOR batch is an empty array */
+    rc = sht3x_serialize_batch(SHT3X_SERIALIZE_FORMAT_CBOR, records, 0, buf, sizeof(buf), &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(1, length);
+    CHECK_EQUAL(0x80, buf[0]);
+}
+
+TEST(SHT3XSerialize, OutOfMemory)
+{
+    SHT3XRecord records[] = {
+        make_record(1, 10, 20.0f, 40.0f),
+        make_record(2, 20, 21.0f, 41.0f),
+    };
+    length = 123;
+    uint8_t rc = sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_BINARY, &records[0], buf,
+                                        SHT3X_SERIALIZE_BINARY_SIZE - 1, &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OUT_OF_MEMORY, rc);
+    CHECK_EQUAL(123, length);
+
+    rc = sht3x_serialize_batch(SHT3X_SERIALIZE_FORMAT_BINARY, records, 2, buf, (2 * SHT3X_SERIALIZE_BINARY_SIZE) - 1,
+                               &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OUT_OF_MEMORY, rc);
+    rc = sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_JSON_LINES, &records[0], buf, 10, &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OUT_OF_MEMORY, rc);
+    rc = sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_CBOR, &records[0], buf, 0, &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OUT_OF_MEMORY, rc);
+}
+
+TEST(SHT3XSerialize, InvalidArgs)
+{
+    SHT3XRecord record = make_record(1, 10, 20.0f, 40.0f);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_serialize_record((SHT3XSerializeFormat)3, &record, buf, sizeof(buf), &length));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_CBOR, NULL, buf, sizeof(buf), &length));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_CBOR, &record, NULL, sizeof(buf), &length));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_serialize_record(SHT3X_SERIALIZE_FORMAT_CBOR, &record, buf, sizeof(buf), NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_serialize_batch(SHT3X_SERIALIZE_FORMAT_CBOR, NULL, 1, buf, sizeof(buf), &length));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_serialize_batch((SHT3XSerializeFormat)3, &record, 1, buf, sizeof(buf), &length));
+}
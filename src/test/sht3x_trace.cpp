@@ -0,0 +1,325 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+#include "sht3x.h"
+#include "sht3x_trace.h"
+#include "sht3x_flight_recorder.h"
+#include "sht3x_latency.h"
+/* Included to know the size of SHT3X instance we need to define to return from mock_sht3x_get_instance_memory. */
+#include "sht3x_private.h"
+#include "mock_cfg_functions.h"
+
+#define SHT3X_TRACE_TEST_I2C_ADDR 0x44
+#define SHT3X_TRACE_TEST_MAX_EVENTS 16
+#define SHT3X_TRACE_TEST_RECORDER_EVENTS 8
+
+/* To return from mock_sht3x_get_instance_memory */
+static struct SHT3XStruct instance_memory;
+
+static void *i2c_write_user_data = (void *)0x10;
+static void *i2c_read_user_data = (void *)0x11;
+static void *start_timer_user_data = (void *)0x56;
+static void *trace_hook_user_data = (void *)0x78;
+
+static SHT3X sht3x;
+
+/* Populated by mock object whenever mock_sht3x_i2c_write is called */
+static SHT3X_I2CTransactionCompleteCb i2c_write_complete_cb;
+static void *i2c_write_complete_cb_user_data;
+
+/* Populated by mock object whenever mock_sht3x_i2c_read is called */
+static SHT3X_I2CTransactionCompleteCb i2c_read_complete_cb;
+static void *i2c_read_complete_cb_user_data;
+
+/* Populated by mock object whenever mock_sht3x_start_timer is called */
+static SHT3XTimerExpiredCb timer_expired_cb;
+static void *timer_expired_cb_user_data;
+
+/* Populated by trace_hook */
+static SHT3XTraceEvent events[SHT3X_TRACE_TEST_MAX_EVENTS];
+static size_t num_events;
+static void *trace_hook_received_user_data;
+
+static void trace_hook(const SHT3XTraceEvent *event, void *user_data)
+{
+    if (num_events < SHT3X_TRACE_TEST_MAX_EVENTS) {
+        events[num_events] = *event;
+    }
+    num_events++;
+    trace_hook_received_user_data = user_data;
+}
+
+// clang-format off
+TEST_GROUP(SHT3XTrace)
+{
+    void setup() {
+        /* Order of expected calls is important for these tests. Fail the test if the expected mock calls do not happen
+        in the specified order. */
+        mock().strictOrder();
+
+        i2c_write_complete_cb = NULL;
+        i2c_write_complete_cb_user_data = NULL;
+        i2c_read_complete_cb = NULL;
+        i2c_read_complete_cb_user_data = NULL;
+        timer_expired_cb = NULL;
+        timer_expired_cb_user_data = NULL;
+
+        mock().setData("i2cWriteCompleteCb", (void *)&i2c_write_complete_cb);
+        mock().setData("i2cWriteCompleteCbUserData", &i2c_write_complete_cb_user_data);
+        mock().setData("i2cReadCompleteCb", (void *)&i2c_read_complete_cb);
+        mock().setData("i2cReadCompleteCbUserData", &i2c_read_complete_cb_user_data);
+        mock().setData("timerExpiredCb", (void *)&timer_expired_cb);
+        mock().setData("timerExpiredCbUserData", &timer_expired_cb_user_data);
+
+        memset(events, 0, sizeof(events));
+        num_events = 0;
+        trace_hook_received_user_data = NULL;
+        memset(&instance_memory, 0, sizeof(instance_memory));
+
+        mock()
+            .expectOneCall("mock_sht3x_get_instance_memory")
+            .withParameter("user_data", (void *)NULL)
+            .andReturnValue((void *)&instance_memory);
+        SHT3XInitConfig init_cfg = {
+            .get_instance_memory = mock_sht3x_get_instance_memory,
+            .get_instance_memory_user_data = NULL,
+            .i2c_write = mock_sht3x_i2c_write,
+            .i2c_write_user_data = i2c_write_user_data,
+            .i2c_read = mock_sht3x_i2c_read,
+            .i2c_read_user_data = i2c_read_user_data,
+            .start_timer = mock_sht3x_start_timer,
+            .start_timer_user_data = start_timer_user_data,
+            .i2c_addr = SHT3X_TRACE_TEST_I2C_ADDR,
+            .trace_hook = trace_hook,
+            .trace_hook_user_data = trace_hook_user_data,
+        };
+        uint8_t rc = sht3x_create(&sht3x, &init_cfg);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    }
+};
+// clang-format on
+
+static void check_event(size_t idx, uint8_t type, uint8_t sequence_type, uint8_t result_code, uint32_t arg)
+{
+    POINTERS_EQUAL(sht3x, events[idx].instance);
+    CHECK_EQUAL(type, events[idx].type);
+    CHECK_EQUAL(sequence_type, events[idx].sequence_type);
+    CHECK_EQUAL(result_code, events[idx].result_code);
+    CHECK_EQUAL(arg, events[idx].arg);
+}
+
+static void check_formatted(const SHT3XTraceEvent *event, uint64_t timestamp_us, const char *expected)
+{
+    char buf[160];
+    size_t length = 0;
+    uint8_t rc = sht3x_trace_format_chrome_event(event, timestamp_us, 3, buf, sizeof(buf), &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(strlen(expected), length);
+    MEMCMP_EQUAL(expected, buf, length);
+}
+
+TEST(SHT3XTrace, PeriodicMeasReadoutEvents)
+{
+    uint8_t fetch_data_cmd[] = {0xE0, 0x00};
+    mock()
+        .expectOneCall("mock_sht3x_i2c_write")
+        .withMemoryBufferParameter("data", fetch_data_cmd, 2)
+        .ignoreOtherParameters();
+    mock().expectOneCall("mock_sht3x_start_timer").withParameter("duration_ms", 1).ignoreOtherParameters();
+    mock().expectOneCall("mock_sht3x_i2c_read").withParameter("length", 5).ignoreOtherParameters();
+
+    uint8_t rc = sht3x_read_periodic_measurement(sht3x, SHT3X_FLAG_READ_TEMP | SHT3X_FLAG_READ_HUM, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    timer_expired_cb(timer_expired_cb_user_data);
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+
+    CHECK_EQUAL(8, num_events);
+    uint8_t seq = SHT3X_SEQUENCE_TYPE_READ_PERIODIC_MEAS;
+    check_event(0, SHT3X_TRACE_EVENT_SEQUENCE_START, seq, 0, 0);
+    check_event(1, SHT3X_TRACE_EVENT_I2C_WRITE_ISSUE, seq, 0, 0xE000);
+    check_event(2, SHT3X_TRACE_EVENT_I2C_WRITE_COMPLETE, seq, SHT3X_I2C_RESULT_CODE_OK, 0);
+    check_event(3, SHT3X_TRACE_EVENT_TIMER_ARM, seq, 0, 1);
+    check_event(4, SHT3X_TRACE_EVENT_TIMER_EXPIRE, seq, 0, 0);
+    check_event(5, SHT3X_TRACE_EVENT_I2C_READ_ISSUE, seq, 0, 5);
+    check_event(6, SHT3X_TRACE_EVENT_I2C_READ_COMPLETE, seq, SHT3X_I2C_RESULT_CODE_OK, 0);
+    check_event(7, SHT3X_TRACE_EVENT_SEQUENCE_END, seq, SHT3X_RESULT_CODE_OK, 0);
+    POINTERS_EQUAL(trace_hook_user_data, trace_hook_received_user_data);
+}
+
+TEST(SHT3XTrace, FailedCommandEvents)
+{
+    mock().expectOneCall("mock_sht3x_i2c_write").ignoreOtherParameters();
+
+    uint8_t rc = sht3x_clear_status_register(sht3x, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_BUS_ERROR, i2c_write_complete_cb_user_data);
+
+    CHECK_EQUAL(4, num_events);
+    uint8_t seq = SHT3X_SEQUENCE_TYPE_WRITE_CMD;
+    check_event(0, SHT3X_TRACE_EVENT_SEQUENCE_START, seq, 0, 0);
+    /* Clear status register command */
+    check_event(1, SHT3X_TRACE_EVENT_I2C_WRITE_ISSUE, seq, 0, 0x3041);
+    check_event(2, SHT3X_TRACE_EVENT_I2C_WRITE_COMPLETE, seq, SHT3X_I2C_RESULT_CODE_BUS_ERROR, 0);
+    check_event(3, SHT3X_TRACE_EVENT_SEQUENCE_END, seq, SHT3X_RESULT_CODE_IO_ERR, 0);
+}
+
+TEST(SHT3XTrace, LocallyCompletedCommandHasNoEvents)
+{
+    /* Nothing is known about the device yet, so the first stop command is sent */
+    mock().expectOneCall("mock_sht3x_i2c_write").ignoreOtherParameters();
+    sht3x_stop_periodic_measurement(sht3x, NULL, NULL);
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    num_events = 0;
+
+    /* Device is known to be in single shot mode, no I2C transaction */
+    uint8_t rc = sht3x_stop_periodic_measurement(sht3x, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(0, num_events);
+}
+
+TEST(SHT3XTrace, FormatChromeEvents)
+{
+    SHT3XTraceEvent event = {
+        .instance = sht3x,
+        .type = SHT3X_TRACE_EVENT_SEQUENCE_START,
+        .sequence_type = SHT3X_SEQUENCE_TYPE_READ_PERIODIC_MEAS,
+        .result_code = 0,
+        .arg = 0,
+    };
+    check_formatted(&event, 1000,
+                    "{\"name\":\"read_periodic_meas\",\"cat\":\"sequence\",\"ph\":\"B\",\"ts\":1000,"
+                    "\"pid\":1,\"tid\":3}");
+
+    event.type = SHT3X_TRACE_EVENT_SEQUENCE_END;
+    event.result_code = SHT3X_RESULT_CODE_NO_DATA;
+    check_formatted(&event, 18446744073709551615ULL,
+                    "{\"name\":\"read_periodic_meas\",\"cat\":\"sequence\",\"ph\":\"E\",\"ts\":18446744073709551615,"
+                    "\"pid\":1,\"tid\":3,\"args\":{\"rc\":5}}");
+
+    event.type = SHT3X_TRACE_EVENT_I2C_READ_ISSUE;
+    event.arg = 6;
+    check_formatted(&event, 0,
+                    "{\"name\":\"i2c_read\",\"cat\":\"i2c\",\"ph\":\"B\",\"ts\":0,\"pid\":1,\"tid\":3,"
+                    "\"args\":{\"length\":6}}");
+
+    event.type = SHT3X_TRACE_EVENT_I2C_WRITE_ISSUE;
+    event.arg = 0x2B32;
+    check_formatted(&event, 7,
+                    "{\"name\":\"i2c_write\",\"cat\":\"i2c\",\"ph\":\"B\",\"ts\":7,\"pid\":1,\"tid\":3,"
+                    "\"args\":{\"cmd\":\"0x2B32\"}}");
+
+    event.type = SHT3X_TRACE_EVENT_TIMER_ARM;
+    event.arg = 16;
+    check_formatted(&event, 42,
+                    "{\"name\":\"timer\",\"cat\":\"timer\",\"ph\":\"B\",\"ts\":42,\"pid\":1,\"tid\":3,"
+                    "\"args\":{\"duration_ms\":16}}");
+
+    event.type = SHT3X_TRACE_EVENT_TIMER_EXPIRE;
+    check_formatted(&event, 58, "{\"name\":\"timer\",\"cat\":\"timer\",\"ph\":\"E\",\"ts\":58,\"pid\":1,\"tid\":3}");
+}
+
+TEST(SHT3XTrace, FormatChromeEventInvalidArgs)
+{
+    SHT3XTraceEvent event = {
+        .instance = sht3x,
+        .type = SHT3X_TRACE_EVENT_TIMER_EXPIRE,
+        .sequence_type = SHT3X_SEQUENCE_TYPE_WRITE_CMD,
+        .result_code = 0,
+        .arg = 0,
+    };
+    char buf[16];
+    size_t length = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_trace_format_chrome_event(NULL, 0, 0, buf, sizeof(buf), &length));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_trace_format_chrome_event(&event, 0, 0, NULL, 0, &length));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_trace_format_chrome_event(&event, 0, 0, buf, sizeof(buf), NULL));
+    /* Does not fit */
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OUT_OF_MEMORY,
+                sht3x_trace_format_chrome_event(&event, 0, 0, buf, sizeof(buf), &length));
+    event.type = 0xFF;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG,
+                sht3x_trace_format_chrome_event(&event, 0, 0, buf, sizeof(buf), &length));
+}
+
+TEST(SHT3XTrace, GetSequenceName)
+{
+    STRCMP_EQUAL("write_cmd", sht3x_trace_get_sequence_name(SHT3X_SEQUENCE_TYPE_WRITE_CMD));
+    STRCMP_EQUAL("read_periodic_meas", sht3x_trace_get_sequence_name(SHT3X_SEQUENCE_TYPE_READ_PERIODIC_MEAS));
+    STRCMP_EQUAL("no_seq", sht3x_trace_get_sequence_name(SHT3X_SEQUENCE_TYPE_NO_SEQ));
+    POINTERS_EQUAL(NULL, sht3x_trace_get_sequence_name(SHT3X_SEQUENCE_TYPE_NO_SEQ + 1));
+}
+
+static uint32_t fanout_now_us;
+
+static uint32_t fanout_get_time_us(void *user_data)
+{
+    (void)user_data;
+    return fanout_now_us;
+}
+
+TEST(SHT3XTrace, FanoutFeedsFlightRecorderAndLatency)
+{
+    static struct SHT3XStruct fanout_instance_memory;
+    static uint8_t ring[SHT3X_TRACE_TEST_RECORDER_EVENTS * SHT3X_FLIGHT_RECORDER_EVENT_SIZE];
+    SHT3XFlightRecorder recorder;
+    SHT3XLatencyMonitor monitor;
+    memset(&fanout_instance_memory, 0, sizeof(fanout_instance_memory));
+    fanout_now_us = 0;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_flight_recorder_init(&recorder, ring, sizeof(ring)));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_latency_init(&monitor, fanout_get_time_us, NULL));
+
+    /* Entry with a NULL hook is skipped */
+    const SHT3XTraceHookEntry entries[] = {
+        {sht3x_flight_recorder_hook, &recorder},
+        {NULL, NULL},
+        {sht3x_latency_hook, &monitor},
+    };
+    const SHT3XTraceFanout fanout = {
+        .entries = entries,
+        .num_entries = sizeof(entries) / sizeof(entries[0]),
+    };
+
+    mock()
+        .expectOneCall("mock_sht3x_get_instance_memory")
+        .withParameter("user_data", (void *)NULL)
+        .andReturnValue((void *)&fanout_instance_memory);
+    SHT3XInitConfig init_cfg = {
+        .get_instance_memory = mock_sht3x_get_instance_memory,
+        .get_instance_memory_user_data = NULL,
+        .i2c_write = mock_sht3x_i2c_write,
+        .i2c_write_user_data = i2c_write_user_data,
+        .i2c_read = mock_sht3x_i2c_read,
+        .i2c_read_user_data = i2c_read_user_data,
+        .start_timer = mock_sht3x_start_timer,
+        .start_timer_user_data = start_timer_user_data,
+        .i2c_addr = SHT3X_TRACE_TEST_I2C_ADDR,
+        .trace_hook = sht3x_trace_fanout_hook,
+        .trace_hook_user_data = (void *)&fanout,
+    };
+    SHT3X fanout_sht3x;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_create(&fanout_sht3x, &init_cfg));
+
+    mock().expectOneCall("mock_sht3x_i2c_write").ignoreOtherParameters();
+    fanout_now_us = 100;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_enable_heater(fanout_sht3x, NULL, NULL));
+    fanout_now_us = 350;
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+
+    /* Sequence start, I2C write issue and completion, sequence end */
+    CHECK_EQUAL(4, recorder.num_events);
+    CHECK_EQUAL(4, recorder.total);
+
+    const SHT3XLatencyHistogram *histogram = NULL;
+    uint8_t rc = sht3x_latency_get_histogram(&monitor, SHT3X_LATENCY_KIND_SEQUENCE, SHT3X_SEQUENCE_TYPE_WRITE_CMD,
+                                             &histogram);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(1, histogram->count);
+    rc = sht3x_latency_get_histogram(&monitor, SHT3X_LATENCY_KIND_I2C, 0, &histogram);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(1, histogram->count);
+
+    /* Hook of the instance created in setup is not executed */
+    CHECK_EQUAL(0, num_events);
+}
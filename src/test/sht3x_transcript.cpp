@@ -0,0 +1,283 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+#include "sht3x.h"
+#include "sht3x_transcript.h"
+/* Included to know the size of SHT3X instance we need to define to return from mock_sht3x_get_instance_memory. */
+#include "sht3x_private.h"
+#include "mock_cfg_functions.h"
+
+#define SHT3X_TRANSCRIPT_TEST_I2C_ADDR 0x44
+/* Read status register without CRC: 2-byte write, timer, 2-byte read */
+#define SHT3X_TRANSCRIPT_TEST_LENGTH                                                                                   \
+    (SHT3X_TRANSCRIPT_HEADER_SIZE + (2 * (SHT3X_TRANSCRIPT_I2C_RECORD_OVERHEAD + 2)) +                                \
+     SHT3X_TRANSCRIPT_TIMER_RECORD_SIZE)
+
+/* To return from mock_sht3x_get_instance_memory */
+static struct SHT3XStruct instance_memory;
+
+static SHT3X sht3x;
+static SHT3XTranscriptRecorder recorder;
+static SHT3XTranscriptReplay replay;
+static uint8_t transcript[64];
+static uint32_t now_us;
+
+/* Populated by mock object whenever mock_sht3x_i2c_write is called */
+static SHT3X_I2CTransactionCompleteCb i2c_write_complete_cb;
+static void *i2c_write_complete_cb_user_data;
+
+/* Populated by mock object whenever mock_sht3x_i2c_read is called */
+static SHT3X_I2CTransactionCompleteCb i2c_read_complete_cb;
+static void *i2c_read_complete_cb_user_data;
+
+/* Populated by mock object whenever mock_sht3x_start_timer is called */
+static SHT3XTimerExpiredCb timer_expired_cb;
+static void *timer_expired_cb_user_data;
+
+static size_t complete_cb_call_count;
+static uint8_t complete_cb_result_code;
+static uint16_t complete_cb_reg_val;
+
+static uint32_t get_time_us(void *user_data)
+{
+    (void)user_data;
+    return now_us;
+}
+
+static void read_status_reg_complete_cb(uint8_t result_code, uint16_t reg_val, void *user_data)
+{
+    (void)user_data;
+    complete_cb_call_count++;
+    complete_cb_result_code = result_code;
+    complete_cb_reg_val = reg_val;
+}
+
+// clang-format off
+TEST_GROUP(SHT3XTranscript)
+{
+    void setup() {
+        /* Order of expected calls is important for these tests. Fail the test if the expected mock calls do not happen
+        in the specified order. */
+        mock().strictOrder();
+
+        i2c_write_complete_cb = NULL;
+        i2c_write_complete_cb_user_data = NULL;
+        i2c_read_complete_cb = NULL;
+        i2c_read_complete_cb_user_data = NULL;
+        timer_expired_cb = NULL;
+        timer_expired_cb_user_data = NULL;
+        mock().setData("i2cWriteCompleteCb", (void *)&i2c_write_complete_cb);
+        mock().setData("i2cWriteCompleteCbUserData", &i2c_write_complete_cb_user_data);
+        mock().setData("i2cReadCompleteCb", (void *)&i2c_read_complete_cb);
+        mock().setData("i2cReadCompleteCbUserData", &i2c_read_complete_cb_user_data);
+        mock().setData("timerExpiredCb", (void *)&timer_expired_cb);
+        mock().setData("timerExpiredCbUserData", &timer_expired_cb_user_data);
+
+        complete_cb_call_count = 0;
+        complete_cb_result_code = 0xFF;
+        complete_cb_reg_val = 0;
+        now_us = 0;
+        memset(transcript, 0, sizeof(transcript));
+    }
+};
+// clang-format on
+
+static void create_instance(SHT3X_I2CWrite i2c_write, SHT3X_I2CRead i2c_read, SHT3XStartTimer start_timer,
+                            void *user_data)
+{
+    memset(&instance_memory, 0, sizeof(instance_memory));
+    mock()
+        .expectOneCall("mock_sht3x_get_instance_memory")
+        .withParameter("user_data", (void *)NULL)
+        .andReturnValue((void *)&instance_memory);
+    SHT3XInitConfig init_cfg = {
+        .get_instance_memory = mock_sht3x_get_instance_memory,
+        .get_instance_memory_user_data = NULL,
+        .i2c_write = i2c_write,
+        .i2c_write_user_data = user_data,
+        .i2c_read = i2c_read,
+        .i2c_read_user_data = user_data,
+        .start_timer = start_timer,
+        .start_timer_user_data = user_data,
+        .i2c_addr = SHT3X_TRANSCRIPT_TEST_I2C_ADDR,
+    };
+    uint8_t rc = sht3x_create(&sht3x, &init_cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+}
+
+/* Record reading the status register: write at 100 us completes at 300 us, 1 ms timer expires at 1400 us, read
+ * completes at 1600 us. */
+static void record_read_status_register(size_t transcript_size)
+{
+    SHT3XTranscriptRecorderConfig cfg = {
+        .buf = transcript,
+        .size = transcript_size,
+        .i2c_write = mock_sht3x_i2c_write,
+        .i2c_write_user_data = NULL,
+        .i2c_read = mock_sht3x_i2c_read,
+        .i2c_read_user_data = NULL,
+        .start_timer = mock_sht3x_start_timer,
+        .start_timer_user_data = NULL,
+        .get_time_us = get_time_us,
+        .get_time_us_user_data = NULL,
+    };
+    uint8_t rc = sht3x_transcript_recorder_init(&recorder, &cfg);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    create_instance(sht3x_transcript_record_i2c_write, sht3x_transcript_record_i2c_read,
+                    sht3x_transcript_record_start_timer, &recorder);
+
+    uint8_t i2c_read_data[] = {0x80, 0x10};
+    mock().expectOneCall("mock_sht3x_i2c_write").withParameter("length", 2).ignoreOtherParameters();
+    mock().expectOneCall("mock_sht3x_start_timer").withParameter("duration_ms", 1).ignoreOtherParameters();
+    mock()
+        .expectOneCall("mock_sht3x_i2c_read")
+        .withOutputParameterReturning("data", i2c_read_data, sizeof(i2c_read_data))
+        .withParameter("length", 2)
+        .ignoreOtherParameters();
+
+    now_us = 100;
+    rc = sht3x_read_status_register(sht3x, SHT3X_VERIFY_CRC_NO, read_status_reg_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    now_us = 300;
+    i2c_write_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_write_complete_cb_user_data);
+    now_us = 1400;
+    timer_expired_cb(timer_expired_cb_user_data);
+    now_us = 1600;
+    i2c_read_complete_cb(SHT3X_I2C_RESULT_CODE_OK, i2c_read_complete_cb_user_data);
+    CHECK_EQUAL(1, complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, complete_cb_result_code);
+    CHECK_EQUAL(0x8010, complete_cb_reg_val);
+}
+
+TEST(SHT3XTranscript, RecordsTranscript)
+{
+    record_read_status_register(sizeof(transcript));
+
+    size_t length = 0;
+    uint8_t rc = sht3x_transcript_recorder_get_length(&recorder, &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(SHT3X_TRANSCRIPT_TEST_LENGTH, length);
+    uint8_t expected[] = {
+        /* Header */
+        0x01, 0x00,
+        /* Write at 100 us, took 200 us */
+        0x01, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0xC8, 0x44, 0x00, 0x02, 0xF3, 0x2D,
+        /* 1 ms timer at 300 us, took 1100 us */
+        0x03, 0x00, 0x00, 0x01, 0x2C, 0x00, 0x00, 0x04, 0x4C, 0x00, 0x00, 0x00, 0x01,
+        /* Read at 1400 us, took 200 us */
+        0x02, 0x00, 0x00, 0x05, 0x78, 0x00, 0x00, 0x00, 0xC8, 0x44, 0x00, 0x02, 0x80, 0x10,
+    };
+    CHECK_EQUAL(sizeof(expected), length);
+    MEMCMP_EQUAL(expected, transcript, sizeof(expected));
+}
+
+TEST(SHT3XTranscript, ReplayMatchesRecording)
+{
+    record_read_status_register(sizeof(transcript));
+    size_t length = 0;
+    sht3x_transcript_recorder_get_length(&recorder, &length);
+
+    uint8_t rc = sht3x_transcript_replay_init(&replay, transcript, length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    create_instance(sht3x_transcript_replay_i2c_write, sht3x_transcript_replay_i2c_read,
+                    sht3x_transcript_replay_start_timer, &replay);
+    complete_cb_call_count = 0;
+    complete_cb_reg_val = 0;
+
+    rc = sht3x_read_status_register(sht3x, SHT3X_VERIFY_CRC_NO, read_status_reg_complete_cb, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    /* Recorded durations of the write, the timer and the read */
+    uint32_t expected_durations[] = {200, 1100, 200};
+    for (size_t i = 0; i < 3; i++) {
+        uint32_t duration_us = 0;
+        rc = sht3x_transcript_replay_get_pending(&replay, &duration_us);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+        CHECK_EQUAL(expected_durations[i], duration_us);
+        CHECK_EQUAL(0, complete_cb_call_count);
+        rc = sht3x_transcript_replay_complete(&replay);
+        CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    }
+    CHECK_EQUAL(1, complete_cb_call_count);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, complete_cb_result_code);
+    CHECK_EQUAL(0x8010, complete_cb_reg_val);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_transcript_replay_complete(&replay));
+
+    bool done = false;
+    uint32_t mismatches = 0xFF;
+    rc = sht3x_transcript_replay_get_status(&replay, &done, &mismatches);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    CHECK_TRUE(done);
+    CHECK_EQUAL(0, mismatches);
+}
+
+TEST(SHT3XTranscript, ReplayMismatch)
+{
+    record_read_status_register(sizeof(transcript));
+    size_t length = 0;
+    sht3x_transcript_recorder_get_length(&recorder, &length);
+    sht3x_transcript_replay_init(&replay, transcript, length);
+    create_instance(sht3x_transcript_replay_i2c_write, sht3x_transcript_replay_i2c_read,
+                    sht3x_transcript_replay_start_timer, &replay);
+    complete_cb_call_count = 0;
+
+    /* Driver sends a different command than recorded */
+    uint8_t rc = sht3x_enable_heater(sht3x, NULL, NULL);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+    rc = sht3x_transcript_replay_complete(&replay);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, rc);
+
+    bool done = true;
+    uint32_t mismatches = 0;
+    sht3x_transcript_replay_get_status(&replay, &done, &mismatches);
+    CHECK_FALSE(done);
+    CHECK_EQUAL(1, mismatches);
+}
+
+TEST(SHT3XTranscript, RecordingStopsWhenFull)
+{
+    /* Fits the write record, but not the timer record */
+    record_read_status_register(SHT3X_TRANSCRIPT_HEADER_SIZE + SHT3X_TRANSCRIPT_I2C_RECORD_OVERHEAD + 2 + 1);
+
+    size_t length = 0;
+    uint8_t rc = sht3x_transcript_recorder_get_length(&recorder, &length);
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OUT_OF_MEMORY, rc);
+    CHECK_EQUAL(SHT3X_TRANSCRIPT_HEADER_SIZE + SHT3X_TRANSCRIPT_I2C_RECORD_OVERHEAD + 2, length);
+}
+
+TEST(SHT3XTranscript, InvalidArgs)
+{
+    SHT3XTranscriptRecorderConfig cfg = {
+        .buf = transcript,
+        .size = 1,
+        .i2c_write = mock_sht3x_i2c_write,
+        .i2c_write_user_data = NULL,
+        .i2c_read = mock_sht3x_i2c_read,
+        .i2c_read_user_data = NULL,
+        .start_timer = mock_sht3x_start_timer,
+        .start_timer_user_data = NULL,
+        .get_time_us = get_time_us,
+        .get_time_us_user_data = NULL,
+    };
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_transcript_recorder_init(&recorder, &cfg));
+    cfg.size = sizeof(transcript);
+    cfg.get_time_us = NULL;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_transcript_recorder_init(&recorder, &cfg));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_transcript_recorder_init(NULL, &cfg));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_transcript_recorder_get_length(&recorder, NULL));
+
+    uint8_t bad_version[] = {0x02, 0x00};
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_transcript_replay_init(&replay, bad_version, 2));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_transcript_replay_init(&replay, transcript, 1));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_transcript_replay_init(NULL, transcript, 2));
+
+    uint8_t empty[] = {0x01, 0x00};
+    CHECK_EQUAL(SHT3X_RESULT_CODE_OK, sht3x_transcript_replay_init(&replay, empty, sizeof(empty)));
+    uint32_t duration_us;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_NO_DATA, sht3x_transcript_replay_get_pending(&replay, &duration_us));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_transcript_replay_get_pending(&replay, NULL));
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_transcript_replay_complete(NULL));
+    bool done;
+    CHECK_EQUAL(SHT3X_RESULT_CODE_INVALID_ARG, sht3x_transcript_replay_get_status(&replay, &done, NULL));
+}